@@ -35,6 +35,7 @@
 
 #define _LIBMM_INSIDE_MMCLI
 #include "libmm-glib.h"
+#include "mm-gdbus-test.h"
 
 #include "mmcli.h"
 #include "mmcli-common.h"
@@ -52,6 +53,7 @@ static Context *ctx;
 
 /* Options */
 static gboolean get_daemon_version_flag;
+static gboolean debug_stats_flag;
 static gboolean list_modems_flag;
 static gboolean monitor_modems_flag;
 static gboolean scan_modems_flag;
@@ -72,6 +74,10 @@ static GOptionEntry entries[] = {
       "Set logging level in the ModemManager daemon",
       "[ERR,WARN,INFO,DEBUG]",
     },
+    { "debug-stats", 0, 0, G_OPTION_ARG_NONE, &debug_stats_flag,
+      "Show main loop statistics of the ModemManager daemon (requires --debug in the daemon)",
+      NULL
+    },
     { "list-modems", 'L', 0, G_OPTION_ARG_NONE, &list_modems_flag,
       "List available modems",
       NULL
@@ -127,6 +133,7 @@ mmcli_manager_options_enabled (void)
         return !!n_actions;
 
     n_actions = (get_daemon_version_flag +
+                 debug_stats_flag +
                  list_modems_flag +
                  monitor_modems_flag +
                  scan_modems_flag +
@@ -143,7 +150,7 @@ mmcli_manager_options_enabled (void)
         exit (EXIT_FAILURE);
     }
 
-    if (get_daemon_version_flag)
+    if (get_daemon_version_flag || debug_stats_flag)
         mmcli_force_sync_operation ();
     else if (monitor_modems_flag) {
         if (mmcli_output_get () != MMC_OUTPUT_TYPE_HUMAN) {
@@ -263,6 +270,286 @@ build_kernel_event_properties_from_input (const gchar *properties_string)
     return properties;
 }
 
+static gchar *
+format_usecs (guint64 usecs)
+{
+    if (usecs >= G_USEC_PER_SEC)
+        return g_strdup_printf ("%.3fs", (gdouble) usecs / G_USEC_PER_SEC);
+    if (usecs >= 1000)
+        return g_strdup_printf ("%.3fms", (gdouble) usecs / 1000);
+    return g_strdup_printf ("%" G_GUINT64_FORMAT "us", usecs);
+}
+
+static gchar *
+format_bound (guint64 usecs)
+{
+    if (usecs % G_USEC_PER_SEC == 0)
+        return g_strdup_printf ("%" G_GUINT64_FORMAT "s", usecs / G_USEC_PER_SEC);
+    if (usecs % 1000 == 0)
+        return g_strdup_printf ("%" G_GUINT64_FORMAT "ms", usecs / 1000);
+    return g_strdup_printf ("%" G_GUINT64_FORMAT "us", usecs);
+}
+
+/* Histogram buckets, with an additional last one for values over the last
+ * bound */
+static gchar **
+build_histogram_bounds_strv (GVariant *bounds_variant)
+{
+    const guint64 *bounds;
+    gsize          n_bounds;
+    GPtrArray     *aux;
+    gsize          i;
+
+    bounds = g_variant_get_fixed_array (bounds_variant, &n_bounds, sizeof (guint64));
+    if (!n_bounds)
+        return NULL;
+
+    aux = g_ptr_array_new ();
+    for (i = 0; i < n_bounds; i++) {
+        g_autofree gchar *bound = NULL;
+
+        bound = format_bound (bounds[i]);
+        g_ptr_array_add (aux, g_strdup_printf ("<%s", bound));
+    }
+    {
+        g_autofree gchar *bound = NULL;
+
+        bound = format_bound (bounds[n_bounds - 1]);
+        g_ptr_array_add (aux, g_strdup_printf (">=%s", bound));
+    }
+    g_ptr_array_add (aux, NULL);
+    return (gchar **) g_ptr_array_free (aux, FALSE);
+}
+
+static void
+append_histogram (GString      *str,
+                  GVariantDict *dict,
+                  const gchar  *name,
+                  const gchar  *histogram_key,
+                  const gchar  *max_key)
+{
+    g_autoptr(GVariant)  histogram = NULL;
+    g_autofree gchar    *max_str = NULL;
+    const guint64       *buckets;
+    gsize                n_buckets;
+    guint64              max = 0;
+    gsize                i;
+
+    histogram = g_variant_dict_lookup_value (dict, histogram_key, G_VARIANT_TYPE ("at"));
+    if (!histogram || !g_variant_dict_lookup (dict, max_key, "t", &max))
+        return;
+
+    buckets = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+    g_string_append_printf (str, ", %s: ", name);
+    for (i = 0; i < n_buckets; i++)
+        g_string_append_printf (str, "%s%" G_GUINT64_FORMAT, i ? "/" : "", buckets[i]);
+    max_str = format_usecs (max);
+    g_string_append_printf (str, ", %s max: %s", name, max_str);
+}
+
+static gchar *
+build_handler_string (GVariantDict *dict)
+{
+    GString     *str;
+    const gchar *type = NULL;
+    const gchar *tag = NULL;
+    guint64      count = 0;
+    guint64      time_total = 0;
+
+    g_variant_dict_lookup (dict, "type", "&s", &type);
+    g_variant_dict_lookup (dict, "tag", "&s", &tag);
+    g_variant_dict_lookup (dict, "count", "t", &count);
+
+    str = g_string_new (NULL);
+    g_string_append_printf (str, "type: %s, tag: %s, count: %" G_GUINT64_FORMAT,
+                            type ? type : "unknown", tag ? tag : "unknown", count);
+    append_histogram (str, dict, "latency", "latency-histogram", "latency-max");
+    if (g_variant_dict_lookup (dict, "time-total", "t", &time_total)) {
+        g_autofree gchar *time_total_str = NULL;
+
+        time_total_str = format_usecs (time_total);
+        g_string_append_printf (str, ", run time total: %s", time_total_str);
+        append_histogram (str, dict, "run time", "time-histogram", "time-max");
+    }
+    return g_string_free (str, FALSE);
+}
+
+static gint
+handler_stats_cmp (GVariantDict **a,
+                   GVariantDict **b)
+{
+    guint64 time_a = 0;
+    guint64 time_b = 0;
+    guint64 count_a = 0;
+    guint64 count_b = 0;
+
+    /* Handlers blocking the main loop the longest go first */
+    g_variant_dict_lookup (*a, "time-total", "t", &time_a);
+    g_variant_dict_lookup (*b, "time-total", "t", &time_b);
+    if (time_a != time_b)
+        return time_a > time_b ? -1 : 1;
+    g_variant_dict_lookup (*a, "count", "t", &count_a);
+    g_variant_dict_lookup (*b, "count", "t", &count_b);
+    if (count_a != count_b)
+        return count_a > count_b ? -1 : 1;
+    return 0;
+}
+
+static gchar **
+build_handlers_strv (GVariant *handlers)
+{
+    g_autoptr(GPtrArray)  dicts = NULL;
+    GPtrArray            *aux;
+    GVariantIter          iter;
+    GVariant             *handler;
+    guint                 i;
+
+    dicts = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_dict_unref);
+    g_variant_iter_init (&iter, handlers);
+    while ((handler = g_variant_iter_next_value (&iter))) {
+        g_ptr_array_add (dicts, g_variant_dict_new (handler));
+        g_variant_unref (handler);
+    }
+    if (!dicts->len)
+        return NULL;
+    g_ptr_array_sort (dicts, (GCompareFunc) handler_stats_cmp);
+
+    aux = g_ptr_array_new ();
+    for (i = 0; i < dicts->len; i++)
+        g_ptr_array_add (aux, build_handler_string (g_ptr_array_index (dicts, i)));
+    g_ptr_array_add (aux, NULL);
+    return (gchar **) g_ptr_array_free (aux, FALSE);
+}
+
+static gchar *
+build_regex_string (GVariant *regex)
+{
+    const gchar      *pattern = NULL;
+    guint32           compiles = 0;
+    guint32           lookups = 0;
+    guint32           matches = 0;
+    guint64           match_time = 0;
+    g_autofree gchar *match_time_str = NULL;
+
+    g_variant_lookup (regex, "pattern", "&s", &pattern);
+    g_variant_lookup (regex, "compiles", "u", &compiles);
+    g_variant_lookup (regex, "lookups", "u", &lookups);
+    g_variant_lookup (regex, "matches", "u", &matches);
+    g_variant_lookup (regex, "match-time", "t", &match_time);
+
+    match_time_str = format_usecs (match_time);
+    return g_strdup_printf ("pattern: %s, compiles: %u, lookups: %u, matches: %u, match time: %s",
+                            pattern ? pattern : "unknown", compiles, lookups, matches, match_time_str);
+}
+
+static gchar *
+build_modem_string (GVariant *modem)
+{
+    GString             *str;
+    g_autoptr(GVariant)  probing_timings = NULL;
+    const gchar         *path = NULL;
+    const gchar         *mode = NULL;
+    guint32              n_indications = 0;
+    guint32              n_polls = 0;
+
+    g_variant_lookup (modem, "path", "&o", &path);
+
+    str = g_string_new (NULL);
+    g_string_append_printf (str, "path: %s", path ? path : "unknown");
+    probing_timings = g_variant_lookup_value (modem, "probing-timings", G_VARIANT_TYPE ("a{su}"));
+    if (probing_timings) {
+        guint32 total_time = 0;
+        guint32 wait_time = 0;
+        guint32 probing_time = 0;
+
+        g_variant_lookup (probing_timings, "total-time", "u", &total_time);
+        g_variant_lookup (probing_timings, "wait-time", "u", &wait_time);
+        g_variant_lookup (probing_timings, "probing-time", "u", &probing_time);
+        g_string_append_printf (str, ", probing: %ums (waiting %ums, probing %ums)", total_time, wait_time, probing_time);
+    }
+    if (g_variant_lookup (modem, "signal-report-mode", "&s", &mode)) {
+        g_variant_lookup (modem, "signal-indications", "u", &n_indications);
+        g_variant_lookup (modem, "signal-polls", "u", &n_polls);
+        g_string_append_printf (str, ", mode: %s, indications: %u, polls: %u", mode, n_indications, n_polls);
+    }
+    if (g_variant_lookup (modem, "extended-signal-indications", "u", &n_indications) &&
+        g_variant_lookup (modem, "extended-signal-polls", "u", &n_polls))
+        g_string_append_printf (str, ", extended indications: %u, extended polls: %u", n_indications, n_polls);
+    return g_string_free (str, FALSE);
+}
+
+static gchar **
+build_strv (GVariant *list,
+            gchar *(* build_string) (GVariant *item))
+{
+    GPtrArray    *aux;
+    GVariantIter  iter;
+    GVariant     *item;
+
+    if (!g_variant_n_children (list))
+        return NULL;
+
+    aux = g_ptr_array_new ();
+    g_variant_iter_init (&iter, list);
+    while ((item = g_variant_iter_next_value (&iter))) {
+        g_ptr_array_add (aux, build_string (item));
+        g_variant_unref (item);
+    }
+    g_ptr_array_add (aux, NULL);
+    return (gchar **) g_ptr_array_free (aux, FALSE);
+}
+
+static void
+debug_stats_process_reply (GVariant     *stats,
+                           const GError *error)
+{
+    g_autoptr(GVariantDict) dict = NULL;
+    g_autoptr(GVariant)     bounds = NULL;
+    g_autoptr(GVariant)     handlers = NULL;
+    g_autoptr(GVariant)     regexes = NULL;
+    g_autoptr(GVariant)     modems = NULL;
+    guint64                 wakeups = 0;
+    gdouble                 wakeups_per_second = 0.0;
+    guint32                 timers = 0;
+    guint64                 timer_wakeups = 0;
+    guint64                 timer_callbacks = 0;
+
+    if (!stats) {
+        g_printerr ("error: couldn't get debug stats: '%s' (is the daemon running with --debug?)\n",
+                    error ? error->message : "unknown error");
+        exit (EXIT_FAILURE);
+    }
+
+    dict = g_variant_dict_new (stats);
+    g_variant_dict_lookup (dict, "wakeups", "t", &wakeups);
+    g_variant_dict_lookup (dict, "wakeups-per-second", "d", &wakeups_per_second);
+    g_variant_dict_lookup (dict, "timers", "u", &timers);
+    g_variant_dict_lookup (dict, "timer-wakeups", "t", &timer_wakeups);
+    g_variant_dict_lookup (dict, "timer-callbacks", "t", &timer_callbacks);
+
+    mmcli_output_string_take (MMC_F_DEBUG_MAIN_LOOP_WAKEUPS, g_strdup_printf ("%" G_GUINT64_FORMAT, wakeups));
+    mmcli_output_string_take (MMC_F_DEBUG_MAIN_LOOP_WAKEUPS_PER_SECOND, g_strdup_printf ("%.2f", wakeups_per_second));
+    mmcli_output_string_take (MMC_F_DEBUG_TIMERS_PENDING, g_strdup_printf ("%u", timers));
+    mmcli_output_string_take (MMC_F_DEBUG_TIMERS_WAKEUPS, g_strdup_printf ("%" G_GUINT64_FORMAT, timer_wakeups));
+    mmcli_output_string_take (MMC_F_DEBUG_TIMERS_CALLBACKS, g_strdup_printf ("%" G_GUINT64_FORMAT, timer_callbacks));
+
+    /* Handler and regex stats only given if enabled in the daemon */
+    bounds = g_variant_dict_lookup_value (dict, "histogram-bounds", G_VARIANT_TYPE ("at"));
+    handlers = g_variant_dict_lookup_value (dict, "handlers", G_VARIANT_TYPE ("aa{sv}"));
+    if (bounds && handlers) {
+        mmcli_output_string_array_take (MMC_F_DEBUG_HANDLERS_HISTOGRAM_BOUNDS, build_histogram_bounds_strv (bounds), FALSE);
+        mmcli_output_string_array_take (MMC_F_DEBUG_HANDLERS_STATS, build_handlers_strv (handlers), TRUE);
+    }
+    regexes = g_variant_dict_lookup_value (dict, "regexes", G_VARIANT_TYPE ("aa{sv}"));
+    if (regexes)
+        mmcli_output_string_array_take (MMC_F_DEBUG_REGEXES_STATS, build_strv (regexes, build_regex_string), TRUE);
+    modems = g_variant_dict_lookup_value (dict, "modems", G_VARIANT_TYPE ("aa{sv}"));
+    if (modems)
+        mmcli_output_string_array_take (MMC_F_DEBUG_MODEMS_STATS, build_strv (modems, build_modem_string), TRUE);
+
+    mmcli_output_dump ();
+}
+
 static void
 set_logging_process_reply (gboolean      result,
                            const GError *error)
@@ -566,6 +853,26 @@ mmcli_manager_run_synchronous (GDBusConnection *connection)
         return;
     }
 
+    /* Get debug stats? */
+    if (debug_stats_flag) {
+        MmGdbusDebug        *debug;
+        g_autoptr(GVariant)  stats = NULL;
+
+        debug = mm_gdbus_debug_proxy_new_sync (connection,
+                                               (G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
+                                                G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS),
+                                               MM_DBUS_SERVICE,
+                                               MM_DBUS_PATH,
+                                               NULL,
+                                               &error);
+        if (debug) {
+            mm_gdbus_debug_call_get_stats_sync (debug, &stats, NULL, &error);
+            g_object_unref (debug);
+        }
+        debug_stats_process_reply (stats, error);
+        return;
+    }
+
     /* Setup operation timeout */
     mmcli_force_operation_timeout (mm_manager_peek_proxy (ctx->manager));
 
@@ -87,6 +87,11 @@ static SectionInfo section_infos[] = {
     [MMC_S_SMS_PROPERTIES]             = { "Properties"           },
     [MMC_S_SIM_GENERAL]                = { "General"              },
     [MMC_S_SIM_PROPERTIES]             = { "Properties"           },
+    [MMC_S_DEBUG_MAIN_LOOP]            = { "Main loop"            },
+    [MMC_S_DEBUG_TIMERS]               = { "Timers"               },
+    [MMC_S_DEBUG_HANDLERS]             = { "Handlers"             },
+    [MMC_S_DEBUG_REGEXES]              = { "Regexes"              },
+    [MMC_S_DEBUG_MODEMS]               = { "Modems"               },
 };
 
 /******************************************************************************/
@@ -310,6 +315,15 @@ static FieldInfo field_infos[] = {
     [MMC_F_SIM_PROPERTIES_REMOVABILITY]              = { "sim.properties.removability",                     "removability",             MMC_S_SIM_PROPERTIES,             },
     [MMC_F_SAR_STATE]                                = { "modem.sar.state",                                 "enabled",                  MMC_S_MODEM_SAR,                  },
     [MMC_F_SAR_POWER_LEVEL]                          = { "modem.sar.power-level",                           "power level",              MMC_S_MODEM_SAR,                  },
+    [MMC_F_DEBUG_MAIN_LOOP_WAKEUPS]                  = { "debug.main-loop.wakeups",                         "wakeups",                  MMC_S_DEBUG_MAIN_LOOP,            },
+    [MMC_F_DEBUG_MAIN_LOOP_WAKEUPS_PER_SECOND]       = { "debug.main-loop.wakeups-per-second",              "wakeups per second",       MMC_S_DEBUG_MAIN_LOOP,            },
+    [MMC_F_DEBUG_TIMERS_PENDING]                     = { "debug.timers.pending",                            "pending",                  MMC_S_DEBUG_TIMERS,               },
+    [MMC_F_DEBUG_TIMERS_WAKEUPS]                     = { "debug.timers.wakeups",                            "wakeups",                  MMC_S_DEBUG_TIMERS,               },
+    [MMC_F_DEBUG_TIMERS_CALLBACKS]                   = { "debug.timers.callbacks",                          "callbacks",                MMC_S_DEBUG_TIMERS,               },
+    [MMC_F_DEBUG_HANDLERS_HISTOGRAM_BOUNDS]          = { "debug.handlers.histogram-bounds",                 "histogram buckets",        MMC_S_DEBUG_HANDLERS,             },
+    [MMC_F_DEBUG_HANDLERS_STATS]                     = { "debug.handlers.stats",                            "dispatches",               MMC_S_DEBUG_HANDLERS,             },
+    [MMC_F_DEBUG_REGEXES_STATS]                      = { "debug.regexes.stats",                             "patterns",                 MMC_S_DEBUG_REGEXES,              },
+    [MMC_F_DEBUG_MODEMS_STATS]                       = { "debug.modems.stats",                              "stats",                    MMC_S_DEBUG_MODEMS,               },
     [MMC_F_MODEM_LIST_DBUS_PATH]                     = { "modem-list",                                      "modems",                   MMC_S_UNKNOWN,                    },
     [MMC_F_SMS_LIST_DBUS_PATH]                       = { "modem.messaging.sms",                             "sms messages",             MMC_S_UNKNOWN,                    },
     [MMC_F_CALL_LIST_DBUS_PATH]                      = { "modem.voice.call",                                "calls",                    MMC_S_UNKNOWN,                    },
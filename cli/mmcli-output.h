@@ -83,6 +83,11 @@ typedef enum {
     MMC_S_SMS_PROPERTIES,
     MMC_S_SIM_GENERAL,
     MMC_S_SIM_PROPERTIES,
+    MMC_S_DEBUG_MAIN_LOOP,
+    MMC_S_DEBUG_TIMERS,
+    MMC_S_DEBUG_HANDLERS,
+    MMC_S_DEBUG_REGEXES,
+    MMC_S_DEBUG_MODEMS,
 } MmcS;
 
 /******************************************************************************/
@@ -328,6 +333,15 @@ typedef enum {
     MMC_F_SIM_PROPERTIES_REMOVABILITY,
     MMC_F_SAR_STATE,
     MMC_F_SAR_POWER_LEVEL,
+    MMC_F_DEBUG_MAIN_LOOP_WAKEUPS,
+    MMC_F_DEBUG_MAIN_LOOP_WAKEUPS_PER_SECOND,
+    MMC_F_DEBUG_TIMERS_PENDING,
+    MMC_F_DEBUG_TIMERS_WAKEUPS,
+    MMC_F_DEBUG_TIMERS_CALLBACKS,
+    MMC_F_DEBUG_HANDLERS_HISTOGRAM_BOUNDS,
+    MMC_F_DEBUG_HANDLERS_STATS,
+    MMC_F_DEBUG_REGEXES_STATS,
+    MMC_F_DEBUG_MODEMS_STATS,
     /* Lists */
     MMC_F_MODEM_LIST_DBUS_PATH,
     MMC_F_SMS_LIST_DBUS_PATH,
@@ -1786,6 +1786,139 @@ mm_new_iso8601_time (guint    year,
 
 /*****************************************************************************/
 
+static gboolean
+nmea_sentence_add_field (MMNmeaSentence *sentence,
+                         const gchar    *str,
+                         gsize           len)
+{
+    if (sentence->n_fields == MM_NMEA_MAX_FIELDS)
+        return FALSE;
+
+    sentence->fields[sentence->n_fields].str = str;
+    sentence->fields[sentence->n_fields].len = len;
+    sentence->n_fields++;
+    return TRUE;
+}
+
+gboolean
+mm_nmea_sentence_parse (const gchar    *str,
+                        gssize          len,
+                        MMNmeaSentence *sentence)
+{
+    const gchar *p;
+    const gchar *end;
+    const gchar *field;
+    guint8       checksum = 0;
+
+    if (len < 0)
+        len = strlen (str);
+
+    sentence->str = str;
+    sentence->len = len;
+    sentence->has_checksum = FALSE;
+    sentence->checksum_ok = FALSE;
+    sentence->n_fields = 0;
+
+    /* Ignore trailing CR/LF */
+    while (len > 0 && (str[len - 1] == '\r' || str[len - 1] == '\n'))
+        len--;
+
+    if (len < 2 || (str[0] != '$' && str[0] != '!'))
+        return FALSE;
+
+    /* The checksum covers everything between the start delimiter and the
+     * checksum delimiter */
+    end = str + len;
+    field = str + 1;
+    for (p = field; p < end && *p != '*'; p++) {
+        checksum ^= (guint8) *p;
+        if (*p == ',') {
+            if (!nmea_sentence_add_field (sentence, field, p - field))
+                return FALSE;
+            field = p + 1;
+        }
+    }
+    if (!nmea_sentence_add_field (sentence, field, p - field))
+        return FALSE;
+
+    if (p < end) {
+        gint high;
+        gint low;
+
+        sentence->has_checksum = TRUE;
+        if (end - p == 3) {
+            high = g_ascii_xdigit_value (p[1]);
+            low = g_ascii_xdigit_value (p[2]);
+            sentence->checksum_ok = (high >= 0 && low >= 0 && ((high << 4) | low) == checksum);
+        }
+    }
+
+    /* Address field: talker and sentence id, or 'P' and the manufacturer
+     * specific id for proprietary sentences */
+    if (sentence->fields[0].len < 2)
+        return FALSE;
+    sentence->talker.str = sentence->fields[0].str;
+    sentence->talker.len = (sentence->fields[0].str[0] == 'P') ? 1 : 2;
+    sentence->id.str = sentence->fields[0].str + sentence->talker.len;
+    sentence->id.len = sentence->fields[0].len - sentence->talker.len;
+    return TRUE;
+}
+
+gboolean
+mm_nmea_field_equal (const MMNmeaField *field,
+                     const gchar       *str)
+{
+    return (strncmp (field->str, str, field->len) == 0 && str[field->len] == '\0');
+}
+
+gboolean
+mm_nmea_sentence_is (const MMNmeaSentence *sentence,
+                     const gchar          *talker,
+                     const gchar          *id)
+{
+    return ((!talker || mm_nmea_field_equal (&sentence->talker, talker)) &&
+            (!id || mm_nmea_field_equal (&sentence->id, id)));
+}
+
+gchar *
+mm_nmea_field_dup (const MMNmeaField *field)
+{
+    return g_strndup (field->str, field->len);
+}
+
+/* Numeric fields are short, copy them to the stack to NUL-terminate them */
+#define NMEA_NUMERIC_FIELD_MAX_LEN 32
+
+gboolean
+mm_nmea_field_get_uint (const MMNmeaField *field,
+                        guint             *out)
+{
+    gchar buf[NMEA_NUMERIC_FIELD_MAX_LEN];
+
+    if (field->len == 0 || field->len >= sizeof (buf))
+        return FALSE;
+
+    memcpy (buf, field->str, field->len);
+    buf[field->len] = '\0';
+    return mm_get_uint_from_str (buf, out);
+}
+
+gboolean
+mm_nmea_field_get_double (const MMNmeaField *field,
+                          gdouble           *out)
+{
+    gchar buf[NMEA_NUMERIC_FIELD_MAX_LEN];
+
+    if (field->len == 0 || field->len >= sizeof (buf))
+        return FALSE;
+
+    memcpy (buf, field->str, field->len);
+    buf[field->len] = '\0';
+    return mm_get_double_from_str (buf, out);
+}
+
+/*****************************************************************************/
+
 /* From hostap, Copyright (c) 2002-2005, Jouni Malinen <jkmaline@cc.hut.fi> */
 
 static gint
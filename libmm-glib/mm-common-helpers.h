@@ -218,6 +218,48 @@ gchar    *mm_new_iso8601_time                    (guint    year,
                                                   gboolean have_offset,
                                                   gint     offset_minutes);
 
+/******************************************************************************/
+/* NMEA sentence tokenizer
+ *
+ * Sentences are split in place: the fields point into the given string,
+ * which is never modified, so nothing is allocated while parsing. */
+
+#define MM_NMEA_MAX_FIELDS 40
+
+typedef struct {
+    const gchar *str;
+    gsize        len;
+} MMNmeaField;
+
+typedef struct {
+    /* The whole sentence as given, including any trailing CR/LF */
+    const gchar *str;
+    gsize        len;
+    gboolean     has_checksum;
+    gboolean     checksum_ok;
+    /* Talker (e.g. "GP", or "P" for proprietary sentences) and sentence id
+     * (e.g. "GGA") */
+    MMNmeaField  talker;
+    MMNmeaField  id;
+    /* The first field is the address, e.g. "GPGGA" */
+    guint        n_fields;
+    MMNmeaField  fields[MM_NMEA_MAX_FIELDS];
+} MMNmeaSentence;
+
+gboolean  mm_nmea_sentence_parse    (const gchar          *str,
+                                     gssize                len,
+                                     MMNmeaSentence       *sentence);
+gboolean  mm_nmea_sentence_is       (const MMNmeaSentence *sentence,
+                                     const gchar          *talker,
+                                     const gchar          *id);
+gboolean  mm_nmea_field_equal       (const MMNmeaField    *field,
+                                     const gchar          *str);
+gchar    *mm_nmea_field_dup         (const MMNmeaField    *field);
+gboolean  mm_nmea_field_get_uint    (const MMNmeaField    *field,
+                                     guint                *out);
+gboolean  mm_nmea_field_get_double  (const MMNmeaField    *field,
+                                     gdouble              *out);
+
 /******************************************************************************/
 /* Type checkers and conversion utilities */
 
@@ -45,87 +45,98 @@ G_DEFINE_TYPE (MMLocationGpsNmea, mm_location_gps_nmea, G_TYPE_OBJECT)
 
 struct _MMLocationGpsNmeaPrivate {
     GHashTable *traces;
-    GRegex *sequence_regex;
 };
 
 /*****************************************************************************/
 
 static gboolean
-check_append_or_replace (MMLocationGpsNmea *self,
-                         const gchar *trace)
+check_append_or_replace (const MMNmeaSentence *sentence)
 {
-    /* By default, replace */
-    gboolean append_or_replace = FALSE;
-    GMatchInfo *match_info = NULL;
-
-    if (G_UNLIKELY (!self->priv->sequence_regex))
-        self->priv->sequence_regex = g_regex_new ("\\$..(?:ALM|GSV|RTE|SFI),(\\d),(\\d).*",
-                                                  G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                                                  0,
-                                                  NULL);
-
-    if (g_regex_match (self->priv->sequence_regex, trace, 0, &match_info)) {
-        guint index;
+    guint index;
 
-        /* If we don't have the first element of a sequence, append */
-        if (mm_get_uint_from_match_info (match_info, 2, &index) && index != 1)
-            append_or_replace = TRUE;
-    }
-    g_match_info_free (match_info);
+    /* By default, replace */
+    if (sentence->talker.len != 2 ||
+        sentence->n_fields < 3 ||
+        !(mm_nmea_sentence_is (sentence, NULL, "ALM") ||
+          mm_nmea_sentence_is (sentence, NULL, "GSV") ||
+          mm_nmea_sentence_is (sentence, NULL, "RTE") ||
+          mm_nmea_sentence_is (sentence, NULL, "SFI")))
+        return FALSE;
 
-    return append_or_replace;
+    /* If we don't have the first element of a sequence, append */
+    return (mm_nmea_field_get_uint (&sentence->fields[2], &index) && index != 1);
 }
 
+/* Trace types are short, e.g. "$GPGGA", so they're looked up from the stack */
+#define TRACE_TYPE_MAX_LEN 16
+
 static gboolean
-location_gps_nmea_take_trace (MMLocationGpsNmea *self,
-                              gchar *trace)
+location_gps_nmea_take_trace (MMLocationGpsNmea    *self,
+                              gchar                *trace,
+                              const MMNmeaSentence *sentence)
 {
-    gchar *i;
-    gchar *trace_type;
-
-    i = strchr (trace, ',');
-    if (!i || i == trace) {
+    gchar             trace_type_buf[TRACE_TYPE_MAX_LEN];
+    g_autofree gchar *trace_type_allocated = NULL;
+    const gchar      *trace_type;
+    gsize             trace_type_len;
+    gpointer          previous_trace_type = NULL;
+    gpointer          previous = NULL;
+
+    /* The trace type is the start delimiter and the address, e.g. "$GPGGA" */
+    if (sentence->n_fields < 2) {
         g_free (trace);
         return FALSE;
     }
 
-    trace_type = g_malloc (i - trace + 1);
-    memcpy (trace_type, trace, i - trace);
-    trace_type[i - trace] = '\0';
-
-    /* Some traces are part of a SEQUENCE; so we need to decide whether we
-     * completely replace the previous trace, or we append the new one to
-     * the already existing list */
-    if (check_append_or_replace (self, trace)) {
-        /* Append */
-        const gchar *previous;
-
-        previous = g_hash_table_lookup (self->priv->traces, trace_type);
-        if (previous) {
+    trace_type_len = 1 + sentence->fields[0].len;
+    if (trace_type_len < sizeof (trace_type_buf)) {
+        memcpy (trace_type_buf, sentence->str, trace_type_len);
+        trace_type_buf[trace_type_len] = '\0';
+        trace_type = trace_type_buf;
+    } else
+        trace_type = trace_type_allocated = g_strndup (sentence->str, trace_type_len);
+
+    /* Reuse the key already in the table, if any */
+    if (g_hash_table_lookup_extended (self->priv->traces, trace_type, &previous_trace_type, &previous)) {
+        /* Some traces are part of a SEQUENCE; so we need to decide whether we
+         * completely replace the previous trace, or we append the new one to
+         * the already existing list */
+        if (check_append_or_replace (sentence)) {
             gchar *sequence;
 
             /* Skip the trace if we already have it there */
-            if (strstr (previous, trace)) {
-                g_free (trace_type);
+            if (strstr ((const gchar *) previous, trace)) {
                 g_free (trace);
                 return TRUE;
             }
 
             sequence = g_strdup_printf ("%s%s%s",
-                                        previous,
-                                        g_str_has_suffix (previous, "\r\n") ? "" : "\r\n",
+                                        (const gchar *) previous,
+                                        g_str_has_suffix ((const gchar *) previous, "\r\n") ? "" : "\r\n",
                                         trace);
             g_free (trace);
             trace = sequence;
         }
-    }
 
-    g_hash_table_replace (self->priv->traces,
-                          trace_type,
-                          trace);
+        g_hash_table_steal (self->priv->traces, previous_trace_type);
+        g_free (previous);
+    } else
+        previous_trace_type = trace_type_allocated ? g_steal_pointer (&trace_type_allocated) : g_strdup (trace_type);
+
+    g_hash_table_insert (self->priv->traces, previous_trace_type, trace);
     return TRUE;
 }
 
+/**
+ * mm_location_gps_nmea_add_sentence: (skip)
+ */
+gboolean
+mm_location_gps_nmea_add_sentence (MMLocationGpsNmea    *self,
+                                   const MMNmeaSentence *sentence)
+{
+    return location_gps_nmea_take_trace (self, g_strndup (sentence->str, sentence->len), sentence);
+}
+
 /**
  * mm_location_gps_nmea_add_trace: (skip)
  */
@@ -133,7 +144,12 @@ gboolean
 mm_location_gps_nmea_add_trace (MMLocationGpsNmea *self,
                                 const gchar *trace)
 {
-    return location_gps_nmea_take_trace (self, g_strdup (trace));
+    MMNmeaSentence sentence;
+
+    if (!mm_nmea_sentence_parse (trace, -1, &sentence))
+        return FALSE;
+
+    return mm_location_gps_nmea_add_sentence (self, &sentence);
 }
 
 /*****************************************************************************/
@@ -250,7 +266,12 @@ mm_location_gps_nmea_new_from_string_variant (GVariant *string,
     self = mm_location_gps_nmea_new ();
 
     for (i = 0; split[i]; i++) {
-        location_gps_nmea_take_trace (self, split[i]);
+        MMNmeaSentence sentence;
+
+        if (mm_nmea_sentence_parse (split[i], -1, &sentence))
+            location_gps_nmea_take_trace (self, split[i], &sentence);
+        else
+            g_free (split[i]);
     }
 
     /* Note that the strings in the array of strings were already taken
@@ -291,8 +312,6 @@ finalize (GObject *object)
     MMLocationGpsNmea *self = MM_LOCATION_GPS_NMEA (object);
 
     g_hash_table_destroy (self->priv->traces);
-    if (self->priv->sequence_regex)
-        g_regex_unref (self->priv->sequence_regex);
 
     G_OBJECT_CLASS (mm_location_gps_nmea_parent_class)->finalize (object);
 }
@@ -78,8 +78,10 @@ MMLocationGpsNmea *mm_location_gps_nmea_new (void);
 MMLocationGpsNmea *mm_location_gps_nmea_new_from_string_variant (GVariant *string,
                                                                  GError **error);
 
-gboolean mm_location_gps_nmea_add_trace (MMLocationGpsNmea *self,
-                                         const gchar *trace);
+gboolean mm_location_gps_nmea_add_trace    (MMLocationGpsNmea    *self,
+                                            const gchar          *trace);
+gboolean mm_location_gps_nmea_add_sentence (MMLocationGpsNmea    *self,
+                                            const MMNmeaSentence *sentence);
 
 GVariant *mm_location_gps_nmea_get_string_variant (MMLocationGpsNmea *self);
 
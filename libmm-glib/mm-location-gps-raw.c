@@ -49,7 +49,6 @@ G_DEFINE_TYPE (MMLocationGpsRaw, mm_location_gps_raw, G_TYPE_OBJECT)
 #define PROPERTY_ALTITUDE  "altitude"
 
 struct _MMLocationGpsRawPrivate {
-    GRegex   *gga_regex;
     gboolean  prefer_gngga;
 
     gchar   *utc_time;
@@ -145,69 +144,55 @@ mm_location_gps_raw_get_altitude (MMLocationGpsRaw *self)
 /*****************************************************************************/
 
 static gboolean
-get_longitude_or_latitude_from_match_info (GMatchInfo *match_info,
-                                           guint32 match_index,
-                                           gdouble *out)
+get_longitude_or_latitude_from_field (const MMNmeaField *field,
+                                      gdouble           *out)
 {
-    gchar *aux;
-    gchar *s;
-    gboolean ret = FALSE;
-    gdouble minutes;
-    gdouble degrees;
-
-    s = g_match_info_fetch (match_info, match_index);
-    if (!s)
-        goto out;
+    const gchar *dot;
+    MMNmeaField  degrees_field;
+    MMNmeaField  minutes_field;
+    gdouble      minutes;
+    gdouble      degrees;
 
     /* 4533.35 is 45 degrees and 33.35 minutes */
 
-    aux = strchr (s, '.');
-    if (!aux || ((aux - s) < 3))
-        goto out;
+    dot = memchr (field->str, '.', field->len);
+    if (!dot || ((dot - field->str) < 3))
+        return FALSE;
 
-    aux -= 2;
-    if (!mm_get_double_from_str (aux, &minutes))
-        goto out;
+    degrees_field.str = field->str;
+    degrees_field.len = dot - field->str - 2;
+    minutes_field.str = dot - 2;
+    minutes_field.len = field->len - degrees_field.len;
 
-    aux[0] = '\0';
-    if (!mm_get_double_from_str (s, &degrees))
-        goto out;
+    if (!mm_nmea_field_get_double (&minutes_field, &minutes) ||
+        !mm_nmea_field_get_double (&degrees_field, &degrees))
+        return FALSE;
 
     /* Include the minutes as part of the degrees */
     *out = degrees + (minutes / 60.0);
-    ret = TRUE;
-
-out:
-    g_free (s);
-
-    return ret;
+    return TRUE;
 }
 
 /**
- * mm_location_gps_raw_add_trace: (skip)
+ * mm_location_gps_raw_add_sentence: (skip)
  */
 gboolean
-mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
-                               const gchar *trace)
+mm_location_gps_raw_add_sentence (MMLocationGpsRaw     *self,
+                                  const MMNmeaSentence *sentence)
 {
-    GMatchInfo *match_info = NULL;
-
     /* Current implementation works only with $GPGGA and $GNGGA traces */
-    do {
-        if (g_str_has_prefix (trace, "$GPGGA")) {
-            if (self->priv->prefer_gngga)
-                /* Ignore GPGGA, prefer GNGGA */
-                return FALSE;
-            break;
-        }
-        if (g_str_has_prefix (trace, "$GNGGA")) {
-            if (!self->priv->prefer_gngga)
-                self->priv->prefer_gngga = TRUE;
-            break;
-        }
+    if (!mm_nmea_sentence_is (sentence, NULL, "GGA"))
+        return FALSE;
+    if (mm_nmea_sentence_is (sentence, "GP", NULL)) {
+        if (self->priv->prefer_gngga)
+            /* Ignore GPGGA, prefer GNGGA */
+            return FALSE;
+    } else if (mm_nmea_sentence_is (sentence, "GN", NULL)) {
+        if (!self->priv->prefer_gngga)
+            self->priv->prefer_gngga = TRUE;
+    } else
         /* Otherwise, ignore trace */
         return FALSE;
-    } while (0);
 
     /*
      * $GPGGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,x.x,xxxx*hh
@@ -228,51 +213,50 @@ mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
      * 14   = Diff. reference station ID#
      * 15   = Checksum
      */
-    if (G_UNLIKELY (!self->priv->gga_regex))
-        self->priv->gga_regex = g_regex_new ("\\$G(?:P|N)GGA,(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*)\\*(.*).*",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                                             0,
-                                             NULL);
-
-    if (g_regex_match (self->priv->gga_regex, trace, 0, &match_info)) {
+    if (sentence->n_fields == 15 && sentence->has_checksum) {
         /* UTC time */
         g_free (self->priv->utc_time);
-        self->priv->utc_time = g_match_info_fetch (match_info, 1);
+        self->priv->utc_time = mm_nmea_field_dup (&sentence->fields[1]);
 
         /* Latitude */
         self->priv->latitude = MM_LOCATION_LATITUDE_UNKNOWN;
-        if (get_longitude_or_latitude_from_match_info (match_info, 2, &self->priv->latitude)) {
-            gchar *str;
-
+        if (get_longitude_or_latitude_from_field (&sentence->fields[2], &self->priv->latitude)) {
             /* N/S */
-            str = g_match_info_fetch (match_info, 3);
-            if (str && str[0] == 'S')
+            if (sentence->fields[3].len && sentence->fields[3].str[0] == 'S')
                 self->priv->latitude *= -1;
-            g_free (str);
         }
 
         /* Longitude */
         self->priv->longitude = MM_LOCATION_LONGITUDE_UNKNOWN;
-        if (get_longitude_or_latitude_from_match_info (match_info, 4, &self->priv->longitude)) {
-            gchar *str;
-
-            /* N/S */
-            str = g_match_info_fetch (match_info, 5);
-            if (str && str[0] == 'W')
+        if (get_longitude_or_latitude_from_field (&sentence->fields[4], &self->priv->longitude)) {
+            /* E/W */
+            if (sentence->fields[5].len && sentence->fields[5].str[0] == 'W')
                 self->priv->longitude *= -1;
-            g_free (str);
         }
 
         /* Altitude */
         self->priv->altitude = MM_LOCATION_ALTITUDE_UNKNOWN;
-        mm_get_double_from_match_info (match_info, 9, &self->priv->altitude);
+        mm_nmea_field_get_double (&sentence->fields[9], &self->priv->altitude);
     }
 
-    g_match_info_free (match_info);
-
     return TRUE;
 }
 
+/**
+ * mm_location_gps_raw_add_trace: (skip)
+ */
+gboolean
+mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
+                               const gchar *trace)
+{
+    MMNmeaSentence sentence;
+
+    if (!mm_nmea_sentence_parse (trace, -1, &sentence))
+        return FALSE;
+
+    return mm_location_gps_raw_add_sentence (self, &sentence);
+}
+
 /*****************************************************************************/
 
 /**
@@ -412,9 +396,6 @@ finalize (GObject *object)
 {
     MMLocationGpsRaw *self = MM_LOCATION_GPS_RAW (object);
 
-    if (self->priv->gga_regex)
-        g_regex_unref (self->priv->gga_regex);
-
     g_free (self->priv->utc_time);
 
     G_OBJECT_CLASS (mm_location_gps_raw_parent_class)->finalize (object);
@@ -81,8 +81,10 @@ MMLocationGpsRaw *mm_location_gps_raw_new (void);
 MMLocationGpsRaw *mm_location_gps_raw_new_from_dictionary (GVariant *string,
                                                            GError **error);
 
-gboolean mm_location_gps_raw_add_trace (MMLocationGpsRaw *self,
-                                        const gchar *trace);
+gboolean mm_location_gps_raw_add_trace    (MMLocationGpsRaw     *self,
+                                           const gchar          *trace);
+gboolean mm_location_gps_raw_add_sentence (MMLocationGpsRaw     *self,
+                                           const MMNmeaSentence *sentence);
 
 GVariant *mm_location_gps_raw_get_dictionary (MMLocationGpsRaw *self);
 
@@ -616,6 +616,117 @@ date_time_iso8601 (void)
     g_free (date);
 }
 
+/********************* NMEA TOKENIZER TESTS *********************/
+
+static void
+nmea_sentence_parse (void)
+{
+    MMNmeaSentence  sentence;
+    const gchar    *trace = "$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*18\r\n";
+
+    g_assert (mm_nmea_sentence_parse (trace, -1, &sentence));
+    g_assert (sentence.str == trace);
+    g_assert_cmpuint (sentence.len, ==, strlen (trace));
+    g_assert (sentence.has_checksum);
+    g_assert (sentence.checksum_ok);
+    g_assert (mm_nmea_sentence_is (&sentence, "GP", "GGA"));
+    g_assert (mm_nmea_sentence_is (&sentence, NULL, "GGA"));
+    g_assert (!mm_nmea_sentence_is (&sentence, "GN", NULL));
+    g_assert_cmpuint (sentence.n_fields, ==, 15);
+    g_assert (mm_nmea_field_equal (&sentence.fields[0], "GPGGA"));
+    g_assert (mm_nmea_field_equal (&sentence.fields[3], "N"));
+    g_assert_cmpuint (sentence.fields[11].len, ==, 0);
+    g_assert (mm_nmea_field_equal (&sentence.fields[14], "0000"));
+}
+
+static void
+nmea_sentence_parse_checksum (void)
+{
+    MMNmeaSentence sentence;
+
+    /* Wrong checksum */
+    g_assert (mm_nmea_sentence_parse ("$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*19\r\n", -1, &sentence));
+    g_assert (sentence.has_checksum);
+    g_assert (!sentence.checksum_ok);
+
+    /* Malformed checksum */
+    g_assert (mm_nmea_sentence_parse ("$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*1", -1, &sentence));
+    g_assert (sentence.has_checksum);
+    g_assert (!sentence.checksum_ok);
+
+    /* No checksum, it's optional in some sentences */
+    g_assert (mm_nmea_sentence_parse ("$GPGGA,161229.487,3723.2475,N", -1, &sentence));
+    g_assert (!sentence.has_checksum);
+    g_assert_cmpuint (sentence.n_fields, ==, 4);
+}
+
+static void
+nmea_sentence_parse_proprietary (void)
+{
+    MMNmeaSentence sentence;
+
+    g_assert (mm_nmea_sentence_parse ("$PQXFI,1,2*55\r\n", -1, &sentence));
+    g_assert (mm_nmea_sentence_is (&sentence, "P", "QXFI"));
+    g_assert_cmpuint (sentence.n_fields, ==, 3);
+}
+
+static void
+nmea_sentence_parse_invalid (void)
+{
+    MMNmeaSentence sentence;
+
+    g_assert (!mm_nmea_sentence_parse ("", -1, &sentence));
+    g_assert (!mm_nmea_sentence_parse ("\r\n", -1, &sentence));
+    g_assert (!mm_nmea_sentence_parse ("GPGGA,1,2,3*00", -1, &sentence));
+    g_assert (!mm_nmea_sentence_parse ("$G,1,2*00", -1, &sentence));
+}
+
+static void
+nmea_location_gps_raw (void)
+{
+    g_autoptr(MMLocationGpsRaw) raw = NULL;
+
+    raw = mm_location_gps_raw_new ();
+    g_assert (!mm_location_gps_raw_add_trace (raw, "$GPRMC,161229.487,A,3723.2475,N,12158.3416,W,0.13,309.62,120598,,*10\r\n"));
+    g_assert (mm_location_gps_raw_add_trace (raw, "$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*18\r\n"));
+    g_assert_cmpstr (mm_location_gps_raw_get_utc_time (raw), ==, "161229.487");
+    g_assert_cmpfloat_with_epsilon (mm_location_gps_raw_get_latitude (raw), 37.387458, 0.000001);
+    g_assert_cmpfloat_with_epsilon (mm_location_gps_raw_get_longitude (raw), -121.972360, 0.000001);
+    g_assert_cmpfloat_with_epsilon (mm_location_gps_raw_get_altitude (raw), 9.0, 0.000001);
+
+    /* Once GNGGA is received, GPGGA is ignored */
+    g_assert (mm_location_gps_raw_add_trace (raw, "$GNGGA,161230.000,3723.2475,S,12158.3416,E,1,07,1.0,9.0,M,,,,0000*0A\r\n"));
+    g_assert_cmpstr (mm_location_gps_raw_get_utc_time (raw), ==, "161230.000");
+    g_assert_cmpfloat (mm_location_gps_raw_get_latitude (raw), <, 0);
+    g_assert_cmpfloat (mm_location_gps_raw_get_longitude (raw), >, 0);
+    g_assert (!mm_location_gps_raw_add_trace (raw, "$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*18\r\n"));
+    g_assert_cmpstr (mm_location_gps_raw_get_utc_time (raw), ==, "161230.000");
+}
+
+static void
+nmea_location_gps_nmea (void)
+{
+    g_autoptr(MMLocationGpsNmea) nmea = NULL;
+
+    nmea = mm_location_gps_nmea_new ();
+    g_assert (mm_location_gps_nmea_add_trace (nmea, "$GPGSV,2,1,07,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*71\r\n"));
+    g_assert (mm_location_gps_nmea_add_trace (nmea, "$GPGSV,2,2,07,09,23,313,42,04,19,159,41,15,12,041,42*41\r\n"));
+    /* Repeated elements of a sequence are skipped */
+    g_assert (mm_location_gps_nmea_add_trace (nmea, "$GPGSV,2,2,07,09,23,313,42,04,19,159,41,15,12,041,42*41\r\n"));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==,
+                     "$GPGSV,2,1,07,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*71\r\n"
+                     "$GPGSV,2,2,07,09,23,313,42,04,19,159,41,15,12,041,42*41\r\n");
+
+    /* A new sequence replaces the previous one */
+    g_assert (mm_location_gps_nmea_add_trace (nmea, "$GPGSV,1,1,01,07,79,048,42*4B\r\n"));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGSV"), ==, "$GPGSV,1,1,01,07,79,048,42*4B\r\n");
+
+    g_assert (mm_location_gps_nmea_add_trace (nmea, "$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*18\r\n"));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (nmea, "$GPGGA"), ==,
+                     "$GPGGA,161229.487,3723.2475,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000*18\r\n");
+    g_assert (!mm_location_gps_nmea_add_trace (nmea, "garbage"));
+}
+
 /**************************************************************/
 
 int main (int argc, char **argv)
@@ -663,5 +774,13 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/Common/HexStr/wrong-digits-some", hexstr_wrong_digits_some);
 
     g_test_add_func ("/MM/Common/DateTime/iso8601", date_time_iso8601);
+
+    g_test_add_func ("/MM/Common/Nmea/parse",             nmea_sentence_parse);
+    g_test_add_func ("/MM/Common/Nmea/parse-checksum",    nmea_sentence_parse_checksum);
+    g_test_add_func ("/MM/Common/Nmea/parse-proprietary", nmea_sentence_parse_proprietary);
+    g_test_add_func ("/MM/Common/Nmea/parse-invalid",     nmea_sentence_parse_invalid);
+    g_test_add_func ("/MM/Common/Nmea/location-gps-raw",  nmea_location_gps_raw);
+    g_test_add_func ("/MM/Common/Nmea/location-gps-nmea", nmea_location_gps_nmea);
+
     return g_test_run ();
 }
@@ -59,4 +59,18 @@ qcdmbool dm_decapsulate_buffer (const char *inbuf,
                                 size_t *out_used,
                                 qcdmbool *out_need_more);
 
+/* Byte by byte implementations, used to validate the optimized ones */
+uint16_t dm_crc16_reference (const char *buffer, size_t len);
+
+size_t dm_escape_reference (const char *inbuf,
+                            size_t inbuf_len,
+                            char *outbuf,
+                            size_t outbuf_len);
+
+size_t dm_unescape_reference (const char *inbuf,
+                              size_t inbuf_len,
+                              char *outbuf,
+                              size_t outbuf_len,
+                              qcdmbool *escaping);
+
 #endif  /* LIBQCDM_UTILS_H */
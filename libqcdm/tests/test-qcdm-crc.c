@@ -63,3 +63,55 @@ test_crc16_1 (void *f, void *data)
     g_assert (crc == expected);
 }
 
+
+void
+test_crc16_fuzz (void *f, void *data)
+{
+    char buf[300];
+    guint n;
+
+    /* The sliced CRC must match the byte by byte one for every length and
+     * alignment */
+    for (n = 0; n < 2000; n++) {
+        gsize offset, len, i;
+
+        offset = g_test_rand_int_range (0, 8);
+        len = g_test_rand_int_range (0, sizeof (buf) - offset);
+        for (i = 0; i < len; i++)
+            buf[offset + i] = g_test_rand_int_range (0, 256);
+
+        g_assert_cmpuint (dm_crc16 (buf + offset, len), ==, dm_crc16_reference (buf + offset, len));
+    }
+}
+
+#define PERF_FRAME_SIZE   2048
+#define PERF_ITERATIONS   5000
+
+void
+test_crc16_perf (void *f, void *data)
+{
+    char buf[PERF_FRAME_SIZE];
+    GTimer *timer;
+    gdouble elapsed, ref_elapsed;
+    guint16 crc = 0, ref_crc = 0;
+    guint i;
+
+    for (i = 0; i < sizeof (buf); i++)
+        buf[i] = g_test_rand_int_range (0, 256);
+
+    timer = g_timer_new ();
+    for (i = 0; i < PERF_ITERATIONS; i++)
+        crc ^= dm_crc16 (buf, sizeof (buf));
+    elapsed = g_timer_elapsed (timer, NULL);
+
+    g_timer_start (timer);
+    for (i = 0; i < PERF_ITERATIONS; i++)
+        ref_crc ^= dm_crc16_reference (buf, sizeof (buf));
+    ref_elapsed = g_timer_elapsed (timer, NULL);
+    g_timer_destroy (timer);
+
+    g_assert_cmpuint (crc, ==, ref_crc);
+    g_test_minimized_result (0, "crc16: %.1f MiB/s (reference: %.1f MiB/s)",
+                             ((gdouble) PERF_FRAME_SIZE * PERF_ITERATIONS) / (1024 * 1024) / elapsed,
+                             ((gdouble) PERF_FRAME_SIZE * PERF_ITERATIONS) / (1024 * 1024) / ref_elapsed);
+}
@@ -122,3 +122,117 @@ test_escape_unescape (void *f, void *data)
     g_assert (memcmp (unescaped, data1, unlen) == 0);
 }
 
+
+static void
+fill_random_frame (char *buf, gsize len, guint escapable_pct)
+{
+    gsize i;
+
+    for (i = 0; i < len; i++) {
+        if (g_test_rand_int_range (0, 100) < (gint) escapable_pct)
+            buf[i] = g_test_rand_bit () ? 0x7e : 0x7d;
+        else
+            buf[i] = g_test_rand_int_range (0, 256);
+    }
+}
+
+void
+test_escape_fuzz (void *f, void *data)
+{
+    static const guint pcts[] = { 0, 1, 10, 50, 100 };
+    char in[600];
+    char out[1300], ref_out[1300];
+    char unesc[1300], ref_unesc[1300];
+    guint n;
+
+    /* The optimized escaping routines must behave exactly like the byte by
+     * byte ones, for any length (SIMD block boundaries included), density of
+     * escapable bytes and output buffer size.
+     */
+    for (n = 0; n < 2000; n++) {
+        gsize len, out_len, esc_len, ref_esc_len, unesc_len, ref_unesc_len;
+        qcdmbool escaping = FALSE, ref_escaping = FALSE;
+
+        len = g_test_rand_int_range (1, sizeof (in));
+        fill_random_frame (in, len, pcts[n % G_N_ELEMENTS (pcts)]);
+
+        /* Mostly exercise buffers that may be too small */
+        out_len = g_test_rand_int_range (len + 1, (len * 2) + 2);
+
+        esc_len = dm_escape (in, len, out, out_len);
+        ref_esc_len = dm_escape_reference (in, len, ref_out, out_len);
+        g_assert_cmpuint (esc_len, ==, ref_esc_len);
+        if (!esc_len)
+            continue;
+        g_assert (memcmp (out, ref_out, esc_len) == 0);
+
+        unesc_len = dm_unescape (out, esc_len, unesc, sizeof (unesc), &escaping);
+        ref_unesc_len = dm_unescape_reference (out, esc_len, ref_unesc, sizeof (ref_unesc), &ref_escaping);
+        g_assert_cmpuint (unesc_len, ==, ref_unesc_len);
+        g_assert_cmpuint (unesc_len, ==, len);
+        g_assert (memcmp (unesc, ref_unesc, unesc_len) == 0);
+        g_assert (memcmp (unesc, in, len) == 0);
+        g_assert (escaping == ref_escaping);
+
+        /* Unescaping raw random data may end in the middle of an escape
+         * sequence, or overrun a tight output buffer */
+        escaping = ref_escaping = FALSE;
+        out_len = g_test_rand_int_range (len, len + 2);
+        unesc_len = dm_unescape (in, len, unesc, out_len, &escaping);
+        ref_unesc_len = dm_unescape_reference (in, len, ref_unesc, out_len, &ref_escaping);
+        g_assert_cmpuint (unesc_len, ==, ref_unesc_len);
+        if (!unesc_len)
+            continue;
+        g_assert (memcmp (unesc, ref_unesc, unesc_len) == 0);
+        g_assert (escaping == ref_escaping);
+    }
+}
+
+#define PERF_FRAME_SIZE   2048
+#define PERF_ITERATIONS   5000
+
+static gdouble
+escape_throughput (gboolean reference, guint escapable_pct)
+{
+    char in[PERF_FRAME_SIZE];
+    char out[(PERF_FRAME_SIZE * 2) + 1];
+    char unesc[(PERF_FRAME_SIZE * 2) + 1];
+    GTimer *timer;
+    gdouble elapsed;
+    guint i;
+
+    fill_random_frame (in, sizeof (in), escapable_pct);
+
+    timer = g_timer_new ();
+    for (i = 0; i < PERF_ITERATIONS; i++) {
+        qcdmbool escaping = FALSE;
+        gsize len;
+
+        if (reference) {
+            len = dm_escape_reference (in, sizeof (in), out, sizeof (out));
+            len = dm_unescape_reference (out, len, unesc, sizeof (unesc), &escaping);
+        } else {
+            len = dm_escape (in, sizeof (in), out, sizeof (out));
+            len = dm_unescape (out, len, unesc, sizeof (unesc), &escaping);
+        }
+        g_assert_cmpuint (len, ==, sizeof (in));
+    }
+    elapsed = g_timer_elapsed (timer, NULL);
+    g_timer_destroy (timer);
+
+    /* MiB/s of frame data escaped and unescaped */
+    return ((gdouble) PERF_FRAME_SIZE * PERF_ITERATIONS) / (1024 * 1024) / elapsed;
+}
+
+void
+test_escape_perf (void *f, void *data)
+{
+    static const guint pcts[] = { 0, 1, 10 };
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (pcts); i++)
+        g_test_minimized_result (0, "%u%% escapable bytes: %.1f MiB/s (reference: %.1f MiB/s)",
+                                 pcts[i],
+                                 escape_throughput (FALSE, pcts[i]),
+                                 escape_throughput (TRUE, pcts[i]));
+}
@@ -80,9 +80,11 @@ int main (int argc, char **argv)
 
     g_test_suite_add (suite, TESTCASE (test_crc16_1, NULL));
     g_test_suite_add (suite, TESTCASE (test_crc16_2, NULL));
+    g_test_suite_add (suite, TESTCASE (test_crc16_fuzz, NULL));
     g_test_suite_add (suite, TESTCASE (test_escape1, NULL));
     g_test_suite_add (suite, TESTCASE (test_escape2, NULL));
     g_test_suite_add (suite, TESTCASE (test_escape_unescape, NULL));
+    g_test_suite_add (suite, TESTCASE (test_escape_fuzz, NULL));
     g_test_suite_add (suite, TESTCASE (test_utils_decapsulate_buffer, NULL));
     g_test_suite_add (suite, TESTCASE (test_utils_encapsulate_buffer, NULL));
     g_test_suite_add (suite, TESTCASE (test_utils_decapsulate_sierra_cns, NULL));
@@ -91,6 +93,12 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_result_uint8, NULL));
     g_test_suite_add (suite, TESTCASE (test_result_uint8_array, NULL));
 
+    /* Benchmarks */
+    if (g_test_perf ()) {
+        g_test_suite_add (suite, TESTCASE (test_crc16_perf, NULL));
+        g_test_suite_add (suite, TESTCASE (test_escape_perf, NULL));
+    }
+
     /* Live tests */
     if (port) {
         g_test_suite_add (suite, TESTCASE (test_com_port_init, data->com_data));
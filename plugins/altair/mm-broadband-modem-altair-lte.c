@@ -509,6 +509,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                     gboolean             is_ps_supported,
                                     gboolean             is_eps_supported,
                                     gboolean             is_5gs_supported,
+                                    gboolean             is_polling,
                                     GAsyncReadyCallback  callback,
                                     gpointer             user_data)
 {
@@ -522,6 +523,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                                       is_ps_supported,
                                                       is_eps_supported,
                                                       is_5gs_supported,
+                                                      is_polling,
                                                       (GAsyncReadyCallback) run_registration_checks_ready,
                                                       task);
 }
@@ -29,6 +29,7 @@
 #include "mm-errors-types.h"
 #include "mm-modem-helpers-cinterion.h"
 #include "mm-modem-helpers.h"
+#include "mm-regex-cache.h"
 #include "mm-common-helpers.h"
 #include "mm-port-serial-at.h"
 
@@ -272,11 +273,11 @@ mm_cinterion_parse_scfg_test (const gchar                 *response,
         return FALSE;
     }
 
-    r1 = g_regex_new ("\\^SCFG:\\s*\"Radio/Band\",\\((?:\")?([0-9]*)(?:\")?-(?:\")?([0-9]*)(?:\")?.*\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r1 = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band\",\\((?:\")?([0-9]*)(?:\")?-(?:\")?([0-9]*)(?:\")?.*\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r1 != NULL);
 
-    g_regex_match_full (r1, response, strlen (response), 0, 0, &match_info1, &inner_error);
+    mm_regex_match_full (r1, response, strlen (response), 0, 0, &match_info1, &inner_error);
     if (inner_error)
         goto finish;
     if (g_match_info_matches (match_info1)) {
@@ -307,13 +308,13 @@ mm_cinterion_parse_scfg_test (const gchar                 *response,
         goto finish;
     }
 
-    r2 = g_regex_new ("\\^SCFG:\\s*\"Radio/Band/([234]G)\","
-                      "\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\)"
-                      "(,*\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\))?",
-                     0, 0, NULL);
+    r2 = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band/([234]G)\","
+                             "\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\)"
+                             "(,*\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\))?",
+                            0, 0, NULL);
     g_assert (r2 != NULL);
 
-    g_regex_match_full (r2, response, strlen (response), 0, 0, &match_info2, &inner_error);
+    mm_regex_match_full (r2, response, strlen (response), 0, 0, &match_info2, &inner_error);
     if (inner_error)
         goto finish;
 
@@ -356,7 +357,7 @@ mm_cinterion_parse_scfg_test (const gchar                 *response,
             break;
         }
 
-        g_match_info_next (match_info2, NULL);
+        mm_match_info_next (match_info2, NULL);
     }
 
 finish:
@@ -436,10 +437,10 @@ mm_cinterion_parse_scfg_response (const gchar                  *response,
     }
 
     if (format == MM_CINTERION_RADIO_BAND_FORMAT_SINGLE) {
-        r = g_regex_new ("\\^SCFG:\\s*\"Radio/Band\",\\s*\"?([0-9a-fA-F]*)\"?", 0, 0, NULL);
+        r = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band\",\\s*\"?([0-9a-fA-F]*)\"?", 0, 0, NULL);
         g_assert (r != NULL);
 
-        g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+        mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
         if (inner_error)
             goto finish;
 
@@ -468,11 +469,11 @@ mm_cinterion_parse_scfg_response (const gchar                  *response,
             }
         }
     } else if (format == MM_CINTERION_RADIO_BAND_FORMAT_MULTIPLE) {
-        r = g_regex_new ("\\^SCFG:\\s*\"Radio/Band/([234]G)\",\"?([0-9A-Fa-fx]*)\"?,?\"?([0-9A-Fa-fx]*)?\"?",
-                         0, 0, NULL);
+        r = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band/([234]G)\",\"?([0-9A-Fa-fx]*)\"?,?\"?([0-9A-Fa-fx]*)?\"?",
+                                0, 0, NULL);
         g_assert (r != NULL);
 
-        g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+        mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
         if (inner_error)
             goto finish;
 
@@ -514,7 +515,7 @@ mm_cinterion_parse_scfg_response (const gchar                  *response,
                 break;
             }
 
-            g_match_info_next (match_info, NULL);
+            mm_match_info_next (match_info, NULL);
         }
     } else
         g_assert_not_reached ();
@@ -568,12 +569,12 @@ mm_cinterion_parse_cnmi_test (const gchar *response,
         return FALSE;
     }
 
-    r = g_regex_new ("\\+CNMI:\\s*\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, NULL);
+    r = mm_regex_cache_get ("\\+CNMI:\\s*\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         if (supported_mode) {
             gchar *str;
@@ -772,10 +773,10 @@ mm_cinterion_parse_sind_response (const gchar *response,
         return FALSE;
     }
 
-    r = g_regex_new ("\\^SIND:\\s*(.*),(\\d+),(\\d+)(\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SIND:\\s*(.*),(\\d+),(\\d+)(\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (g_regex_match (r, response, 0, &match_info)) {
+    if (mm_regex_match (r, response, 0, &match_info)) {
         if (description) {
             *description = mm_get_string_unquoted_from_match_info (match_info, 1);
             if (*description == NULL)
@@ -854,12 +855,12 @@ mm_cinterion_parse_swwan_response (const gchar  *response,
         return MM_BEARER_CONNECTION_STATUS_UNKNOWN;
     }
 
-    r = g_regex_new ("\\^SWWAN:\\s*(\\d+),\\s*(\\d+)(?:,\\s*(\\d+))?(?:\\r\\n)?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\^SWWAN:\\s*(\\d+),\\s*(\\d+)(?:,\\s*(\\d+))?(?:\\r\\n)?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     status = MM_BEARER_CONNECTION_STATUS_UNKNOWN;
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
         guint read_state;
         guint read_cid;
@@ -880,7 +881,7 @@ mm_cinterion_parse_swwan_response (const gchar  *response,
             mm_obj_warn (log_object, "invalid state read in ^SWWAN response: %u", read_state);
             break;
         }
-        g_match_info_next (match_info, &inner_error);
+        mm_match_info_next (match_info, &inner_error);
     }
 
     g_match_info_free (match_info);
@@ -914,10 +915,10 @@ mm_cinterion_parse_sgauth_response (const gchar          *response,
     g_autoptr(GRegex)     r = NULL;
     g_autoptr(GMatchInfo) match_info = NULL;
 
-    r = g_regex_new ("\\^SGAUTH:\\s*(\\d+),(\\d+),?\"?([a-zA-Z0-9_-]+)?\"?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SGAUTH:\\s*(\\d+),(\\d+),?\"?([a-zA-Z0-9_-]+)?\"?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, NULL);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, NULL);
     while (g_match_info_matches (match_info)) {
         guint sgauth_cid = 0;
 
@@ -930,7 +931,7 @@ mm_cinterion_parse_sgauth_response (const gchar          *response,
             *out_username = mm_get_string_unquoted_from_match_info (match_info, 3);
             return TRUE;
         }
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
     g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND,
@@ -991,14 +992,14 @@ mm_cinterion_parse_smong_response (const gchar              *response,
      * 0776  1  -      -   214   03  2    00      01
      * OK
      */
-    regex = g_regex_new (".*GPRS Monitor(?:\r\n)*"
-                         "BCCH\\s*G.*\\r\\n"
-                         "\\s*(\\d+)\\s*(\\d+)\\s*",
-                         G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                         0, NULL);
+    regex = mm_regex_cache_get (".*GPRS Monitor(?:\r\n)*"
+                                "BCCH\\s*G.*\\r\\n"
+                                "\\s*(\\d+)\\s*(\\d+)\\s*",
+                                G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                                0, NULL);
     g_assert (regex);
 
-    g_regex_match_full (regex, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (regex, response, strlen (response), 0, 0, &match_info, &inner_error);
 
     if (inner_error) {
         g_prefix_error (&inner_error, "Failed to match AT^SMONG response: ");
@@ -1059,8 +1060,8 @@ mm_cinterion_get_slcc_regex (void)
      * with an empty line preceded by prefix "^SLCC: ", in order to indicate the end
      * of the list.
      */
-    return g_regex_new ("\\r\\n(\\^SLCC: .*\\r\\n)*\\^SLCC: \\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    return mm_regex_cache_get ("\\r\\n(\\^SLCC: .*\\r\\n)*\\^SLCC: \\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 static void
@@ -1107,16 +1108,16 @@ mm_cinterion_parse_slcc_list (const gchar *str,
      *  ^SLCC :
      */
 
-    r = g_regex_new ("\\^SLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
-                     "(?:,\\s*([^,]*),\\s*(\\d+)"                                                /* number and type */
-                     "(?:,\\s*([^,]*)"                                                           /* alpha */
-                     ")?)?$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\^SLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
+                            "(?:,\\s*([^,]*),\\s*(\\d+)"                                                /* number and type */
+                            "(?:,\\s*([^,]*)"                                                           /* alpha */
+                            ")?)?$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -1154,7 +1155,7 @@ mm_cinterion_parse_slcc_list (const gchar *str,
 
     next:
         cinterion_call_info_free (call_info);
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
 out:
@@ -1191,8 +1192,8 @@ mm_cinterion_get_ctzu_regex (void)
      *  +CTZU: "19/07/09,10:19:15",+08,1
      */
 
-    return g_regex_new ("\\r\\n\\+CTZU:\\s*\"(\\d+)\\/(\\d+)\\/(\\d+),(\\d+):(\\d+):(\\d+)\",([\\-\\+\\d]+)(?:,(\\d+))?(?:\\r\\n)?",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CTZU:\\s*\"(\\d+)\\/(\\d+)\\/(\\d+),(\\d+):(\\d+):(\\d+)\",([\\-\\+\\d]+)(?:,(\\d+))?(?:\\r\\n)?",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 gboolean
@@ -1338,9 +1339,9 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
         success = TRUE;
         goto out;
     }
-    pre = g_regex_new ("\\^SMONI:\\s*([234])", 0, 0, NULL);
+    pre = mm_regex_cache_get ("\\^SMONI:\\s*([234])", 0, 0, NULL);
     g_assert (pre != NULL);
-    g_regex_match_full (pre, response, strlen (response), 0, 0, &match_info_pre, &inner_error);
+    mm_regex_match_full (pre, response, strlen (response), 0, 0, &match_info_pre, &inner_error);
     if (!inner_error && g_match_info_matches (match_info_pre)) {
         if (!mm_get_uint_from_match_info (match_info_pre, 1, &tech)) {
             inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Couldn't read tech");
@@ -1349,9 +1350,9 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
         #define FLOAT "([-+]?[0-9]+\\.?[0-9]*)"
         switch (tech) {
         case MM_CINTERION_RADIO_GEN_2G:
-            r = g_regex_new ("\\^SMONI:\\s*2G,(\\d+),"FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*2G,(\\d+),"FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
-            g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+            mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
                 /* skip ARFCN */
                 if (!mm_get_double_from_match_info (match_info, 2, &rssi)) {
@@ -1361,9 +1362,9 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
             }
             break;
         case MM_CINTERION_RADIO_GEN_3G:
-            r = g_regex_new ("\\^SMONI:\\s*3G,(\\d+),(\\d+),"FLOAT","FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*3G,(\\d+),(\\d+),"FLOAT","FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
-            g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+            mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
                 /* skip UARFCN */
                 /* skip PSC (Primary scrambling code) */
@@ -1378,9 +1379,9 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
             }
             break;
         case MM_CINTERION_RADIO_GEN_4G:
-            r = g_regex_new ("\\^SMONI:\\s*4G,(\\d+),(\\d+),(\\d+),(\\d+),(\\w+),(\\d+),(\\d+),(\\w+),(\\w+),(\\d+),([^,]*),"FLOAT","FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*4G,(\\d+),(\\d+),(\\d+),(\\d+),(\\w+),(\\d+),(\\d+),(\\w+),(\\w+),(\\d+),([^,]*),"FLOAT","FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
-            g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+            mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
                 /* skip EARFCN */
                 /* skip Band */
@@ -1517,10 +1518,10 @@ mm_cinterion_provcfg_response_to_cid (const gchar             *response,
     g_autofree gchar      *mno = NULL;
     GError                *inner_error = NULL;
 
-    r = g_regex_new ("\\^SCFG:\\s*\"MEopMode/Prov/Cfg\",\\s*\"([0-9a-zA-Z*]*)\"", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SCFG:\\s*\"MEopMode/Prov/Cfg\",\\s*\"([0-9a-zA-Z*]*)\"", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
 
     if (inner_error) {
         g_prefix_error (&inner_error, "Failed to match Prov/Cfg response: ");
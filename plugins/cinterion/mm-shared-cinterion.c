@@ -194,10 +194,10 @@ mm_shared_cinterion_modem_reset (MMIfaceModem        *self,
 
 static void
 trace_received (MMPortSerialGps      *port,
-                const gchar          *trace,
+                const MMNmeaSentence *sentence,
                 MMIfaceModemLocation *self)
 {
-    mm_iface_modem_location_gps_update (self, trace);
+    mm_iface_modem_location_gps_update_sentence (self, sentence);
 }
 
 /*****************************************************************************/
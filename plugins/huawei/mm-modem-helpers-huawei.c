@@ -25,6 +25,7 @@
 #include "mm-log-object.h"
 #include "mm-common-helpers.h"
 #include "mm-modem-helpers.h"
+#include "mm-regex-cache.h"
 #include "mm-modem-helpers-huawei.h"
 #include "mm-huawei-enums-types.h"
 
@@ -71,13 +72,13 @@ mm_huawei_parse_ndisstatqry_response (const gchar *response,
 
     /* If multiple fields available, try first parsing method */
     if (strchr (response, ',')) {
-        r = g_regex_new ("\\^NDISSTAT(?:QRY)?(?:Qry)?:\\s*(\\d),([^,]*),([^,]*),([^,\\r\\n]*)(?:\\r\\n)?"
-                         "(?:\\^NDISSTAT:|\\^NDISSTATQRY:)?\\s*,?(\\d)?,?([^,]*)?,?([^,]*)?,?([^,\\r\\n]*)?(?:\\r\\n)?",
-                         G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                         0, NULL);
+        r = mm_regex_cache_get ("\\^NDISSTAT(?:QRY)?(?:Qry)?:\\s*(\\d),([^,]*),([^,]*),([^,\\r\\n]*)(?:\\r\\n)?"
+                                "(?:\\^NDISSTAT:|\\^NDISSTATQRY:)?\\s*,?(\\d)?,?([^,]*)?,?([^,]*)?,?([^,\\r\\n]*)?(?:\\r\\n)?",
+                                G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                                0, NULL);
         g_assert (r != NULL);
 
-        g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+        mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
         if (!inner_error && g_match_info_matches (match_info)) {
             guint ip_type_field = 4;
 
@@ -114,12 +115,12 @@ mm_huawei_parse_ndisstatqry_response (const gchar *response,
     }
     /* No separate IPv4/IPv6 info given just connected/not connected */
     else {
-        r = g_regex_new ("\\^NDISSTAT(?:QRY)?(?:Qry)?:\\s*(\\d)(?:\\r\\n)?",
-                         G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                         0, NULL);
+        r = mm_regex_cache_get ("\\^NDISSTAT(?:QRY)?(?:Qry)?:\\s*(\\d)(?:\\r\\n)?",
+                                G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                                0, NULL);
         g_assert (r != NULL);
 
-        g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+        mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
         if (!inner_error && g_match_info_matches (match_info)) {
             guint connected;
 
@@ -230,10 +231,10 @@ mm_huawei_parse_dhcp_response (const char *reply,
      * actually 10.10.1.1.
      */
 
-    r = g_regex_new ("\\^DHCP:\\s*(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),.*$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^DHCP:\\s*(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),(?:0[xX])?([0-9a-fA-F]+),.*$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    matched = g_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
+    matched = mm_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
     if (!matched) {
         if (match_error) {
             g_propagate_error (error, match_error);
@@ -295,10 +296,10 @@ mm_huawei_parse_sysinfo_response (const char *reply,
      */
 
     /* Can't just use \d here since sometimes you get "^SYSINFO:2,1,0,3,1,,3" */
-    r = g_regex_new ("\\^SYSINFO:\\s*(\\d+),(\\d+),(\\d+),(\\d+),(\\d+),?(\\d+)?,?(\\d+)?$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SYSINFO:\\s*(\\d+),(\\d+),(\\d+),(\\d+),(\\d+),?(\\d+)?,?(\\d+)?$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    matched = g_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
+    matched = mm_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
     if (!matched) {
         if (match_error) {
             g_propagate_error (error, match_error);
@@ -362,10 +363,10 @@ mm_huawei_parse_sysinfoex_response (const char *reply,
 
     /* ^SYSINFOEX:2,3,0,1,,3,"WCDMA",41,"HSPA+" */
 
-    r = g_regex_new ("\\^SYSINFOEX:\\s*(\\d+),(\\d+),(\\d+),(\\d+),?(\\d*),(\\d+),\"?([^\"]*)\"?,(\\d+),\"?([^\"]*)\"?$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SYSINFOEX:\\s*(\\d+),(\\d+),(\\d+),(\\d+),?(\\d*),(\\d+),\"?([^\"]*)\"?,(\\d+),\"?([^\"]*)\"?$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    matched = g_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
+    matched = mm_regex_match_full (r, reply, -1, 0, 0, &match_info, &match_error);
     if (!matched) {
         if (match_error) {
             g_propagate_error (error, match_error);
@@ -1203,10 +1204,10 @@ gboolean mm_huawei_parse_nwtime_response (const gchar *response,
 
     g_assert (iso8601p || tzp); /* at least one */
 
-    r = g_regex_new ("\\^NWTIME:\\s*(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d*)([\\-\\+\\d]+),(\\d+)$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^NWTIME:\\s*(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d*)([\\-\\+\\d]+),(\\d+)$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
+    if (!mm_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
         if (match_error) {
             g_propagate_error (error, match_error);
             g_prefix_error (error, "Could not parse ^NWTIME results: ");
@@ -1289,10 +1290,10 @@ gboolean mm_huawei_parse_time_response (const gchar *response,
     }
 
     /* Already in ISO-8601 format, but verify just to be sure */
-    r = g_regex_new ("\\^TIME:\\s*(\\d+)/(\\d+)/(\\d+)\\s*(\\d+):(\\d+):(\\d*)$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^TIME:\\s*(\\d+)/(\\d+)/(\\d+)\\s*(\\d+):(\\d+):(\\d*)$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
+    if (!mm_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
         if (match_error) {
             g_propagate_error (error, match_error);
             g_prefix_error (error, "Could not parse ^TIME results: ");
@@ -1353,10 +1354,10 @@ mm_huawei_parse_hcsq_response (const gchar *response,
     gboolean ret = FALSE;
     char *s;
 
-    r = g_regex_new ("\\^HCSQ:\\s*\"?([a-zA-Z]*)\"?,(\\d+),?(\\d+)?,?(\\d+)?,?(\\d+)?,?(\\d+)?$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^HCSQ:\\s*\"?([a-zA-Z]*)\"?,(\\d+),?(\\d+)?,?(\\d+)?,?(\\d+)?,?(\\d+)?$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
+    if (!mm_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
         if (match_error) {
             g_propagate_error (error, match_error);
             g_prefix_error (error, "Could not parse ^HCSQ results: ");
@@ -1420,10 +1421,10 @@ mm_huawei_parse_cvoice_response (const gchar  *response,
     gboolean ret = FALSE;
 
     /* ^CVOICE: <0=supported,1=unsupported>,<hz>,<bits>,<unknown> */
-    r = g_regex_new ("\\^CVOICE:\\s*(\\d)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^CVOICE:\\s*(\\d)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)$", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
+    if (!mm_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
         if (match_error) {
             g_propagate_error (error, match_error);
             g_prefix_error (error, "Could not parse ^CVOICE results: ");
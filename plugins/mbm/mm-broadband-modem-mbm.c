@@ -1360,10 +1360,10 @@ emrdy_received (MMPortSerialAt *port,
 
 static void
 gps_trace_received (MMPortSerialGps *port,
-                    const gchar *trace,
+                    const MMNmeaSentence *sentence,
                     MMIfaceModemLocation *self)
 {
-    mm_iface_modem_location_gps_update (self, trace);
+    mm_iface_modem_location_gps_update_sentence (self, sentence);
 }
 
 static void
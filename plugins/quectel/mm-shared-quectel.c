@@ -483,10 +483,10 @@ mm_shared_quectel_setup_sim_hot_swap (MMIfaceModem        *self,
 
 static void
 trace_received (MMPortSerialGps      *port,
-                const gchar          *trace,
+                const MMNmeaSentence *sentence,
                 MMIfaceModemLocation *self)
 {
-    mm_iface_modem_location_gps_update (self, trace);
+    mm_iface_modem_location_gps_update_sentence (self, sentence);
 }
 
 /*****************************************************************************/
@@ -111,10 +111,10 @@ get_private (MMSharedSimtech *self)
 
 static void
 trace_received (MMPortSerialGps      *port,
-                const gchar          *trace,
+                const MMNmeaSentence *sentence,
                 MMIfaceModemLocation *self)
 {
-    mm_iface_modem_location_gps_update (self, trace);
+    mm_iface_modem_location_gps_update_sentence (self, sentence);
 }
 
 /*****************************************************************************/
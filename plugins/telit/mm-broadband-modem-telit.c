@@ -292,10 +292,10 @@ enable_location_gathering (MMIfaceModemLocation *self,
 
 static void
 trace_received (MMPortSerialGps *port,
-                const gchar *trace,
+                const MMNmeaSentence *sentence,
                 MMIfaceModemLocation *self)
 {
-    mm_iface_modem_location_gps_update (self, trace);
+    mm_iface_modem_location_gps_update_sentence (self, sentence);
 }
 
 static gboolean
@@ -18,6 +18,7 @@
 
 #include "mm-log.h"
 #include "mm-modem-helpers.h"
+#include "mm-regex-cache.h"
 #include "mm-modem-helpers-ublox.h"
 
 /*****************************************************************************/
@@ -48,10 +49,10 @@ mm_ublox_parse_upincnt_response (const gchar  *response,
     /* Response may be e.g.:
      * +UPINCNT: 3,3,10,10
      */
-    r = g_regex_new ("\\+UPINCNT: (\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+UPINCNT: (\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         if (!mm_get_uint_from_match_info (match_info, 1, &pin_attempts)) {
             inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
@@ -122,10 +123,10 @@ mm_ublox_parse_uusbconf_response (const gchar        *response,
      * Note: we don't rely on the PID; assuming future new modules will
      * have a different PID but they may keep the profile names.
      */
-    r = g_regex_new ("\\+UUSBCONF: (\\d+),([^,]*),([^,]*),([^,]*)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+UUSBCONF: (\\d+),([^,]*),([^,]*),([^,]*)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         gchar *profile_name;
 
@@ -180,10 +181,10 @@ mm_ublox_parse_ubmconf_response (const gchar            *response,
      * +UBMCONF: 1
      * +UBMCONF: 2
      */
-    r = g_regex_new ("\\+UBMCONF: (\\d+)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+UBMCONF: (\\d+)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         guint mode_id = 0;
 
@@ -251,10 +252,10 @@ mm_ublox_parse_uipaddr_response (const gchar  *response,
      *
      * We assume only ONE line is returned; because we request +UIPADDR with a specific N CID.
      */
-    r = g_regex_new ("\\+UIPADDR: (\\d+),([^,]*),([^,]*),([^,]*),([^,]*),([^,]*)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+UIPADDR: (\\d+),([^,]*),([^,]*),([^,]*),([^,]*),([^,]*)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -1560,11 +1561,11 @@ mm_ublox_parse_uact_response (const gchar  *response,
      * AT+UACT?
      * +UACT: ,,,900,1800,1,8,101,103,107,108,120,138
      */
-    r = g_regex_new ("\\+UACT: ([^,]*),([^,]*),([^,]*),(.*)(?:\\r\\n)?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+UACT: ([^,]*),([^,]*),([^,]*),(.*)(?:\\r\\n)?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         gchar *bandstr;
 
@@ -1649,11 +1650,11 @@ mm_ublox_parse_uact_test (const gchar  *response,
      * AT+UACT=?
      * +UACT: ,,,(900,1800),(1,8),(101,103,107,108,120),(138)
      */
-    r = g_regex_new ("\\+UACT: ([^,]*),([^,]*),([^,]*),(.*)(?:\\r\\n)?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+UACT: ([^,]*),([^,]*),([^,]*),(.*)(?:\\r\\n)?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -1774,10 +1775,10 @@ mm_ublox_parse_urat_read_response (const gchar  *response,
      * +URAT: 1,2
      * +URAT: 1
      */
-    r = g_regex_new ("\\+URAT: (\\d+)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+URAT: (\\d+)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         guint  value = 0;
 
@@ -1994,8 +1995,8 @@ mm_ublox_parse_ugcntrd_response_for_cid (const gchar  *response,
      *  +UGCNTRD: 31,2704,1819,2724,1839
      * We assume only ONE line is returned.
      */
-    r = g_regex_new ("\\+UGCNTRD:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+UGCNTRD:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     /* Report invalid CID given */
@@ -2004,13 +2005,13 @@ mm_ublox_parse_ugcntrd_response_for_cid (const gchar  *response,
         goto out;
     }
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
         guint cid = 0;
 
         /* Matched CID? */
         if (!mm_get_uint_from_match_info (match_info, 1, &cid) || cid != in_cid) {
-            g_match_info_next (match_info, &inner_error);
+            mm_match_info_next (match_info, &inner_error);
             continue;
         }
 
@@ -32,6 +32,8 @@ udev_rule_match_clear (MMUdevRuleMatch *rule_match)
 {
     g_free (rule_match->parameter);
     g_free (rule_match->value);
+    mm_kernel_device_string_pattern_clear (&rule_match->pattern);
+    mm_kernel_device_string_pattern_clear (&rule_match->prefix_pattern);
 }
 
 static void
@@ -115,6 +117,50 @@ out:
     return TRUE;
 }
 
+static MMUdevRuleAttribute
+parse_attribute (const gchar *name)
+{
+    /* VID/PID directly from our API */
+    if (g_str_equal (name, "idVendor") || g_str_equal (name, "vendor"))
+        return MM_UDEV_RULE_ATTRIBUTE_VID;
+    if (g_str_equal (name, "idProduct") || g_str_equal (name, "device"))
+        return MM_UDEV_RULE_ATTRIBUTE_PID;
+    /* manufacturer and product in the physdev */
+    if (g_str_equal (name, "manufacturer"))
+        return MM_UDEV_RULE_ATTRIBUTE_MANUFACTURER;
+    if (g_str_equal (name, "product"))
+        return MM_UDEV_RULE_ATTRIBUTE_PRODUCT;
+    /* interface class/subclass/protocol/number in the interface */
+    if (g_str_equal (name, "bInterfaceClass"))
+        return MM_UDEV_RULE_ATTRIBUTE_INTERFACE_CLASS;
+    if (g_str_equal (name, "bInterfaceSubClass"))
+        return MM_UDEV_RULE_ATTRIBUTE_INTERFACE_SUBCLASS;
+    if (g_str_equal (name, "bInterfaceProtocol"))
+        return MM_UDEV_RULE_ATTRIBUTE_INTERFACE_PROTOCOL;
+    if (g_str_equal (name, "bInterfaceNumber"))
+        return MM_UDEV_RULE_ATTRIBUTE_INTERFACE_NUMBER;
+    return MM_UDEV_RULE_ATTRIBUTE_OTHER;
+}
+
+static MMUdevRuleAttribute
+parse_result_value_attribute (const gchar *value)
+{
+    MMUdevRuleAttribute attribute = MM_UDEV_RULE_ATTRIBUTE_OTHER;
+    gsize               value_len;
+
+    /* Only the interface attributes are supported as property values */
+    value_len = strlen (value);
+    if (g_str_has_prefix (value, "$attr{") && value[value_len - 1] == '}') {
+        g_autofree gchar *name = NULL;
+
+        name = g_strndup (value + 6, value_len - 7);
+        attribute = parse_attribute (name);
+        if (attribute < MM_UDEV_RULE_ATTRIBUTE_INTERFACE_CLASS)
+            attribute = MM_UDEV_RULE_ATTRIBUTE_OTHER;
+    }
+    return attribute;
+}
+
 static gboolean
 load_rule_result (MMUdevRuleResult  *rule_result,
                   const gchar       *item,
@@ -153,7 +199,9 @@ load_rule_result (MMUdevRuleResult  *rule_result,
     if (g_str_has_prefix (left, "ENV{") && left[left_len - 1] == '}') {
         rule_result->type = MM_UDEV_RULE_RESULT_TYPE_PROPERTY;
         rule_result->content.property.name = g_strndup (left + 4, left_len - 5);
+        rule_result->content.property.name_quark = g_quark_from_string (rule_result->content.property.name);
         rule_result->content.property.value = right;
+        rule_result->content.property.value_attribute = parse_result_value_attribute (right);
         right = NULL;
         goto out;
     }
@@ -174,6 +222,76 @@ out:
     return TRUE;
 }
 
+static gchar *
+parse_parameter_name (const gchar *parameter,
+                      gsize        offset)
+{
+    gchar *name;
+
+    name = g_strdup (strlen (parameter) > offset ? &parameter[offset] : "");
+    g_strdelimit (name, "{}", ' ');
+    g_strstrip (name);
+    return name;
+}
+
+/* Parse everything that doesn't depend on the device the match is applied
+ * to, so that it isn't done for every port */
+static void
+compile_rule_match (MMUdevRuleMatch *rule_match)
+{
+    const gchar *parameter = rule_match->parameter;
+    const gchar *value = rule_match->value;
+
+    if (g_str_equal (parameter, "ACTION")) {
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_ACTION;
+        rule_match->value_has_add = !!strstr (value, "add");
+    } else if (g_str_equal (parameter, "SUBSYSTEM"))
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEM;
+    else if (g_str_equal (parameter, "SUBSYSTEMS"))
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEMS;
+    else if (g_str_equal (parameter, "DRIVER"))
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_DRIVER;
+    else if (g_str_equal (parameter, "DRIVERS"))
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_DRIVERS;
+    else if (g_str_equal (parameter, "KERNEL")) {
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_KERNEL;
+        mm_kernel_device_string_pattern_init (&rule_match->pattern, value);
+    } else if (g_str_equal (parameter, "DEVPATH")) {
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_DEVPATH;
+        mm_kernel_device_string_pattern_init (&rule_match->pattern, value);
+
+        /* If not already doing a prefix match, do an implicit one. This is so that
+         * we can add properties to the usb_device owning all ports, and then apply
+         * the property to all ports individually processed here. */
+        if (value[0] && value[strlen (value) - 1] != '*') {
+            g_autofree gchar *prefix_match = NULL;
+
+            prefix_match = g_strdup_printf ("%s/*", value);
+            mm_kernel_device_string_pattern_init (&rule_match->prefix_pattern, prefix_match);
+            rule_match->has_prefix_pattern = TRUE;
+        }
+    } else if (g_str_has_prefix (parameter, "ATTR")) {
+        g_autofree gchar *name = NULL;
+
+        rule_match->parameter_type = (g_str_has_prefix (parameter, "ATTRS") ?
+                                      MM_UDEV_RULE_MATCH_PARAMETER_ATTRS :
+                                      MM_UDEV_RULE_MATCH_PARAMETER_ATTR);
+        name = parse_parameter_name (parameter, 5);
+        rule_match->name = g_intern_string (name);
+        rule_match->attribute = parse_attribute (name);
+        rule_match->value_any = g_str_equal (value, "?*");
+        rule_match->value_uint_valid = mm_get_uint_from_hex_str (value, &rule_match->value_uint);
+    } else if (g_str_has_prefix (parameter, "ENV")) {
+        g_autofree gchar *name = NULL;
+
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_ENV;
+        name = parse_parameter_name (parameter, 3);
+        rule_match->name = g_intern_string (name);
+        rule_match->name_quark = g_quark_from_string (name);
+    } else
+        rule_match->parameter_type = MM_UDEV_RULE_MATCH_PARAMETER_UNKNOWN;
+}
+
 static gboolean
 load_rule_match (MMUdevRuleMatch  *rule_match,
                  const gchar      *item,
@@ -203,9 +321,55 @@ load_rule_match (MMUdevRuleMatch  *rule_match,
     g_free (operator);
     rule_match->parameter = left;
     rule_match->value     = right;
+    compile_rule_match (rule_match);
     return TRUE;
 }
 
+static void
+load_rule_filter (MMUdevRule *rule)
+{
+    guint i;
+
+    if (!rule->conditions)
+        return;
+
+    for (i = 0; i < rule->conditions->len; i++) {
+        MMUdevRuleMatch *match;
+
+        match = &g_array_index (rule->conditions, MMUdevRuleMatch, i);
+
+        /* We only apply 'add' rules */
+        if (match->parameter_type == MM_UDEV_RULE_MATCH_PARAMETER_ACTION) {
+            if (match->value_has_add != (match->type == MM_UDEV_RULE_MATCH_TYPE_EQUAL))
+                rule->filter.never = TRUE;
+            continue;
+        }
+
+        if (match->type != MM_UDEV_RULE_MATCH_TYPE_EQUAL)
+            continue;
+
+        if (match->parameter_type == MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEM) {
+            if (!rule->filter.subsystem)
+                rule->filter.subsystem = g_intern_string (match->value);
+            continue;
+        }
+
+        if ((match->parameter_type != MM_UDEV_RULE_MATCH_PARAMETER_ATTR &&
+             match->parameter_type != MM_UDEV_RULE_MATCH_PARAMETER_ATTRS) ||
+            !match->value_uint_valid ||
+            match->value_uint > G_MAXUINT16)
+            continue;
+
+        if (match->attribute == MM_UDEV_RULE_ATTRIBUTE_VID && !rule->filter.has_vid) {
+            rule->filter.has_vid = TRUE;
+            rule->filter.vid = match->value_uint;
+        } else if (match->attribute == MM_UDEV_RULE_ATTRIBUTE_PID && !rule->filter.has_pid) {
+            rule->filter.has_pid = TRUE;
+            rule->filter.pid = match->value_uint;
+        }
+    }
+}
+
 static gboolean
 load_rule_from_line (MMUdevRule   *rule,
                      const gchar  *line,
@@ -243,6 +407,8 @@ load_rule_from_line (MMUdevRule   *rule,
     if (!load_rule_result (&rule->result, split[n_items - 1], &inner_error))
         goto out;
 
+    load_rule_filter (rule);
+
     g_assert ((rule->result.type == MM_UDEV_RULE_RESULT_TYPE_GOTO_TAG && rule->result.content.tag) ||
               (rule->result.type == MM_UDEV_RULE_RESULT_TYPE_LABEL && rule->result.content.tag) ||
               (rule->result.type == MM_UDEV_RULE_RESULT_TYPE_PROPERTY && rule->result.content.property.name && rule->result.content.property.value));
@@ -262,43 +428,55 @@ process_goto_tags (GArray  *rules,
                    guint    first_rule_index,
                    GError **error)
 {
-    guint i;
+    g_autoptr(GHashTable)  labels = NULL;
+    g_autoptr(GHashTable)  duplicated_labels = NULL;
+    GError                *inner_error = NULL;
+    guint                  i;
 
-    for (i = first_rule_index; i < rules->len; i++) {
+    /* Walk the rules backwards, so that when a GOTO is found all the labels
+     * it may jump to (i.e. the ones after it) are already known */
+    labels = g_hash_table_new (g_str_hash, g_str_equal);
+    duplicated_labels = g_hash_table_new (g_str_hash, g_str_equal);
+
+    for (i = rules->len; i > first_rule_index; i--) {
         MMUdevRule *rule;
+        gpointer    label_index;
 
-        rule = &g_array_index (rules, MMUdevRule, i);
-        if (rule->result.type == MM_UDEV_RULE_RESULT_TYPE_GOTO_TAG) {
-            guint j;
-            guint label_index = 0;
+        rule = &g_array_index (rules, MMUdevRule, i - 1);
 
-            for (j = i + 1; j < rules->len; j++) {
-                MMUdevRule *walker;
+        if (rule->result.type == MM_UDEV_RULE_RESULT_TYPE_LABEL) {
+            if (g_hash_table_contains (labels, rule->result.content.tag))
+                g_hash_table_add (duplicated_labels, rule->result.content.tag);
+            g_hash_table_insert (labels, rule->result.content.tag, GUINT_TO_POINTER (i - 1));
+            continue;
+        }
 
-                walker = &g_array_index (rules, MMUdevRule, j);
-                if (walker->result.type == MM_UDEV_RULE_RESULT_TYPE_LABEL &&
-                    g_str_equal (rule->result.content.tag, walker->result.content.tag)) {
+        if (rule->result.type != MM_UDEV_RULE_RESULT_TYPE_GOTO_TAG)
+            continue;
 
-                    if (label_index) {
-                        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                                     "More than one label '%s' found", rule->result.content.tag);
-                        return FALSE;
-                    }
+        /* Report the error of the first failing GOTO in the file */
+        if (g_hash_table_contains (duplicated_labels, rule->result.content.tag)) {
+            g_clear_error (&inner_error);
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                       "More than one label '%s' found", rule->result.content.tag);
+            continue;
+        }
 
-                    label_index = j;
-                }
-            }
+        if (!g_hash_table_lookup_extended (labels, rule->result.content.tag, NULL, &label_index)) {
+            g_clear_error (&inner_error);
+            inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                       "Couldn't find label '%s'", rule->result.content.tag);
+            continue;
+        }
 
-            if (!label_index) {
-                g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                             "Couldn't find label '%s'", rule->result.content.tag);
-                return FALSE;
-            }
+        rule->result.type = MM_UDEV_RULE_RESULT_TYPE_GOTO_INDEX;
+        g_free (rule->result.content.tag);
+        rule->result.content.index = GPOINTER_TO_UINT (label_index);
+    }
 
-            rule->result.type = MM_UDEV_RULE_RESULT_TYPE_GOTO_INDEX;
-            g_free (rule->result.content.tag);
-            rule->result.content.index = label_index;
-        }
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        return FALSE;
     }
 
     return TRUE;
@@ -397,6 +575,35 @@ list_rule_files (const gchar *rules_dir_path)
     return g_list_sort (children, (GCompareFunc) g_strcmp0);
 }
 
+static void
+link_rule_filters (GArray *rules)
+{
+    guint i;
+
+    /* Walk the rules backwards, so that each rule can inherit the skip
+     * index of the next one when both have the same requirement */
+    for (i = rules->len; i > 0; i--) {
+        MMUdevRuleFilter *filter;
+        MMUdevRuleFilter *next = NULL;
+
+        filter = &g_array_index (rules, MMUdevRule, i - 1).filter;
+        if (i < rules->len)
+            next = &g_array_index (rules, MMUdevRule, i).filter;
+
+        filter->vid_next = i;
+        if (next && filter->has_vid && next->has_vid && filter->vid == next->vid)
+            filter->vid_next = next->vid_next;
+
+        filter->pid_next = i;
+        if (next && filter->has_pid && next->has_pid && filter->pid == next->pid)
+            filter->pid_next = next->pid_next;
+
+        filter->subsystem_next = i;
+        if (next && filter->subsystem && filter->subsystem == next->subsystem)
+            filter->subsystem_next = next->subsystem_next;
+    }
+}
+
 GArray *
 mm_kernel_device_generic_rules_load (const gchar  *rules_dir,
                                      GError      **error)
@@ -428,6 +635,8 @@ mm_kernel_device_generic_rules_load (const gchar  *rules_dir,
         goto out;
     }
 
+    link_rule_filters (rules);
+
 out:
     if (rule_files)
         g_list_free_full (rule_files, g_free);
@@ -15,6 +15,8 @@
 
 #include <glib.h>
 
+#include "mm-kernel-device-helpers.h"
+
 G_BEGIN_DECLS
 
 typedef enum {
@@ -23,10 +25,51 @@ typedef enum {
     MM_UDEV_RULE_MATCH_TYPE_NOT_EQUAL,
 } MMUdevRuleMatchType;
 
+typedef enum {
+    MM_UDEV_RULE_MATCH_PARAMETER_UNKNOWN,
+    MM_UDEV_RULE_MATCH_PARAMETER_ACTION,
+    MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEM,
+    MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEMS,
+    MM_UDEV_RULE_MATCH_PARAMETER_DRIVER,
+    MM_UDEV_RULE_MATCH_PARAMETER_DRIVERS,
+    MM_UDEV_RULE_MATCH_PARAMETER_KERNEL,
+    MM_UDEV_RULE_MATCH_PARAMETER_DEVPATH,
+    MM_UDEV_RULE_MATCH_PARAMETER_ATTR,
+    MM_UDEV_RULE_MATCH_PARAMETER_ATTRS,
+    MM_UDEV_RULE_MATCH_PARAMETER_ENV,
+} MMUdevRuleMatchParameter;
+
+/* Attributes that are read from the device contents preloaded by the
+ * generic kernel device, instead of from sysfs */
+typedef enum {
+    MM_UDEV_RULE_ATTRIBUTE_OTHER,
+    MM_UDEV_RULE_ATTRIBUTE_VID,
+    MM_UDEV_RULE_ATTRIBUTE_PID,
+    MM_UDEV_RULE_ATTRIBUTE_MANUFACTURER,
+    MM_UDEV_RULE_ATTRIBUTE_PRODUCT,
+    MM_UDEV_RULE_ATTRIBUTE_INTERFACE_CLASS,
+    MM_UDEV_RULE_ATTRIBUTE_INTERFACE_SUBCLASS,
+    MM_UDEV_RULE_ATTRIBUTE_INTERFACE_PROTOCOL,
+    MM_UDEV_RULE_ATTRIBUTE_INTERFACE_NUMBER,
+} MMUdevRuleAttribute;
+
 typedef struct {
     MMUdevRuleMatchType  type;
     gchar               *parameter;
     gchar               *value;
+
+    /* Precompiled from parameter and value */
+    MMUdevRuleMatchParameter     parameter_type;
+    MMUdevRuleAttribute          attribute;
+    const gchar                 *name;         /* interned ATTR/ATTRS/ENV name */
+    GQuark                       name_quark;   /* ENV name as object data key */
+    gboolean                     value_any;    /* value is "?*" */
+    gboolean                     value_uint_valid;
+    guint                        value_uint;
+    gboolean                     value_has_add; /* ACTION value includes "add" */
+    MMKernelDeviceStringPattern  pattern;
+    MMKernelDeviceStringPattern  prefix_pattern;
+    gboolean                     has_prefix_pattern;
 } MMUdevRuleMatch;
 
 typedef enum {
@@ -38,8 +81,10 @@ typedef enum {
 } MMUdevRuleResultType;
 
 typedef struct {
-    gchar *name;
-    gchar *value;
+    gchar               *name;
+    gchar               *value;
+    GQuark               name_quark;
+    MMUdevRuleAttribute  value_attribute; /* value is "$attr{...}" */
 } MMUdevRuleResultProperty;
 
 typedef struct {
@@ -51,9 +96,26 @@ typedef struct {
     } content;
 } MMUdevRuleResult;
 
+/* Requirements of a rule that can be checked without evaluating its
+ * conditions. Consecutive rules with the same requirement (e.g. all the
+ * rules of a vendor block) are chained, so that a device that doesn't
+ * fulfill it skips the whole block in one step. */
+typedef struct {
+    gboolean     never;            /* e.g. ACTION!="add" */
+    gboolean     has_vid;
+    guint16      vid;
+    guint        vid_next;         /* first following rule with a different VID requirement */
+    gboolean     has_pid;
+    guint16      pid;
+    guint        pid_next;         /* first following rule with a different PID requirement */
+    const gchar *subsystem;        /* interned, exact SUBSYSTEM match */
+    guint        subsystem_next;   /* first following rule with a different SUBSYSTEM requirement */
+} MMUdevRuleFilter;
+
 typedef struct {
     GArray           *conditions;
     MMUdevRuleResult  result;
+    MMUdevRuleFilter  filter;
 } MMUdevRule;
 
 GArray *mm_kernel_device_generic_rules_load (const gchar  *rules_dir,
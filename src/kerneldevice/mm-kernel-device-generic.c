@@ -52,7 +52,8 @@ struct _MMKernelDeviceGenericPrivate {
     /* Input properties */
     MMKernelEventProperties *properties;
     /* Rules to apply */
-    GArray *rules;
+    GArray      *rules;
+    const gchar *rules_subsystem;
 
     /* Contents from sysfs */
     gchar  **drivers;
@@ -739,6 +740,58 @@ kernel_device_cmp (MMKernelDevice *a,
 
 /*****************************************************************************/
 
+static gboolean
+check_interface_attribute (MMUdevRuleMatch *match,
+                           guint8           value,
+                           gboolean         condition_equal)
+{
+    return (match->value_any || (match->value_uint_valid && ((value == match->value_uint) == condition_equal)));
+}
+
+static gboolean
+check_attribute (MMKernelDeviceGeneric *self,
+                 MMUdevRuleMatch       *match,
+                 gboolean               condition_equal)
+{
+    switch (match->attribute) {
+    case MM_UDEV_RULE_ATTRIBUTE_VID:
+        return (match->value_uint_valid &&
+                ((mm_kernel_device_get_physdev_vid (MM_KERNEL_DEVICE (self)) == match->value_uint) == condition_equal));
+    case MM_UDEV_RULE_ATTRIBUTE_PID:
+        return (match->value_uint_valid &&
+                ((mm_kernel_device_get_physdev_pid (MM_KERNEL_DEVICE (self)) == match->value_uint) == condition_equal));
+    case MM_UDEV_RULE_ATTRIBUTE_MANUFACTURER:
+        return ((self->priv->physdev_manufacturer && g_str_equal (self->priv->physdev_manufacturer, match->value)) == condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_PRODUCT:
+        return ((self->priv->physdev_product && g_str_equal (self->priv->physdev_product, match->value)) == condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_CLASS:
+        return check_interface_attribute (match, self->priv->interface_class, condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_SUBCLASS:
+        return check_interface_attribute (match, self->priv->interface_subclass, condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_PROTOCOL:
+        return check_interface_attribute (match, self->priv->interface_protocol, condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_NUMBER:
+        return check_interface_attribute (match, self->priv->interface_number, condition_equal);
+    case MM_UDEV_RULE_ATTRIBUTE_OTHER:
+    default: {
+        g_autofree gchar *found_value = NULL;
+
+        found_value = lookup_sysfs_attribute_as_string (self, match->name, match->parameter_type == MM_UDEV_RULE_MATCH_PARAMETER_ATTRS);
+        return ((found_value && g_str_equal (found_value, match->value)) == condition_equal);
+    }
+    }
+}
+
+static gboolean
+check_devpath (MMKernelDeviceGeneric *self,
+               const gchar           *sysfs_path,
+               MMUdevRuleMatch       *match,
+               gboolean               condition_equal)
+{
+    return ((mm_kernel_device_string_pattern_match (&match->pattern, sysfs_path, self) == condition_equal) ||
+            (match->has_prefix_pattern && mm_kernel_device_string_pattern_match (&match->prefix_pattern, sysfs_path, self) == condition_equal));
+}
+
 static gboolean
 check_condition (MMKernelDeviceGeneric *self,
                  MMUdevRuleMatch       *match)
@@ -747,133 +800,100 @@ check_condition (MMKernelDeviceGeneric *self,
 
     condition_equal = (match->type == MM_UDEV_RULE_MATCH_TYPE_EQUAL);
 
-    /* We only apply 'add' rules */
-    if (g_str_equal (match->parameter, "ACTION"))
-        return ((!!strstr (match->value, "add")) == condition_equal);
+    switch (match->parameter_type) {
+    case MM_UDEV_RULE_MATCH_PARAMETER_ACTION:
+        /* We only apply 'add' rules */
+        return (match->value_has_add == condition_equal);
 
-    /* Exact SUBSYSTEM match */
-    if (g_str_equal (match->parameter, "SUBSYSTEM"))
+    case MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEM:
+        /* Exact SUBSYSTEM match */
         return ((self->priv->subsystems && !g_strcmp0 (self->priv->subsystems[0], match->value)) == condition_equal);
 
-    /* Loose SUBSYSTEMS match */
-    if (g_str_equal (match->parameter, "SUBSYSTEMS"))
+    case MM_UDEV_RULE_MATCH_PARAMETER_SUBSYSTEMS:
+        /* Loose SUBSYSTEMS match */
         return ((self->priv->subsystems && g_strv_contains ((const gchar * const *) self->priv->subsystems, match->value)) == condition_equal);
 
-    /* Exact DRIVER match */
-    if (g_str_equal (match->parameter, "DRIVER"))
+    case MM_UDEV_RULE_MATCH_PARAMETER_DRIVER:
+        /* Exact DRIVER match */
         return ((self->priv->drivers && !g_strcmp0 (self->priv->drivers[0], match->value)) == condition_equal);
 
-    /* Loose DRIVERS match */
-    if (g_str_equal (match->parameter, "DRIVERS"))
+    case MM_UDEV_RULE_MATCH_PARAMETER_DRIVERS:
+        /* Loose DRIVERS match */
         return ((self->priv->drivers && g_strv_contains ((const gchar * const *) self->priv->drivers, match->value)) == condition_equal);
 
-    /* Device name checks */
-    if (g_str_equal (match->parameter, "KERNEL"))
-        return (mm_kernel_device_generic_string_match (mm_kernel_device_get_name (MM_KERNEL_DEVICE (self)), match->value, self) == condition_equal);
+    case MM_UDEV_RULE_MATCH_PARAMETER_KERNEL:
+        /* Device name checks */
+        return (mm_kernel_device_string_pattern_match (&match->pattern, mm_kernel_device_get_name (MM_KERNEL_DEVICE (self)), self) == condition_equal);
 
-    /* Device sysfs path checks; we allow both a direct match and a prefix patch */
-    if (g_str_equal (match->parameter, "DEVPATH")) {
-        g_autofree gchar *prefix_match = NULL;
+    case MM_UDEV_RULE_MATCH_PARAMETER_DEVPATH:
+        /* Device sysfs path checks; we allow both a direct match and a prefix patch */
 
         /* If sysfs path invalid (e.g. path doesn't exist), no match */
         if (!self->priv->sysfs_path)
             return FALSE;
 
-        /* If not already doing a prefix match, do an implicit one. This is so that
-         * we can add properties to the usb_device owning all ports, and then apply
-         * the property to all ports individually processed here. */
-        if (match->value[0] && match->value[strlen (match->value) - 1] != '*')
-            prefix_match = g_strdup_printf ("%s/*", match->value);
+        if (check_devpath (self, self->priv->sysfs_path, match, condition_equal))
+            return TRUE;
 
-        if ((mm_kernel_device_generic_string_match (self->priv->sysfs_path, match->value, self) == condition_equal) ||
-            (prefix_match && mm_kernel_device_generic_string_match (self->priv->sysfs_path, prefix_match, self) == condition_equal))
+        if (g_str_has_prefix (self->priv->sysfs_path, "/sys") &&
+            check_devpath (self, &self->priv->sysfs_path[4], match, condition_equal))
             return TRUE;
 
-        if (g_str_has_prefix (self->priv->sysfs_path, "/sys")) {
-            if ((mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], match->value, self) == condition_equal) ||
-                (prefix_match && mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], prefix_match, self) == condition_equal))
-                return TRUE;
-        }
         return FALSE;
-    }
-
-    /* Attributes checks */
-    if (g_str_has_prefix (match->parameter, "ATTR")) {
-        gchar    *attribute;
-        gchar    *contents = NULL;
-        gboolean  result = FALSE;
-        guint     val;
-
-        attribute = g_strdup (&match->parameter[5]);
-        g_strdelimit (attribute, "{}", ' ');
-        g_strstrip (attribute);
-
-        /* VID/PID directly from our API */
-        if (g_str_equal (attribute, "idVendor") || g_str_equal (attribute, "vendor"))
-            result = ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                      ((mm_kernel_device_get_physdev_vid (MM_KERNEL_DEVICE (self)) == val) == condition_equal));
-        else if (g_str_equal (attribute, "idProduct") || g_str_equal (attribute, "device"))
-            result = ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                      ((mm_kernel_device_get_physdev_pid (MM_KERNEL_DEVICE (self)) == val) == condition_equal));
-        /* manufacturer in the physdev */
-        else if (g_str_equal (attribute, "manufacturer"))
-            result = ((self->priv->physdev_manufacturer && g_str_equal (self->priv->physdev_manufacturer, match->value)) == condition_equal);
-        /* product in the physdev */
-        else if (g_str_equal (attribute, "product"))
-            result = ((self->priv->physdev_product && g_str_equal (self->priv->physdev_product, match->value)) == condition_equal);
-        /* interface class/subclass/protocol/number in the interface */
-        else if (g_str_equal (attribute, "bInterfaceClass"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_class == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceSubClass"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_subclass == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceProtocol"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_protocol == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceNumber"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_number == val) == condition_equal)));
-        else {
-            g_autofree gchar *found_value = NULL;
-
-            found_value = lookup_sysfs_attribute_as_string (self, attribute, g_str_has_prefix (match->parameter, "ATTRS"));
-            result = ((found_value && g_str_equal (found_value, match->value)) == condition_equal);
-        }
-
-        g_free (contents);
-        g_free (attribute);
-        return result;
-    }
 
-    /* Previously set property checks */
-    if (g_str_has_prefix (match->parameter, "ENV")) {
-        gchar    *property;
-        gboolean  result = FALSE;
+    case MM_UDEV_RULE_MATCH_PARAMETER_ATTR:
+    case MM_UDEV_RULE_MATCH_PARAMETER_ATTRS:
+        /* Attributes checks */
+        return check_attribute (self, match, condition_equal);
 
-        property = g_strdup (&match->parameter[3]);
-        g_strdelimit (property, "{}", ' ');
-        g_strstrip (property);
+    case MM_UDEV_RULE_MATCH_PARAMETER_ENV:
+        /* Previously set property checks */
+        return ((!g_strcmp0 ((const gchar *) g_object_get_qdata (G_OBJECT (self), match->name_quark), match->value)) == condition_equal);
 
-        result = ((!g_strcmp0 ((const gchar *) g_object_get_data (G_OBJECT (self), property), match->value)) == condition_equal);
-
-        g_free (property);
-        return result;
+    case MM_UDEV_RULE_MATCH_PARAMETER_UNKNOWN:
+    default:
+        break;
     }
 
     mm_obj_warn (self, "unknown match condition parameter: %s", match->parameter);
     return FALSE;
 }
 
+/* Returns the index of the next rule to check if the given one can't apply
+ * to the device without even checking its conditions, or rule_i otherwise */
+static guint
+filter_rule (MMKernelDeviceGeneric *self,
+             guint                  rule_i)
+{
+    MMUdevRuleFilter *filter;
+
+    filter = &g_array_index (self->priv->rules, MMUdevRule, rule_i).filter;
+
+    if (filter->never)
+        return rule_i + 1;
+    if (filter->has_vid && filter->vid != self->priv->physdev_vid)
+        return filter->vid_next;
+    if (filter->has_pid && filter->pid != self->priv->physdev_pid)
+        return filter->pid_next;
+    if (filter->subsystem && filter->subsystem != self->priv->rules_subsystem)
+        return filter->subsystem_next;
+    return rule_i;
+}
+
 static guint
 check_rule (MMKernelDeviceGeneric *self,
             guint                  rule_i)
 {
     MMUdevRule *rule;
     gboolean    apply = TRUE;
+    guint       next_rule_i;
 
     g_assert (rule_i < self->priv->rules->len);
 
+    next_rule_i = filter_rule (self, rule_i);
+    if (next_rule_i != rule_i)
+        return next_rule_i;
+
     rule = &g_array_index (self->priv->rules, MMUdevRule, rule_i);
     if (rule->conditions) {
         guint condition_i;
@@ -892,34 +912,48 @@ check_rule (MMKernelDeviceGeneric *self,
     if (apply) {
         switch (rule->result.type) {
         case MM_UDEV_RULE_RESULT_TYPE_PROPERTY: {
-            gchar *property_value_read = NULL;
+            MMUdevRuleResultProperty *property = &rule->result.content.property;
+            gchar                    *property_value_read = NULL;
 
-            if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceClass}"))
+            switch (property->value_attribute) {
+            case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_CLASS:
                 property_value_read = g_strdup_printf ("%02x", self->priv->interface_class);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceSubClass}"))
+                break;
+            case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_SUBCLASS:
                 property_value_read = g_strdup_printf ("%02x", self->priv->interface_subclass);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceProtocol}"))
+                break;
+            case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_PROTOCOL:
                 property_value_read = g_strdup_printf ("%02x", self->priv->interface_protocol);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceNumber}"))
+                break;
+            case MM_UDEV_RULE_ATTRIBUTE_INTERFACE_NUMBER:
                 property_value_read = g_strdup_printf ("%02x", self->priv->interface_number);
+                break;
+            case MM_UDEV_RULE_ATTRIBUTE_OTHER:
+            case MM_UDEV_RULE_ATTRIBUTE_VID:
+            case MM_UDEV_RULE_ATTRIBUTE_PID:
+            case MM_UDEV_RULE_ATTRIBUTE_MANUFACTURER:
+            case MM_UDEV_RULE_ATTRIBUTE_PRODUCT:
+            default:
+                break;
+            }
 
             /* add new property */
             mm_obj_dbg (self, "property added: %s=%s",
-                        rule->result.content.property.name,
-                        property_value_read ? property_value_read : rule->result.content.property.value);
+                        property->name,
+                        property_value_read ? property_value_read : property->value);
 
             if (!property_value_read)
                 /* NOTE: we keep a reference to the list of rules ourselves, so it isn't
                  * an issue if we re-use the same string (i.e. without g_strdup-ing it)
                  * as a property value. */
-                g_object_set_data (G_OBJECT (self),
-                                   rule->result.content.property.name,
-                                   rule->result.content.property.value);
+                g_object_set_qdata (G_OBJECT (self),
+                                    property->name_quark,
+                                    property->value);
             else
-                g_object_set_data_full (G_OBJECT (self),
-                                        rule->result.content.property.name,
-                                        property_value_read,
-                                        g_free);
+                g_object_set_qdata_full (G_OBJECT (self),
+                                         property->name_quark,
+                                         property_value_read,
+                                         g_free);
             break;
         }
 
@@ -950,6 +984,10 @@ preload_rule_properties (MMKernelDeviceGeneric *self)
     g_assert (self->priv->rules);
     g_assert (self->priv->rules->len > 0);
 
+    /* Rules requiring an exact SUBSYSTEM match are filtered by comparing
+     * interned strings */
+    self->priv->rules_subsystem = (self->priv->subsystems ? g_intern_string (self->priv->subsystems[0]) : NULL);
+
     /* Start to process rules */
     i = 0;
     while (i < self->priv->rules->len) {
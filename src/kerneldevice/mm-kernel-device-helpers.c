@@ -14,6 +14,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <glib.h>
 #include <glib-object.h>
@@ -65,27 +66,24 @@ mm_kernel_device_get_lower_device_name (const gchar *sysfs_path)
 
 /******************************************************************************/
 
-static gchar *
-build_string_match_pattern (const gchar *str)
+void
+mm_kernel_device_string_pattern_init (MMKernelDeviceStringPattern *pattern,
+                                      const gchar                 *str)
 {
-    GString          *regex_pattern;
-    const gchar      *str_start;
-    gsize             len;
-    g_autofree gchar *aux = NULL;
-    gboolean          prefix_match = FALSE;
-    gboolean          suffix_match = FALSE;
+    const gchar *str_start;
+    gsize        len;
+
+    memset (pattern, 0, sizeof (MMKernelDeviceStringPattern));
 
     /* We allow prefix and suffix matches given as input, by means of the
      * single '*' character given either at the beginning or the end of the
      * string. If given in another place, it will assumed to be explicitly
      * the '*' character, not a catch-all indication. */
 
-    regex_pattern = g_string_new (NULL);
-
     /* suffix match? */
     if (str[0] == '*') {
         str_start = &str[1];
-        suffix_match = TRUE;
+        pattern->suffix_match = TRUE;
     } else
         str_start = str;
 
@@ -93,25 +91,47 @@ build_string_match_pattern (const gchar *str)
     len = strlen (str_start);
     if (len > 0 && str_start[len - 1] == '*') {
         len--;
-        prefix_match = TRUE;
+        pattern->prefix_match = TRUE;
     }
 
-    /* match start of string */
-    g_string_append (regex_pattern, "^");
+    pattern->str = g_strdup (str);
+    pattern->literal = g_strndup (str_start, len);
+    pattern->literal_len = len;
+}
+
+void
+mm_kernel_device_string_pattern_clear (MMKernelDeviceStringPattern *pattern)
+{
+    g_clear_pointer (&pattern->str, g_free);
+    g_clear_pointer (&pattern->literal, g_free);
+}
 
-    if (suffix_match)
-        g_string_append (regex_pattern, ".*");
+gboolean
+mm_kernel_device_string_pattern_match (const MMKernelDeviceStringPattern *pattern,
+                                       const gchar                       *str,
+                                       gpointer                           log_object)
+{
+    gsize    str_len;
+    gboolean match;
 
-    aux = g_regex_escape_string (str_start, len);
-    g_string_append (regex_pattern, aux);
+    str_len = strlen (str);
+    if (str_len < pattern->literal_len)
+        return FALSE;
 
-    if (prefix_match)
-        g_string_append (regex_pattern, ".*");
+    if (pattern->prefix_match && pattern->suffix_match)
+        match = !!strstr (str, pattern->literal);
+    else if (pattern->prefix_match)
+        match = !strncmp (str, pattern->literal, pattern->literal_len);
+    else if (pattern->suffix_match)
+        match = !memcmp (&str[str_len - pattern->literal_len], pattern->literal, pattern->literal_len);
+    else
+        match = (str_len == pattern->literal_len && !memcmp (str, pattern->literal, str_len));
 
-    /* match end of string */
-    g_string_append (regex_pattern, "$");
+    if (!match)
+        return FALSE;
 
-    return g_string_free (regex_pattern, FALSE);
+    mm_obj_dbg (log_object, "pattern '%s' matched: '%s'", pattern->str, str);
+    return TRUE;
 }
 
 gboolean
@@ -119,27 +139,125 @@ mm_kernel_device_generic_string_match (const gchar *str,
                                        const gchar *pattern,
                                        gpointer     log_object)
 {
-    g_autoptr(GError)      inner_error = NULL;
-    g_autoptr(GRegex)      regex = NULL;
-    g_autoptr(GMatchInfo)  match_info = NULL;
-    g_autofree gchar      *regex_pattern = NULL;
+    MMKernelDeviceStringPattern compiled;
+    gboolean                    match;
 
-    regex_pattern = build_string_match_pattern (pattern);
+    mm_kernel_device_string_pattern_init (&compiled, pattern);
+    match = mm_kernel_device_string_pattern_match (&compiled, str, log_object);
+    mm_kernel_device_string_pattern_clear (&compiled);
+    return match;
+}
 
-    regex = g_regex_new (regex_pattern, G_REGEX_UNGREEDY, 0, &inner_error);
-    if (!regex) {
-        mm_obj_warn (log_object, "invalid pattern in rule '%s': %s", regex_pattern, inner_error->message);
-        return FALSE;
-    }
-    g_regex_match_full (regex, str, -1, 0, 0, &match_info, &inner_error);
-    if (inner_error) {
-        mm_obj_warn (log_object, "couldn't apply pattern match in rule '%s': %s", regex_pattern, inner_error->message);
-        return FALSE;
-    }
+/******************************************************************************/
 
-    if (!g_match_info_matches (match_info))
-        return FALSE;
+struct _MMKernelDevicePortIndex {
+    /* "subsystem/name" -> owner */
+    GHashTable *by_name;
+    /* sysfs path -> owner */
+    GHashTable *by_sysfs_path;
+};
 
-    mm_obj_dbg (log_object, "pattern '%s' matched: '%s'", regex_pattern, str);
-    return TRUE;
+/* Port names and subsystem names never include '/', so the combination is
+ * unique */
+static gchar *
+port_index_build_name_key (const gchar *subsystem,
+                           const gchar *name)
+{
+    return g_strconcat (subsystem, "/", name, NULL);
+}
+
+MMKernelDevicePortIndex *
+mm_kernel_device_port_index_new (void)
+{
+    MMKernelDevicePortIndex *self;
+
+    self = g_slice_new (MMKernelDevicePortIndex);
+    self->by_name       = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    self->by_sysfs_path = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    return self;
+}
+
+void
+mm_kernel_device_port_index_free (MMKernelDevicePortIndex *self)
+{
+    g_hash_table_unref (self->by_name);
+    g_hash_table_unref (self->by_sysfs_path);
+    g_slice_free (MMKernelDevicePortIndex, self);
+}
+
+void
+mm_kernel_device_port_index_add (MMKernelDevicePortIndex *self,
+                                 const gchar             *subsystem,
+                                 const gchar             *name,
+                                 const gchar             *sysfs_path,
+                                 gpointer                 owner)
+{
+    g_return_if_fail (subsystem && name && owner);
+
+    g_hash_table_insert (self->by_name, port_index_build_name_key (subsystem, name), owner);
+    if (sysfs_path)
+        g_hash_table_insert (self->by_sysfs_path, g_strdup (sysfs_path), owner);
+}
+
+void
+mm_kernel_device_port_index_remove (MMKernelDevicePortIndex *self,
+                                    const gchar             *subsystem,
+                                    const gchar             *name,
+                                    const gchar             *sysfs_path,
+                                    gpointer                 owner)
+{
+    g_autofree gchar *key = NULL;
+
+    g_return_if_fail (subsystem && name && owner);
+
+    /* Only remove if still owned by the same owner, the port may have been
+     * indexed again for a different one in the meantime */
+    key = port_index_build_name_key (subsystem, name);
+    if (g_hash_table_lookup (self->by_name, key) == owner)
+        g_hash_table_remove (self->by_name, key);
+    if (sysfs_path && g_hash_table_lookup (self->by_sysfs_path, sysfs_path) == owner)
+        g_hash_table_remove (self->by_sysfs_path, sysfs_path);
+}
+
+static gboolean
+port_index_owner_equal (gpointer key,
+                        gpointer value,
+                        gpointer owner)
+{
+    return value == owner;
+}
+
+void
+mm_kernel_device_port_index_remove_owner (MMKernelDevicePortIndex *self,
+                                          gpointer                 owner)
+{
+    g_hash_table_foreach_remove (self->by_name, port_index_owner_equal, owner);
+    g_hash_table_foreach_remove (self->by_sysfs_path, port_index_owner_equal, owner);
+}
+
+gpointer
+mm_kernel_device_port_index_lookup_name (MMKernelDevicePortIndex *self,
+                                         const gchar             *subsystem,
+                                         const gchar             *name)
+{
+    g_autofree gchar *key = NULL;
+
+    if (!subsystem || !name)
+        return NULL;
+
+    key = port_index_build_name_key (subsystem, name);
+    return g_hash_table_lookup (self->by_name, key);
+}
+
+gpointer
+mm_kernel_device_port_index_lookup_sysfs_path (MMKernelDevicePortIndex *self,
+                                               const gchar             *sysfs_path)
+{
+    return (sysfs_path ? g_hash_table_lookup (self->by_sysfs_path, sysfs_path) : NULL);
+}
+
+guint
+mm_kernel_device_port_index_get_size (MMKernelDevicePortIndex *self)
+{
+    return g_hash_table_size (self->by_name);
 }
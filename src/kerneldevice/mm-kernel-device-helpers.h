@@ -28,4 +28,49 @@ gboolean mm_kernel_device_generic_string_match (const gchar *str,
                                                 const gchar *pattern,
                                                 gpointer     log_object);
 
+/* Same string matching logic, with the pattern parsed only once so that it
+ * can be applied to multiple strings */
+typedef struct {
+    gchar    *str;
+    gchar    *literal;
+    gsize     literal_len;
+    gboolean  prefix_match;
+    gboolean  suffix_match;
+} MMKernelDeviceStringPattern;
+
+void     mm_kernel_device_string_pattern_init  (MMKernelDeviceStringPattern       *pattern,
+                                                const gchar                       *str);
+void     mm_kernel_device_string_pattern_clear (MMKernelDeviceStringPattern       *pattern);
+gboolean mm_kernel_device_string_pattern_match (const MMKernelDeviceStringPattern *pattern,
+                                                const gchar                       *str,
+                                                gpointer                           log_object);
+
+/* Index of the owners of a set of ports, looked up either by subsystem and
+ * name or by sysfs path. The owner is an opaque pointer not owned by the
+ * index. */
+typedef struct _MMKernelDevicePortIndex MMKernelDevicePortIndex;
+
+MMKernelDevicePortIndex *mm_kernel_device_port_index_new               (void);
+void                     mm_kernel_device_port_index_free              (MMKernelDevicePortIndex *self);
+void                     mm_kernel_device_port_index_add               (MMKernelDevicePortIndex *self,
+                                                                        const gchar             *subsystem,
+                                                                        const gchar             *name,
+                                                                        const gchar             *sysfs_path,
+                                                                        gpointer                 owner);
+void                     mm_kernel_device_port_index_remove            (MMKernelDevicePortIndex *self,
+                                                                        const gchar             *subsystem,
+                                                                        const gchar             *name,
+                                                                        const gchar             *sysfs_path,
+                                                                        gpointer                 owner);
+void                     mm_kernel_device_port_index_remove_owner      (MMKernelDevicePortIndex *self,
+                                                                        gpointer                 owner);
+gpointer                 mm_kernel_device_port_index_lookup_name       (MMKernelDevicePortIndex *self,
+                                                                        const gchar             *subsystem,
+                                                                        const gchar             *name);
+gpointer                 mm_kernel_device_port_index_lookup_sysfs_path (MMKernelDevicePortIndex *self,
+                                                                        const gchar             *sysfs_path);
+guint                    mm_kernel_device_port_index_get_size          (MMKernelDevicePortIndex *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMKernelDevicePortIndex, mm_kernel_device_port_index_free)
+
 #endif /* MM_KERNEL_DEVICE_HELPERS_H */
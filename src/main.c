@@ -30,6 +30,9 @@
 #include "mm-log.h"
 #include "mm-base-manager.h"
 #include "mm-context.h"
+#include "mm-port-trace.h"
+#include "mm-modem-snapshot.h"
+#include "mm-main-loop-monitor.h"
 
 #if defined WITH_SYSTEMD_SUSPEND_RESUME
 # include "mm-sleep-monitor.h"
@@ -165,11 +168,25 @@ main (int argc, char *argv[])
                        mm_context_get_log_journal (),
                        mm_context_get_log_timestamps (),
                        mm_context_get_log_relative_timestamps (),
+                       mm_context_get_log_file_buffered (),
+                       mm_context_get_log_file_max_size (),
                        &error)) {
         g_printerr ("error: failed to set up logging: %s\n", error->message);
         g_error_free (error);
         exit (1);
     }
+    mm_log_set_debug_filter (mm_context_get_log_debug_filter ());
+
+    if (mm_context_get_capture_file () &&
+        !mm_port_trace_open (mm_context_get_capture_file (), &error)) {
+        g_printerr ("error: failed to set up traffic capture: %s\n", error->message);
+        g_error_free (error);
+        exit (1);
+    }
+
+    /* Never reuse modem info across test runs */
+    if (!mm_context_get_no_modem_snapshot () && !mm_context_get_test_session ())
+        mm_modem_snapshot_setup (PKGSTATEDIR "/modem-snapshot", mm_context_get_flush_modem_snapshot ());
 
     g_unix_signal_add (SIGTERM, quit_cb, NULL);
     g_unix_signal_add (SIGINT, quit_cb, NULL);
@@ -212,6 +229,7 @@ main (int argc, char *argv[])
 #endif
 
     /* Go into the main loop */
+    mm_main_loop_monitor_setup (mm_context_get_debug ());
     loop = g_main_loop_new (NULL, FALSE);
     g_main_loop_run (loop);
 
@@ -251,6 +269,8 @@ main (int argc, char *argv[])
 
     mm_info ("ModemManager is shut down");
 
+    mm_main_loop_monitor_shutdown ();
+    mm_port_trace_close ();
     mm_log_shutdown ();
 
     return 0;
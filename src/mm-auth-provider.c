@@ -16,10 +16,12 @@
  */
 
 #include <config.h>
+#include <string.h>
 
 #include <ModemManager.h>
 #include "mm-errors-types.h"
 #include "mm-log-object.h"
+#include "mm-main-loop-monitor.h"
 #include "mm-utils.h"
 #include "mm-auth-provider.h"
 
@@ -116,6 +118,21 @@ check_authorization_ready (PolkitAuthority *authority,
 }
 #endif
 
+static void
+record_method_dispatch (GDBusMethodInvocation *invocation)
+{
+    const gchar *path;
+
+    if (!mm_main_loop_monitor_handler_stats_enabled ())
+        return;
+
+    /* Tag with the object, e.g. "Modem/0" */
+    path = g_dbus_method_invocation_get_object_path (invocation);
+    if (g_str_has_prefix (path, MM_DBUS_PATH "/"))
+        path += strlen (MM_DBUS_PATH "/");
+    mm_main_loop_monitor_dispatch_record (MM_MAIN_LOOP_HANDLER_DBUS_METHOD, path, 0);
+}
+
 void
 mm_auth_provider_authorize (MMAuthProvider        *self,
                             GDBusMethodInvocation *invocation,
@@ -126,6 +143,12 @@ mm_auth_provider_authorize (MMAuthProvider        *self,
 {
     GTask *task;
 
+    /* Method handlers request authorization as soon as they're dispatched, so
+     * this is where their latency is recorded. Only latency, as the method may
+     * complete asynchronously; and methods not requiring authorization and
+     * property accesses are not seen at all. */
+    record_method_dispatch (invocation);
+
     task = g_task_new (self, cancellable, callback, user_data);
 
 #if defined WITH_POLKIT
@@ -39,6 +39,7 @@
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-bearer-stats.h"
+#include "mm-timer.h"
 
 /* We require up to 20s to get a proper IP when using PPP */
 #define BEARER_IP_TIMEOUT_DEFAULT 20
@@ -157,7 +158,7 @@ static void
 connection_monitor_stop (MMBaseBearer *self)
 {
     if (self->priv->connection_monitor_id) {
-        g_source_remove (self->priv->connection_monitor_id);
+        mm_timer_remove (self->priv->connection_monitor_id);
         self->priv->connection_monitor_id = 0;
     }
 }
@@ -215,9 +216,11 @@ initial_connection_monitor_cb (MMBaseBearer *self)
             NULL);
 
     /* Add new monitor timeout at a higher rate */
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
-                                                               (GSourceFunc) connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                              MM_LOG_OBJECT (self),
+                                                              BEARER_CONNECTION_MONITOR_TIMEOUT,
+                                                              (GSourceFunc) connection_monitor_cb,
+                                                              self);
 
     /* Remove the initial connection monitor timeout as we added a new one */
     return G_SOURCE_REMOVE;
@@ -236,9 +239,11 @@ connection_monitor_start (MMBaseBearer *self)
 
     /* Schedule initial check */
     g_assert (!self->priv->connection_monitor_id);
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
-                                                               (GSourceFunc) initial_connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                              MM_LOG_OBJECT (self),
+                                                              BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
+                                                              (GSourceFunc) initial_connection_monitor_cb,
+                                                              self);
 }
 
 /*****************************************************************************/
@@ -384,7 +389,7 @@ bearer_stats_stop (MMBaseBearer *self)
     }
 
     if (self->priv->stats_update_id) {
-        g_source_remove (self->priv->stats_update_id);
+        mm_timer_remove (self->priv->stats_update_id);
         self->priv->stats_update_id = 0;
     }
 }
@@ -445,9 +450,11 @@ bearer_stats_start (MMBaseBearer *self,
 
     /* Schedule */
     g_assert (!self->priv->stats_update_id);
-    self->priv->stats_update_id = g_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
-                                                         (GSourceFunc) stats_update_cb,
-                                                         self);
+    self->priv->stats_update_id = mm_timer_add_seconds (MM_TIMER_CLASS_STATS,
+                                                        MM_LOG_OBJECT (self),
+                                                        BEARER_STATS_UPDATE_TIMEOUT,
+                                                        (GSourceFunc) stats_update_cb,
+                                                        self);
 
     mm_bearer_stats_set_start_date (self->priv->stats, (guint64)(g_get_real_time() / G_USEC_PER_SEC));
     mm_bearer_stats_set_uplink_speed (self->priv->stats, uplink_speed);
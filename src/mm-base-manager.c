@@ -35,6 +35,7 @@
 # include "mm-kernel-device-udev.h"
 #endif
 #include "mm-kernel-device-generic.h"
+#include "mm-kernel-device-helpers.h"
 
 #include <ModemManager.h>
 #include <ModemManager-tags.h>
@@ -53,6 +54,9 @@
 #include "mm-filter.h"
 #include "mm-log-object.h"
 #include "mm-base-modem.h"
+#include "mm-iface-modem.h"
+#include "mm-iface-modem-signal.h"
+#include "mm-main-loop-monitor.h"
 
 static void initable_iface_init   (GInitableIface       *iface);
 static void log_object_iface_init (MMLogObjectInterface *iface);
@@ -94,6 +98,8 @@ struct _MMBaseManagerPrivate {
     MMFilter *filter;
     /* The container of devices being prepared */
     GHashTable *devices;
+    /* Index of the devices owning each port grabbed */
+    MMKernelDevicePortIndex *ports;
     /* The Object Manager server */
     GDBusObjectManagerServer *object_manager;
     /* The map of inhibited devices */
@@ -101,6 +107,8 @@ struct _MMBaseManagerPrivate {
 
     /* The Test interface support */
     MmGdbusTest *test_skeleton;
+    /* The Debug interface support */
+    MmGdbusDebug *debug_skeleton;
 
 #if defined WITH_UDEV
     /* The UDev client */
@@ -114,20 +122,32 @@ struct _MMBaseManagerPrivate {
 
 /*****************************************************************************/
 
+static MMDevice *
+find_device_by_physdev_uid (MMBaseManager *self,
+                            const gchar   *physdev_uid)
+{
+    return g_hash_table_lookup (self->priv->devices, physdev_uid);
+}
+
+/* Only devices in the tracking table are considered, the index may still
+ * refer to devices already removed from it */
+static gboolean
+device_is_tracked (MMBaseManager *self,
+                   MMDevice      *device)
+{
+    return (device && find_device_by_physdev_uid (self, mm_device_get_uid (device)) == device);
+}
+
 static MMDevice *
 find_device_by_modem (MMBaseManager *manager,
                       MMBaseModem *modem)
 {
-    GHashTableIter iter;
-    gpointer key, value;
-
-    g_hash_table_iter_init (&iter, manager->priv->devices);
-    while (g_hash_table_iter_next (&iter, &key, &value)) {
-        MMDevice *candidate = MM_DEVICE (value);
+    MMDevice *candidate;
 
-        if (modem == mm_device_peek_modem (candidate))
-            return candidate;
-    }
+    /* The modem keeps the uid of the device it was created for */
+    candidate = find_device_by_physdev_uid (manager, mm_base_modem_get_device (modem));
+    if (candidate && modem == mm_device_peek_modem (candidate))
+        return candidate;
     return NULL;
 }
 
@@ -135,12 +155,28 @@ static MMDevice *
 find_device_by_port (MMBaseManager  *manager,
                      MMKernelDevice *port)
 {
-    GHashTableIter iter;
-    gpointer key, value;
+    MMDevice       *candidate;
+    GHashTableIter  iter;
+    gpointer        key, value;
+
+    candidate = mm_kernel_device_port_index_lookup_name (manager->priv->ports,
+                                                         mm_kernel_device_get_subsystem (port),
+                                                         mm_kernel_device_get_name (port));
+    if (device_is_tracked (manager, candidate) && mm_device_owns_port (candidate, port))
+        return candidate;
+
+    candidate = mm_kernel_device_port_index_lookup_sysfs_path (manager->priv->ports,
+                                                               mm_kernel_device_get_sysfs_path (port));
+    if (device_is_tracked (manager, candidate) && mm_device_owns_port (candidate, port))
+        return candidate;
+
+    /* Renamed ports may match a port with a different name and sysfs path */
+    if (!mm_kernel_device_has_property (port, "DEVPATH_OLD"))
+        return NULL;
 
     g_hash_table_iter_init (&iter, manager->priv->devices);
     while (g_hash_table_iter_next (&iter, &key, &value)) {
-        MMDevice *candidate = MM_DEVICE (value);
+        candidate = MM_DEVICE (value);
 
         if (mm_device_owns_port (candidate, port))
             return candidate;
@@ -153,24 +189,62 @@ find_device_by_port_name (MMBaseManager *manager,
                           const gchar   *subsystem,
                           const gchar   *name)
 {
-    GHashTableIter iter;
-    gpointer key, value;
-
-    g_hash_table_iter_init (&iter, manager->priv->devices);
-    while (g_hash_table_iter_next (&iter, &key, &value)) {
-        MMDevice *candidate = MM_DEVICE (value);
+    MMDevice *candidate;
 
-        if (mm_device_owns_port_name (candidate, subsystem, name))
-            return candidate;
-    }
+    candidate = mm_kernel_device_port_index_lookup_name (manager->priv->ports, subsystem, name);
+    if (device_is_tracked (manager, candidate) && mm_device_owns_port_name (candidate, subsystem, name))
+        return candidate;
     return NULL;
 }
 
-static MMDevice *
-find_device_by_physdev_uid (MMBaseManager *self,
-                            const gchar   *physdev_uid)
+static void
+device_port_grabbed (MMBaseManager  *self,
+                     MMKernelDevice *port,
+                     MMDevice       *device)
 {
-    return g_hash_table_lookup (self->priv->devices, physdev_uid);
+    mm_kernel_device_port_index_add (self->priv->ports,
+                                     mm_kernel_device_get_subsystem (port),
+                                     mm_kernel_device_get_name (port),
+                                     mm_kernel_device_get_sysfs_path (port),
+                                     device);
+}
+
+static void
+device_port_released (MMBaseManager  *self,
+                      MMKernelDevice *port,
+                      MMDevice       *device)
+{
+    mm_kernel_device_port_index_remove (self->priv->ports,
+                                        mm_kernel_device_get_subsystem (port),
+                                        mm_kernel_device_get_name (port),
+                                        mm_kernel_device_get_sysfs_path (port),
+                                        device);
+}
+
+static void
+remove_device (MMBaseManager *self,
+               const gchar   *physdev_uid)
+{
+    MMDevice *device;
+
+    device = find_device_by_physdev_uid (self, physdev_uid);
+    if (!device)
+        return;
+
+    /* The index must never refer to devices not in the tracking table */
+    mm_kernel_device_port_index_remove_owner (self->priv->ports, device);
+    g_hash_table_remove (self->priv->devices, physdev_uid);
+}
+
+static void
+track_device_ports (MMBaseManager *self,
+                    MMDevice      *device)
+{
+    /* The device is given as last argument to the swapped handlers */
+    g_signal_connect_object (device, MM_DEVICE_PORT_GRABBED,
+                             G_CALLBACK (device_port_grabbed), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object (device, MM_DEVICE_PORT_RELEASED,
+                             G_CALLBACK (device_port_released), self, G_CONNECT_SWAPPED);
 }
 
 /*****************************************************************************/
@@ -207,7 +281,7 @@ device_support_check_ready (MMPluginManager          *plugin_manager,
         mm_obj_info (ctx->self, "couldn't check support for device '%s': %s",
                      mm_device_get_uid (ctx->device), error->message);
         g_error_free (error);
-        g_hash_table_remove (ctx->self->priv->devices, mm_device_get_uid (ctx->device));
+        remove_device (ctx->self, mm_device_get_uid (ctx->device));
         find_device_support_context_free (ctx);
         return;
     }
@@ -220,7 +294,7 @@ device_support_check_ready (MMPluginManager          *plugin_manager,
         mm_obj_warn (ctx->self, "couldn't create modem for device '%s': %s",
                      mm_device_get_uid (ctx->device), error->message);
         g_error_free (error);
-        g_hash_table_remove (ctx->self->priv->devices, mm_device_get_uid (ctx->device));
+        remove_device (ctx->self, mm_device_get_uid (ctx->device));
         find_device_support_context_free (ctx);
         return;
     }
@@ -279,7 +353,7 @@ device_removed (MMBaseManager *self,
         /* The device may have already been removed from the tracking HT, we
          * just try to remove it and if it fails, we ignore it */
         mm_device_remove_modem (device);
-        g_hash_table_remove (self->priv->devices, mm_device_get_uid (device));
+        remove_device (self, mm_device_get_uid (device));
     }
 }
 
@@ -354,6 +428,7 @@ device_added (MMBaseManager  *self,
         g_hash_table_insert (self->priv->devices,
                              g_strdup (physdev_uid),
                              device);
+        track_device_ports (self, device);
 
         /* Launch device support check */
         ctx = g_slice_new (FindDeviceSupportContext);
@@ -651,7 +726,7 @@ remove_disable_ready (MMBaseModem *modem,
     if (device) {
         g_cancellable_cancel (mm_base_modem_peek_cancellable (modem));
         mm_device_remove_modem (device);
-        g_hash_table_remove (self->priv->devices, mm_device_get_uid (device));
+        remove_device (self, mm_device_get_uid (device));
     }
 }
 
@@ -678,6 +753,7 @@ foreach_remove (gpointer key,
     if (modem)
         g_cancellable_cancel (mm_base_modem_peek_cancellable (modem));
     mm_device_remove_modem (device);
+    mm_kernel_device_port_index_remove_owner (self->priv->ports, device);
     return TRUE;
 }
 
@@ -1315,6 +1391,7 @@ handle_set_profile (MmGdbusTest *skeleton,
     /* Create device and keep it listed in the Manager */
     physdev_uid = g_strdup_printf ("/virtual/%s", id);
     device = mm_device_new (physdev_uid, TRUE, TRUE, self->priv->object_manager);
+    remove_device (self, physdev_uid);
     g_hash_table_insert (self->priv->devices, physdev_uid, device);
 
     /* Grab virtual ports */
@@ -1349,7 +1426,7 @@ out:
 
     if (error) {
         mm_device_remove_modem (device);
-        g_hash_table_remove (self->priv->devices, mm_device_get_uid (device));
+        remove_device (self, mm_device_get_uid (device));
         g_dbus_method_invocation_return_gerror (invocation, error);
         g_error_free (error);
     } else
@@ -1358,6 +1435,89 @@ out:
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Debug stats */
+
+static GVariant *
+build_modem_stats (MMDevice *device)
+{
+    GVariantBuilder    builder;
+    MMBaseModem       *modem;
+    GVariant          *probing_timings;
+    const gchar       *path;
+    MMSignalReportMode mode = MM_SIGNAL_REPORT_MODE_NONE;
+    guint              n_indications = 0;
+    guint              n_polls = 0;
+
+    modem = mm_device_peek_modem (device);
+    if (!modem)
+        return NULL;
+
+    path = g_dbus_object_get_object_path (G_DBUS_OBJECT (modem));
+    if (!path)
+        return NULL;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "path", g_variant_new_object_path (path));
+
+    probing_timings = mm_device_peek_probing_timings (device);
+    if (probing_timings)
+        g_variant_builder_add (&builder, "{sv}", "probing-timings", probing_timings);
+
+    if (MM_IS_IFACE_MODEM (modem)) {
+        mm_iface_modem_get_signal_report_stats (MM_IFACE_MODEM (modem), &mode, &n_indications, &n_polls);
+        g_variant_builder_add (&builder, "{sv}", "signal-report-mode", g_variant_new_string (mm_signal_report_mode_get_string (mode)));
+        g_variant_builder_add (&builder, "{sv}", "signal-indications", g_variant_new_uint32 (n_indications));
+        g_variant_builder_add (&builder, "{sv}", "signal-polls", g_variant_new_uint32 (n_polls));
+    }
+
+    if (MM_IS_IFACE_MODEM_SIGNAL (modem)) {
+        mm_iface_modem_signal_get_report_stats (MM_IFACE_MODEM_SIGNAL (modem), &n_indications, &n_polls);
+        g_variant_builder_add (&builder, "{sv}", "extended-signal-indications", g_variant_new_uint32 (n_indications));
+        g_variant_builder_add (&builder, "{sv}", "extended-signal-polls", g_variant_new_uint32 (n_polls));
+    }
+
+    return g_variant_builder_end (&builder);
+}
+
+static gboolean
+handle_get_stats (MmGdbusDebug          *skeleton,
+                  GDBusMethodInvocation *invocation,
+                  MMBaseManager         *self)
+{
+    g_autoptr(GVariant)  main_loop_stats = NULL;
+    GVariantBuilder      builder;
+    GVariantBuilder      modems_builder;
+    GVariantIter         iter;
+    GHashTableIter       devices_iter;
+    const gchar         *key;
+    GVariant            *value;
+    gpointer             device;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
+    main_loop_stats = g_variant_ref_sink (mm_main_loop_monitor_get_stats ());
+    g_variant_iter_init (&iter, main_loop_stats);
+    while (g_variant_iter_next (&iter, "{&sv}", &key, &value)) {
+        g_variant_builder_add (&builder, "{sv}", key, value);
+        g_variant_unref (value);
+    }
+
+    g_variant_builder_init (&modems_builder, G_VARIANT_TYPE ("aa{sv}"));
+    g_hash_table_iter_init (&devices_iter, self->priv->devices);
+    while (g_hash_table_iter_next (&devices_iter, NULL, &device)) {
+        GVariant *modem_stats;
+
+        modem_stats = build_modem_stats (MM_DEVICE (device));
+        if (modem_stats)
+            g_variant_builder_add_value (&modems_builder, modem_stats);
+    }
+    g_variant_builder_add (&builder, "{sv}", "modems", g_variant_builder_end (&modems_builder));
+
+    mm_gdbus_debug_complete_get_stats (skeleton, invocation, g_variant_builder_end (&builder));
+    return TRUE;
+}
+
 /*****************************************************************************/
 
 static gchar *
@@ -1420,6 +1580,11 @@ set_property (GObject      *object,
                 mm_obj_dbg (self, "stopping connection in test skeleton");
                 g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self->priv->test_skeleton));
             }
+            if (self->priv->debug_skeleton &&
+                g_dbus_interface_skeleton_get_connection (G_DBUS_INTERFACE_SKELETON (self->priv->debug_skeleton))) {
+                mm_obj_dbg (self, "stopping connection in debug skeleton");
+                g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self->priv->debug_skeleton));
+            }
         }
         break;
     }
@@ -1491,6 +1656,7 @@ mm_base_manager_init (MMBaseManager *self)
 
     /* Setup internal lists of device objects */
     self->priv->devices = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    self->priv->ports = mm_kernel_device_port_index_new ();
 
     /* Setup internal list of inhibited devices */
     self->priv->inhibited_devices = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)inhibited_device_info_free);
@@ -1579,6 +1745,20 @@ initable_init (GInitable     *initable,
             return FALSE;
     }
 
+    /* Setup the Debug skeleton and export the interface */
+    if (mm_context_get_debug ()) {
+        self->priv->debug_skeleton = mm_gdbus_debug_skeleton_new ();
+        g_signal_connect (self->priv->debug_skeleton,
+                          "handle-get-stats",
+                          G_CALLBACK (handle_get_stats),
+                          self);
+        if (!g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (self->priv->debug_skeleton),
+                                               self->priv->connection,
+                                               MM_DBUS_PATH,
+                                               error))
+            return FALSE;
+    }
+
     /* All good */
     return TRUE;
 }
@@ -1593,6 +1773,7 @@ finalize (GObject *object)
 
     g_hash_table_destroy (self->priv->inhibited_devices);
     g_hash_table_destroy (self->priv->devices);
+    mm_kernel_device_port_index_free (self->priv->ports);
 
 #if defined WITH_UDEV
     if (self->priv->udev)
@@ -1616,6 +1797,9 @@ finalize (GObject *object)
     if (self->priv->test_skeleton)
         g_object_unref (self->priv->test_skeleton);
 
+    if (self->priv->debug_skeleton)
+        g_object_unref (self->priv->debug_skeleton);
+
     if (self->priv->connection)
         g_object_unref (self->priv->connection);
 
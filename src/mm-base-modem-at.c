@@ -102,6 +102,9 @@ typedef struct {
     gpointer                    response_processor_context;
     GDestroyNotify              response_processor_context_free;
     GVariant                   *result;
+    MMPortSerialCommandPriority priority;
+    /* Cache mode of the commands not allowing any cached reply */
+    MMPortSerialCacheMode       cache_mode;
 } AtSequenceContext;
 
 static void
@@ -216,12 +219,13 @@ at_sequence_parse_response (MMPortSerialAt    *port,
         ctx->current++;
         if (ctx->current->command) {
             /* Schedule the next command in the probing group */
-            mm_port_serial_at_command (
+            mm_port_serial_at_command_full (
                 ctx->port,
                 ctx->current->command,
                 ctx->current->timeout,
                 FALSE,
-                ctx->current->allow_cached,
+                ctx->current->allow_cached ? MM_PORT_SERIAL_CACHE_MODE_ANY : ctx->cache_mode,
+                ctx->priority,
                 ctx->cancellable,
                 (GAsyncReadyCallback)at_sequence_parse_response,
                 ctx);
@@ -251,15 +255,17 @@ at_sequence_parse_response (MMPortSerialAt    *port,
     g_object_unref (simple);
 }
 
-void
-mm_base_modem_at_sequence_full (MMBaseModem                *self,
-                                MMPortSerialAt             *port,
-                                const MMBaseModemAtCommand *sequence,
-                                gpointer                    response_processor_context,
-                                GDestroyNotify              response_processor_context_free,
-                                GCancellable               *cancellable,
-                                GAsyncReadyCallback         callback,
-                                gpointer                    user_data)
+static void
+at_sequence_common (MMBaseModem                 *self,
+                    MMPortSerialAt              *port,
+                    const MMBaseModemAtCommand  *sequence,
+                    gpointer                     response_processor_context,
+                    GDestroyNotify               response_processor_context_free,
+                    MMPortSerialCommandPriority  priority,
+                    MMPortSerialCacheMode        cache_mode,
+                    GCancellable                *cancellable,
+                    GAsyncReadyCallback          callback,
+                    gpointer                     user_data)
 {
     AtSequenceContext *ctx;
 
@@ -278,6 +284,8 @@ mm_base_modem_at_sequence_full (MMBaseModem                *self,
     ctx->current = ctx->sequence = sequence;
     ctx->response_processor_context = response_processor_context;
     ctx->response_processor_context_free = response_processor_context_free;
+    ctx->priority = priority;
+    ctx->cache_mode = cache_mode;
 
     /* Setup cancellables */
     ctx->modem_cancellable = mm_base_modem_get_cancellable (self);
@@ -296,17 +304,40 @@ mm_base_modem_at_sequence_full (MMBaseModem                *self,
     }
 
     /* Go on with the first one in the sequence */
-    mm_port_serial_at_command (
+    mm_port_serial_at_command_full (
         ctx->port,
         ctx->current->command,
         ctx->current->timeout,
         FALSE,
-        ctx->current->allow_cached,
+        ctx->current->allow_cached ? MM_PORT_SERIAL_CACHE_MODE_ANY : ctx->cache_mode,
+        ctx->priority,
         ctx->cancellable,
         (GAsyncReadyCallback)at_sequence_parse_response,
         ctx);
 }
 
+void
+mm_base_modem_at_sequence_full (MMBaseModem                *self,
+                                MMPortSerialAt             *port,
+                                const MMBaseModemAtCommand *sequence,
+                                gpointer                    response_processor_context,
+                                GDestroyNotify              response_processor_context_free,
+                                GCancellable               *cancellable,
+                                GAsyncReadyCallback         callback,
+                                gpointer                    user_data)
+{
+    at_sequence_common (self,
+                        port,
+                        sequence,
+                        response_processor_context,
+                        response_processor_context_free,
+                        MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                        MM_PORT_SERIAL_CACHE_MODE_NONE,
+                        cancellable,
+                        callback,
+                        user_data);
+}
+
 GVariant *
 mm_base_modem_at_sequence_finish (MMBaseModem *self,
                                   GAsyncResult *res,
@@ -353,6 +384,42 @@ mm_base_modem_at_sequence (MMBaseModem *self,
         user_data);
 }
 
+void
+mm_base_modem_at_sequence_polling (MMBaseModem                *self,
+                                   MMPortSerialAt             *port,
+                                   const MMBaseModemAtCommand *sequence,
+                                   gpointer                    response_processor_context,
+                                   GDestroyNotify              response_processor_context_free,
+                                   MMPortSerialCacheMode       cache_mode,
+                                   GAsyncReadyCallback         callback,
+                                   gpointer                    user_data)
+{
+    GError *error = NULL;
+
+    if (!port) {
+        port = mm_base_modem_peek_best_at_port_for_polling (self, &error);
+        if (!port) {
+            g_assert (error != NULL);
+            g_simple_async_report_take_gerror_in_idle (G_OBJECT (self),
+                                                       callback,
+                                                       user_data,
+                                                       error);
+            return;
+        }
+    }
+
+    at_sequence_common (self,
+                        port,
+                        sequence,
+                        response_processor_context,
+                        response_processor_context_free,
+                        MM_PORT_SERIAL_COMMAND_PRIORITY_POLLING,
+                        cache_mode,
+                        NULL,
+                        callback,
+                        user_data);
+}
+
 /*****************************************************************************/
 /* Response processor helpers */
 
@@ -539,16 +606,17 @@ at_command_ready (MMPortSerialAt *port,
     at_command_context_free (ctx);
 }
 
-void
-mm_base_modem_at_command_full (MMBaseModem *self,
-                               MMPortSerialAt *port,
-                               const gchar *command,
-                               guint timeout,
-                               gboolean allow_cached,
-                               gboolean is_raw,
-                               GCancellable *cancellable,
-                               GAsyncReadyCallback callback,
-                               gpointer user_data)
+static void
+at_command_common (MMBaseModem *self,
+                   MMPortSerialAt *port,
+                   const gchar *command,
+                   guint timeout,
+                   MMPortSerialCacheMode cache_mode,
+                   gboolean is_raw,
+                   MMPortSerialCommandPriority priority,
+                   GCancellable *cancellable,
+                   GAsyncReadyCallback callback,
+                   gpointer user_data)
 {
     AtCommandContext *ctx;
 
@@ -581,17 +649,41 @@ mm_base_modem_at_command_full (MMBaseModem *self,
     }
 
     /* Go on with the command */
-    mm_port_serial_at_command (
+    mm_port_serial_at_command_full (
         port,
         command,
         timeout,
         is_raw,
-        allow_cached,
+        cache_mode,
+        priority,
         ctx->cancellable,
         (GAsyncReadyCallback)at_command_ready,
         ctx);
 }
 
+void
+mm_base_modem_at_command_full (MMBaseModem *self,
+                               MMPortSerialAt *port,
+                               const gchar *command,
+                               guint timeout,
+                               gboolean allow_cached,
+                               gboolean is_raw,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+    at_command_common (self,
+                       port,
+                       command,
+                       timeout,
+                       allow_cached ? MM_PORT_SERIAL_CACHE_MODE_ANY : MM_PORT_SERIAL_CACHE_MODE_NONE,
+                       is_raw,
+                       MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                       cancellable,
+                       callback,
+                       user_data);
+}
+
 const gchar *
 mm_base_modem_at_command_finish (MMBaseModem *self,
                                  GAsyncResult *res,
@@ -656,6 +748,41 @@ mm_base_modem_at_command_raw (MMBaseModem *self,
     _at_command (self, command, timeout, allow_cached, TRUE, callback, user_data);
 }
 
+void
+mm_base_modem_at_command_polling (MMBaseModem *self,
+                                  MMPortSerialAt *port,
+                                  const gchar *command,
+                                  guint timeout,
+                                  MMPortSerialCacheMode cache_mode,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    GError *error = NULL;
+
+    if (!port) {
+        port = mm_base_modem_peek_best_at_port_for_polling (self, &error);
+        if (!port) {
+            g_assert (error != NULL);
+            g_simple_async_report_take_gerror_in_idle (G_OBJECT (self),
+                                                       callback,
+                                                       user_data,
+                                                       error);
+            return;
+        }
+    }
+
+    at_command_common (self,
+                       port,
+                       command,
+                       timeout,
+                       cache_mode,
+                       FALSE,
+                       MM_PORT_SERIAL_COMMAND_PRIORITY_POLLING,
+                       NULL,
+                       callback,
+                       user_data);
+}
+
 void
 mm_base_modem_at_command_alloc_clear (MMBaseModemAtCommandAlloc *command)
 {
@@ -97,6 +97,19 @@ GVariant *mm_base_modem_at_sequence_full_finish (MMBaseModem *self,
                                                  gpointer *response_processor_context,
                                                  GError **error);
 
+/* AT sequence handling for periodic state polling, with polling priority.
+ * If no port is given, the best one for polling is used. The cache mode
+ * applies to the commands in the sequence not allowing any cached reply.
+ * Finish with mm_base_modem_at_sequence_full_finish(). */
+void     mm_base_modem_at_sequence_polling      (MMBaseModem *self,
+                                                 MMPortSerialAt *port,
+                                                 const MMBaseModemAtCommand *sequence,
+                                                 gpointer response_processor_context,
+                                                 GDestroyNotify response_processor_context_free,
+                                                 MMPortSerialCacheMode cache_mode,
+                                                 GAsyncReadyCallback callback,
+                                                 gpointer user_data);
+
 /* Common helper response processors */
 
 /*
@@ -210,6 +223,17 @@ const gchar *mm_base_modem_at_command_full_finish (MMBaseModem *self,
                                                    GAsyncResult *res,
                                                    GError **error);
 
+/* AT command handling for periodic state polling, with polling priority.
+ * If no port is given, the best one for polling is used. Finish with
+ * mm_base_modem_at_command_full_finish(). */
+void mm_base_modem_at_command_polling             (MMBaseModem *self,
+                                                   MMPortSerialAt *port,
+                                                   const gchar *command,
+                                                   guint timeout,
+                                                   MMPortSerialCacheMode cache_mode,
+                                                   GAsyncReadyCallback callback,
+                                                   gpointer user_data);
+
 /******************************************************************************/
 /* Support for MMBaseModemAtCommand with heap allocated contents */
 
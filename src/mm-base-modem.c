@@ -96,6 +96,9 @@ struct _MMBaseModemPrivate {
 
     guint max_timeouts;
 
+    /* Monotonic time when initialization was started */
+    gint64 initialize_start;
+
     /* The authorization provider */
     MMAuthProvider *authp;
     GCancellable *authp_cancellable;
@@ -806,6 +809,7 @@ mm_base_modem_initialize (MMBaseModem *self,
     g_assert (MM_BASE_MODEM_GET_CLASS (self)->initialize != NULL);
     g_assert (MM_BASE_MODEM_GET_CLASS (self)->initialize_finish != NULL);
 
+    self->priv->initialize_start = g_get_monotonic_time ();
     MM_BASE_MODEM_GET_CLASS (self)->initialize (
         self,
         self->priv->cancellable,
@@ -1061,6 +1065,27 @@ mm_base_modem_peek_best_at_port (MMBaseModem *self,
     return NULL;
 }
 
+MMPortSerialAt *
+mm_base_modem_peek_best_at_port_for_polling (MMBaseModem *self,
+                                             GError **error)
+{
+    MMPortSerialAt *best;
+
+    best = mm_base_modem_peek_best_at_port (self, error);
+
+    /* Polls don't need to wait for the commands already queued in the
+     * primary port if the secondary port is idle */
+    if (best &&
+        best == self->priv->primary &&
+        self->priv->secondary &&
+        !mm_port_get_connected (MM_PORT (self->priv->secondary)) &&
+        mm_port_serial_get_queue_depth (MM_PORT_SERIAL (best)) > 0 &&
+        mm_port_serial_get_queue_depth (MM_PORT_SERIAL (self->priv->secondary)) == 0)
+        return self->priv->secondary;
+
+    return best;
+}
+
 gboolean
 mm_base_modem_has_at_port (MMBaseModem *self)
 {
@@ -1227,9 +1252,12 @@ initialize_ready (MMBaseModem *self,
                   GAsyncResult *res)
 {
     GError *error = NULL;
+    gdouble elapsed;
+
+    elapsed = (gdouble) (g_get_monotonic_time () - self->priv->initialize_start) / G_USEC_PER_SEC;
 
     if (mm_base_modem_initialize_finish (self, res, &error)) {
-        mm_obj_dbg (self, "modem initialized");
+        mm_obj_info (self, "modem initialized in %.3f seconds", elapsed);
         mm_base_modem_set_valid (self, TRUE);
         return;
     }
@@ -1239,7 +1267,7 @@ initialize_ready (MMBaseModem *self,
         /* Even with initialization errors, we do set the state to valid, so
          * that the modem gets exported and the failure notified to the user.
          */
-        mm_obj_dbg (self, "couldn't finish initialization in the current state: '%s'", error->message);
+        mm_obj_dbg (self, "couldn't finish initialization in the current state after %.3f seconds: '%s'", elapsed, error->message);
         g_error_free (error);
         mm_base_modem_set_valid (self, TRUE);
         return;
@@ -1505,6 +1533,11 @@ mm_base_modem_organize_ports (MMBaseModem *self,
 
     self->priv->primary = (primary ? g_object_ref (primary) : NULL);
     self->priv->secondary = (secondary ? g_object_ref (secondary) : NULL);
+
+    /* Both AT ports talk to the same device, so replies can be reused from
+     * either one */
+    if (primary && secondary)
+        mm_port_serial_share_reply_cache (MM_PORT_SERIAL (primary), MM_PORT_SERIAL (secondary));
     self->priv->qcdm = (qcdm ? g_object_ref (qcdm) : NULL);
     self->priv->gps_control = (gps_control ? g_object_ref (gps_control) : NULL);
     self->priv->gps = (gps ? g_object_ref (gps) : NULL);
@@ -5886,6 +5886,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                     gboolean             is_ps_supported,
                                     gboolean             is_eps_supported,
                                     gboolean             is_5gs_supported,
+                                    gboolean             is_polling,
                                     GAsyncReadyCallback  callback,
                                     gpointer             user_data)
 {
@@ -9340,6 +9341,10 @@ mm_broadband_modem_mbim_class_init (MMBroadbandModemMbimClass *klass)
     /* Do not initialize the MBIM modem through AT commands */
     broadband_modem_class->enabling_modem_init = NULL;
     broadband_modem_class->enabling_modem_init_finish = NULL;
+    /* Requests of different services may be in flight at the same time in
+     * the MBIM port, but keep it low as some devices process them one by
+     * one anyway */
+    broadband_modem_class->initialization_max_parallel_ifaces = 2;
 
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
     g_object_class_install_property (object_class, PROP_QMI_UNSUPPORTED,
@@ -1596,7 +1596,7 @@ get_signal_strength_ready (QmiClientNas *client,
 
     /* We update the access technologies directly here when loading signal
      * quality. It goes a bit out of context, but we can do it nicely */
-    mm_iface_modem_update_access_technologies (
+    mm_iface_modem_update_polled_access_technologies (
         MM_IFACE_MODEM (self),
         act,
         (MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK | MM_IFACE_MODEM_CDMA_ALL_ACCESS_TECHNOLOGIES_MASK));
@@ -1670,7 +1670,7 @@ get_signal_info_ready (QmiClientNas *client,
 
     /* We update the access technologies directly here when loading signal
      * quality. It goes a bit out of context, but we can do it nicely */
-    mm_iface_modem_update_access_technologies (
+    mm_iface_modem_update_polled_access_technologies (
         MM_IFACE_MODEM (self),
         act,
         (MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK | MM_IFACE_MODEM_CDMA_ALL_ACCESS_TECHNOLOGIES_MASK));
@@ -3969,6 +3969,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                     gboolean             is_ps_supported,
                                     gboolean             is_eps_supported,
                                     gboolean             is_5gs_supported,
+                                    gboolean             is_polling,
                                     GAsyncReadyCallback  callback,
                                     gpointer             user_data)
 {
@@ -13143,4 +13144,7 @@ mm_broadband_modem_qmi_class_init (MMBroadbandModemQmiClass *klass)
     /* Do not initialize the QMI modem through AT commands */
     broadband_modem_class->enabling_modem_init = NULL;
     broadband_modem_class->enabling_modem_init_finish = NULL;
+    /* Interfaces mostly use their own QMI clients (LOC, WMS, NAS...), which
+     * may have requests in flight at the same time */
+    broadband_modem_class->initialization_max_parallel_ifaces = 4;
 }
@@ -126,6 +126,7 @@ enum {
     PROP_MODEM_MESSAGING_SMS_PDU_MODE,
     PROP_MODEM_MESSAGING_SMS_DEFAULT_STORAGE,
     PROP_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS,
+    PROP_MODEM_LOCATION_UPDATE_WINDOW,
     PROP_MODEM_VOICE_CALL_LIST,
     PROP_MODEM_SIMPLE_STATUS,
     PROP_MODEM_SIM_HOT_SWAP_SUPPORTED,
@@ -232,6 +233,7 @@ struct _MMBroadbandModemPrivate {
     /* Properties */
     GObject *modem_location_dbus_skeleton;
     gboolean modem_location_allow_gps_unmanaged_always;
+    guint modem_location_update_window;
 
     /*<--- Modem Messaging interface --->*/
     /* Properties */
@@ -2143,13 +2145,13 @@ signal_quality_csq (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    mm_base_modem_at_sequence_full (
+    mm_base_modem_at_sequence_polling (
         MM_BASE_MODEM (self),
         MM_PORT_SERIAL_AT (ctx->at_port),
         signal_quality_csq_sequence,
         NULL, /* response_processor_context */
         NULL, /* response_processor_context_free */
-        NULL, /* cancellable */
+        MM_PORT_SERIAL_CACHE_MODE_RECENT,
         (GAsyncReadyCallback)signal_quality_csq_ready,
         task);
 }
@@ -2239,15 +2241,13 @@ signal_quality_cind (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    mm_base_modem_at_command_full (MM_BASE_MODEM (self),
-                                   MM_PORT_SERIAL_AT (ctx->at_port),
-                                   "+CIND?",
-                                   5,
-                                   FALSE,
-                                   FALSE, /* raw */
-                                   NULL, /* cancellable */
-                                   (GAsyncReadyCallback)signal_quality_cind_ready,
-                                   task);
+    mm_base_modem_at_command_polling (MM_BASE_MODEM (self),
+                                      MM_PORT_SERIAL_AT (ctx->at_port),
+                                      "+CIND?",
+                                      5,
+                                      MM_PORT_SERIAL_CACHE_MODE_RECENT,
+                                      (GAsyncReadyCallback)signal_quality_cind_ready,
+                                      task);
 }
 
 static void
@@ -2365,8 +2365,9 @@ modem_load_signal_quality (MMIfaceModem *_self,
     g_task_set_task_data (task, ctx, (GDestroyNotify)signal_quality_context_free);
 
     /* Check whether we can get a non-connected AT port */
-    ctx->at_port = (MMPortSerial *)mm_base_modem_get_best_at_port (MM_BASE_MODEM (self), &error);
+    ctx->at_port = (MMPortSerial *)mm_base_modem_peek_best_at_port_for_polling (MM_BASE_MODEM (self), &error);
     if (ctx->at_port) {
+        g_object_ref (ctx->at_port);
         if (!self->priv->modem_cind_disabled &&
             self->priv->modem_cind_supported &&
             CIND_INDICATOR_IS_VALID (self->priv->modem_cind_indicator_signal_quality))
@@ -4967,6 +4968,7 @@ typedef struct {
     gboolean run_ps;
     gboolean run_eps;
     gboolean run_5gs;
+    gboolean is_polling;
     gboolean running_cs;
     gboolean running_ps;
     gboolean running_eps;
@@ -5154,6 +5156,36 @@ registration_status_check_ready (MMBroadbandModem *self,
     run_registration_checks_context_step (task);
 }
 
+static void
+registration_status_check (GTask       *task,
+                           const gchar *command)
+{
+    MMBroadbandModem             *self;
+    RunRegistrationChecksContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    /* Only the periodic checks may be answered with a recent reply, with
+     * polling priority and possibly on the secondary port; the ones requested
+     * by the user or after a state change need the current state */
+    if (ctx->is_polling)
+        mm_base_modem_at_command_polling (MM_BASE_MODEM (self),
+                                          NULL,
+                                          command,
+                                          10,
+                                          MM_PORT_SERIAL_CACHE_MODE_RECENT,
+                                          (GAsyncReadyCallback)registration_status_check_ready,
+                                          task);
+    else
+        mm_base_modem_at_command (MM_BASE_MODEM (self),
+                                  command,
+                                  10,
+                                  FALSE,
+                                  (GAsyncReadyCallback)registration_status_check_ready,
+                                  task);
+}
+
 static void
 run_registration_checks_context_step (GTask *task)
 {
@@ -5173,12 +5205,7 @@ run_registration_checks_context_step (GTask *task)
         ctx->running_cs = TRUE;
         ctx->run_cs = FALSE;
         /* Check current CS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
+        registration_status_check (task, "+CREG?");
         return;
     }
 
@@ -5186,12 +5213,7 @@ run_registration_checks_context_step (GTask *task)
         ctx->running_ps = TRUE;
         ctx->run_ps = FALSE;
         /* Check current PS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CGREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
+        registration_status_check (task, "+CGREG?");
         return;
     }
 
@@ -5199,12 +5221,7 @@ run_registration_checks_context_step (GTask *task)
         ctx->running_eps = TRUE;
         ctx->run_eps = FALSE;
         /* Check current EPS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CEREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
+        registration_status_check (task, "+CEREG?");
         return;
     }
 
@@ -5212,12 +5229,7 @@ run_registration_checks_context_step (GTask *task)
         ctx->running_5gs = TRUE;
         ctx->run_5gs = FALSE;
         /* Check current 5GS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+C5GREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
+        registration_status_check (task, "+C5GREG?");
         return;
     }
 
@@ -5253,6 +5265,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                     gboolean             is_ps_supported,
                                     gboolean             is_eps_supported,
                                     gboolean             is_5gs_supported,
+                                    gboolean             is_polling,
                                     GAsyncReadyCallback  callback,
                                     gpointer             user_data)
 {
@@ -5268,6 +5281,7 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
     ctx->run_ps = is_ps_supported;
     ctx->run_eps = is_eps_supported;
     ctx->run_5gs = is_5gs_supported;
+    ctx->is_polling = is_polling;
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)run_registration_checks_context_free);
@@ -12256,27 +12270,28 @@ typedef enum {
     INITIALIZE_STEP_IFACE_MODEM,
     INITIALIZE_STEP_IFACE_3GPP,
     INITIALIZE_STEP_JUMP_TO_LIMITED,
-    INITIALIZE_STEP_IFACE_3GPP_PROFILE_MANAGER,
-    INITIALIZE_STEP_IFACE_3GPP_USSD,
     INITIALIZE_STEP_IFACE_CDMA,
-    INITIALIZE_STEP_IFACE_LOCATION,
-    INITIALIZE_STEP_IFACE_MESSAGING,
-    INITIALIZE_STEP_IFACE_TIME,
-    INITIALIZE_STEP_IFACE_SIGNAL,
-    INITIALIZE_STEP_IFACE_OMA,
-    INITIALIZE_STEP_IFACE_SAR,
+    INITIALIZE_STEP_IFACES,
     INITIALIZE_STEP_FALLBACK_LIMITED,
-    INITIALIZE_STEP_IFACE_VOICE,
-    INITIALIZE_STEP_IFACE_FIRMWARE,
+    INITIALIZE_STEP_IFACES_LIMITED,
     INITIALIZE_STEP_SIM_HOT_SWAP,
     INITIALIZE_STEP_IFACE_SIMPLE,
     INITIALIZE_STEP_LAST,
 } InitializeStep;
 
+typedef struct _InitializeIface InitializeIface;
+
 typedef struct {
     MMBroadbandModem *self;
     InitializeStep step;
     gpointer ports_ctx;
+
+    /* Group of interfaces being initialized */
+    const InitializeIface *ifaces;
+    guint                  n_ifaces;
+    guint                  next_iface;
+    guint                  n_ifaces_in_flight;
+    gboolean               launching_ifaces;
 } InitializeContext;
 
 static void initialize_step (GTask *task);
@@ -12432,18 +12447,239 @@ iface_modem_initialize_ready (MMBroadbandModem *self,
         initialize_step (task);                                         \
     }
 
-INTERFACE_INIT_READY_FN (iface_modem_3gpp,                 MM_IFACE_MODEM_3GPP,                 TRUE)
-INTERFACE_INIT_READY_FN (iface_modem_3gpp_profile_manager, MM_IFACE_MODEM_3GPP_PROFILE_MANAGER, FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_3gpp_ussd,            MM_IFACE_MODEM_3GPP_USSD,            FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_cdma,                 MM_IFACE_MODEM_CDMA,                 TRUE)
-INTERFACE_INIT_READY_FN (iface_modem_location,             MM_IFACE_MODEM_LOCATION,             FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_messaging,            MM_IFACE_MODEM_MESSAGING,            FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_voice,                MM_IFACE_MODEM_VOICE,                FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_time,                 MM_IFACE_MODEM_TIME,                 FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_signal,               MM_IFACE_MODEM_SIGNAL,               FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_oma,                  MM_IFACE_MODEM_OMA,                  FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_firmware,             MM_IFACE_MODEM_FIRMWARE,             FALSE)
-INTERFACE_INIT_READY_FN (iface_modem_sar,                  MM_IFACE_MODEM_SAR,                  FALSE)
+INTERFACE_INIT_READY_FN (iface_modem_3gpp, MM_IFACE_MODEM_3GPP, TRUE)
+INTERFACE_INIT_READY_FN (iface_modem_cdma, MM_IFACE_MODEM_CDMA, TRUE)
+
+/*
+ * Once the Modem interface and the 3GPP or CDMA interfaces are initialized,
+ * the remaining interfaces only depend on the info loaded by those, not on
+ * each other, and their errors are never fatal. Each group of them is run
+ * by a small scheduler that keeps up to initialization_max_parallel_ifaces
+ * of them being initialized at the same time. Modems controlled through AT
+ * ports keep the default of 1, so that the interfaces are initialized one
+ * after the other in the order given, as all of them would end up queueing
+ * commands in the same port anyway.
+ */
+
+struct _InitializeIface {
+    const gchar *name;
+    /* Only initialized in 3GPP modems */
+    gboolean     requires_3gpp;
+    void     (* initialize)         (MMBroadbandModem     *self,
+                                     GCancellable         *cancellable,
+                                     GAsyncReadyCallback   callback,
+                                     gpointer              user_data);
+    gboolean (* initialize_finish)  (MMBroadbandModem     *self,
+                                     GAsyncResult         *res,
+                                     GError              **error);
+    void     (* shutdown)           (MMBroadbandModem     *self);
+    void     (* bind_simple_status) (MMBroadbandModem     *self,
+                                     MMSimpleStatus       *status);
+};
+
+#undef INTERFACE_INIT_FNS
+#define INTERFACE_INIT_FNS(NAME,TYPE)                                   \
+    static gboolean                                                     \
+    NAME##_initialize_iface_finish (MMBroadbandModem  *self,            \
+                                    GAsyncResult      *res,             \
+                                    GError           **error)           \
+    {                                                                   \
+        return mm_##NAME##_initialize_finish (TYPE (self), res, error); \
+    }                                                                   \
+                                                                        \
+    static void                                                         \
+    NAME##_shutdown_iface (MMBroadbandModem *self)                      \
+    {                                                                   \
+        mm_##NAME##_shutdown (TYPE (self));                             \
+    }                                                                   \
+                                                                        \
+    static void                                                         \
+    NAME##_bind_simple_status_iface (MMBroadbandModem *self,            \
+                                     MMSimpleStatus   *status)          \
+    {                                                                   \
+        mm_##NAME##_bind_simple_status (TYPE (self), status);           \
+    }
+
+#undef INTERFACE_INIT_START_FN
+#define INTERFACE_INIT_START_FN(NAME,TYPE)                              \
+    static void                                                         \
+    NAME##_initialize_iface (MMBroadbandModem    *self,                 \
+                             GCancellable        *cancellable,          \
+                             GAsyncReadyCallback  callback,             \
+                             gpointer             user_data)            \
+    {                                                                   \
+        mm_##NAME##_initialize (TYPE (self), cancellable, callback, user_data); \
+    }
+
+/* These two don't support cancellation */
+#undef INTERFACE_INIT_START_NO_CANCELLABLE_FN
+#define INTERFACE_INIT_START_NO_CANCELLABLE_FN(NAME,TYPE)               \
+    static void                                                         \
+    NAME##_initialize_iface (MMBroadbandModem    *self,                 \
+                             GCancellable        *cancellable,          \
+                             GAsyncReadyCallback  callback,             \
+                             gpointer             user_data)            \
+    {                                                                   \
+        mm_##NAME##_initialize (TYPE (self), callback, user_data);      \
+    }
+
+INTERFACE_INIT_FNS                     (iface_modem_3gpp_profile_manager, MM_IFACE_MODEM_3GPP_PROFILE_MANAGER)
+INTERFACE_INIT_START_NO_CANCELLABLE_FN (iface_modem_3gpp_profile_manager, MM_IFACE_MODEM_3GPP_PROFILE_MANAGER)
+INTERFACE_INIT_FNS                     (iface_modem_3gpp_ussd,            MM_IFACE_MODEM_3GPP_USSD)
+INTERFACE_INIT_START_NO_CANCELLABLE_FN (iface_modem_3gpp_ussd,            MM_IFACE_MODEM_3GPP_USSD)
+INTERFACE_INIT_FNS                     (iface_modem_location,             MM_IFACE_MODEM_LOCATION)
+INTERFACE_INIT_START_FN                (iface_modem_location,             MM_IFACE_MODEM_LOCATION)
+INTERFACE_INIT_FNS                     (iface_modem_messaging,            MM_IFACE_MODEM_MESSAGING)
+INTERFACE_INIT_START_FN                (iface_modem_messaging,            MM_IFACE_MODEM_MESSAGING)
+INTERFACE_INIT_FNS                     (iface_modem_time,                 MM_IFACE_MODEM_TIME)
+INTERFACE_INIT_START_FN                (iface_modem_time,                 MM_IFACE_MODEM_TIME)
+INTERFACE_INIT_FNS                     (iface_modem_signal,               MM_IFACE_MODEM_SIGNAL)
+INTERFACE_INIT_START_FN                (iface_modem_signal,               MM_IFACE_MODEM_SIGNAL)
+INTERFACE_INIT_FNS                     (iface_modem_oma,                  MM_IFACE_MODEM_OMA)
+INTERFACE_INIT_START_FN                (iface_modem_oma,                  MM_IFACE_MODEM_OMA)
+INTERFACE_INIT_FNS                     (iface_modem_sar,                  MM_IFACE_MODEM_SAR)
+INTERFACE_INIT_START_FN                (iface_modem_sar,                  MM_IFACE_MODEM_SAR)
+INTERFACE_INIT_FNS                     (iface_modem_voice,                MM_IFACE_MODEM_VOICE)
+INTERFACE_INIT_START_FN                (iface_modem_voice,                MM_IFACE_MODEM_VOICE)
+INTERFACE_INIT_FNS                     (iface_modem_firmware,             MM_IFACE_MODEM_FIRMWARE)
+INTERFACE_INIT_START_FN                (iface_modem_firmware,             MM_IFACE_MODEM_FIRMWARE)
+
+#undef INITIALIZE_IFACE
+#define INITIALIZE_IFACE(NAME,DISPLAY_NAME,REQUIRES_3GPP) { \
+        .name               = DISPLAY_NAME,                 \
+        .requires_3gpp      = REQUIRES_3GPP,                \
+        .initialize         = NAME##_initialize_iface,      \
+        .initialize_finish  = NAME##_initialize_iface_finish, \
+        .shutdown           = NAME##_shutdown_iface,        \
+        .bind_simple_status = NAME##_bind_simple_status_iface, \
+    }
+
+/* Only run when the modem is neither locked nor failed */
+static const InitializeIface ifaces_full[] = {
+    INITIALIZE_IFACE (iface_modem_3gpp_profile_manager, "3GPP profile manager", TRUE),
+    INITIALIZE_IFACE (iface_modem_3gpp_ussd,            "3GPP USSD",            TRUE),
+    INITIALIZE_IFACE (iface_modem_location,             "location",             FALSE),
+    INITIALIZE_IFACE (iface_modem_messaging,            "messaging",            FALSE),
+    INITIALIZE_IFACE (iface_modem_time,                 "time",                 FALSE),
+    INITIALIZE_IFACE (iface_modem_signal,               "signal",               FALSE),
+    INITIALIZE_IFACE (iface_modem_oma,                  "OMA",                  FALSE),
+    INITIALIZE_IFACE (iface_modem_sar,                  "SAR",                  FALSE),
+};
+
+/* Run both on successful and locked/failed initializations */
+static const InitializeIface ifaces_limited[] = {
+    INITIALIZE_IFACE (iface_modem_voice,    "voice",    FALSE),
+    INITIALIZE_IFACE (iface_modem_firmware, "firmware", FALSE),
+};
+
+typedef struct {
+    GTask                 *task;
+    const InitializeIface *iface;
+} InitializeIfaceContext;
+
+static void initialize_ifaces_next (GTask *task);
+
+static void
+initialize_iface_ready (MMBroadbandModem       *self,
+                        GAsyncResult           *res,
+                        InitializeIfaceContext *iface_ctx)
+{
+    GTask                 *task;
+    const InitializeIface *iface;
+    InitializeContext     *ctx;
+    GError                *error = NULL;
+
+    task = iface_ctx->task;
+    iface = iface_ctx->iface;
+    g_slice_free (InitializeIfaceContext, iface_ctx);
+
+    ctx = g_task_get_task_data (task);
+
+    if (!iface->initialize_finish (self, res, &error)) {
+        mm_obj_dbg (self, "couldn't initialize %s interface: '%s'", iface->name, error->message);
+        /* Just shutdown this interface */
+        iface->shutdown (self);
+        g_error_free (error);
+    } else {
+        /* bind simple properties */
+        iface->bind_simple_status (self, self->priv->modem_simple_status);
+    }
+
+    g_assert (ctx->n_ifaces_in_flight > 0);
+    ctx->n_ifaces_in_flight--;
+    initialize_ifaces_next (task);
+}
+
+static void
+initialize_ifaces_next (GTask *task)
+{
+    InitializeContext *ctx;
+    guint              max_parallel;
+
+    ctx = g_task_get_task_data (task);
+
+    /* An interface may complete right away while launching the others, the
+     * loop below takes care of it */
+    if (ctx->launching_ifaces)
+        return;
+
+    max_parallel = MAX (MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_max_parallel_ifaces, 1);
+
+    /* Once cancelled, don't launch any other, but wait for the ones in flight */
+    ctx->launching_ifaces = TRUE;
+    while (ctx->next_iface < ctx->n_ifaces &&
+           ctx->n_ifaces_in_flight < max_parallel &&
+           !g_cancellable_is_cancelled (g_task_get_cancellable (task))) {
+        const InitializeIface  *iface;
+        InitializeIfaceContext *iface_ctx;
+
+        iface = &ctx->ifaces[ctx->next_iface++];
+        if (iface->requires_3gpp && !mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self)))
+            continue;
+
+        iface_ctx = g_slice_new (InitializeIfaceContext);
+        iface_ctx->task = task;
+        iface_ctx->iface = iface;
+
+        ctx->n_ifaces_in_flight++;
+        iface->initialize (ctx->self,
+                           g_task_get_cancellable (task),
+                           (GAsyncReadyCallback)initialize_iface_ready,
+                           iface_ctx);
+    }
+    ctx->launching_ifaces = FALSE;
+
+    if (ctx->n_ifaces_in_flight > 0)
+        return;
+
+    /* Whole group done, go on to next step */
+    ctx->ifaces = NULL;
+    ctx->n_ifaces = 0;
+    ctx->next_iface = 0;
+    ctx->step++;
+    initialize_step (task);
+}
+
+static void
+initialize_ifaces_start (GTask                 *task,
+                         const InitializeIface *ifaces,
+                         guint                  n_ifaces)
+{
+    InitializeContext *ctx;
+
+    ctx = g_task_get_task_data (task);
+    g_assert (!ctx->ifaces);
+    g_assert (ctx->n_ifaces_in_flight == 0);
+
+    if (MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_max_parallel_ifaces > 1)
+        mm_obj_dbg (ctx->self, "initializing up to %u interfaces at the same time",
+                    MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_max_parallel_ifaces);
+
+    ctx->ifaces = ifaces;
+    ctx->n_ifaces = n_ifaces;
+    ctx->next_iface = 0;
+    initialize_ifaces_next (task);
+}
 
 static void
 initialize_step (GTask *task)
@@ -12521,28 +12757,6 @@ initialize_step (GTask *task)
         ctx->step++;
        /* fall through */
 
-    case INITIALIZE_STEP_IFACE_3GPP_PROFILE_MANAGER:
-        if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
-            /* Initialize the 3GPP Profile Manager interface */
-            mm_iface_modem_3gpp_profile_manager_initialize (MM_IFACE_MODEM_3GPP_PROFILE_MANAGER (ctx->self),
-                                                            (GAsyncReadyCallback)iface_modem_3gpp_profile_manager_initialize_ready,
-                                                            task);
-            return;
-        }
-        ctx->step++;
-       /* fall through */
-
-    case INITIALIZE_STEP_IFACE_3GPP_USSD:
-        if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
-            /* Initialize the 3GPP/USSD interface */
-            mm_iface_modem_3gpp_ussd_initialize (MM_IFACE_MODEM_3GPP_USSD (ctx->self),
-                                                 (GAsyncReadyCallback)iface_modem_3gpp_ussd_initialize_ready,
-                                                 task);
-            return;
-        }
-        ctx->step++;
-       /* fall through */
-
     case INITIALIZE_STEP_IFACE_CDMA:
         if (mm_iface_modem_is_cdma (MM_IFACE_MODEM (ctx->self))) {
             /* Initialize the CDMA interface */
@@ -12555,52 +12769,8 @@ initialize_step (GTask *task)
         ctx->step++;
        /* fall through */
 
-    case INITIALIZE_STEP_IFACE_LOCATION:
-        /* Initialize the Location interface */
-        mm_iface_modem_location_initialize (MM_IFACE_MODEM_LOCATION (ctx->self),
-                                            g_task_get_cancellable (task),
-                                            (GAsyncReadyCallback)iface_modem_location_initialize_ready,
-                                            task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_MESSAGING:
-        /* Initialize the Messaging interface */
-        mm_iface_modem_messaging_initialize (MM_IFACE_MODEM_MESSAGING (ctx->self),
-                                             g_task_get_cancellable (task),
-                                             (GAsyncReadyCallback)iface_modem_messaging_initialize_ready,
-                                             task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_TIME:
-        /* Initialize the Time interface */
-        mm_iface_modem_time_initialize (MM_IFACE_MODEM_TIME (ctx->self),
-                                        g_task_get_cancellable (task),
-                                        (GAsyncReadyCallback)iface_modem_time_initialize_ready,
-                                        task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_SIGNAL:
-        /* Initialize the Signal interface */
-        mm_iface_modem_signal_initialize (MM_IFACE_MODEM_SIGNAL (ctx->self),
-                                          g_task_get_cancellable (task),
-                                          (GAsyncReadyCallback)iface_modem_signal_initialize_ready,
-                                          task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_OMA:
-        /* Initialize the Oma interface */
-        mm_iface_modem_oma_initialize (MM_IFACE_MODEM_OMA (ctx->self),
-                                       g_task_get_cancellable (task),
-                                       (GAsyncReadyCallback)iface_modem_oma_initialize_ready,
-                                       task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_SAR:
-        /* Initialize the SAR interface */
-        mm_iface_modem_sar_initialize (MM_IFACE_MODEM_SAR (ctx->self),
-                                       g_task_get_cancellable (task),
-                                       (GAsyncReadyCallback)iface_modem_sar_initialize_ready,
-                                       task);
+    case INITIALIZE_STEP_IFACES:
+        initialize_ifaces_start (task, ifaces_full, G_N_ELEMENTS (ifaces_full));
         return;
 
     case INITIALIZE_STEP_FALLBACK_LIMITED:
@@ -12609,20 +12779,8 @@ initialize_step (GTask *task)
         ctx->step++;
        /* fall through */
 
-    case INITIALIZE_STEP_IFACE_VOICE:
-        /* Initialize the Voice interface */
-        mm_iface_modem_voice_initialize (MM_IFACE_MODEM_VOICE (ctx->self),
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)iface_modem_voice_initialize_ready,
-                                         task);
-        return;
-
-    case INITIALIZE_STEP_IFACE_FIRMWARE:
-        /* Initialize the Firmware interface */
-        mm_iface_modem_firmware_initialize (MM_IFACE_MODEM_FIRMWARE (ctx->self),
-                                            g_task_get_cancellable (task),
-                                            (GAsyncReadyCallback)iface_modem_firmware_initialize_ready,
-                                            task);
+    case INITIALIZE_STEP_IFACES_LIMITED:
+        initialize_ifaces_start (task, ifaces_limited, G_N_ELEMENTS (ifaces_limited));
         return;
 
     case INITIALIZE_STEP_SIM_HOT_SWAP:
@@ -13045,6 +13203,9 @@ set_property (GObject *object,
     case PROP_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS:
         self->priv->modem_location_allow_gps_unmanaged_always = g_value_get_boolean (value);
         break;
+    case PROP_MODEM_LOCATION_UPDATE_WINDOW:
+        self->priv->modem_location_update_window = g_value_get_uint (value);
+        break;
     case PROP_MODEM_VOICE_CALL_LIST:
         g_clear_object (&self->priv->modem_voice_call_list);
         self->priv->modem_voice_call_list = g_value_dup_object (value);
@@ -13197,6 +13358,9 @@ get_property (GObject *object,
     case PROP_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS:
         g_value_set_boolean (value, self->priv->modem_location_allow_gps_unmanaged_always);
         break;
+    case PROP_MODEM_LOCATION_UPDATE_WINDOW:
+        g_value_set_uint (value, self->priv->modem_location_update_window);
+        break;
     case PROP_MODEM_VOICE_CALL_LIST:
         g_value_set_object (value, self->priv->modem_voice_call_list);
         break;
@@ -13845,6 +14009,10 @@ mm_broadband_modem_class_init (MMBroadbandModemClass *klass)
                                       PROP_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS,
                                       MM_IFACE_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS);
 
+    g_object_class_override_property (object_class,
+                                      PROP_MODEM_LOCATION_UPDATE_WINDOW,
+                                      MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW);
+
     g_object_class_override_property (object_class,
                                       PROP_MODEM_VOICE_CALL_LIST,
                                       MM_IFACE_MODEM_VOICE_CALL_LIST);
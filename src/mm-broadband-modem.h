@@ -67,6 +67,11 @@ struct _MMBroadbandModemClass {
                                                 gpointer started_context,
                                                 GError **error);
 
+    /* Maximum number of interfaces initialized at the same time once the
+     * Modem, 3GPP and CDMA interfaces are ready. 0 or 1 means one after the
+     * other, which is what AT-controlled modems want. */
+    guint initialization_max_parallel_ifaces;
+
     /* First enabling step */
     void     (* enabling_started)        (MMBroadbandModem *self,
                                           GAsyncReadyCallback callback,
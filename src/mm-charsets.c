@@ -189,42 +189,6 @@ gsm_def_char_to_utf8 (const guint8 gsm,
     return gsm_def_utf8_alphabet[gsm].len;
 }
 
-static gboolean
-utf8_to_gsm_def_char (const gchar *utf8,
-                      guint32      len,
-                      guint8      *out_gsm)
-{
-    gint i;
-
-    if (len > 0 && len < 4) {
-        for (i = 0; i < GSM_DEF_ALPHABET_SIZE; i++) {
-            if (gsm_def_utf8_alphabet[i].len == len) {
-                if (memcmp (&gsm_def_utf8_alphabet[i].chars[0], utf8, len) == 0) {
-                    *out_gsm = i;
-                    return TRUE;
-                }
-            }
-        }
-    }
-    return FALSE;
-}
-
-static gboolean
-translit_gsm_nul_byte (GByteArray *gsm)
-{
-    guint i;
-    guint n_replaces = 0;
-
-    for (i = 0; i < gsm->len; i++) {
-        if (gsm->data[i] == 0x00) {
-            utf8_to_gsm_def_char (translit_fallback, strlen (translit_fallback), &gsm->data[i]);
-            n_replaces++;
-        }
-    }
-
-    return (n_replaces > 0);
-}
-
 
 #define EONE(a, g)        { {a, 0x00, 0x00}, 1, g }
 #define ETHR(a, b, c, g)  { {a, b,    c},    3, g }
@@ -246,39 +210,127 @@ static const GsmUtf8Mapping gsm_ext_utf8_alphabet[GSM_EXT_ALPHABET_SIZE] = {
 
 #define GSM_ESCAPE_CHAR 0x1b
 
+/*
+ * Reverse lookup tables, built from the ones above on first use.
+ *
+ * All the code points in the GSM alphabets are in the Latin and Greek
+ * blocks, except for the euro sign, so a single direct table indexed by
+ * code point is enough. Each entry holds the GSM char, flagged as mapped
+ * and, if needed, as belonging to the extended alphabet.
+ */
+#define GSM_REVERSE_MAP_SIZE    0x400
+#define GSM_REVERSE_MAPPED      0x8000
+#define GSM_REVERSE_EXTENDED    0x4000
+#define GSM_REVERSE_GSM_MASK    0x7f
+#define UNICODE_EURO_SIGN       0x20ac
+
+static guint16 gsm_reverse_map[GSM_REVERSE_MAP_SIZE];
+static guint16 gsm_reverse_euro_sign;
+/* GSM extended char -> position in gsm_ext_utf8_alphabet + 1 */
+static guint8  gsm_ext_map[GSM_DEF_ALPHABET_SIZE];
+
+static gunichar
+gsm_utf8_mapping_get_char (const GsmUtf8Mapping *mapping)
+{
+    return g_utf8_get_char_validated (mapping->chars, mapping->len);
+}
+
+static void
+gsm_reverse_map_add (gunichar c,
+                     guint16  entry)
+{
+    if (c == UNICODE_EURO_SIGN)
+        gsm_reverse_euro_sign = entry;
+    else {
+        g_assert (c < GSM_REVERSE_MAP_SIZE);
+        gsm_reverse_map[c] = entry;
+    }
+}
+
+static void
+gsm_maps_init (void)
+{
+    static gsize initialized = 0;
+
+    if (g_once_init_enter (&initialized)) {
+        guint i;
+
+        for (i = 0; i < GSM_DEF_ALPHABET_SIZE; i++) {
+            gunichar c;
+
+            /* The escape code doesn't map to a valid char */
+            c = gsm_utf8_mapping_get_char (&gsm_def_utf8_alphabet[i]);
+            if (c == (gunichar) -1 || c == (gunichar) -2)
+                continue;
+            gsm_reverse_map_add (c, GSM_REVERSE_MAPPED | i);
+        }
+
+        /* Extended chars are preferred over the default ones */
+        for (i = 0; i < GSM_EXT_ALPHABET_SIZE; i++) {
+            gsm_reverse_map_add (gsm_utf8_mapping_get_char (&gsm_ext_utf8_alphabet[i]),
+                                 GSM_REVERSE_MAPPED | GSM_REVERSE_EXTENDED | gsm_ext_utf8_alphabet[i].gsm);
+            gsm_ext_map[gsm_ext_utf8_alphabet[i].gsm] = i + 1;
+        }
+
+        g_once_init_leave (&initialized, 1);
+    }
+}
+
 static guint8
 gsm_ext_char_to_utf8 (const guint8 gsm,
                       guint8       out_utf8[3])
 {
-    int i;
+    const GsmUtf8Mapping *mapping;
 
-    for (i = 0; i < GSM_EXT_ALPHABET_SIZE; i++) {
-        if (gsm == gsm_ext_utf8_alphabet[i].gsm) {
-            memcpy (&out_utf8[0], &gsm_ext_utf8_alphabet[i].chars[0], gsm_ext_utf8_alphabet[i].len);
-            return gsm_ext_utf8_alphabet[i].len;
-        }
-    }
-    return 0;
+    gsm_maps_init ();
+
+    if (gsm >= GSM_DEF_ALPHABET_SIZE || !gsm_ext_map[gsm])
+        return 0;
+
+    mapping = &gsm_ext_utf8_alphabet[gsm_ext_map[gsm] - 1];
+    memcpy (&out_utf8[0], &mapping->chars[0], mapping->len);
+    return mapping->len;
 }
 
 static gboolean
-utf8_to_gsm_ext_char (const gchar *utf8,
-                      guint32      len,
-                      guint8      *out_gsm)
+unichar_to_gsm (gunichar  c,
+                guint8   *out_gsm,
+                gboolean *out_extended)
 {
-    int i;
+    guint16 entry;
 
-    if (len > 0 && len < 4) {
-        for (i = 0; i < GSM_EXT_ALPHABET_SIZE; i++) {
-            if (gsm_ext_utf8_alphabet[i].len == len) {
-                if (memcmp (&gsm_ext_utf8_alphabet[i].chars[0], utf8, len) == 0) {
-                    *out_gsm = gsm_ext_utf8_alphabet[i].gsm;
-                    return TRUE;
-                }
-            }
+    gsm_maps_init ();
+
+    if (c < GSM_REVERSE_MAP_SIZE)
+        entry = gsm_reverse_map[c];
+    else if (c == UNICODE_EURO_SIGN)
+        entry = gsm_reverse_euro_sign;
+    else
+        return FALSE;
+
+    if (!(entry & GSM_REVERSE_MAPPED))
+        return FALSE;
+
+    *out_gsm = entry & GSM_REVERSE_GSM_MASK;
+    if (out_extended)
+        *out_extended = !!(entry & GSM_REVERSE_EXTENDED);
+    return TRUE;
+}
+
+static gboolean
+translit_gsm_nul_byte (GByteArray *gsm)
+{
+    guint i;
+    guint n_replaces = 0;
+
+    for (i = 0; i < gsm->len; i++) {
+        if (gsm->data[i] == 0x00) {
+            unichar_to_gsm (g_utf8_get_char (translit_fallback), &gsm->data[i], NULL);
+            n_replaces++;
         }
     }
-    return FALSE;
+
+    return (n_replaces > 0);
 }
 
 static guint8 *
@@ -355,8 +407,7 @@ charset_utf8_to_unpacked_gsm (const gchar  *utf8,
                               GError      **error)
 {
     g_autoptr(GByteArray)  gsm = NULL;
-    const gchar           *c;
-    const gchar           *next;
+    const gchar           *p;
     static const guint8    gesc = GSM_ESCAPE_CHAR;
 
     if (!utf8 || !g_utf8_validate (utf8, -1, NULL)) {
@@ -376,19 +427,14 @@ charset_utf8_to_unpacked_gsm (const gchar  *utf8,
         return g_byte_array_free (g_steal_pointer (&gsm), FALSE);
     }
 
-    next = utf8;
-    c    = utf8;
-    while (next && *next) {
-        guint8 gch = 0x3f;  /* 0x3f == '?' */
-
-        next = g_utf8_next_char (c);
+    for (p = utf8; *p; p = g_utf8_next_char (p)) {
+        guint8   gch = 0x3f;  /* 0x3f == '?' */
+        gboolean extended = FALSE;
 
-        /* Try escaped chars first, then default alphabet */
-        if (utf8_to_gsm_ext_char (c, next - c, &gch)) {
-            /* Add the escape char */
-            g_byte_array_append (gsm, &gesc, 1);
-            g_byte_array_append (gsm, &gch, 1);
-        } else if (utf8_to_gsm_def_char (c, next - c, &gch)) {
+        if (unichar_to_gsm (g_utf8_get_char (p), &gch, &extended)) {
+            /* Add the escape char for the extended alphabet */
+            if (extended)
+                g_byte_array_append (gsm, &gesc, 1);
             g_byte_array_append (gsm, &gch, 1);
         } else if (translit) {
             /* add ? */
@@ -398,8 +444,6 @@ charset_utf8_to_unpacked_gsm (const gchar  *utf8,
                          "Couldn't convert UTF-8 char to GSM");
             return NULL;
         }
-
-        c = next;
     }
 
     /* Output length doesn't consider terminating NUL byte */
@@ -422,11 +466,7 @@ gsm_is_subset (gunichar     c,
 {
     guint8 gsm;
 
-    if (utf8_to_gsm_def_char (utf8, ulen, &gsm))
-        return TRUE;
-    if (utf8_to_gsm_ext_char (utf8, ulen, &gsm))
-        return TRUE;
-    return FALSE;
+    return unichar_to_gsm (c, &gsm, NULL);
 }
 
 static gboolean
@@ -590,40 +630,52 @@ mm_charset_can_convert_to (const gchar    *utf8,
 /******************************************************************************/
 /* GSM-7 pack/unpack operations */
 
+/* Once a septet starts at a byte boundary, every 7 bytes hold 8 septets, so
+ * those blocks are converted at once through a 64-bit word. */
+#define GSM_SEPTETS_PER_BLOCK 8
+#define GSM_BYTES_PER_BLOCK   7
+
 guint8 *
 mm_charset_gsm_unpack (const guint8 *gsm,
                        guint32       num_septets,
                        guint8        start_offset,  /* in _bits_ */
                        guint32      *out_unpacked_len)
 {
-    GByteArray *unpacked;
-    guint i;
+    guint8 *unpacked;
+    guint   i;
 
-    unpacked = g_byte_array_sized_new (num_septets + 1);
+    unpacked = g_malloc (num_septets + 1);
 
-    for (i = 0; i < num_septets; i++) {
-        guint8 bits_here, bits_in_next, octet, offset, c;
+    for (i = 0; i < num_septets;) {
         guint32 start_bit;
+        guint8  offset;
+        guint8  c;
 
         start_bit = start_offset + (i * 7); /* Overall bit offset of char in buffer */
         offset = start_bit % 8;  /* Offset to start of char in this byte */
-        bits_here = offset ? (8 - offset) : 7;
-        bits_in_next = 7 - bits_here;
 
-        /* Grab bits in the current byte */
-        octet = gsm[start_bit / 8];
-        c = (octet >> offset) & (0xFF >> (8 - bits_here));
+        if (!offset && (num_septets - i) >= GSM_SEPTETS_PER_BLOCK) {
+            guint64 block = 0;
+            guint   j;
 
-        /* Grab any bits that spilled over to next byte */
-        if (bits_in_next) {
-            octet = gsm[(start_bit / 8) + 1];
-            c |= (octet & (0xFF >> (8 - bits_in_next))) << bits_here;
+            memcpy (&block, &gsm[start_bit / 8], GSM_BYTES_PER_BLOCK);
+            block = GUINT64_FROM_LE (block);
+            for (j = 0; j < GSM_SEPTETS_PER_BLOCK; j++)
+                unpacked[i++] = (block >> (j * 7)) & 0x7F;
+            continue;
         }
-        g_byte_array_append (unpacked, &c, 1);
+
+        /* Grab bits in the current byte, and any bits that spilled over to
+         * the next one */
+        c = gsm[start_bit / 8] >> offset;
+        if (offset > 1)
+            c |= gsm[(start_bit / 8) + 1] << (8 - offset);
+        unpacked[i++] = c & 0x7F;
     }
+    unpacked[num_septets] = 0;
 
-    *out_unpacked_len = unpacked->len;
-    return g_byte_array_free (unpacked, FALSE);
+    *out_unpacked_len = num_septets;
+    return unpacked;
 }
 
 guint8 *
@@ -633,8 +685,8 @@ mm_charset_gsm_pack (const guint8 *src,
                      guint32      *out_packed_len)
 {
     guint8 *packed;
-    guint octet = 0, lshift, plen;
-    guint i = 0;
+    guint   plen;
+    guint   i;
 
     g_return_val_if_fail (start_offset < 8, NULL);
 
@@ -645,16 +697,31 @@ mm_charset_gsm_pack (const guint8 *src,
 
     packed = g_malloc0 (plen);
 
-    for (i = 0, lshift = start_offset; i < src_len; i++) {
-        packed[octet] |= (src[i] & 0x7F) << lshift;
-        if (lshift > 1) {
+    for (i = 0; i < src_len;) {
+        guint32 start_bit;
+        guint8  offset;
+
+        start_bit = start_offset + (i * 7);
+        offset = start_bit % 8;
+
+        if (!offset && (src_len - i) >= GSM_SEPTETS_PER_BLOCK) {
+            guint64 block = 0;
+            guint   j;
+
+            for (j = 0; j < GSM_SEPTETS_PER_BLOCK; j++)
+                block |= (guint64) (src[i++] & 0x7F) << (j * 7);
+            block = GUINT64_TO_LE (block);
+            memcpy (&packed[start_bit / 8], &block, GSM_BYTES_PER_BLOCK);
+            continue;
+        }
+
+        packed[start_bit / 8] |= (src[i] & 0x7F) << offset;
+        if (offset > 1) {
             /* Grab the lost bits and add to next octet */
-            g_assert (octet + 1 < plen);
-            packed[octet + 1] = (src[i] & 0x7F) >> (8 - lshift);
+            g_assert ((start_bit / 8) + 1 < plen);
+            packed[(start_bit / 8) + 1] |= (src[i] & 0x7F) >> (8 - offset);
         }
-        if (lshift)
-            octet++;
-        lshift = lshift ? lshift - 1 : 7;
+        i++;
     }
 
     if (out_packed_len)
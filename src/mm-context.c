@@ -41,6 +41,11 @@ static gboolean      debug;
 static MMFilterRule  filter_policy = MM_FILTER_POLICY_STRICT;
 static gboolean      no_auto_scan = NO_AUTO_SCAN_DEFAULT;
 static const gchar  *initial_kernel_events;
+static gboolean      no_probe_cache;
+static gboolean      flush_probe_cache;
+static gboolean      no_modem_snapshot;
+static gboolean      flush_modem_snapshot;
+static gint          signal_keep_alive;
 
 static gboolean
 filter_policy_option_arg (const gchar  *option_name,
@@ -84,6 +89,31 @@ static const GOptionEntry entries[] = {
         "Path to initial kernel events file",
         "[PATH]"
     },
+    {
+        "no-probe-cache", 0, 0, G_OPTION_ARG_NONE, &no_probe_cache,
+        "Don't reuse or store port probing results across runs",
+        NULL
+    },
+    {
+        "flush-probe-cache", 0, 0, G_OPTION_ARG_NONE, &flush_probe_cache,
+        "Flush the port probing results cache on startup",
+        NULL
+    },
+    {
+        "no-modem-snapshot", 0, 0, G_OPTION_ARG_NONE, &no_modem_snapshot,
+        "Don't reuse or store static modem information across runs",
+        NULL
+    },
+    {
+        "flush-modem-snapshot", 0, 0, G_OPTION_ARG_NONE, &flush_modem_snapshot,
+        "Flush the static modem information snapshot on startup",
+        NULL
+    },
+    {
+        "signal-keep-alive", 0, 0, G_OPTION_ARG_INT, &signal_keep_alive,
+        "Poll signal values reported by indications when none received in this many seconds (0 to never poll them)",
+        "[SECS]"
+    },
     {
         "debug", 0, 0, G_OPTION_ARG_NONE, &debug,
         "Run with extended debugging capabilities",
@@ -120,6 +150,36 @@ mm_context_get_no_auto_scan (void)
     return no_auto_scan;
 }
 
+gboolean
+mm_context_get_no_probe_cache (void)
+{
+    return no_probe_cache;
+}
+
+gboolean
+mm_context_get_flush_probe_cache (void)
+{
+    return flush_probe_cache;
+}
+
+gboolean
+mm_context_get_no_modem_snapshot (void)
+{
+    return no_modem_snapshot;
+}
+
+gboolean
+mm_context_get_flush_modem_snapshot (void)
+{
+    return flush_modem_snapshot;
+}
+
+guint
+mm_context_get_signal_keep_alive (void)
+{
+    return (guint) MAX (signal_keep_alive, 0);
+}
+
 MMFilterRule
 mm_context_get_filter_policy (void)
 {
@@ -131,9 +191,13 @@ mm_context_get_filter_policy (void)
 
 static const gchar *log_level;
 static const gchar *log_file;
+static gboolean     log_file_buffered;
+static gint64       log_file_max_size;
 static gboolean     log_journal;
 static gboolean     log_show_ts;
 static gboolean     log_rel_ts;
+static const gchar *log_debug_filter;
+static const gchar *capture_file;
 
 static const GOptionEntry log_entries[] = {
     {
@@ -146,6 +210,16 @@ static const GOptionEntry log_entries[] = {
         "Path to log file",
         "[PATH]"
     },
+    {
+        "log-file-buffered", 0, 0, G_OPTION_ARG_NONE, &log_file_buffered,
+        "Write the log file from a separate thread, syncing only warnings and errors right away",
+        NULL
+    },
+    {
+        "log-file-max-size", 0, 0, G_OPTION_ARG_INT64, &log_file_max_size,
+        "Rotate the log file when it grows over the given size",
+        "[BYTES]"
+    },
 #if defined WITH_SYSTEMD_JOURNAL
     {
         "log-journal", 0, 0, G_OPTION_ARG_NONE, &log_journal,
@@ -163,6 +237,16 @@ static const GOptionEntry log_entries[] = {
         "Use relative timestamps (from MM start)",
         NULL
     },
+    {
+        "log-debug-filter", 0, 0, G_OPTION_ARG_STRING, &log_debug_filter,
+        "Log debug messages only for the given comma-separated objects (e.g. modem0, ttyUSB2) or plugins",
+        "[ID,...]"
+    },
+    {
+        "capture-file", 0, 0, G_OPTION_ARG_FILENAME, &capture_file,
+        "Capture the raw traffic of all control ports in the given file",
+        "[PATH]"
+    },
     { NULL }
 };
 
@@ -192,6 +276,18 @@ mm_context_get_log_file (void)
     return log_file;
 }
 
+gboolean
+mm_context_get_log_file_buffered (void)
+{
+    return log_file_buffered;
+}
+
+guint64
+mm_context_get_log_file_max_size (void)
+{
+    return (log_file_max_size > 0) ? (guint64) log_file_max_size : 0;
+}
+
 gboolean
 mm_context_get_log_journal (void)
 {
@@ -210,6 +306,18 @@ mm_context_get_log_relative_timestamps (void)
     return log_rel_ts;
 }
 
+const gchar *
+mm_context_get_log_debug_filter (void)
+{
+    return log_debug_filter;
+}
+
+const gchar *
+mm_context_get_capture_file (void)
+{
+    return capture_file;
+}
+
 /*****************************************************************************/
 /* Test context */
 
@@ -31,6 +31,11 @@ void mm_context_init (gint    argc,
 gboolean     mm_context_get_debug                 (void);
 const gchar *mm_context_get_initial_kernel_events (void);
 gboolean     mm_context_get_no_auto_scan          (void);
+gboolean     mm_context_get_no_probe_cache        (void);
+gboolean     mm_context_get_flush_probe_cache     (void);
+gboolean     mm_context_get_no_modem_snapshot     (void);
+gboolean     mm_context_get_flush_modem_snapshot  (void);
+guint        mm_context_get_signal_keep_alive     (void);
 
 /* Filter support */
 MMFilterRule mm_context_get_filter_policy (void);
@@ -38,9 +43,13 @@ MMFilterRule mm_context_get_filter_policy (void);
 /* Logging support */
 const gchar *mm_context_get_log_level               (void);
 const gchar *mm_context_get_log_file                (void);
+gboolean     mm_context_get_log_file_buffered       (void);
+guint64      mm_context_get_log_file_max_size       (void);
 gboolean     mm_context_get_log_journal             (void);
 gboolean     mm_context_get_log_timestamps          (void);
 gboolean     mm_context_get_log_relative_timestamps (void);
+const gchar *mm_context_get_log_debug_filter        (void);
+const gchar *mm_context_get_capture_file            (void);
 
 /* Testing support */
 gboolean     mm_context_get_test_session           (void);
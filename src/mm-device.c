@@ -25,6 +25,7 @@
 
 #include "mm-device.h"
 #include "mm-plugin.h"
+#include "mm-iface-modem.h"
 #include "mm-log-object.h"
 
 static void log_object_iface_init (MMLogObjectInterface *iface);
@@ -92,6 +93,9 @@ struct _MMDevicePrivate {
 
     /* Scheduled reprobe */
     guint reprobe_id;
+
+    /* Timings of the last device support check, as a{su} */
+    GVariant *probing_timings;
 };
 
 /*****************************************************************************/
@@ -363,6 +367,19 @@ export_modem (MMDevice *self)
     mm_obj_dbg (self, "    vid:pid: 0x%04X:0x%04X",
                 (mm_base_modem_get_vendor_id (self->priv->modem) & 0xFFFF),
                 (mm_base_modem_get_product_id (self->priv->modem) & 0xFFFF));
+    if (self->priv->probing_timings) {
+        guint32 wait_time = 0;
+        guint32 last_port_time = 0;
+        guint32 probing_time = 0;
+        guint32 total_time = 0;
+
+        g_variant_lookup (self->priv->probing_timings, "wait-time", "u", &wait_time);
+        g_variant_lookup (self->priv->probing_timings, "last-port-time", "u", &last_port_time);
+        g_variant_lookup (self->priv->probing_timings, "probing-time", "u", &probing_time);
+        g_variant_lookup (self->priv->probing_timings, "total-time", "u", &total_time);
+        mm_obj_dbg (self, "    probing: %ums (waiting %ums, last port after %ums, probing %ums)",
+                    total_time, wait_time, last_port_time, probing_time);
+    }
     if (self->priv->virtual)
         mm_obj_dbg (self, "    virtual");
 
@@ -540,6 +557,20 @@ mm_device_get_plugin (MMDevice *self)
             NULL);
 }
 
+void
+mm_device_set_probing_timings (MMDevice *self,
+                               GVariant *timings)
+{
+    g_clear_pointer (&self->priv->probing_timings, g_variant_unref);
+    self->priv->probing_timings = g_variant_ref_sink (timings);
+}
+
+GVariant *
+mm_device_peek_probing_timings (MMDevice *self)
+{
+    return self->priv->probing_timings;
+}
+
 MMBaseModem *
 mm_device_peek_modem (MMDevice *self)
 {
@@ -847,6 +878,7 @@ finalize (GObject *object)
     g_free (self->priv->uid);
     g_strfreev (self->priv->drivers);
     g_strfreev (self->priv->virtual_ports);
+    g_clear_pointer (&self->priv->probing_timings, g_variant_unref);
 
     G_OBJECT_CLASS (mm_device_parent_class)->finalize (object);
 }
@@ -103,6 +103,9 @@ void             mm_device_set_plugin           (MMDevice       *self,
                                                  GObject        *plugin);
 GObject         *mm_device_peek_plugin          (MMDevice       *self);
 GObject         *mm_device_get_plugin           (MMDevice       *self);
+void             mm_device_set_probing_timings  (MMDevice       *self,
+                                                 GVariant       *timings);
+GVariant        *mm_device_peek_probing_timings (MMDevice       *self);
 MMBaseModem     *mm_device_peek_modem           (MMDevice       *self);
 MMBaseModem     *mm_device_get_modem            (MMDevice       *self);
 GObject         *mm_device_peek_port_probe      (MMDevice       *self,
@@ -27,6 +27,7 @@
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-log.h"
+#include "mm-timer.h"
 
 #define SUBSYSTEM_3GPP "3gpp"
 
@@ -80,7 +81,7 @@ private_free (Private *priv)
         g_object_unref (priv->pending_registration_cancellable);
     }
     if (priv->check_timeout_source)
-        g_source_remove (priv->check_timeout_source);
+        mm_timer_remove (priv->check_timeout_source);
     g_slice_free (Private, priv);
 }
 
@@ -1603,10 +1604,11 @@ mm_iface_modem_3gpp_run_registration_checks_finish (MMIfaceModem3gpp *self,
     return MM_IFACE_MODEM_3GPP_GET_INTERFACE (self)->run_registration_checks_finish (self, res, error);
 }
 
-void
-mm_iface_modem_3gpp_run_registration_checks (MMIfaceModem3gpp *self,
-                                             GAsyncReadyCallback callback,
-                                             gpointer user_data)
+static void
+run_registration_checks_full (MMIfaceModem3gpp *self,
+                              gboolean is_polling,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data)
 {
     gboolean is_cs_supported = FALSE;
     gboolean is_ps_supported = FALSE;
@@ -1633,10 +1635,19 @@ mm_iface_modem_3gpp_run_registration_checks (MMIfaceModem3gpp *self,
                                                                        is_ps_supported,
                                                                        is_eps_supported,
                                                                        is_5gs_supported,
+                                                                       is_polling,
                                                                        callback,
                                                                        user_data);
 }
 
+void
+mm_iface_modem_3gpp_run_registration_checks (MMIfaceModem3gpp *self,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data)
+{
+    run_registration_checks_full (self, FALSE, callback, user_data);
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -2127,8 +2138,9 @@ periodic_registration_check (MMIfaceModem3gpp *self)
     /* Only launch a new one if not one running already */
     if (!priv->check_running) {
         priv->check_running = TRUE;
-        mm_iface_modem_3gpp_run_registration_checks (
+        run_registration_checks_full (
             self,
+            TRUE,
             (GAsyncReadyCallback)periodic_registration_checks_ready,
             NULL);
     }
@@ -2146,7 +2158,7 @@ periodic_registration_check_disable (MMIfaceModem3gpp *self)
     if (!priv->check_timeout_source)
         return;
 
-    g_source_remove (priv->check_timeout_source);
+    mm_timer_remove (priv->check_timeout_source);
     priv->check_timeout_source = 0;
 
     mm_obj_dbg (self, "periodic 3GPP registration checks disabled");
@@ -2165,9 +2177,11 @@ periodic_registration_check_enable (MMIfaceModem3gpp *self)
 
     /* Create context and keep it as object data */
     mm_obj_dbg (self, "periodic 3GPP registration checks enabled");
-    priv->check_timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                        (GSourceFunc)periodic_registration_check,
-                                                        self);
+    priv->check_timeout_source = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                       MM_LOG_OBJECT (self),
+                                                       REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                       (GSourceFunc)periodic_registration_check,
+                                                       self);
 }
 
 /*****************************************************************************/
@@ -179,12 +179,15 @@ struct _MMIfaceModem3gpp {
 
     /* Run CS/PS/EPS/5GS registration state checks..
      * Note that no registration state is returned, implementations should call
-     * mm_iface_modem_3gpp_update_registration_state(). */
+     * mm_iface_modem_3gpp_update_registration_state().
+     * @is_polling is only set for the periodic checks, which may run with a
+     * lower priority and reuse recent replies. */
     void (* run_registration_checks) (MMIfaceModem3gpp *self,
                                       gboolean is_cs_supported,
                                       gboolean is_ps_supported,
                                       gboolean is_eps_supported,
                                       gboolean is_5gs_supported,
+                                      gboolean is_polling,
                                       GAsyncReadyCallback callback,
                                       gpointer user_data);
     gboolean (*run_registration_checks_finish) (MMIfaceModem3gpp *self,
@@ -24,6 +24,7 @@
 #include "mm-base-modem.h"
 #include "mm-modem-helpers.h"
 #include "mm-log-object.h"
+#include "mm-timer.h"
 
 #define SUBSYSTEM_CDMA1X "cdma1x"
 #define SUBSYSTEM_EVDO "evdo"
@@ -1234,7 +1235,7 @@ static void
 registration_check_context_free (RegistrationCheckContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_timer_remove (ctx->timeout_source);
     g_free (ctx);
 }
 
@@ -1307,9 +1308,11 @@ periodic_registration_check_enable (MMIfaceModemCdma *self)
     /* Create context and keep it as object data */
     mm_obj_dbg (self, "periodic CDMA registration checks enabled");
     ctx = g_new0 (RegistrationCheckContext, 1);
-    ctx->timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                 (GSourceFunc)periodic_registration_check,
-                                                 self);
+    ctx->timeout_source = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                MM_LOG_OBJECT (self),
+                                                REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                (GSourceFunc)periodic_registration_check,
+                                                self);
     g_object_set_qdata_full (G_OBJECT (self),
                              registration_check_context_quark,
                              ctx,
@@ -23,6 +23,7 @@
 #include "mm-iface-modem-location.h"
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
+#include "mm-location-updates.h"
 
 #define MM_LOCATION_GPS_REFRESH_TIME_SECS 30
 
@@ -43,18 +44,23 @@ mm_iface_modem_location_bind_simple_status (MMIfaceModemLocation *self,
 typedef struct {
     /* 3GPP location */
     MMLocation3gpp *location_3gpp;
-    /* GPS location */
-    time_t location_gps_nmea_last_time;
+    /* GPS location, last times in monotonic clock */
+    guint gps_refresh_rate;
+    gint64 location_gps_nmea_last_time;
     MMLocationGpsNmea *location_gps_nmea;
-    time_t location_gps_raw_last_time;
+    gint64 location_gps_raw_last_time;
     MMLocationGpsRaw *location_gps_raw;
     /* CDMA BS location */
     MMLocationCdmaBs *location_cdma_bs;
+
+    /* Coalesced updates of the Location property */
+    MMLocationUpdates *updates;
 } LocationContext;
 
 static void
 location_context_free (LocationContext *ctx)
 {
+    mm_location_updates_free (ctx->updates);
     if (ctx->location_3gpp)
         g_object_unref (ctx->location_3gpp);
     if (ctx->location_gps_nmea)
@@ -79,6 +85,12 @@ clear_location_context (MMIfaceModemLocation *self)
                         NULL);
 }
 
+static GVariant *build_location_value (MMModemLocationSource  source,
+                                       MMIfaceModemLocation  *self);
+static void      publish_location_updates (MMLocationUpdates     *updates,
+                                           MMModemLocationSource  sources,
+                                           MMIfaceModemLocation  *self);
+
 static LocationContext *
 get_location_context (MMIfaceModemLocation *self)
 {
@@ -90,8 +102,21 @@ get_location_context (MMIfaceModemLocation *self)
 
     ctx = g_object_get_qdata (G_OBJECT (self), location_context_quark);
     if (!ctx) {
+        g_autoptr(MmGdbusModemLocation) skeleton = NULL;
+        guint                           update_window = 0;
+
         /* Create context and keep it as object data */
         ctx = g_new0 (LocationContext, 1);
+        g_object_get (self,
+                      MM_IFACE_MODEM_LOCATION_DBUS_SKELETON, &skeleton,
+                      MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW, &update_window,
+                      NULL);
+        if (skeleton)
+            ctx->gps_refresh_rate = mm_gdbus_modem_location_get_gps_refresh_rate (skeleton);
+        ctx->updates = mm_location_updates_new (update_window,
+                                                (MMLocationUpdatesBuildFunc) build_location_value,
+                                                (MMLocationUpdatesPublishFunc) publish_location_updates,
+                                                self);
 
         g_object_set_qdata_full (
             G_OBJECT (self),
@@ -106,192 +131,109 @@ get_location_context (MMIfaceModemLocation *self)
 /*****************************************************************************/
 
 static GVariant *
-build_location_dictionary (GVariant *previous,
-                           MMLocation3gpp *location_3gpp,
-                           MMLocationGpsNmea *location_gps_nmea,
-                           MMLocationGpsRaw *location_gps_raw,
-                           MMLocationCdmaBs *location_cdma_bs)
-{
-    GVariant *location_3gpp_value = NULL;
-    GVariant *location_gps_nmea_value = NULL;
-    GVariant *location_gps_raw_value = NULL;
-    GVariant *location_cdma_bs_value = NULL;
-    GVariantBuilder builder;
-
-    /* If a previous dictionary given, parse its values */
-    if (previous) {
-        guint source;
-        GVariant *value;
-        GVariantIter iter;
-
-        g_variant_iter_init (&iter, previous);
-        while (g_variant_iter_next (&iter, "{uv}", &source, &value)) {
-            switch (source) {
-            case MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI:
-                g_assert (!location_3gpp_value);
-                location_3gpp_value = value;
-                break;
-            case MM_MODEM_LOCATION_SOURCE_GPS_NMEA:
-                g_assert (!location_gps_nmea_value);
-                location_gps_nmea_value = value;
-                break;
-            case MM_MODEM_LOCATION_SOURCE_GPS_RAW:
-                g_assert (!location_gps_raw_value);
-                location_gps_raw_value = value;
-                break;
-            case MM_MODEM_LOCATION_SOURCE_CDMA_BS:
-                g_assert (!location_cdma_bs_value);
-                location_cdma_bs_value = value;
-                break;
-            case MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED:
-                g_assert_not_reached ();
-            case MM_MODEM_LOCATION_SOURCE_AGPS_MSA:
-                g_assert_not_reached ();
-            case MM_MODEM_LOCATION_SOURCE_AGPS_MSB:
-                g_assert_not_reached ();
-            default:
-                g_warn_if_reached ();
-                g_variant_unref (value);
-                break;
-            }
-        }
-    }
-
-    /* Build the new one */
-    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{uv}"));
-
-    /* If a new one given, use it */
-    if (location_3gpp) {
-        if (location_3gpp_value)
-            g_variant_unref (location_3gpp_value);
-        location_3gpp_value = mm_location_3gpp_get_string_variant (location_3gpp);
-    }
-
-    if (location_3gpp_value) {
-        g_assert (!g_variant_is_floating (location_3gpp_value));
-        g_variant_builder_add (&builder,
-                               "{uv}",
-                               MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI,
-                               location_3gpp_value);
-        g_variant_unref (location_3gpp_value);
-    }
-
-    /* If a new one given, use it */
-    if (location_gps_nmea) {
-        if (location_gps_nmea_value)
-            g_variant_unref (location_gps_nmea_value);
-        location_gps_nmea_value = mm_location_gps_nmea_get_string_variant (location_gps_nmea);
-    }
+build_location_value (MMModemLocationSource  source,
+                      MMIfaceModemLocation  *self)
+{
+    LocationContext *ctx;
 
-    if (location_gps_nmea_value) {
-        g_assert (!g_variant_is_floating (location_gps_nmea_value));
-        g_variant_builder_add (&builder,
-                               "{uv}",
-                               MM_MODEM_LOCATION_SOURCE_GPS_NMEA,
-                               location_gps_nmea_value);
-        g_variant_unref (location_gps_nmea_value);
+    ctx = get_location_context (self);
+    switch (source) {
+    case MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI:
+        return ctx->location_3gpp ? mm_location_3gpp_get_string_variant (ctx->location_3gpp) : NULL;
+    case MM_MODEM_LOCATION_SOURCE_GPS_NMEA:
+        return ctx->location_gps_nmea ? mm_location_gps_nmea_get_string_variant (ctx->location_gps_nmea) : NULL;
+    case MM_MODEM_LOCATION_SOURCE_GPS_RAW:
+        return ctx->location_gps_raw ? mm_location_gps_raw_get_dictionary (ctx->location_gps_raw) : NULL;
+    case MM_MODEM_LOCATION_SOURCE_CDMA_BS:
+        return ctx->location_cdma_bs ? mm_location_cdma_bs_get_dictionary (ctx->location_cdma_bs) : NULL;
+    case MM_MODEM_LOCATION_SOURCE_NONE:
+    case MM_MODEM_LOCATION_SOURCE_GPS_UNMANAGED:
+    case MM_MODEM_LOCATION_SOURCE_AGPS_MSA:
+    case MM_MODEM_LOCATION_SOURCE_AGPS_MSB:
+    default:
+        g_assert_not_reached ();
     }
+}
 
-    /* If a new one given, use it */
-    if (location_gps_raw) {
-        if (location_gps_raw_value)
-            g_variant_unref (location_gps_raw_value);
-        location_gps_raw_value = mm_location_gps_raw_get_dictionary (location_gps_raw);
-    }
+static void
+publish_location_updates (MMLocationUpdates     *updates,
+                          MMModemLocationSource  sources,
+                          MMIfaceModemLocation  *self)
+{
+    g_autoptr(MmGdbusModemLocation) skeleton = NULL;
 
-    if (location_gps_raw_value) {
-        g_assert (!g_variant_is_floating (location_gps_raw_value));
-        g_variant_builder_add (&builder,
-                               "{uv}",
-                               MM_MODEM_LOCATION_SOURCE_GPS_RAW,
-                               location_gps_raw_value);
-        g_variant_unref (location_gps_raw_value);
-    }
+    g_object_get (self,
+                  MM_IFACE_MODEM_LOCATION_DBUS_SKELETON, &skeleton,
+                  NULL);
 
-    /* If a new one given, use it */
-    if (location_cdma_bs) {
-        if (location_cdma_bs_value)
-            g_variant_unref (location_cdma_bs_value);
-        location_cdma_bs_value = mm_location_cdma_bs_get_dictionary (location_cdma_bs);
-    }
+    /* We only update the property if we are supposed to signal
+     * location */
+    if (!skeleton || !mm_gdbus_modem_location_get_signals_location (skeleton))
+        return;
 
-    if (location_cdma_bs_value) {
-        g_assert (!g_variant_is_floating (location_cdma_bs_value));
-        g_variant_builder_add (&builder,
-                               "{uv}",
-                               MM_MODEM_LOCATION_SOURCE_CDMA_BS,
-                               location_cdma_bs_value);
-        g_variant_unref (location_cdma_bs_value);
-    }
+    mm_gdbus_modem_location_set_location (skeleton, mm_location_updates_build_dictionary (updates, sources));
+}
 
-    return g_variant_builder_end (&builder);
+static void
+schedule_location_update (MMIfaceModemLocation  *self,
+                          MMModemLocationSource  sources)
+{
+    mm_location_updates_schedule (get_location_context (self)->updates, sources);
 }
 
 /*****************************************************************************/
 
-static void
-notify_gps_location_update (MMIfaceModemLocation *self,
-                            MmGdbusModemLocation *skeleton,
-                            MMLocationGpsNmea *location_gps_nmea,
-                            MMLocationGpsRaw *location_gps_raw)
+static gboolean
+gps_refresh_rate_elapsed (LocationContext *ctx,
+                          gint64           now,
+                          gint64          *last_time)
 {
-    mm_obj_dbg (self, "GPS location updated");
-
-    /* We only update the property if we are supposed to signal
-     * location */
-    if (mm_gdbus_modem_location_get_signals_location (skeleton))
-        mm_gdbus_modem_location_set_location (
-            skeleton,
-            build_location_dictionary (mm_gdbus_modem_location_get_location (skeleton),
-                                       NULL,
-                                       location_gps_nmea,
-                                       location_gps_raw,
-                                       NULL));
+    if (*last_time != 0 && (now - *last_time) < ((gint64) ctx->gps_refresh_rate * G_USEC_PER_SEC))
+        return FALSE;
+    *last_time = now;
+    return TRUE;
 }
 
-static void
-location_gps_update_nmea (MMIfaceModemLocation *self,
-                          const gchar          *nmea_trace)
+void
+mm_iface_modem_location_gps_update_sentence (MMIfaceModemLocation *self,
+                                             const MMNmeaSentence *sentence)
 {
-    MmGdbusModemLocation *skeleton;
-    LocationContext      *ctx;
-    gboolean              update_nmea = FALSE;
-    gboolean              update_raw = FALSE;
+    LocationContext       *ctx;
+    MMModemLocationSource  updated = MM_MODEM_LOCATION_SOURCE_NONE;
+    gint64                 now;
 
+    /* The location objects only exist while the sources are enabled */
     ctx = get_location_context (self);
-    g_object_get (self,
-                  MM_IFACE_MODEM_LOCATION_DBUS_SKELETON, &skeleton,
-                  NULL);
-    if (!skeleton)
+    if (!ctx->location_gps_nmea && !ctx->location_gps_raw)
         return;
 
-    if (mm_gdbus_modem_location_get_enabled (skeleton) & MM_MODEM_LOCATION_SOURCE_GPS_NMEA) {
-        g_assert (ctx->location_gps_nmea != NULL);
-        if (mm_location_gps_nmea_add_trace (ctx->location_gps_nmea, nmea_trace) &&
-            (ctx->location_gps_nmea_last_time == 0 ||
-             time (NULL) - ctx->location_gps_nmea_last_time >= (glong)mm_gdbus_modem_location_get_gps_refresh_rate (skeleton))) {
-            ctx->location_gps_nmea_last_time = time (NULL);
-            update_nmea = TRUE;
-        }
-    }
+    /* The same sentence is fed to both location objects */
+    now = g_get_monotonic_time ();
 
-    if (mm_gdbus_modem_location_get_enabled (skeleton) & MM_MODEM_LOCATION_SOURCE_GPS_RAW) {
-        g_assert (ctx->location_gps_raw != NULL);
-        if (mm_location_gps_raw_add_trace (ctx->location_gps_raw, nmea_trace) &&
-            (ctx->location_gps_raw_last_time == 0 ||
-             time (NULL) - ctx->location_gps_raw_last_time >= (glong)mm_gdbus_modem_location_get_gps_refresh_rate (skeleton))) {
-            ctx->location_gps_raw_last_time = time (NULL);
-            update_raw = TRUE;
-        }
+    if (ctx->location_gps_nmea &&
+        mm_location_gps_nmea_add_sentence (ctx->location_gps_nmea, sentence) &&
+        gps_refresh_rate_elapsed (ctx, now, &ctx->location_gps_nmea_last_time))
+        updated |= MM_MODEM_LOCATION_SOURCE_GPS_NMEA;
+
+    if (ctx->location_gps_raw &&
+        mm_location_gps_raw_add_sentence (ctx->location_gps_raw, sentence) &&
+        gps_refresh_rate_elapsed (ctx, now, &ctx->location_gps_raw_last_time))
+        updated |= MM_MODEM_LOCATION_SOURCE_GPS_RAW;
+
+    if (updated) {
+        mm_obj_dbg (self, "GPS location updated");
+        schedule_location_update (self, updated);
     }
+}
 
-    if (update_nmea || update_raw)
-        notify_gps_location_update (self,
-                                    skeleton,
-                                    update_nmea ? ctx->location_gps_nmea : NULL,
-                                    update_raw ? ctx->location_gps_raw : NULL);
+static void
+location_gps_update_nmea (MMIfaceModemLocation *self,
+                          const gchar          *nmea_trace)
+{
+    MMNmeaSentence sentence;
 
-    g_object_unref (skeleton);
+    if (mm_nmea_sentence_parse (nmea_trace, -1, &sentence))
+        mm_iface_modem_location_gps_update_sentence (self, &sentence);
 }
 
 void
@@ -342,7 +284,6 @@ mm_iface_modem_location_gps_update (MMIfaceModemLocation *self,
 
 static void
 notify_3gpp_location_update (MMIfaceModemLocation *self,
-                             MmGdbusModemLocation *skeleton,
                              MMLocation3gpp *location_3gpp)
 {
     const gchar *operator_code;
@@ -355,15 +296,7 @@ notify_3gpp_location_update (MMIfaceModemLocation *self,
                 mm_location_3gpp_get_tracking_area_code (location_3gpp),
                 mm_location_3gpp_get_cell_id (location_3gpp));
 
-    /* We only update the property if we are supposed to signal
-     * location */
-    if (mm_gdbus_modem_location_get_signals_location (skeleton))
-        mm_gdbus_modem_location_set_location (
-            skeleton,
-            build_location_dictionary (mm_gdbus_modem_location_get_location (skeleton),
-                                       location_3gpp,
-                                       NULL, NULL,
-                                       NULL));
+    schedule_location_update (self, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI);
 }
 
 void
@@ -387,7 +320,7 @@ mm_iface_modem_location_3gpp_update_operator_code (MMIfaceModemLocation *self,
         changed += mm_location_3gpp_set_operator_code (ctx->location_3gpp,
                                                        operator_code);
         if (changed)
-            notify_3gpp_location_update (self, skeleton, ctx->location_3gpp);
+            notify_3gpp_location_update (self, ctx->location_3gpp);
     }
 
     g_object_unref (skeleton);
@@ -458,7 +391,7 @@ mm_iface_modem_location_3gpp_update_lac_tac_ci (MMIfaceModemLocation *self,
     }
 
     if (changed)
-        notify_3gpp_location_update (self, MM_GDBUS_MODEM_LOCATION (skeleton), ctx->location_3gpp);
+        notify_3gpp_location_update (self, ctx->location_3gpp);
 }
 
 void
@@ -477,7 +410,7 @@ mm_iface_modem_location_3gpp_clear (MMIfaceModemLocation *self)
     if (mm_gdbus_modem_location_get_enabled (skeleton) & MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI) {
         g_assert (ctx->location_3gpp != NULL);
         if (mm_location_3gpp_reset (ctx->location_3gpp))
-            notify_3gpp_location_update (self, skeleton, ctx->location_3gpp);
+            notify_3gpp_location_update (self, ctx->location_3gpp);
     }
 
     g_object_unref (skeleton);
@@ -487,22 +420,13 @@ mm_iface_modem_location_3gpp_clear (MMIfaceModemLocation *self)
 
 static void
 notify_cdma_bs_location_update (MMIfaceModemLocation *self,
-                                MmGdbusModemLocation *skeleton,
                                 MMLocationCdmaBs *location_cdma_bs)
 {
     mm_obj_dbg (self, "CDMA base station location updated (longitude: '%lf', latitude: '%lf')",
                 mm_location_cdma_bs_get_longitude (location_cdma_bs),
                 mm_location_cdma_bs_get_latitude (location_cdma_bs));
 
-    /* We only update the property if we are supposed to signal
-     * location */
-    if (mm_gdbus_modem_location_get_signals_location (skeleton))
-        mm_gdbus_modem_location_set_location (
-            skeleton,
-            build_location_dictionary (mm_gdbus_modem_location_get_location (skeleton),
-                                       NULL,
-                                       NULL, NULL,
-                                       location_cdma_bs));
+    schedule_location_update (self, MM_MODEM_LOCATION_SOURCE_CDMA_BS);
 }
 
 void
@@ -522,7 +446,7 @@ mm_iface_modem_location_cdma_bs_update (MMIfaceModemLocation *self,
 
     if (mm_gdbus_modem_location_get_enabled (skeleton) & MM_MODEM_LOCATION_SOURCE_CDMA_BS) {
         if (mm_location_cdma_bs_set (ctx->location_cdma_bs, longitude, latitude))
-            notify_cdma_bs_location_update (self, skeleton, ctx->location_cdma_bs);
+            notify_cdma_bs_location_update (self, ctx->location_cdma_bs);
     }
 
     g_object_unref (skeleton);
@@ -972,18 +896,20 @@ handle_setup_auth_ready (MMBaseModem *self,
                     ctx->signal_location ? "enabling" : "disabling");
         mm_gdbus_modem_location_set_signals_location (ctx->skeleton,
                                                       ctx->signal_location);
-        if (ctx->signal_location)
-            mm_gdbus_modem_location_set_location (
-                ctx->skeleton,
-                build_location_dictionary (mm_gdbus_modem_location_get_location (ctx->skeleton),
-                                           location_ctx->location_3gpp,
-                                           location_ctx->location_gps_nmea,
-                                           location_ctx->location_gps_raw,
-                                           location_ctx->location_cdma_bs));
-        else
+        if (ctx->signal_location) {
+            /* Publish the current values of all sources right away */
+            mm_location_updates_schedule (location_ctx->updates,
+                                          (MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI |
+                                           MM_MODEM_LOCATION_SOURCE_GPS_NMEA |
+                                           MM_MODEM_LOCATION_SOURCE_GPS_RAW |
+                                           MM_MODEM_LOCATION_SOURCE_CDMA_BS));
+            mm_location_updates_flush (location_ctx->updates);
+        } else {
+            mm_location_updates_clear (location_ctx->updates);
             mm_gdbus_modem_location_set_location (
                 ctx->skeleton,
-                build_location_dictionary (NULL, NULL, NULL, NULL, NULL));
+                mm_location_build_dictionary (NULL, NULL, NULL, NULL));
+        }
     }
 
     str = mm_modem_location_source_build_string_from_mask (ctx->sources);
@@ -1303,6 +1229,7 @@ handle_set_gps_refresh_rate_auth_ready (MMBaseModem *self,
 
     /* Set the new rate in the interface */
     mm_gdbus_modem_location_set_gps_refresh_rate (ctx->skeleton, ctx->rate);
+    get_location_context (ctx->self)->gps_refresh_rate = ctx->rate;
     mm_gdbus_modem_location_complete_set_gps_refresh_rate (ctx->skeleton, ctx->invocation);
     handle_set_gps_refresh_rate_context_free (ctx);
 }
@@ -1354,6 +1281,10 @@ handle_get_location_auth_ready (MMBaseModem *self,
     MMModemState modem_state;
     LocationContext *location_ctx;
     GError *error = NULL;
+    g_autoptr(GVariant) location_3gpp_value = NULL;
+    g_autoptr(GVariant) location_gps_nmea_value = NULL;
+    g_autoptr(GVariant) location_gps_raw_value = NULL;
+    g_autoptr(GVariant) location_cdma_bs_value = NULL;
 
     if (!mm_base_modem_authorize_finish (self, res, &error)) {
         g_dbus_method_invocation_take_error (ctx->invocation, error);
@@ -1376,14 +1307,17 @@ handle_get_location_auth_ready (MMBaseModem *self,
     }
 
     location_ctx = get_location_context (ctx->self);
+    location_3gpp_value = location_ctx->location_3gpp ? mm_location_3gpp_get_string_variant (location_ctx->location_3gpp) : NULL;
+    location_gps_nmea_value = location_ctx->location_gps_nmea ? mm_location_gps_nmea_get_string_variant (location_ctx->location_gps_nmea) : NULL;
+    location_gps_raw_value = location_ctx->location_gps_raw ? mm_location_gps_raw_get_dictionary (location_ctx->location_gps_raw) : NULL;
+    location_cdma_bs_value = location_ctx->location_cdma_bs ? mm_location_cdma_bs_get_dictionary (location_ctx->location_cdma_bs) : NULL;
     mm_gdbus_modem_location_complete_get_location (
         ctx->skeleton,
         ctx->invocation,
-        build_location_dictionary (NULL,
-                                   location_ctx->location_3gpp,
-                                   location_ctx->location_gps_nmea,
-                                   location_ctx->location_gps_raw,
-                                   location_ctx->location_cdma_bs));
+        mm_location_build_dictionary (location_3gpp_value,
+                                      location_gps_nmea_value,
+                                      location_gps_raw_value,
+                                      location_cdma_bs_value));
     handle_get_location_context_free (ctx);
 }
 
@@ -1881,9 +1815,11 @@ interface_initialization_step (GTask *task)
     case INITIALIZATION_STEP_GPS_REFRESH_RATE:
         /* If we have GPS capabilities, expose the GPS refresh rate */
         if (ctx->capabilities & ((MM_MODEM_LOCATION_SOURCE_GPS_RAW |
-                                  MM_MODEM_LOCATION_SOURCE_GPS_NMEA)))
+                                  MM_MODEM_LOCATION_SOURCE_GPS_NMEA))) {
             /* Set the default rate in the interface */
             mm_gdbus_modem_location_set_gps_refresh_rate (ctx->skeleton, MM_LOCATION_GPS_REFRESH_TIME_SECS);
+            get_location_context (self)->gps_refresh_rate = MM_LOCATION_GPS_REFRESH_TIME_SECS;
+        }
 
         ctx->step++;
         /* fall through */
@@ -1959,7 +1895,7 @@ mm_iface_modem_location_initialize (MMIfaceModemLocation *self,
         mm_gdbus_modem_location_set_enabled (skeleton, MM_MODEM_LOCATION_SOURCE_NONE);
         mm_gdbus_modem_location_set_signals_location (skeleton, FALSE);
         mm_gdbus_modem_location_set_location (skeleton,
-                                              build_location_dictionary (NULL, NULL, NULL, NULL, NULL));
+                                              mm_location_build_dictionary (NULL, NULL, NULL, NULL));
 
         g_object_set (self,
                       MM_IFACE_MODEM_LOCATION_DBUS_SKELETON, skeleton,
@@ -2016,6 +1952,14 @@ iface_modem_location_init (gpointer g_iface)
                                FALSE,
                                G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
+    g_object_interface_install_property
+        (g_iface,
+         g_param_spec_uint (MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW,
+                            "Location update window",
+                            "Time window, in milliseconds, in which location updates are coalesced; 0 to publish them right away",
+                            0, G_MAXUINT, MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW_DEFAULT_MS,
+                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
     initialized = TRUE;
 }
 
@@ -29,6 +29,9 @@
 
 #define MM_IFACE_MODEM_LOCATION_DBUS_SKELETON              "iface-modem-location-dbus-skeleton"
 #define MM_IFACE_MODEM_LOCATION_ALLOW_GPS_UNMANAGED_ALWAYS "iface-modem-location-allow-gps-unmanaged-always"
+#define MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW              "iface-modem-location-update-window"
+
+#define MM_IFACE_MODEM_LOCATION_UPDATE_WINDOW_DEFAULT_MS 100
 
 typedef struct _MMIfaceModemLocation MMIfaceModemLocation;
 
@@ -147,8 +150,10 @@ void mm_iface_modem_location_3gpp_update_lac_tac_ci  (MMIfaceModemLocation *self
                                                       gulong cell_id);
 
 /* Update GPS location */
-void mm_iface_modem_location_gps_update (MMIfaceModemLocation *self,
-                                         const gchar *nmea_trace);
+void mm_iface_modem_location_gps_update          (MMIfaceModemLocation *self,
+                                                  const gchar *nmea_trace);
+void mm_iface_modem_location_gps_update_sentence (MMIfaceModemLocation *self,
+                                                  const MMNmeaSentence *sentence);
 
 /* Update CDMA BS location */
 void mm_iface_modem_location_cdma_bs_update (MMIfaceModemLocation *self,
@@ -21,6 +21,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-signal.h"
 #include "mm-log-object.h"
+#include "mm-timer.h"
 
 #define SUPPORT_CHECKED_TAG "signal-support-checked-tag"
 #define SUPPORTED_TAG       "signal-supported-tag"
@@ -41,13 +42,18 @@ typedef struct {
     /* threshold-based reporting enabled */
     guint    rssi_threshold;
     gboolean error_rate_threshold;
+    /* monotonic time of the last indication, 0 if none */
+    gint64   indication_time;
+    /* reporting statistics */
+    guint    n_indications;
+    guint    n_polls;
 } Private;
 
 static void
 private_free (Private *priv)
 {
     if (priv->timeout_source)
-        g_source_remove (priv->timeout_source);
+        mm_timer_remove (priv->timeout_source);
     g_slice_free (Private, priv);
 }
 
@@ -143,6 +149,26 @@ internal_signal_update (MMIfaceModemSignal *self,
     g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
 }
 
+static void
+signal_update (MMIfaceModemSignal *self,
+               MMSignal           *cdma,
+               MMSignal           *evdo,
+               MMSignal           *gsm,
+               MMSignal           *umts,
+               MMSignal           *lte,
+               MMSignal           *nr5g)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (!priv->rate && !priv->rssi_threshold && !priv->error_rate_threshold) {
+        mm_obj_dbg (self, "skipping extended signal information update...");
+        return;
+    }
+
+    internal_signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
+}
+
 void
 mm_iface_modem_signal_update (MMIfaceModemSignal *self,
                               MMSignal           *cdma,
@@ -155,12 +181,24 @@ mm_iface_modem_signal_update (MMIfaceModemSignal *self,
     Private *priv;
 
     priv = get_private (self);
-    if (!priv->rate && !priv->rssi_threshold && !priv->error_rate_threshold) {
-        mm_obj_dbg (self, "skipping extended signal information update...");
-        return;
-    }
+    priv->indication_time = g_get_monotonic_time ();
+    priv->n_indications++;
 
-    internal_signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
+    signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
+}
+
+void
+mm_iface_modem_signal_get_report_stats (MMIfaceModemSignal *self,
+                                        guint              *out_n_indications,
+                                        guint              *out_n_polls)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (out_n_indications)
+        *out_n_indications = priv->n_indications;
+    if (out_n_polls)
+        *out_n_polls = priv->n_polls;
 }
 
 /*****************************************************************************/
@@ -174,7 +212,7 @@ check_interface_reset (MMIfaceModemSignal *self)
 
     if (!priv->rate && !priv->rssi_threshold && !priv->error_rate_threshold) {
         mm_obj_dbg (self, "reseting extended signal information...");
-        mm_iface_modem_signal_update (self, NULL, NULL, NULL, NULL, NULL, NULL);
+        signal_update (self, NULL, NULL, NULL, NULL, NULL, NULL);
     }
 }
 
@@ -206,12 +244,25 @@ load_values_ready (MMIfaceModemSignal *self,
         return;
     }
 
-    mm_iface_modem_signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
+    signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
 }
 
 static gboolean
 polling_context_cb (MMIfaceModemSignal *self)
 {
+    Private *priv;
+
+    priv = get_private (self);
+
+    /* Values reported by indications within the last period are as recent
+     * as the ones we would load now */
+    if (priv->indication_time &&
+        (g_get_monotonic_time () - priv->indication_time) < (gint64) priv->rate * G_USEC_PER_SEC) {
+        mm_obj_dbg (self, "extended signal information recently reported by indications: not polling");
+        return G_SOURCE_CONTINUE;
+    }
+
+    priv->n_polls++;
     MM_IFACE_MODEM_SIGNAL_GET_INTERFACE (self)->load_values (
         self,
         NULL,
@@ -249,7 +300,7 @@ polling_restart (MMIfaceModemSignal  *self,
     if (rate == 0) {
         mm_obj_dbg (self, "extended signal information polling disabled (rate: 0 seconds)");
         if (priv->timeout_source) {
-            g_source_remove (priv->timeout_source);
+            mm_timer_remove (priv->timeout_source);
             priv->timeout_source = 0;
         }
         check_interface_reset (self);
@@ -259,8 +310,8 @@ polling_restart (MMIfaceModemSignal  *self,
     /* Restart polling */
     mm_obj_dbg (self, "extended signal information reporting enabled (rate: %u seconds)", rate);
     if (priv->timeout_source)
-        g_source_remove (priv->timeout_source);
-    priv->timeout_source = g_timeout_add_seconds (rate, (GSourceFunc) polling_context_cb, self);
+        mm_timer_remove (priv->timeout_source);
+    priv->timeout_source = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING, MM_LOG_OBJECT (self), rate, (GSourceFunc) polling_context_cb, self);
 
     /* Also launch right away */
     polling_context_cb (self);
@@ -484,9 +535,12 @@ mm_iface_modem_signal_disable (MMIfaceModemSignal  *self,
                                GAsyncReadyCallback  callback,
                                gpointer             user_data)
 {
-    GTask *task;
+    GTask   *task;
+    Private *priv;
 
-    mm_iface_modem_signal_update (self, NULL, NULL, NULL, NULL, NULL, NULL);
+    priv = get_private (self);
+    priv->indication_time = 0;
+    signal_update (self, NULL, NULL, NULL, NULL, NULL, NULL);
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_return_boolean (task, TRUE);
@@ -115,4 +115,9 @@ void mm_iface_modem_signal_update (MMIfaceModemSignal *self,
                                    MMSignal           *lte,
                                    MMSignal           *nr5g);
 
+/* Extended signal information updates received via indications and polls */
+void mm_iface_modem_signal_get_report_stats (MMIfaceModemSignal *self,
+                                             guint              *out_n_indications,
+                                             guint              *out_n_polls);
+
 #endif /* MM_IFACE_MODEM_SIGNAL_H */
@@ -20,6 +20,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-time.h"
 #include "mm-log-object.h"
+#include "mm-timer.h"
 
 #define SUPPORT_CHECKED_TAG          "time-support-checked-tag"
 #define SUPPORTED_TAG                "time-supported-tag"
@@ -163,7 +164,7 @@ network_timezone_context_free (NetworkTimezoneContext *ctx)
      * in stop_network_timezone() when the logic is disabled (or will be done
      * automatically when the last modem object reference is dropped) */
     if (ctx->network_timezone_poll_id)
-        g_source_remove (ctx->network_timezone_poll_id);
+        mm_timer_remove (ctx->network_timezone_poll_id);
     g_free (ctx);
 }
 
@@ -220,9 +221,11 @@ load_network_timezone_ready (MMIfaceModemTime *self,
         }
 
         /* Otherwise, relaunch timeout to query a bit later */
-        ctx->network_timezone_poll_id = g_timeout_add_seconds (NETWORK_TIMEZONE_POLL_INTERVAL_SEC,
-                                                               (GSourceFunc)network_timezone_poll_cb,
-                                                               self);
+        ctx->network_timezone_poll_id = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                              MM_LOG_OBJECT (self),
+                                                              NETWORK_TIMEZONE_POLL_INTERVAL_SEC,
+                                                              (GSourceFunc)network_timezone_poll_cb,
+                                                              self);
         return;
     }
 
@@ -256,7 +259,7 @@ start_network_timezone_poll (MMIfaceModemTime *self)
 
     mm_obj_dbg (self, "network timezone polling started");
     ctx->network_timezone_poll_retries = NETWORK_TIMEZONE_POLL_RETRIES;
-    ctx->network_timezone_poll_id = g_timeout_add_seconds (NETWORK_TIMEZONE_POLL_INTERVAL_SEC, (GSourceFunc)network_timezone_poll_cb, self);
+    ctx->network_timezone_poll_id = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING, MM_LOG_OBJECT (self), NETWORK_TIMEZONE_POLL_INTERVAL_SEC, (GSourceFunc)network_timezone_poll_cb, self);
 }
 
 static void
@@ -268,7 +271,7 @@ stop_network_timezone_poll (MMIfaceModemTime *self)
 
     if (ctx->network_timezone_poll_id) {
         mm_obj_dbg (self, "network timezone polling stopped");
-        g_source_remove (ctx->network_timezone_poll_id);
+        mm_timer_remove (ctx->network_timezone_poll_id);
         ctx->network_timezone_poll_id = 0;
     }
 }
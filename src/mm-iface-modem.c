@@ -29,6 +29,8 @@
 #include "mm-log-object.h"
 #include "mm-context.h"
 #include "mm-fcc-unlock-dispatcher.h"
+#include "mm-modem-snapshot.h"
+#include "mm-timer.h"
 #if defined WITH_QMI
 # include "mm-broadband-modem-qmi.h"
 #endif
@@ -40,7 +42,6 @@
 
 #define SIGNAL_CHECK_INITIAL_RETRIES      5
 #define SIGNAL_CHECK_INITIAL_TIMEOUT_SEC  3
-#define SIGNAL_CHECK_TIMEOUT_SEC          30
 
 #define STATE_UPDATE_CONTEXT_TAG          "state-update-context-tag"
 #define SIGNAL_QUALITY_UPDATE_CONTEXT_TAG "signal-quality-update-context-tag"
@@ -1343,10 +1344,13 @@ handle_get_cell_info (MmGdbusModem          *skeleton,
 
 /*****************************************************************************/
 
-void
-mm_iface_modem_update_access_technologies (MMIfaceModem *self,
-                                           MMModemAccessTechnology new_access_tech,
-                                           guint32 mask)
+static void signal_check_indication_received (MMIfaceModem        *self,
+                                              MMSignalReportValue  value);
+
+static void
+update_access_technologies (MMIfaceModem *self,
+                            MMModemAccessTechnology new_access_tech,
+                            guint32 mask)
 {
     MmGdbusModem *skeleton = NULL;
     MMModemAccessTechnology old_access_tech;
@@ -1386,6 +1390,23 @@ mm_iface_modem_update_access_technologies (MMIfaceModem *self,
     g_object_unref (skeleton);
 }
 
+void
+mm_iface_modem_update_access_technologies (MMIfaceModem *self,
+                                           MMModemAccessTechnology new_access_tech,
+                                           guint32 mask)
+{
+    signal_check_indication_received (self, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES);
+    update_access_technologies (self, new_access_tech, mask);
+}
+
+void
+mm_iface_modem_update_polled_access_technologies (MMIfaceModem *self,
+                                                  MMModemAccessTechnology new_access_tech,
+                                                  guint32 mask)
+{
+    update_access_technologies (self, new_access_tech, mask);
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -1503,11 +1524,20 @@ void
 mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                       guint signal_quality)
 {
+    signal_check_indication_received (self, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY);
     update_signal_quality (self, signal_quality, TRUE);
 }
 
 /*****************************************************************************/
-/* Signal info (quality and access technology) polling */
+/* Signal info (quality and access technology) polling
+ *
+ * Values reported by the modem through indications (e.g. +CIEV, QMI NAS
+ * signal info, MBIM signal state notifications) or by registration updates
+ * make polling unneeded for a while, see MMSignalReport. Plugins that setup
+ * indications flag it with the PERIODIC_*_CHECK_DISABLED properties, and in
+ * that case the values are only polled in the initial check, and then as a
+ * keep-alive if one is configured.
+ */
 
 typedef enum {
     SIGNAL_CHECK_STEP_NONE,
@@ -1531,12 +1561,9 @@ typedef struct {
     MMModemAccessTechnology access_technologies;
     guint                   access_technologies_mask;
 
-    /* If both signal and access tech polling are either unsupported
-     * or disabled, we'll automatically stop polling */
-    gboolean signal_quality_polling_supported;
-    gboolean signal_quality_polling_disabled;
-    gboolean access_technology_polling_supported;
-    gboolean access_technology_polling_disabled;
+    /* Which values to poll and when. If both signal and access tech polling
+     * are unsupported, we'll automatically stop polling. */
+    MMSignalReport *report;
 
     /* Steps triggered when polling active */
     SignalCheckStep running_step;
@@ -1546,7 +1573,8 @@ static void
 signal_check_context_free (SignalCheckContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_timer_remove (ctx->timeout_source);
+    mm_signal_report_free (ctx->report);
     g_slice_free (SignalCheckContext, ctx);
 }
 
@@ -1564,24 +1592,23 @@ get_signal_check_context (MMIfaceModem *self)
         /* Create context and attach it to the object */
         ctx = g_slice_new0 (SignalCheckContext);
         ctx->running_step = SIGNAL_CHECK_STEP_NONE;
+        ctx->report = mm_signal_report_new (mm_context_get_signal_keep_alive ());
 
         /* Initially assume supported if load_access_technologies() is
          * implemented. If the plugin reports an UNSUPPORTED error we'll clear
          * this flag and no longer poll. */
-        ctx->access_technology_polling_supported = (MM_IFACE_MODEM_GET_INTERFACE (self)->load_access_technologies &&
-                                                    MM_IFACE_MODEM_GET_INTERFACE (self)->load_access_technologies_finish);
+        mm_signal_report_set_polling_supported (ctx->report,
+                                                MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES,
+                                                (MM_IFACE_MODEM_GET_INTERFACE (self)->load_access_technologies &&
+                                                 MM_IFACE_MODEM_GET_INTERFACE (self)->load_access_technologies_finish));
 
         /* Initially assume supported if load_signal_quality() is
          * implemented. If the plugin reports an UNSUPPORTED error we'll clear
          * this flag and no longer poll. */
-        ctx->signal_quality_polling_supported = (MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality &&
-                                                 MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality_finish);
-
-        /* Get plugin-specific setup for the polling logic */
-        g_object_get (self,
-                      MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED,      &ctx->signal_quality_polling_disabled,
-                      MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, &ctx->access_technology_polling_disabled,
-                      NULL);
+        mm_signal_report_set_polling_supported (ctx->report,
+                                                MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY,
+                                                (MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality &&
+                                                 MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality_finish));
 
         g_object_set_qdata_full (G_OBJECT (self), signal_check_context_quark,
                                  ctx, (GDestroyNotify) signal_check_context_free);
@@ -1596,6 +1623,30 @@ static void     periodic_signal_check_disable (MMIfaceModem *self,
 static gboolean periodic_signal_check_cb      (MMIfaceModem *self);
 static void     periodic_signal_check_step    (MMIfaceModem *self);
 
+static void
+signal_check_indication_received (MMIfaceModem        *self,
+                                  MMSignalReportValue  value)
+{
+    SignalCheckContext *ctx;
+
+    ctx = get_signal_check_context (self);
+    mm_signal_report_indication (ctx->report, value, g_get_monotonic_time ());
+}
+
+void
+mm_iface_modem_get_signal_report_stats (MMIfaceModem       *self,
+                                        MMSignalReportMode *out_mode,
+                                        guint              *out_n_indications,
+                                        guint              *out_n_polls)
+{
+    SignalCheckContext *ctx;
+
+    ctx = get_signal_check_context (self);
+    mm_signal_report_get_stats (ctx->report, out_mode, out_n_indications, out_n_polls);
+    if (out_mode && !ctx->enabled)
+        *out_mode = MM_SIGNAL_REPORT_MODE_NONE;
+}
+
 static void
 access_technologies_check_ready (MMIfaceModem *self,
                                  GAsyncResult *res)
@@ -1614,7 +1665,7 @@ access_technologies_check_ready (MMIfaceModem *self,
         /* Did the plugin report that polling access technology is unsupported? */
         if (g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED)) {
             mm_obj_dbg (self, "polling to refresh access technologies is unsupported");
-            ctx->access_technology_polling_supported = FALSE;
+            mm_signal_report_set_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES, FALSE);
         }
         /* Ignore logging any message if the error is in 'in-progress' */
         else if (!g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_IN_PROGRESS))
@@ -1623,7 +1674,9 @@ access_technologies_check_ready (MMIfaceModem *self,
     }
     /* We may have been disabled while this command was running. */
     else if (ctx->enabled)
-        mm_iface_modem_update_access_technologies (self, ctx->access_technologies, ctx->access_technologies_mask);
+        update_access_technologies (self, ctx->access_technologies, ctx->access_technologies_mask);
+
+    mm_signal_report_polled (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES, ctx->access_technologies);
 
     /* Go on */
     ctx->running_step++;
@@ -1644,7 +1697,7 @@ signal_quality_check_ready (MMIfaceModem *self,
         /* Did the plugin report that polling signal quality is unsupported? */
         if (g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED)) {
             mm_obj_dbg (self, "polling to refresh signal quality is unsupported");
-            ctx->signal_quality_polling_supported = FALSE;
+            mm_signal_report_set_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY, FALSE);
         }
         /* Ignore logging any message if the error is in 'in-progress' */
         else if (!g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_IN_PROGRESS))
@@ -1655,6 +1708,8 @@ signal_quality_check_ready (MMIfaceModem *self,
     else if (ctx->enabled)
         update_signal_quality (self, ctx->signal_quality, TRUE);
 
+    mm_signal_report_polled (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY, ctx->signal_quality);
+
     /* Go on */
     ctx->running_step++;
     periodic_signal_check_step (self);
@@ -1672,12 +1727,13 @@ periodic_signal_check_step (MMIfaceModem *self)
         g_assert_not_reached ();
 
     case SIGNAL_CHECK_STEP_FIRST:
+        mm_signal_report_start_check (ctx->report);
         ctx->running_step++;
         /* fall-through */
 
     case SIGNAL_CHECK_STEP_SIGNAL_QUALITY:
-        if (ctx->enabled && ctx->signal_quality_polling_supported &&
-            (!ctx->initial_check_done || !ctx->signal_quality_polling_disabled)) {
+        if (ctx->enabled &&
+            mm_signal_report_poll_needed (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY, g_get_monotonic_time ())) {
             MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality (
                 self, (GAsyncReadyCallback)signal_quality_check_ready, NULL);
             return;
@@ -1686,8 +1742,8 @@ periodic_signal_check_step (MMIfaceModem *self)
         /* fall-through */
 
     case SIGNAL_CHECK_STEP_ACCESS_TECHNOLOGIES:
-        if (ctx->enabled && ctx->access_technology_polling_supported &&
-            (!ctx->initial_check_done || !ctx->access_technology_polling_disabled)) {
+        if (ctx->enabled &&
+            mm_signal_report_poll_needed (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES, g_get_monotonic_time ())) {
             MM_IFACE_MODEM_GET_INTERFACE (self)->load_access_technologies (
                 self, (GAsyncReadyCallback)access_technologies_check_ready, NULL);
             return;
@@ -1695,7 +1751,11 @@ periodic_signal_check_step (MMIfaceModem *self)
         ctx->running_step++;
         /* fall-through */
 
-    case SIGNAL_CHECK_STEP_LAST:
+    case SIGNAL_CHECK_STEP_LAST: {
+        MMSignalReportMode previous_mode;
+        MMSignalReportMode mode;
+        guint              timeout;
+
         /* Flag as sequence finished */
         ctx->running_step = SIGNAL_CHECK_STEP_NONE;
 
@@ -1717,33 +1777,60 @@ periodic_signal_check_step (MMIfaceModem *self)
 
             /* Signal quality is ready if unsupported or if we got a valid
              * value reported */
-            signal_quality_ready = (!ctx->signal_quality_polling_supported || (ctx->signal_quality != 0));
+            signal_quality_ready = (!mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY) ||
+                                    (ctx->signal_quality != 0));
 
             /* Access technology is ready if unsupported or if we got a valid
              * value reported */
-            access_technology_ready = (!ctx->access_technology_polling_supported ||
+            access_technology_ready = (!mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES) ||
                                        ((ctx->access_technologies & ctx->access_technologies_mask) != MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN));
 
             ctx->initial_check_done = ((signal_quality_ready && access_technology_ready) || (--ctx->initial_retries == 0));
+            if (!ctx->initial_check_done) {
+                g_assert (!ctx->timeout_source);
+                mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled in %us", SIGNAL_CHECK_INITIAL_TIMEOUT_SEC);
+                ctx->timeout_source = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                            MM_LOG_OBJECT (self),
+                                                            SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
+                                                            (GSourceFunc) periodic_signal_check_cb,
+                                                            self);
+                return;
+            }
+            mm_signal_report_initial_check_done (ctx->report, g_get_monotonic_time ());
         }
 
         /* After running the initial check, if both signal quality and access tech
-         * loading are either disabled or unsupported, we'll stop polling completely,
-         * because they may be loaded asynchronously by unsolicited messages */
-        if (ctx->initial_check_done &&
-            (!ctx->signal_quality_polling_supported    || ctx->signal_quality_polling_disabled) &&
-            (!ctx->access_technology_polling_supported || ctx->access_technology_polling_disabled)) {
-            mm_obj_dbg (self, "periodic signal quality and access technology checks not rescheduled: unneeded or unsupported");
+         * loading are unsupported, we'll stop polling completely, because they
+         * may only be loaded asynchronously by unsolicited messages */
+        if (!mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY) &&
+            !mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES)) {
+            mm_obj_dbg (self, "periodic signal quality and access technology checks not rescheduled: unsupported");
             periodic_signal_check_disable (self, FALSE);
             return;
         }
 
-        mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled");
+        mm_signal_report_get_stats (ctx->report, &previous_mode, NULL, NULL);
+        timeout = mm_signal_report_end_check (ctx->report, g_get_monotonic_time ());
+        mm_signal_report_get_stats (ctx->report, &mode, NULL, NULL);
+        if (mode != previous_mode)
+            mm_obj_dbg (self, "signal quality and access technologies now reported by %s",
+                        mm_signal_report_mode_get_string (mode));
+
+        /* Values reported by indications which are never polled again */
+        if (!timeout) {
+            mm_obj_dbg (self, "periodic signal quality and access technology checks not rescheduled: reported by indications");
+            return;
+        }
+
         g_assert (!ctx->timeout_source);
-        ctx->timeout_source = g_timeout_add_seconds (ctx->initial_check_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
-                                                     (GSourceFunc) periodic_signal_check_cb,
-                                                     self);
+        mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled in %us", timeout);
+        ctx->timeout_source = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING,
+                                                    MM_LOG_OBJECT (self),
+                                                    timeout,
+                                                    (GSourceFunc) periodic_signal_check_cb,
+                                                    self);
         return;
+    }
 
     default:
         g_assert_not_reached ();
@@ -1758,16 +1845,16 @@ periodic_signal_check_cb (MMIfaceModem *self)
     ctx = get_signal_check_context (self);
     g_assert (ctx->enabled);
 
+    /* The source is removed once we return; clear its id before running the
+     * sequence, which may complete right away and schedule the next one */
+    ctx->timeout_source = 0;
+
     /* Start the sequence */
     ctx->running_step             = SIGNAL_CHECK_STEP_FIRST;
     ctx->signal_quality           = 0;
     ctx->access_technologies      = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
     ctx->access_technologies_mask = MM_MODEM_ACCESS_TECHNOLOGY_ANY;
     periodic_signal_check_step (self);
-
-    /* Remove the timeout and clear the source id */
-    if (ctx->timeout_source)
-        ctx->timeout_source = 0;
     return G_SOURCE_REMOVE;
 }
 
@@ -1795,7 +1882,7 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
     /* Remove the scheduled timeout as we're going to refresh
      * right away */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_timer_remove (ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1803,6 +1890,7 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
      * so that we poll at a higher frequency */
     ctx->initial_retries    = SIGNAL_CHECK_INITIAL_RETRIES;
     ctx->initial_check_done = FALSE;
+    mm_signal_report_restart (ctx->report);
 
     /* Start sequence */
     periodic_signal_check_cb (self);
@@ -1821,14 +1909,17 @@ periodic_signal_check_disable (MMIfaceModem *self,
     /* Clear access technology and signal quality */
     if (clear) {
         update_signal_quality (self, 0, FALSE);
-        mm_iface_modem_update_access_technologies (self,
-                                                   MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
-                                                   MM_MODEM_ACCESS_TECHNOLOGY_ANY);
+        update_access_technologies (self,
+                                    MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
+                                    MM_MODEM_ACCESS_TECHNOLOGY_ANY);
     }
 
+    /* Indications received while disabled don't count */
+    mm_signal_report_clear (ctx->report);
+
     /* Remove scheduled timeout */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_timer_remove (ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1840,12 +1931,24 @@ static void
 periodic_signal_check_enable (MMIfaceModem *self)
 {
     SignalCheckContext *ctx;
+    gboolean            signal_quality_indications = FALSE;
+    gboolean            access_technologies_indications = FALSE;
 
     ctx = get_signal_check_context (self);
 
+    /* Get plugin-specific setup for the polling logic, which may change
+     * while enabling, e.g. once indications are setup */
+    g_object_get (self,
+                  MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED,      &signal_quality_indications,
+                  MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, &access_technologies_indications,
+                  NULL);
+    mm_signal_report_set_indications (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY, signal_quality_indications);
+    mm_signal_report_set_indications (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES, access_technologies_indications);
+
     /* If polling access technology and signal quality not supported, don't even
      * bother trying. */
-    if (!ctx->signal_quality_polling_supported && !ctx->access_technology_polling_supported) {
+    if (!mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY) &&
+        !mm_signal_report_get_polling_supported (ctx->report, MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES)) {
         mm_obj_dbg (self, "not enabling periodic signal checks: unsupported");
         return;
     }
@@ -4645,12 +4748,14 @@ typedef enum {
     INITIALIZATION_STEP_SUPPORTED_CHARSETS,
     INITIALIZATION_STEP_CHARSET,
     INITIALIZATION_STEP_BEARERS,
+    INITIALIZATION_STEP_SNAPSHOT,
     INITIALIZATION_STEP_MANUFACTURER,
     INITIALIZATION_STEP_MODEL,
     INITIALIZATION_STEP_REVISION,
     INITIALIZATION_STEP_CARRIER_CONFIG,
     INITIALIZATION_STEP_HARDWARE_REVISION,
     INITIALIZATION_STEP_EQUIPMENT_ID,
+    INITIALIZATION_STEP_SNAPSHOT_CONFIRM,
     INITIALIZATION_STEP_DEVICE_ID,
     INITIALIZATION_STEP_SUPPORTED_MODES,
     INITIALIZATION_STEP_SUPPORTED_BANDS,
@@ -4672,6 +4777,8 @@ struct _InitializationContext {
     MmGdbusModem *skeleton;
     MMModemCharset supported_charsets;
     const MMModemCharset *current_charset;
+    /* Properties set from the snapshot, until confirmed */
+    GStrv snapshot_loaded;
     GError *fatal_error;
 };
 
@@ -4680,6 +4787,7 @@ initialization_context_free (InitializationContext *ctx)
 {
     g_assert (ctx->fatal_error == NULL);
     g_object_unref (ctx->skeleton);
+    g_strfreev (ctx->snapshot_loaded);
     g_free (ctx);
 }
 
@@ -5572,6 +5680,16 @@ interface_initialization_step (GTask *task)
         ctx->step++;
     } /* fall-through */
 
+    case INITIALIZATION_STEP_SNAPSHOT:
+        /* Static info stored in a previous run for the same device is used
+         * instead of loading it again from the modem, until the revision and
+         * equipment ID confirm it's still the same modem and firmware. */
+        ctx->snapshot_loaded = mm_modem_snapshot_lookup (mm_modem_snapshot_get (), ctx->skeleton);
+        if (ctx->snapshot_loaded)
+            mm_obj_dbg (self, "static modem info loaded from snapshot");
+        ctx->step++;
+        /* fall-through */
+
     case INITIALIZATION_STEP_MANUFACTURER:
         /* Manufacturer is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
@@ -5667,6 +5785,23 @@ interface_initialization_step (GTask *task)
         ctx->step++;
         /* fall-through */
 
+    case INITIALIZATION_STEP_SNAPSHOT_CONFIRM:
+        if (ctx->snapshot_loaded) {
+            if (!mm_modem_snapshot_confirm (mm_modem_snapshot_get (), ctx->skeleton)) {
+                /* Not the modem or firmware seen before: load everything
+                 * that was taken from the snapshot again */
+                mm_obj_dbg (self, "static modem info from snapshot is outdated, reloading it");
+                mm_modem_snapshot_clear_loaded (ctx->skeleton, (const gchar *const *) ctx->snapshot_loaded);
+                g_clear_pointer (&ctx->snapshot_loaded, g_strfreev);
+                ctx->step = INITIALIZATION_STEP_MANUFACTURER;
+                interface_initialization_step (task);
+                return;
+            }
+            g_clear_pointer (&ctx->snapshot_loaded, g_strfreev);
+        }
+        ctx->step++;
+        /* fall-through */
+
     case INITIALIZATION_STEP_DEVICE_ID:
         /* Device ID is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
@@ -6012,8 +6147,11 @@ interface_initialization_step (GTask *task)
         if (ctx->fatal_error) {
             g_task_return_error (task, ctx->fatal_error);
             ctx->fatal_error = NULL;
-        } else
+        } else {
+            /* Only store static info after a full successful initialization */
+            mm_modem_snapshot_store (mm_modem_snapshot_get (), ctx->skeleton);
             g_task_return_boolean (task, TRUE);
+        }
 
         g_object_unref (task);
         return;
@@ -27,6 +27,7 @@
 #include "mm-base-bearer.h"
 #include "mm-base-sim.h"
 #include "mm-bearer-list.h"
+#include "mm-signal-report.h"
 
 #define MM_TYPE_IFACE_MODEM            (mm_iface_modem_get_type ())
 #define MM_IFACE_MODEM(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_IFACE_MODEM, MMIfaceModem))
@@ -549,6 +550,12 @@ void mm_iface_modem_update_access_technologies (MMIfaceModem *self,
                                                 MMModemAccessTechnology access_tech,
                                                 guint32 mask);
 
+/* Allow reporting access tech loaded while polling signal quality, which is
+ * not taken as an indication */
+void mm_iface_modem_update_polled_access_technologies (MMIfaceModem *self,
+                                                       MMModemAccessTechnology access_tech,
+                                                       guint32 mask);
+
 /* Allow updating signal quality */
 void mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                            guint signal_quality);
@@ -556,6 +563,12 @@ void mm_iface_modem_update_signal_quality (MMIfaceModem *self,
 /* Allow requesting to refresh signal via polling */
 void mm_iface_modem_refresh_signal (MMIfaceModem *self);
 
+/* How signal quality and access technology updates are being received */
+void mm_iface_modem_get_signal_report_stats (MMIfaceModem       *self,
+                                             MMSignalReportMode *out_mode,
+                                             guint              *out_n_indications,
+                                             guint              *out_n_polls);
+
 /* Allow setting allowed modes */
 void     mm_iface_modem_set_current_modes        (MMIfaceModem *self,
                                                   MMModemMode allowed,
@@ -0,0 +1,185 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+
+#include "mm-location-updates.h"
+
+struct _MMLocationUpdates {
+    guint                         window_ms;
+    MMLocationUpdatesBuildFunc    build_func;
+    MMLocationUpdatesPublishFunc  publish_func;
+    gpointer                      user_data;
+
+    /* Last published value of each source */
+    GVariant *location_3gpp_value;
+    GVariant *location_gps_nmea_value;
+    GVariant *location_gps_raw_value;
+    GVariant *location_cdma_bs_value;
+
+    /* Sources updated but not yet published, and the timeout publishing
+     * them once the update window is over */
+    MMModemLocationSource pending;
+    guint                 pending_id;
+};
+
+/*****************************************************************************/
+
+GVariant *
+mm_location_build_dictionary (GVariant *location_3gpp_value,
+                              GVariant *location_gps_nmea_value,
+                              GVariant *location_gps_raw_value,
+                              GVariant *location_cdma_bs_value)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{uv}"));
+
+    if (location_3gpp_value)
+        g_variant_builder_add (&builder,
+                               "{uv}",
+                               MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI,
+                               location_3gpp_value);
+    if (location_gps_nmea_value)
+        g_variant_builder_add (&builder,
+                               "{uv}",
+                               MM_MODEM_LOCATION_SOURCE_GPS_NMEA,
+                               location_gps_nmea_value);
+    if (location_gps_raw_value)
+        g_variant_builder_add (&builder,
+                               "{uv}",
+                               MM_MODEM_LOCATION_SOURCE_GPS_RAW,
+                               location_gps_raw_value);
+    if (location_cdma_bs_value)
+        g_variant_builder_add (&builder,
+                               "{uv}",
+                               MM_MODEM_LOCATION_SOURCE_CDMA_BS,
+                               location_cdma_bs_value);
+
+    return g_variant_builder_end (&builder);
+}
+
+/*****************************************************************************/
+
+static void
+update_value (MMLocationUpdates      *self,
+              MMModemLocationSource   source,
+              GVariant              **value)
+{
+    g_clear_pointer (value, g_variant_unref);
+    *value = self->build_func (source, self->user_data);
+    if (*value)
+        g_variant_take_ref (*value);
+}
+
+GVariant *
+mm_location_updates_build_dictionary (MMLocationUpdates     *self,
+                                      MMModemLocationSource  updated)
+{
+    if (updated & MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI)
+        update_value (self, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI, &self->location_3gpp_value);
+    if (updated & MM_MODEM_LOCATION_SOURCE_GPS_NMEA)
+        update_value (self, MM_MODEM_LOCATION_SOURCE_GPS_NMEA, &self->location_gps_nmea_value);
+    if (updated & MM_MODEM_LOCATION_SOURCE_GPS_RAW)
+        update_value (self, MM_MODEM_LOCATION_SOURCE_GPS_RAW, &self->location_gps_raw_value);
+    if (updated & MM_MODEM_LOCATION_SOURCE_CDMA_BS)
+        update_value (self, MM_MODEM_LOCATION_SOURCE_CDMA_BS, &self->location_cdma_bs_value);
+
+    return mm_location_build_dictionary (self->location_3gpp_value,
+                                         self->location_gps_nmea_value,
+                                         self->location_gps_raw_value,
+                                         self->location_cdma_bs_value);
+}
+
+/*****************************************************************************/
+
+void
+mm_location_updates_flush (MMLocationUpdates *self)
+{
+    MMModemLocationSource sources;
+
+    if (self->pending_id) {
+        g_source_remove (self->pending_id);
+        self->pending_id = 0;
+    }
+
+    sources = self->pending;
+    self->pending = MM_MODEM_LOCATION_SOURCE_NONE;
+    if (sources != MM_MODEM_LOCATION_SOURCE_NONE)
+        self->publish_func (self, sources, self->user_data);
+}
+
+static gboolean
+pending_cb (MMLocationUpdates *self)
+{
+    self->pending_id = 0;
+    mm_location_updates_flush (self);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_location_updates_schedule (MMLocationUpdates     *self,
+                              MMModemLocationSource  sources)
+{
+    self->pending |= sources;
+
+    if (!self->window_ms) {
+        mm_location_updates_flush (self);
+        return;
+    }
+
+    if (!self->pending_id)
+        self->pending_id = g_timeout_add (self->window_ms, (GSourceFunc) pending_cb, self);
+}
+
+void
+mm_location_updates_clear (MMLocationUpdates *self)
+{
+    if (self->pending_id) {
+        g_source_remove (self->pending_id);
+        self->pending_id = 0;
+    }
+    self->pending = MM_MODEM_LOCATION_SOURCE_NONE;
+
+    g_clear_pointer (&self->location_3gpp_value, g_variant_unref);
+    g_clear_pointer (&self->location_gps_nmea_value, g_variant_unref);
+    g_clear_pointer (&self->location_gps_raw_value, g_variant_unref);
+    g_clear_pointer (&self->location_cdma_bs_value, g_variant_unref);
+}
+
+/*****************************************************************************/
+
+MMLocationUpdates *
+mm_location_updates_new (guint                         window_ms,
+                         MMLocationUpdatesBuildFunc    build_func,
+                         MMLocationUpdatesPublishFunc  publish_func,
+                         gpointer                      user_data)
+{
+    MMLocationUpdates *self;
+
+    self = g_slice_new0 (MMLocationUpdates);
+    self->window_ms = window_ms;
+    self->build_func = build_func;
+    self->publish_func = publish_func;
+    self->user_data = user_data;
+    return self;
+}
+
+void
+mm_location_updates_free (MMLocationUpdates *self)
+{
+    mm_location_updates_clear (self);
+    g_slice_free (MMLocationUpdates, self);
+}
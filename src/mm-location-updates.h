@@ -0,0 +1,75 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_LOCATION_UPDATES_H
+#define MM_LOCATION_UPDATES_H
+
+#include <glib.h>
+
+#include <ModemManager.h>
+
+/*
+ * Coalesced updates of the Location property.
+ *
+ * The value of each location source is cached, and only built again when the
+ * source is updated. Updates scheduled within the update window are
+ * published together once the window is over, so that e.g. a burst of NMEA
+ * traces results in a single property change. A window of 0 publishes every
+ * update right away.
+ */
+
+typedef struct _MMLocationUpdates MMLocationUpdates;
+
+/* Returns a new, possibly floating, reference to the current value of the
+ * source, or NULL if the source has no value */
+typedef GVariant * (* MMLocationUpdatesBuildFunc)   (MMModemLocationSource  source,
+                                                     gpointer               user_data);
+
+/* Called once the update window is over, with the sources updated within it.
+ * The cached values are not refreshed until the callback asks for them with
+ * mm_location_updates_build_dictionary(), so that nothing is built when the
+ * location isn't being signaled. */
+typedef void       (* MMLocationUpdatesPublishFunc) (MMLocationUpdates     *self,
+                                                     MMModemLocationSource  sources,
+                                                     gpointer               user_data);
+
+MMLocationUpdates *mm_location_updates_new   (guint                         window_ms,
+                                              MMLocationUpdatesBuildFunc    build_func,
+                                              MMLocationUpdatesPublishFunc  publish_func,
+                                              gpointer                      user_data);
+void               mm_location_updates_free  (MMLocationUpdates            *self);
+
+void               mm_location_updates_schedule (MMLocationUpdates     *self,
+                                                 MMModemLocationSource  sources);
+/* Publishes right away the updates scheduled, if any */
+void               mm_location_updates_flush    (MMLocationUpdates     *self);
+/* Drops the updates scheduled and all cached values */
+void               mm_location_updates_clear    (MMLocationUpdates     *self);
+
+/* Refreshes the cached values of the updated sources, and returns a floating
+ * a{uv} dictionary with the values of all sources */
+GVariant          *mm_location_updates_build_dictionary (MMLocationUpdates     *self,
+                                                         MMModemLocationSource  updated);
+
+/* Builds the floating a{uv} dictionary of the Location property; any of the
+ * values may be NULL */
+GVariant          *mm_location_build_dictionary (GVariant *location_3gpp_value,
+                                                 GVariant *location_gps_nmea_value,
+                                                 GVariant *location_gps_raw_value,
+                                                 GVariant *location_cdma_bs_value);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMLocationUpdates, mm_location_updates_free)
+
+#endif /* MM_LOCATION_UPDATES_H */
@@ -54,6 +54,9 @@ static gboolean ts_flags = TS_FLAG_NONE;
 static guint32 log_level = MM_LOG_LEVEL_INFO | MM_LOG_LEVEL_WARN | MM_LOG_LEVEL_ERR;
 static GTimeVal rel_start = { 0, 0 };
 static int logfd = -1;
+static gchar *logfile_path = NULL;
+static guint64 logfile_size = 0;
+static guint64 logfile_max_size = 0;
 static gboolean append_log_level_text = TRUE;
 
 static void (*log_backend) (const char *loc,
@@ -78,6 +81,8 @@ static const LogDesc level_descs[] = {
 static GString *msgbuf = NULL;
 static gsize msgbuf_once = 0;
 
+static GStrv debug_filter = NULL;
+
 static int
 mm_to_syslog_priority (MMLogLevel level)
 {
@@ -145,6 +150,119 @@ log_level_description (MMLogLevel level)
     return NULL;
 }
 
+#define LOG_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP)
+
+static gboolean
+log_file_open (GError **error)
+{
+    struct stat st;
+
+    logfd = open (logfile_path, O_CREAT | O_APPEND | O_WRONLY, LOG_FILE_MODE);
+    if (logfd < 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't open log file: (%d) %s",
+                     errno, strerror (errno));
+        return FALSE;
+    }
+
+    logfile_size = (fstat (logfd, &st) == 0) ? (guint64) st.st_size : 0;
+    return TRUE;
+}
+
+static void log_file_write (const char *message,
+                            size_t      length);
+
+/* Keeps a single previous log file, with the .1 suffix. If rotating fails,
+ * logging goes on in the current file, without size limit. */
+static void
+log_file_rotate (void)
+{
+    g_autofree gchar  *rotated = NULL;
+    g_autofree gchar  *note = NULL;
+    g_autoptr(GError)  error = NULL;
+    int                oldfd;
+
+    rotated = g_strdup_printf ("%s.1", logfile_path);
+    if (rename (logfile_path, rotated) < 0) {
+        note = g_strdup_printf ("%s[log] couldn't rotate log file: (%d) %s; rotation disabled\n",
+                                append_log_level_text ? "<warn>  " : "", errno, strerror (errno));
+        goto failed;
+    }
+
+    oldfd = logfd;
+    if (!log_file_open (&error)) {
+        logfd = oldfd;
+        note = g_strdup_printf ("%s[log] %s; logging to '%s' with rotation disabled\n",
+                                append_log_level_text ? "<warn>  " : "", error->message, rotated);
+        goto failed;
+    }
+
+    close (oldfd);
+    return;
+
+failed:
+    logfile_max_size = 0;
+    log_file_write (note, strlen (note));
+}
+
+static void
+log_file_write (const char *message,
+                size_t      length)
+{
+    if (logfile_max_size && logfile_size > 0 && logfile_size + length > logfile_max_size)
+        log_file_rotate ();
+
+    if (logfd < 0)
+        return;
+
+    logfile_size += length;
+    while (length > 0) {
+        ssize_t written;
+
+        written = write (logfd, message, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        message += written;
+        length -= written;
+    }
+}
+
+/* Writes a batch of lines, rotating the file between lines if needed */
+static void
+log_file_write_lines (const char *message,
+                      size_t      length)
+{
+    while (length > 0) {
+        size_t chunk = length;
+
+        if (logfile_max_size && logfile_size + length > logfile_max_size) {
+            size_t room;
+
+            /* Write as many full lines as fit, or a single line if none
+             * fit even in an empty file */
+            room = (logfile_size < logfile_max_size) ? MIN (logfile_max_size - logfile_size, length) : 0;
+            while (room > 0 && message[room - 1] != '\n')
+                room--;
+            if (room > 0)
+                chunk = room;
+            else {
+                const char *eol;
+
+                eol = memchr (message, '\n', length);
+                if (eol)
+                    chunk = eol - message + 1;
+            }
+        }
+
+        log_file_write (message, chunk);
+        message += chunk;
+        length -= chunk;
+    }
+}
+
 static void
 log_backend_file (const char *loc,
                   const char *func,
@@ -152,13 +270,154 @@ log_backend_file (const char *loc,
                   const char *message,
                   size_t length)
 {
-    ssize_t ign;
-    ign = write (logfd, message, length);
-    if (ign) {} /* whatever; really shut up about unused result */
-
+    log_file_write (message, length);
     fsync (logfd);  /* Make sure output is dumped to disk immediately  */
 }
 
+/*****************************************************************************/
+/* Buffered file backend
+ *
+ * Writing and syncing every single line to disk blocks the main loop, so
+ * instead lines are appended to an in-memory buffer, and a writer thread
+ * flushes it to disk once it's big enough or after some time. Warnings and
+ * errors are still flushed right away, as they may be the last thing logged
+ * before a crash.
+ */
+
+#define LOG_BUFFER_FLUSH_SIZE     (64 * 1024)
+#define LOG_BUFFER_MAX_SIZE       (4 * 1024 * 1024)
+#define LOG_BUFFER_FLUSH_INTERVAL (G_USEC_PER_SEC / 2)
+
+typedef struct {
+    GThread  *thread;
+    /* Protects pending, n_dropped and stop */
+    GMutex    mutex;
+    GCond     cond;
+    GString  *pending;
+    guint     n_dropped;
+    gboolean  stop;
+    /* Serializes the flushes, and protects writing */
+    GMutex    write_mutex;
+    GString  *writing;
+} LogBuffer;
+
+static LogBuffer *log_buffer = NULL;
+
+static void
+log_buffer_flush (void)
+{
+    GString *tmp;
+    guint    n_dropped;
+
+    g_mutex_lock (&log_buffer->write_mutex);
+
+    g_mutex_lock (&log_buffer->mutex);
+    tmp = log_buffer->writing;
+    log_buffer->writing = log_buffer->pending;
+    log_buffer->pending = tmp;
+    n_dropped = log_buffer->n_dropped;
+    log_buffer->n_dropped = 0;
+    g_mutex_unlock (&log_buffer->mutex);
+
+    if (n_dropped) {
+        g_autofree gchar *note = NULL;
+
+        note = g_strdup_printf ("%s[log] %u messages dropped: writing to disk too slow\n",
+                                append_log_level_text ? "<warn>  " : "", n_dropped);
+        log_file_write (note, strlen (note));
+    }
+
+    if (log_buffer->writing->len || n_dropped) {
+        log_file_write_lines (log_buffer->writing->str, log_buffer->writing->len);
+        fsync (logfd);
+        g_string_truncate (log_buffer->writing, 0);
+    }
+
+    g_mutex_unlock (&log_buffer->write_mutex);
+}
+
+static gpointer
+log_buffer_thread (gpointer user_data)
+{
+    gboolean stop = FALSE;
+
+    while (!stop) {
+        gint64 end_time;
+
+        g_mutex_lock (&log_buffer->mutex);
+        end_time = g_get_monotonic_time () + LOG_BUFFER_FLUSH_INTERVAL;
+        while (!log_buffer->stop && log_buffer->pending->len < LOG_BUFFER_FLUSH_SIZE) {
+            if (!g_cond_wait_until (&log_buffer->cond, &log_buffer->mutex, end_time))
+                break;
+        }
+        stop = log_buffer->stop;
+        g_mutex_unlock (&log_buffer->mutex);
+
+        log_buffer_flush ();
+    }
+
+    return NULL;
+}
+
+static void
+log_backend_file_buffered (const char *loc,
+                           const char *func,
+                           int syslog_level,
+                           const char *message,
+                           size_t length)
+{
+    gboolean urgent;
+
+    urgent = (syslog_level <= LOG_WARNING);
+
+    g_mutex_lock (&log_buffer->mutex);
+    if (!urgent && log_buffer->pending->len + length > LOG_BUFFER_MAX_SIZE)
+        log_buffer->n_dropped++;
+    else {
+        g_string_append_len (log_buffer->pending, message, length);
+        if (log_buffer->pending->len >= LOG_BUFFER_FLUSH_SIZE)
+            g_cond_signal (&log_buffer->cond);
+    }
+    g_mutex_unlock (&log_buffer->mutex);
+
+    if (urgent)
+        log_buffer_flush ();
+}
+
+static void
+log_buffer_start (void)
+{
+    log_buffer = g_slice_new0 (LogBuffer);
+    g_mutex_init (&log_buffer->mutex);
+    g_cond_init (&log_buffer->cond);
+    g_mutex_init (&log_buffer->write_mutex);
+    log_buffer->pending = g_string_sized_new (LOG_BUFFER_FLUSH_SIZE * 2);
+    log_buffer->writing = g_string_sized_new (LOG_BUFFER_FLUSH_SIZE * 2);
+    log_buffer->thread = g_thread_new ("mm-log-writer", log_buffer_thread, NULL);
+}
+
+static void
+log_buffer_stop (void)
+{
+    g_mutex_lock (&log_buffer->mutex);
+    log_buffer->stop = TRUE;
+    g_cond_signal (&log_buffer->cond);
+    g_mutex_unlock (&log_buffer->mutex);
+
+    /* The thread flushes everything before exiting */
+    g_thread_join (log_buffer->thread);
+
+    g_string_free (log_buffer->pending, TRUE);
+    g_string_free (log_buffer->writing, TRUE);
+    g_mutex_clear (&log_buffer->write_mutex);
+    g_cond_clear (&log_buffer->cond);
+    g_mutex_clear (&log_buffer->mutex);
+    g_slice_free (LogBuffer, log_buffer);
+    log_buffer = NULL;
+}
+
+/*****************************************************************************/
+
 static void
 log_backend_syslog (const char *loc,
                     const char *func,
@@ -206,6 +465,54 @@ log_backend_systemd_journal (const char *loc,
 }
 #endif
 
+/* Ids are built as "owner/object", so a filter may match any component */
+static gboolean
+log_id_has_component (const gchar *id,
+                      const gchar *component)
+{
+    gsize        len;
+    const gchar *p;
+
+    len = strlen (component);
+    for (p = id; p; p = strchr (p, '/')) {
+        if (*p == '/')
+            p++;
+        if (strncmp (p, component, len) == 0 && (p[len] == '\0' || p[len] == '/'))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static gboolean
+debug_filter_matches (gpointer     obj,
+                      const gchar *module)
+{
+    const gchar *id = NULL;
+    guint        i;
+
+    if (obj)
+        id = mm_log_object_get_id (MM_LOG_OBJECT (obj));
+
+    for (i = 0; debug_filter[i]; i++) {
+        if (module && g_str_equal (debug_filter[i], module))
+            return TRUE;
+        if (id && log_id_has_component (id, debug_filter[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+_mm_log_is_enabled (gpointer     obj,
+                    const gchar *module,
+                    MMLogLevel   level)
+{
+    if (G_UNLIKELY (debug_filter) && level == MM_LOG_LEVEL_DEBUG)
+        return debug_filter_matches (obj, module);
+
+    return !!(log_level & level);
+}
+
 void
 _mm_log (gpointer     obj,
          const gchar *module,
@@ -218,7 +525,7 @@ _mm_log (gpointer     obj,
     va_list args;
     GTimeVal tv;
 
-    if (!(log_level & level))
+    if (!_mm_log_is_enabled (obj, module, level))
         return;
 
     if (g_once_init_enter (&msgbuf_once)) {
@@ -304,12 +611,42 @@ mm_log_set_level (const char *level, GError **error)
     return found;
 }
 
+void
+mm_log_set_debug_filter (const gchar *filter)
+{
+    g_auto(GStrv)  tokens = NULL;
+    GPtrArray     *array;
+    guint          i;
+
+    g_clear_pointer (&debug_filter, g_strfreev);
+    if (!filter)
+        return;
+
+    array = g_ptr_array_new ();
+    tokens = g_strsplit (filter, ",", -1);
+    for (i = 0; tokens[i]; i++) {
+        g_strstrip (tokens[i]);
+        if (tokens[i][0])
+            g_ptr_array_add (array, g_strdup (tokens[i]));
+    }
+
+    if (!array->len) {
+        g_ptr_array_free (array, TRUE);
+        return;
+    }
+
+    g_ptr_array_add (array, NULL);
+    debug_filter = (GStrv) g_ptr_array_free (array, FALSE);
+}
+
 gboolean
 mm_log_setup (const char *level,
               const char *log_file,
               gboolean log_journal,
               gboolean show_timestamps,
               gboolean rel_timestamps,
+              gboolean log_file_buffered,
+              guint64 log_file_max_size,
               GError **error)
 {
     /* levels */
@@ -334,16 +671,17 @@ mm_log_setup (const char *level,
         openlog (G_LOG_DOMAIN, LOG_CONS | LOG_PID | LOG_PERROR, LOG_DAEMON);
         log_backend = log_backend_syslog;
     } else {
-        logfd = open (log_file,
-                      O_CREAT | O_APPEND | O_WRONLY,
-                      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
-        if (logfd < 0) {
-            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                         "Couldn't open log file: (%d) %s",
-                         errno, strerror (errno));
+        logfile_path = g_strdup (log_file);
+        logfile_max_size = log_file_max_size;
+        if (!log_file_open (error)) {
+            g_clear_pointer (&logfile_path, g_free);
             return FALSE;
         }
-        log_backend = log_backend_file;
+        if (log_file_buffered) {
+            log_buffer_start ();
+            log_backend = log_backend_file_buffered;
+        } else
+            log_backend = log_backend_file;
     }
 
     g_log_set_handler (G_LOG_DOMAIN,
@@ -378,8 +716,16 @@ mm_log_setup (const char *level,
 void
 mm_log_shutdown (void)
 {
+    if (log_buffer) {
+        log_buffer_stop ();
+        log_backend = log_backend_file;
+    }
+
     if (logfd < 0)
         closelog ();
-    else
+    else {
         close (logfd);
+        logfd = -1;
+        g_clear_pointer (&logfile_path, g_free);
+    }
 }
@@ -36,6 +36,11 @@ typedef enum {
 #define mm_obj_info(obj, ...) _mm_log (obj, MM_MODULE_NAME, G_STRLOC, G_STRFUNC, MM_LOG_LEVEL_INFO,  ## __VA_ARGS__ )
 #define mm_obj_dbg(obj, ...)  _mm_log (obj, MM_MODULE_NAME, G_STRLOC, G_STRFUNC, MM_LOG_LEVEL_DEBUG, ## __VA_ARGS__ )
 
+/* Whether messages of the given level would be logged; useful to skip
+ * building expensive log messages that would be discarded anyway */
+#define mm_obj_log_enabled(obj, level) _mm_log_is_enabled (obj, MM_MODULE_NAME, level)
+#define mm_obj_dbg_enabled(obj)        _mm_log_is_enabled (obj, MM_MODULE_NAME, MM_LOG_LEVEL_DEBUG)
+
 /* only allow using non-object logging API if explicitly requested
  * (e.g. in the main daemon source) */
 #if defined MM_LOG_NO_OBJECT
@@ -53,13 +58,24 @@ void _mm_log (gpointer     obj,
               const gchar *fmt,
               ...)  __attribute__((__format__ (__printf__, 6, 7)));
 
+gboolean _mm_log_is_enabled (gpointer     obj,
+                             const gchar *module,
+                             MMLogLevel   level);
+
 gboolean mm_log_set_level (const char *level, GError **error);
 
+/* Comma separated list of object ids (or any of their components, e.g.
+ * "modem0" or "ttyUSB2") and module names (e.g. "huawei"). If given,
+ * debug messages are logged only for those, regardless of the log level. */
+void mm_log_set_debug_filter (const gchar *filter);
+
 gboolean mm_log_setup (const char *level,
                        const char *log_file,
                        gboolean log_journal,
                        gboolean show_ts,
                        gboolean rel_ts,
+                       gboolean log_file_buffered,
+                       guint64 log_file_max_size,
                        GError **error);
 
 void mm_log_shutdown (void);
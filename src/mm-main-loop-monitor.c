@@ -0,0 +1,393 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+
+#include "mm-log.h"
+#include "mm-timer.h"
+#include "mm-regex-cache.h"
+#include "mm-main-loop-monitor.h"
+
+#define REPORT_INTERVAL_SEC 300
+
+/* Dispatches blocking the main loop longer than this are logged */
+#define SLOW_DISPATCH_USEC 100000
+
+/* Beyond this, stats of new tags are accounted in a shared entry */
+#define MAX_TAGS_PER_HANDLER 256
+#define OVERFLOW_TAG         "other"
+
+/* Upper bounds of the histogram buckets in microseconds; the last bucket
+ * has no upper bound */
+static const guint64 histogram_bounds[] = { 100, 1000, 10000, 100000, 1000000 };
+#define N_BUCKETS (G_N_ELEMENTS (histogram_bounds) + 1)
+
+static const gchar *handler_strings[] = {
+    [MM_MAIN_LOOP_HANDLER_SERIAL_READ]    = "serial-read",
+    [MM_MAIN_LOOP_HANDLER_QMI_INDICATION] = "qmi-indication",
+    [MM_MAIN_LOOP_HANDLER_DBUS_METHOD]    = "dbus-method",
+    [MM_MAIN_LOOP_HANDLER_TIMER]          = "timer",
+};
+
+G_STATIC_ASSERT (G_N_ELEMENTS (handler_strings) == MM_MAIN_LOOP_HANDLER_LAST);
+
+typedef struct {
+    gchar   *tag;
+    guint64  count;
+    guint64  latency_max;
+    guint64  latency_histogram[N_BUCKETS];
+    /* Only for handlers with measured run time */
+    guint64  n_timed;
+    guint64  time_total;
+    guint64  time_max;
+    guint64  time_histogram[N_BUCKETS];
+} HandlerStats;
+
+typedef struct {
+    GPollFunc   poll_func;
+    guint       report_id;
+    guint64     n_wakeups;
+    /* Start of the current report period */
+    gint64      period_start;
+    guint64     period_n_wakeups;
+    /* Rate in the last complete report period, < 0 if none yet */
+    gdouble     last_rate;
+    /* tag -> HandlerStats, one table per handler type; NULL if disabled */
+    GHashTable *handlers[MM_MAIN_LOOP_HANDLER_LAST];
+    gint64      poll_return_time;
+} MainLoopMonitor;
+
+static MainLoopMonitor *monitor;
+
+const gchar *
+mm_main_loop_handler_get_string (MMMainLoopHandler handler)
+{
+    g_return_val_if_fail (handler < MM_MAIN_LOOP_HANDLER_LAST, NULL);
+
+    return handler_strings[handler];
+}
+
+/*****************************************************************************/
+
+static gint
+monitor_poll (GPollFD *fds,
+              guint    nfds,
+              gint     timeout)
+{
+    gint ret;
+
+    if (timeout != 0)
+        monitor->n_wakeups++;
+    ret = monitor->poll_func (fds, nfds, timeout);
+    if (monitor->handlers[0])
+        monitor->poll_return_time = g_get_monotonic_time ();
+    return ret;
+}
+
+static gboolean
+report_cb (gpointer unused)
+{
+    gint64  now;
+    guint   n_timers = 0;
+    guint64 n_timer_wakeups = 0;
+    guint64 n_timer_callbacks = 0;
+
+    now = g_get_monotonic_time ();
+    monitor->last_rate = (gdouble) (monitor->n_wakeups - monitor->period_n_wakeups) * G_USEC_PER_SEC / (now - monitor->period_start);
+    monitor->period_start = now;
+    monitor->period_n_wakeups = monitor->n_wakeups;
+
+    mm_timer_get_stats (&n_timers, &n_timer_wakeups, &n_timer_callbacks);
+    mm_obj_dbg (NULL, "main loop: %.2f wakeups/s in the last %us; %u timers pending, "
+                "%" G_GUINT64_FORMAT " timer callbacks run in %" G_GUINT64_FORMAT " wakeups",
+                monitor->last_rate, REPORT_INTERVAL_SEC, n_timers,
+                n_timer_callbacks, n_timer_wakeups);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+handler_stats_free (HandlerStats *stats)
+{
+    g_free (stats->tag);
+    g_slice_free (HandlerStats, stats);
+}
+
+void
+mm_main_loop_monitor_setup (gboolean handler_stats)
+{
+    g_assert (!monitor);
+
+    monitor = g_slice_new0 (MainLoopMonitor);
+    monitor->period_start = g_get_monotonic_time ();
+    monitor->last_rate = -1.0;
+    if (handler_stats) {
+        guint i;
+
+        for (i = 0; i < MM_MAIN_LOOP_HANDLER_LAST; i++)
+            monitor->handlers[i] = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) handler_stats_free);
+    }
+    monitor->poll_func = g_main_context_get_poll_func (NULL);
+    g_main_context_set_poll_func (NULL, monitor_poll);
+    monitor->report_id = mm_timer_add_seconds (MM_TIMER_CLASS_STATS, NULL, REPORT_INTERVAL_SEC, report_cb, NULL);
+}
+
+void
+mm_main_loop_monitor_shutdown (void)
+{
+    guint i;
+
+    if (!monitor)
+        return;
+
+    g_main_context_set_poll_func (NULL, monitor->poll_func);
+    mm_timer_remove (monitor->report_id);
+    for (i = 0; i < MM_MAIN_LOOP_HANDLER_LAST; i++) {
+        if (monitor->handlers[i])
+            g_hash_table_unref (monitor->handlers[i]);
+    }
+    g_slice_free (MainLoopMonitor, monitor);
+    monitor = NULL;
+}
+
+gboolean
+mm_main_loop_monitor_handler_stats_enabled (void)
+{
+    return monitor && monitor->handlers[0];
+}
+
+void
+mm_main_loop_monitor_get_wakeups (guint64 *out_n_wakeups,
+                                  gdouble *out_wakeups_per_second)
+{
+    gint64 elapsed;
+
+    if (!monitor) {
+        *out_n_wakeups = 0;
+        *out_wakeups_per_second = 0.0;
+        return;
+    }
+
+    *out_n_wakeups = monitor->n_wakeups;
+    if (monitor->last_rate >= 0.0) {
+        *out_wakeups_per_second = monitor->last_rate;
+        return;
+    }
+
+    elapsed = g_get_monotonic_time () - monitor->period_start;
+    *out_wakeups_per_second = elapsed > 0 ? (gdouble) monitor->n_wakeups * G_USEC_PER_SEC / elapsed : 0.0;
+}
+
+/*****************************************************************************/
+
+static guint
+histogram_bucket (guint64 usecs)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (histogram_bounds); i++) {
+        if (usecs < histogram_bounds[i])
+            break;
+    }
+    return i;
+}
+
+static HandlerStats *
+handler_stats_lookup (MMMainLoopHandler  handler,
+                      const gchar       *tag)
+{
+    GHashTable   *table;
+    HandlerStats *stats;
+
+    table = monitor->handlers[handler];
+    stats = g_hash_table_lookup (table, tag);
+    if (stats)
+        return stats;
+
+    if (g_hash_table_size (table) >= MAX_TAGS_PER_HANDLER) {
+        tag = OVERFLOW_TAG;
+        stats = g_hash_table_lookup (table, tag);
+        if (stats)
+            return stats;
+    }
+
+    stats = g_slice_new0 (HandlerStats);
+    stats->tag = g_strdup (tag);
+    g_hash_table_insert (table, stats->tag, stats);
+    return stats;
+}
+
+static HandlerStats *
+record_latency (MMMainLoopHandler  handler,
+                const gchar       *tag,
+                gint64             ready_time,
+                gint64             start_time)
+{
+    HandlerStats *stats;
+    guint64       latency;
+
+    if (!ready_time)
+        ready_time = monitor->poll_return_time;
+    latency = (ready_time && start_time > ready_time) ? (guint64) (start_time - ready_time) : 0;
+
+    stats = handler_stats_lookup (handler, tag ? tag : OVERFLOW_TAG);
+    stats->count++;
+    stats->latency_histogram[histogram_bucket (latency)]++;
+    if (latency > stats->latency_max)
+        stats->latency_max = latency;
+    return stats;
+}
+
+void
+mm_main_loop_monitor_dispatch_begin (MMMainLoopDispatch *dispatch,
+                                     gint64              ready_time)
+{
+    if (!monitor || !monitor->handlers[0]) {
+        dispatch->start_time = 0;
+        return;
+    }
+
+    dispatch->ready_time = ready_time;
+    dispatch->start_time = g_get_monotonic_time ();
+}
+
+void
+mm_main_loop_monitor_dispatch_end (MMMainLoopDispatch *dispatch,
+                                   MMMainLoopHandler   handler,
+                                   const gchar        *tag)
+{
+    HandlerStats *stats;
+    guint64       elapsed;
+
+    /* Stats may have been disabled while dispatching */
+    if (!dispatch->start_time || !monitor || !monitor->handlers[0])
+        return;
+
+    elapsed = (guint64) (g_get_monotonic_time () - dispatch->start_time);
+    stats = record_latency (handler, tag, dispatch->ready_time, dispatch->start_time);
+    stats->n_timed++;
+    stats->time_total += elapsed;
+    stats->time_histogram[histogram_bucket (elapsed)]++;
+    if (elapsed > stats->time_max)
+        stats->time_max = elapsed;
+
+    if (elapsed >= SLOW_DISPATCH_USEC)
+        mm_obj_dbg (NULL, "main loop blocked for %.3f seconds by %s handler (%s)",
+                    (gdouble) elapsed / G_USEC_PER_SEC, handler_strings[handler], stats->tag);
+}
+
+void
+mm_main_loop_monitor_dispatch_record (MMMainLoopHandler  handler,
+                                      const gchar       *tag,
+                                      gint64             ready_time)
+{
+    if (!monitor || !monitor->handlers[0])
+        return;
+
+    record_latency (handler, tag, ready_time, g_get_monotonic_time ());
+}
+
+/*****************************************************************************/
+
+static GVariant *
+build_histogram (const guint64 *histogram)
+{
+    return g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64, histogram, N_BUCKETS, sizeof (guint64));
+}
+
+static GVariant *
+build_handler_stats (MMMainLoopHandler   handler,
+                     const HandlerStats *stats)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "type", g_variant_new_string (handler_strings[handler]));
+    g_variant_builder_add (&builder, "{sv}", "tag", g_variant_new_string (stats->tag));
+    g_variant_builder_add (&builder, "{sv}", "count", g_variant_new_uint64 (stats->count));
+    g_variant_builder_add (&builder, "{sv}", "latency-max", g_variant_new_uint64 (stats->latency_max));
+    g_variant_builder_add (&builder, "{sv}", "latency-histogram", build_histogram (stats->latency_histogram));
+    if (stats->n_timed) {
+        g_variant_builder_add (&builder, "{sv}", "time-total", g_variant_new_uint64 (stats->time_total));
+        g_variant_builder_add (&builder, "{sv}", "time-max", g_variant_new_uint64 (stats->time_max));
+        g_variant_builder_add (&builder, "{sv}", "time-histogram", build_histogram (stats->time_histogram));
+    }
+    return g_variant_builder_end (&builder);
+}
+
+static void
+add_regex_stats (const MMRegexCacheStats *stats,
+                 GVariantBuilder         *regexes_builder)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "pattern", g_variant_new_string (stats->pattern));
+    g_variant_builder_add (&builder, "{sv}", "compiles", g_variant_new_uint32 (stats->n_compiles));
+    g_variant_builder_add (&builder, "{sv}", "lookups", g_variant_new_uint32 (stats->n_lookups));
+    g_variant_builder_add (&builder, "{sv}", "matches", g_variant_new_uint32 (stats->n_matches));
+    g_variant_builder_add (&builder, "{sv}", "match-time", g_variant_new_uint64 (stats->match_time_us));
+    g_variant_builder_add_value (regexes_builder, g_variant_builder_end (&builder));
+}
+
+GVariant *
+mm_main_loop_monitor_get_stats (void)
+{
+    GVariantBuilder builder;
+    guint64         n_wakeups;
+    gdouble         wakeups_per_second;
+    guint           n_timers = 0;
+    guint64         n_timer_wakeups = 0;
+    guint64         n_timer_callbacks = 0;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
+    mm_main_loop_monitor_get_wakeups (&n_wakeups, &wakeups_per_second);
+    g_variant_builder_add (&builder, "{sv}", "wakeups", g_variant_new_uint64 (n_wakeups));
+    g_variant_builder_add (&builder, "{sv}", "wakeups-per-second", g_variant_new_double (wakeups_per_second));
+
+    mm_timer_get_stats (&n_timers, &n_timer_wakeups, &n_timer_callbacks);
+    g_variant_builder_add (&builder, "{sv}", "timers", g_variant_new_uint32 (n_timers));
+    g_variant_builder_add (&builder, "{sv}", "timer-wakeups", g_variant_new_uint64 (n_timer_wakeups));
+    g_variant_builder_add (&builder, "{sv}", "timer-callbacks", g_variant_new_uint64 (n_timer_callbacks));
+
+    if (monitor && monitor->handlers[0]) {
+        GVariantBuilder handlers_builder;
+        GVariantBuilder regexes_builder;
+        guint           i;
+
+        g_variant_builder_add (&builder, "{sv}", "histogram-bounds",
+                               g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64,
+                                                          histogram_bounds,
+                                                          G_N_ELEMENTS (histogram_bounds),
+                                                          sizeof (guint64)));
+
+        g_variant_builder_init (&handlers_builder, G_VARIANT_TYPE ("aa{sv}"));
+        for (i = 0; i < MM_MAIN_LOOP_HANDLER_LAST; i++) {
+            GHashTableIter  iter;
+            HandlerStats   *stats;
+
+            g_hash_table_iter_init (&iter, monitor->handlers[i]);
+            while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stats))
+                g_variant_builder_add_value (&handlers_builder, build_handler_stats ((MMMainLoopHandler) i, stats));
+        }
+        g_variant_builder_add (&builder, "{sv}", "handlers", g_variant_builder_end (&handlers_builder));
+
+        g_variant_builder_init (&regexes_builder, G_VARIANT_TYPE ("aa{sv}"));
+        mm_regex_cache_foreach_stats ((MMRegexCacheStatsFunc) add_regex_stats, &regexes_builder);
+        g_variant_builder_add (&builder, "{sv}", "regexes", g_variant_builder_end (&regexes_builder));
+    }
+
+    return g_variant_builder_end (&builder);
+}
@@ -0,0 +1,76 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_MAIN_LOOP_MONITOR_H
+#define MM_MAIN_LOOP_MONITOR_H
+
+#include <glib.h>
+
+/*
+ * Instrumentation of the default main context.
+ *
+ * A wakeup is every poll in which the main loop could have slept, i.e. every
+ * poll with a non-zero timeout. The wakeup rate is periodically reported in
+ * the debug log, along with the coalesced timer stats.
+ *
+ * If handler stats are enabled, the dispatches of the main handlers are also
+ * recorded, per handler type and tag (usually the log id of the port or modem
+ * involved). The latency is the time since the handler became ready (since the
+ * main loop woke up, unless given explicitly) until it was dispatched, i.e.
+ * how long it was blocked by other handlers. The run time is how long the
+ * handler itself blocked the main loop. Both are kept as histograms.
+ */
+
+typedef enum {
+    MM_MAIN_LOOP_HANDLER_SERIAL_READ    = 0,
+    MM_MAIN_LOOP_HANDLER_QMI_INDICATION = 1,
+    MM_MAIN_LOOP_HANDLER_DBUS_METHOD    = 2,
+    MM_MAIN_LOOP_HANDLER_TIMER          = 3,
+    MM_MAIN_LOOP_HANDLER_LAST
+} MMMainLoopHandler;
+
+const gchar *mm_main_loop_handler_get_string (MMMainLoopHandler handler);
+
+void     mm_main_loop_monitor_setup                 (gboolean handler_stats);
+void     mm_main_loop_monitor_shutdown              (void);
+gboolean mm_main_loop_monitor_handler_stats_enabled (void);
+
+/* Total number of wakeups and rate over the last report period, or since
+ * setup if no period has completed yet */
+void mm_main_loop_monitor_get_wakeups (guint64 *out_n_wakeups,
+                                       gdouble *out_wakeups_per_second);
+
+/* Handler dispatch recording; ready_time is given in monotonic time, or 0 if
+ * the handler became ready when the main loop woke up */
+typedef struct {
+    gint64 ready_time;
+    gint64 start_time;
+} MMMainLoopDispatch;
+
+void mm_main_loop_monitor_dispatch_begin  (MMMainLoopDispatch *dispatch,
+                                           gint64              ready_time);
+void mm_main_loop_monitor_dispatch_end    (MMMainLoopDispatch *dispatch,
+                                           MMMainLoopHandler   handler,
+                                           const gchar        *tag);
+
+/* For handlers whose run time cannot be measured, only latency is recorded */
+void mm_main_loop_monitor_dispatch_record (MMMainLoopHandler   handler,
+                                           const gchar        *tag,
+                                           gint64              ready_time);
+
+/* All stats as an a{sv} dictionary, see the Debug interface */
+GVariant *mm_main_loop_monitor_get_stats  (void);
+
+#endif /* MM_MAIN_LOOP_MONITOR_H */
@@ -2653,3 +2653,202 @@ qmi_personalization_feature_from_mm_modem_3gpp_facility (MMModem3gppFacility fac
         return QMI_UIM_CARD_APPLICATION_PERSONALIZATION_FEATURE_UNKNOWN;
     }
 }
+
+/*****************************************************************************/
+
+/* Clients with the default flag of the services with the lowest ids (all
+ * the commonly used ones, up to WDA and DSD), are also indexed in a plain
+ * array */
+#define N_DEFAULT_CLIENTS 0x30
+
+typedef struct {
+    QmiService  service;
+    guint       flag;
+    /* service and flag, the key in the clients table */
+    gint64      key;
+    QmiClient  *client;
+} ClientInfo;
+
+struct _MMQmiClientIndex {
+    /* ClientInfo by service and flag */
+    GHashTable *clients;
+    ClientInfo *default_clients[N_DEFAULT_CLIENTS];
+    /* MMQmiClientStats by service */
+    GHashTable *stats;
+};
+
+static void
+client_info_free (ClientInfo *info)
+{
+    g_clear_object (&info->client);
+    g_slice_free (ClientInfo, info);
+}
+
+static inline gint64
+build_client_key (QmiService service,
+                  guint      flag)
+{
+    return ((gint64) service << 32) | flag;
+}
+
+static inline gboolean
+is_default_client (QmiService service,
+                   guint      flag)
+{
+    return (flag == 0 && (guint) service < N_DEFAULT_CLIENTS);
+}
+
+static MMQmiClientStats *
+get_client_stats (MMQmiClientIndex *self,
+                  QmiService        service)
+{
+    MMQmiClientStats *stats;
+
+    stats = g_hash_table_lookup (self->stats, GUINT_TO_POINTER (service));
+    if (!stats) {
+        stats = g_new0 (MMQmiClientStats, 1);
+        g_hash_table_insert (self->stats, GUINT_TO_POINTER (service), stats);
+    }
+    return stats;
+}
+
+static ClientInfo *
+lookup_client_info (MMQmiClientIndex *self,
+                    QmiService        service,
+                    guint             flag)
+{
+    gint64 key;
+
+    if (is_default_client (service, flag))
+        return self->default_clients[service];
+
+    key = build_client_key (service, flag);
+    return g_hash_table_lookup (self->clients, &key);
+}
+
+gboolean
+mm_qmi_client_index_add (MMQmiClientIndex *self,
+                         QmiService        service,
+                         guint             flag,
+                         QmiClient        *client)
+{
+    ClientInfo *info;
+
+    if (lookup_client_info (self, service, flag))
+        return FALSE;
+
+    info = g_slice_new0 (ClientInfo);
+    info->service = service;
+    info->flag = flag;
+    info->key = build_client_key (service, flag);
+    info->client = g_object_ref (client);
+    g_hash_table_insert (self->clients, &info->key, info);
+    if (is_default_client (service, flag))
+        self->default_clients[service] = info;
+
+    get_client_stats (self, service)->n_allocated++;
+    return TRUE;
+}
+
+QmiClient *
+mm_qmi_client_index_peek (MMQmiClientIndex *self,
+                          QmiService        service,
+                          guint             flag)
+{
+    ClientInfo *info;
+
+    info = lookup_client_info (self, service, flag);
+    return info ? info->client : NULL;
+}
+
+QmiClient *
+mm_qmi_client_index_steal (MMQmiClientIndex *self,
+                           QmiService        service,
+                           guint             flag)
+{
+    ClientInfo *info;
+    QmiClient  *client;
+
+    info = lookup_client_info (self, service, flag);
+    if (!info)
+        return NULL;
+
+    if (is_default_client (service, flag))
+        self->default_clients[service] = NULL;
+    g_hash_table_steal (self->clients, &info->key);
+    get_client_stats (self, service)->n_released++;
+
+    client = g_steal_pointer (&info->client);
+    client_info_free (info);
+    return client;
+}
+
+GList *
+mm_qmi_client_index_steal_all (MMQmiClientIndex *self)
+{
+    GList          *list = NULL;
+    GHashTableIter  iter;
+    ClientInfo     *info;
+
+    g_hash_table_iter_init (&iter, self->clients);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&info)) {
+        g_hash_table_iter_steal (&iter);
+        get_client_stats (self, info->service)->n_released_on_close++;
+        list = g_list_prepend (list, g_steal_pointer (&info->client));
+        client_info_free (info);
+    }
+    memset (self->default_clients, 0, sizeof (self->default_clients));
+
+    return list;
+}
+
+void
+mm_qmi_client_index_get_stats (MMQmiClientIndex *self,
+                               QmiService        service,
+                               MMQmiClientStats *stats)
+{
+    MMQmiClientStats *found;
+
+    found = g_hash_table_lookup (self->stats, GUINT_TO_POINTER (service));
+    if (found)
+        *stats = *found;
+    else
+        memset (stats, 0, sizeof (*stats));
+}
+
+void
+mm_qmi_client_index_log_stats (MMQmiClientIndex *self,
+                               gpointer          log_object)
+{
+    GHashTableIter    iter;
+    gpointer          key;
+    MMQmiClientStats *stats;
+
+    if (!mm_obj_dbg_enabled (log_object))
+        return;
+
+    g_hash_table_iter_init (&iter, self->stats);
+    while (g_hash_table_iter_next (&iter, &key, (gpointer *)&stats))
+        mm_obj_dbg (log_object, "clients for service '%s': %u allocated, %u released, %u released only when closing",
+                    qmi_service_get_string ((QmiService) GPOINTER_TO_UINT (key)),
+                    stats->n_allocated, stats->n_released, stats->n_released_on_close);
+}
+
+MMQmiClientIndex *
+mm_qmi_client_index_new (void)
+{
+    MMQmiClientIndex *self;
+
+    self = g_slice_new0 (MMQmiClientIndex);
+    self->clients = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL, (GDestroyNotify) client_info_free);
+    self->stats = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+    return self;
+}
+
+void
+mm_qmi_client_index_free (MMQmiClientIndex *self)
+{
+    g_hash_table_unref (self->clients);
+    g_hash_table_unref (self->stats);
+    g_slice_free (MMQmiClientIndex, self);
+}
@@ -244,4 +244,46 @@ gboolean mm_qmi_uim_get_configuration_output_parse (gpointer
 
 QmiUimCardApplicationPersonalizationFeature qmi_personalization_feature_from_mm_modem_3gpp_facility (MMModem3gppFacility facility);
 
+/*****************************************************************************/
+/* Index of the clients allocated in a QMI port, by service and flag */
+
+typedef struct _MMQmiClientIndex MMQmiClientIndex;
+
+typedef struct {
+    guint n_allocated;
+    /* Explicitly released by their users */
+    guint n_released;
+    /* Still in use when the port was closed, i.e. leaked */
+    guint n_released_on_close;
+} MMQmiClientStats;
+
+MMQmiClientIndex *mm_qmi_client_index_new       (void);
+void              mm_qmi_client_index_free      (MMQmiClientIndex *self);
+
+/* Takes a reference on the client; returns FALSE without taking it if
+ * there is already a client for the same service and flag */
+gboolean          mm_qmi_client_index_add       (MMQmiClientIndex *self,
+                                                 QmiService        service,
+                                                 guint             flag,
+                                                 QmiClient        *client);
+QmiClient        *mm_qmi_client_index_peek      (MMQmiClientIndex *self,
+                                                 QmiService        service,
+                                                 guint             flag);
+/* Removes the client from the index, returning the reference */
+QmiClient        *mm_qmi_client_index_steal     (MMQmiClientIndex *self,
+                                                 QmiService        service,
+                                                 guint             flag);
+/* Removes all clients when the port is closed, returning a list with the
+ * references */
+GList            *mm_qmi_client_index_steal_all (MMQmiClientIndex *self);
+
+/* Counts since the index was created */
+void              mm_qmi_client_index_get_stats (MMQmiClientIndex *self,
+                                                 QmiService        service,
+                                                 MMQmiClientStats *stats);
+void              mm_qmi_client_index_log_stats (MMQmiClientIndex *self,
+                                                 gpointer          log_object);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMQmiClientIndex, mm_qmi_client_index_free)
+
 #endif  /* MM_MODEM_HELPERS_QMI_H */
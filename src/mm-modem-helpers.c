@@ -32,6 +32,7 @@
 #include "mm-sms-part.h"
 #include "mm-common-helpers.h"
 #include "mm-modem-helpers.h"
+#include "mm-regex-cache.h"
 #include "mm-helper-enums-types.h"
 #include "mm-log-object.h"
 
@@ -460,10 +461,10 @@ mm_voice_ring_regex_get (void)
     /* Example:
      * <CR><LF>RING<CR><LF>
      */
-    return g_regex_new ("\\r\\nRING\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\nRING\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -473,10 +474,10 @@ mm_voice_cring_regex_get (void)
      * <CR><LF>+CRING: VOICE<CR><LF>
      * <CR><LF>+CRING: DATA<CR><LF>
      */
-    return g_regex_new ("\\r\\n\\+CRING:\\s*(\\S+)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CRING:\\s*(\\S+)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -490,10 +491,10 @@ mm_voice_clip_regex_get (void)
      *   <CR><LF>+CLIP: "+393351391306",145,,,,0<CR><LF>
      *                   \_ Number      \_ Type
      */
-    return g_regex_new ("\\r\\n\\+CLIP:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CLIP:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -507,10 +508,10 @@ mm_voice_ccwa_regex_get (void)
      *   <CR><LF>+CCWA: "+393351391306",145,1
      *                   \_ Number      \_ Type
      */
-    return g_regex_new ("\\r\\n\\+CCWA:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CCWA:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 static void
@@ -565,18 +566,18 @@ mm_3gpp_parse_clcc_response (const gchar  *str,
      *  ...
      */
 
-    r = g_regex_new ("\\+CLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
-                     "(?:,\\s*([^,]*),\\s*(\\d+)"                                     /* number and type */
-                     "(?:,\\s*([^,]*)"                                                /* alpha */
-                     "(?:,\\s*(\\d*)"                                                 /* priority */
-                     "(?:,\\s*(\\d*)"                                                 /* CLI validity */
-                     ")?)?)?)?$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\+CLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
+                            "(?:,\\s*([^,]*),\\s*(\\d+)"                                     /* number and type */
+                            "(?:,\\s*([^,]*)"                                                /* alpha */
+                            "(?:,\\s*(\\d*)"                                                 /* priority */
+                            "(?:,\\s*(\\d*)"                                                 /* CLI validity */
+                            ")?)?)?)?$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -637,7 +638,7 @@ mm_3gpp_parse_clcc_response (const gchar  *str,
 
     next:
         call_info_free (call_info);
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
 out:
@@ -743,10 +744,10 @@ mm_parse_ifc_test_response (const gchar  *response,
     MMFlowControl  ta_mask     = MM_FLOW_CONTROL_UNKNOWN;
     MMFlowControl  mask        = MM_FLOW_CONTROL_UNKNOWN;
 
-    r = g_regex_new ("(?:\\+IFC:)?\\s*\\((.*)\\),\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:\\+IFC:)?\\s*\\((.*)\\),\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -850,10 +851,10 @@ mm_3gpp_creg_regex_get (gboolean solicited)
 
         if (solicited) {
             pattern = g_strdup_printf ("%s$", creg_regex[i]);
-            regex = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+            regex = mm_regex_cache_get (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
         } else {
             pattern = g_strdup_printf ("\\r\\n%s\\r\\n", creg_regex[i]);
-            regex = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+            regex = mm_regex_cache_get (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
         }
         g_assert (regex);
         g_ptr_array_add (array, regex);
@@ -873,10 +874,10 @@ mm_3gpp_creg_regex_destroy (GPtrArray *array)
 GRegex *
 mm_3gpp_ciev_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CIEV: (.*),(\\d)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CIEV: (.*),(\\d)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -884,10 +885,10 @@ mm_3gpp_ciev_regex_get (void)
 GRegex *
 mm_3gpp_cgev_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CGEV:\\s*(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CGEV:\\s*(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -895,10 +896,10 @@ mm_3gpp_cgev_regex_get (void)
 GRegex *
 mm_3gpp_cusd_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CUSD:\\s*(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CUSD:\\s*(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -906,10 +907,10 @@ mm_3gpp_cusd_regex_get (void)
 GRegex *
 mm_3gpp_cmti_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CMTI:\\s*\"(\\S+)\",\\s*(\\d+)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CMTI:\\s*\"(\\S+)\",\\s*(\\d+)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -918,10 +919,10 @@ mm_3gpp_cds_regex_get (void)
     /* Example:
      * <CR><LF>+CDS: 24<CR><LF>07914356060013F10659098136395339F6219011707193802190117071938030<CR><LF>
      */
-    return g_regex_new ("\\r\\n\\+CDS:\\s*(\\d+)\\r\\n(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CDS:\\s*(\\d+)\\r\\n(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -998,10 +999,10 @@ mm_3gpp_parse_ws46_test_response (const gchar  *response,
     gboolean    supported_mode_25 = FALSE;
     gboolean    supported_mode_29 = FALSE;
 
-    r = g_regex_new ("(?:\\+WS46:)?\\s*\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:\\+WS46:)?\\s*\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -1228,11 +1229,11 @@ mm_3gpp_parse_cops_test_response (const gchar     *reply,
      *       +COPS: (2,"","T-Mobile","31026",0),(1,"AT&T","AT&T","310410"),0)
      */
 
-    r = g_regex_new ("\\((\\d),\"([^\"\\)]*)\",([^,\\)]*),([^,\\)]*)[\\)]?,(\\d)\\)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\((\\d),\"([^\"\\)]*)\",([^,\\)]*),([^,\\)]*)[\\)]?,(\\d)\\)", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r);
 
     /* If we didn't get any hits, try the pre-UMTS format match */
-    if (!g_regex_match (r, reply, 0, &match_info)) {
+    if (!mm_regex_match (r, reply, 0, &match_info)) {
         g_regex_unref (r);
         g_match_info_free (match_info);
         match_info = NULL;
@@ -1250,10 +1251,10 @@ mm_3gpp_parse_cops_test_response (const gchar     *reply,
          *       +COPS: (2,"T - Mobile",,"31026"),(1,"Einstein PCS",,"31064"),(1,"Cingular",,"31041"),,(0,1,3),(0,2)
          */
 
-        r = g_regex_new ("\\((\\d),([^,\\)]*),([^,\\)]*),([^\\)]*)\\)", G_REGEX_UNGREEDY, 0, NULL);
+        r = mm_regex_cache_get ("\\((\\d),([^,\\)]*),([^,\\)]*),([^\\)]*)\\)", G_REGEX_UNGREEDY, 0, NULL);
         g_assert (r);
 
-        g_regex_match (r, reply, 0, &match_info);
+        mm_regex_match (r, reply, 0, &match_info);
         umts_format = FALSE;
     }
 
@@ -1320,7 +1321,7 @@ mm_3gpp_parse_cops_test_response (const gchar     *reply,
         else
             mm_3gpp_network_info_free (info);
 
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
     g_match_info_free (match_info);
@@ -1355,10 +1356,10 @@ mm_3gpp_parse_cops_read_response (const gchar              *response,
      * or:
      *   +COPS: <mode>,<format>,<oper>,<AcT>
      */
-    r = g_regex_new ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -1732,12 +1733,12 @@ mm_3gpp_parse_cgdcont_test_response (const gchar  *response,
         return NULL;
     }
 
-    r = g_regex_new ("\\+CGDCONT:\\s*\\(\\s*(\\d+)\\s*-?\\s*(\\d+)?[^\\)]*\\)\\s*,\\s*\\(?\"(\\S+)\"",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, &inner_error);
+    r = mm_regex_cache_get ("\\+CGDCONT:\\s*\\(\\s*(\\d+)\\s*-?\\s*(\\d+)?[^\\)]*\\)\\s*,\\s*\\(?\"(\\S+)\"",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, &inner_error);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
         gchar *pdp_type_str;
         guint min_cid;
@@ -1770,7 +1771,7 @@ mm_3gpp_parse_cgdcont_test_response (const gchar  *response,
         }
 
         g_free (pdp_type_str);
-        g_match_info_next (match_info, &inner_error);
+        mm_match_info_next (match_info, &inner_error);
     }
 
     g_match_info_free (match_info);
@@ -1820,11 +1821,11 @@ mm_3gpp_parse_cgdcont_read_response (const gchar *reply,
         return NULL;
 
     list = NULL;
-    r = g_regex_new ("\\+CGDCONT:\\s*(\\d+)\\s*,([^, \\)]*)\\s*,([^, \\)]*)\\s*,([^, \\)]*)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, &inner_error);
+    r = mm_regex_cache_get ("\\+CGDCONT:\\s*(\\d+)\\s*,([^, \\)]*)\\s*,([^, \\)]*)\\s*,([^, \\)]*)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, &inner_error);
     if (r) {
-        g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
+        mm_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
 
         while (!inner_error &&
                g_match_info_matches (match_info)) {
@@ -1851,7 +1852,7 @@ mm_3gpp_parse_cgdcont_read_response (const gchar *reply,
             }
 
             g_free (str);
-            g_match_info_next (match_info, &inner_error);
+            mm_match_info_next (match_info, &inner_error);
         }
 
         g_match_info_free (match_info);
@@ -1905,11 +1906,11 @@ mm_3gpp_parse_cgact_read_response (const gchar *reply,
         return NULL;
 
     list = NULL;
-    r = g_regex_new ("\\+CGACT:\\s*(\\d+),(\\d+)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, &inner_error);
+    r = mm_regex_cache_get ("\\+CGACT:\\s*(\\d+),(\\d+)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, &inner_error);
     g_assert (r);
 
-    g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
         MM3gppPdpContextActive *pdp_active;
         guint cid = 0;
@@ -1935,7 +1936,7 @@ mm_3gpp_parse_cgact_read_response (const gchar *reply,
         pdp_active->active = (gboolean) aux;
         list = g_list_prepend (list, pdp_active);
 
-        g_match_info_next (match_info, &inner_error);
+        mm_match_info_next (match_info, &inner_error);
     }
 
     g_match_info_free (match_info);
@@ -2148,11 +2149,11 @@ mm_3gpp_parse_cmgf_test_response (const gchar *reply,
     while (isspace (*reply))
         reply++;
 
-    r = g_regex_new ("\\(?\\s*(\\d+)\\s*[-,]?\\s*(\\d+)?\\s*\\)?", 0, 0, error);
+    r = mm_regex_cache_get ("\\(?\\s*(\\d+)\\s*[-,]?\\s*(\\d+)?\\s*\\)?", 0, 0, error);
     if (!r)
         return FALSE;
 
-    if (!g_regex_match (r, reply, 0, &match_info)) {
+    if (!mm_regex_match (r, reply, 0, &match_info)) {
         g_set_error (error,
                      MM_CORE_ERROR,
                      MM_CORE_ERROR_FAILED,
@@ -2200,10 +2201,10 @@ mm_3gpp_parse_cmgr_read_response (const gchar *reply,
 
     /* +CMGR: <stat>,<alpha>,<length>(whitespace)<pdu> */
     /* The <alpha> and <length> fields are matched, but not currently used */
-    r = g_regex_new ("\\+CMGR:\\s*(\\d+)\\s*,([^,]*),\\s*(\\d+)\\s*([^\\r\\n]*)", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CMGR:\\s*(\\d+)\\s*,([^,]*),\\s*(\\d+)\\s*([^\\r\\n]*)", 0, 0, NULL);
     g_assert (r);
 
-    if (!g_regex_match (r, reply, 0, &match_info)) {
+    if (!mm_regex_match (r, reply, 0, &match_info)) {
         g_set_error (error,
                      MM_CORE_ERROR,
                      MM_CORE_ERROR_FAILED,
@@ -2281,11 +2282,11 @@ mm_3gpp_parse_crsm_response (const gchar *reply,
         return FALSE;
     }
 
-    r = g_regex_new ("\\+CRSM:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*\"?([0-9a-fA-F]+)\"?",
-                     G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+CRSM:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*\"?([0-9a-fA-F]+)\"?",
+                            G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
-    if (g_regex_match (r, reply, 0, &match_info) &&
+    if (mm_regex_match (r, reply, 0, &match_info) &&
         mm_get_uint_from_match_info (match_info, 1, sw1) &&
         mm_get_uint_from_match_info (match_info, 2, sw2))
         *hex = mm_get_string_unquoted_from_match_info (match_info, 3);
@@ -2395,19 +2396,19 @@ mm_3gpp_parse_cgcontrdp_response (const gchar  *response,
      * The format of the response changed in TS 27.007 v9.4.0, we try to detect
      * both formats ('a' if >= v9.4.0, 'b' if < v9.4.0) with a single regex here.
      */
-    r = g_regex_new ("\\+CGCONTRDP: "
-                     "(\\d+),(\\d+),([^,]*)" /* cid, bearer id, apn */
-                     "(?:,([^,]*))?" /* (a)ip+mask        or (b)ip */
-                     "(?:,([^,]*))?" /* (a)gateway        or (b)mask */
-                     "(?:,([^,]*))?" /* (a)dns1           or (b)gateway */
-                     "(?:,([^,]*))?" /* (a)dns2           or (b)dns1 */
-                     "(?:,([^,]*))?" /* (a)p-cscf primary or (b)dns2 */
-                     "(?:,(.*))?"    /* others, ignored */
-                     "(?:\\r\\n)?",
-                     0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CGCONTRDP: "
+                            "(\\d+),(\\d+),([^,]*)" /* cid, bearer id, apn */
+                            "(?:,([^,]*))?" /* (a)ip+mask        or (b)ip */
+                            "(?:,([^,]*))?" /* (a)gateway        or (b)mask */
+                            "(?:,([^,]*))?" /* (a)dns1           or (b)gateway */
+                            "(?:,([^,]*))?" /* (a)dns2           or (b)dns1 */
+                            "(?:,([^,]*))?" /* (a)p-cscf primary or (b)dns2 */
+                            "(?:,(.*))?"    /* others, ignored */
+                            "(?:\\r\\n)?",
+                            0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -2519,10 +2520,10 @@ mm_3gpp_parse_cfun_query_response (const gchar  *response,
      * +CFUN: 1,0
      *   ..but we don't care about the second number
      */
-    r = g_regex_new ("\\+CFUN: (\\d+)(?:,(?:\\d+))?(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CFUN: (\\d+)(?:,(?:\\d+))?(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -2586,10 +2587,10 @@ mm_3gpp_parse_cesq_response (const gchar  *response,
     /* Response may be e.g.:
      * +CESQ: 99,99,255,255,20,80
      */
-    r = g_regex_new ("\\+CESQ: (\\d+),(\\d+),(\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CESQ: (\\d+),(\\d+),(\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (!inner_error && g_match_info_matches (match_info)) {
         if (!mm_get_uint_from_match_info (match_info, 1, &rxlev)) {
             inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED, "Couldn't read RXLEV");
@@ -2894,13 +2895,13 @@ mm_3gpp_parse_ccwa_service_query_response (const gchar  *response,
      *
      * We're only interested in class 1 (voice)
      */
-    r = g_regex_new ("\\+CCWA:\\s*(\\d+),\\s*(\\d+)$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\+CCWA:\\s*(\\d+),\\s*(\\d+)$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -2919,7 +2920,7 @@ mm_3gpp_parse_ccwa_service_query_response (const gchar  *response,
                 break;
             }
         }
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
 out:
@@ -3026,7 +3027,7 @@ mm_3gpp_parse_cpms_test_response (const gchar  *reply,
         return FALSE;
     }
 
-    r = g_regex_new ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
     g_assert (r);
 
     for (i = 0; i < N_EXPECTED_GROUPS; i++) {
@@ -3037,7 +3038,7 @@ mm_3gpp_parse_cpms_test_response (const gchar  *reply,
         array = g_array_new (FALSE, FALSE, sizeof (MMSmsStorage));
 
         /* Got a range group to match */
-        if (g_regex_match (r, split[i], 0, &match_info)) {
+        if (mm_regex_match (r, split[i], 0, &match_info)) {
             while (g_match_info_matches (match_info)) {
                 gchar *str;
 
@@ -3050,7 +3051,7 @@ mm_3gpp_parse_cpms_test_response (const gchar  *reply,
                     g_free (str);
                 }
 
-                g_match_info_next (match_info, NULL);
+                mm_match_info_next (match_info, NULL);
             }
         }
         g_match_info_free (match_info);
@@ -3099,11 +3100,11 @@ mm_3gpp_parse_cpms_query_response (const gchar *reply,
     gboolean ret = FALSE;
     GMatchInfo *match_info = NULL;
 
-    r = g_regex_new (CPMS_QUERY_REGEX, G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get (CPMS_QUERY_REGEX, G_REGEX_RAW, 0, NULL);
 
     g_assert (r);
 
-    if (!g_regex_match (r, reply, 0, &match_info)) {
+    if (!mm_regex_match (r, reply, 0, &match_info)) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
                      "Could not parse CPMS query response '%s'", reply);
         goto end;
@@ -3188,17 +3189,17 @@ mm_3gpp_parse_cscs_test_response (const gchar *reply,
     }
 
     /* Now parse each charset */
-    r = g_regex_new ("\\s*([^,\\)]+)\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*([^,\\)]+)\\s*", 0, 0, NULL);
     if (!r)
         return FALSE;
 
-    if (g_regex_match (r, p, 0, &match_info)) {
+    if (mm_regex_match (r, p, 0, &match_info)) {
         while (g_match_info_matches (match_info)) {
             str = g_match_info_fetch (match_info, 1);
             charsets |= mm_modem_charset_from_string (str);
             g_free (str);
 
-            g_match_info_next (match_info, NULL);
+            mm_match_info_next (match_info, NULL);
             success = TRUE;
         }
     }
@@ -3230,11 +3231,11 @@ mm_3gpp_parse_clck_test_response (const gchar *reply,
     reply = mm_strip_tag (reply, "+CLCK:");
 
     /* Now parse each facility */
-    r = g_regex_new ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
     g_assert (r != NULL);
 
     *out_facilities = MM_MODEM_3GPP_FACILITY_NONE;
-    if (g_regex_match (r, reply, 0, &match_info)) {
+    if (mm_regex_match (r, reply, 0, &match_info)) {
         while (g_match_info_matches (match_info)) {
             gchar *str;
 
@@ -3244,7 +3245,7 @@ mm_3gpp_parse_clck_test_response (const gchar *reply,
                 g_free (str);
             }
 
-            g_match_info_next (match_info, NULL);
+            mm_match_info_next (match_info, NULL);
         }
     }
     g_match_info_free (match_info);
@@ -3268,10 +3269,10 @@ mm_3gpp_parse_clck_write_response (const gchar *reply,
 
     reply = mm_strip_tag (reply, "+CLCK:");
 
-    r = g_regex_new ("\\s*([01])\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*([01])\\s*", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (g_regex_match (r, reply, 0, &match_info)) {
+    if (mm_regex_match (r, reply, 0, &match_info)) {
         gchar *str;
 
         str = g_match_info_fetch (match_info, 1);
@@ -3308,19 +3309,19 @@ mm_3gpp_parse_cnum_exec_response (const gchar *reply)
     if (!reply || !reply[0])
         return NULL;
 
-    r = g_regex_new ("\\+CNUM:\\s*((\"([^\"]|(\\\"))*\")|([^,]*)),\"(?<num>\\S+)\",\\d",
-                     G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\+CNUM:\\s*((\"([^\"]|(\\\"))*\")|([^,]*)),\"(?<num>\\S+)\",\\d",
+                            G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
     array = g_ptr_array_new ();
-    g_regex_match (r, reply, 0, &match_info);
+    mm_regex_match (r, reply, 0, &match_info);
     while (g_match_info_matches (match_info)) {
         g_autofree gchar *number = NULL;
 
         number = g_match_info_fetch_named (match_info, "num");
         if (number && number[0])
             g_ptr_array_add (array, g_steal_pointer (&number));
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
     if (!array->len)
@@ -3538,7 +3539,7 @@ mm_3gpp_parse_cind_test_response (const gchar *reply,
     while (isspace (*reply))
         reply++;
 
-    r = g_regex_new ("\\(([^,]*),\\((\\d+)[-,](\\d+).*\\)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\(([^,]*),\\((\\d+)[-,](\\d+).*\\)", G_REGEX_UNGREEDY, 0, NULL);
     if (!r) {
         g_set_error_literal (error,
                              MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
@@ -3548,7 +3549,7 @@ mm_3gpp_parse_cind_test_response (const gchar *reply,
 
     hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) cind_response_free);
 
-    if (g_regex_match (r, reply, 0, &match_info)) {
+    if (mm_regex_match (r, reply, 0, &match_info)) {
         while (g_match_info_matches (match_info)) {
             MM3gppCindResponse *resp;
             gchar *desc, *tmp;
@@ -3570,7 +3571,7 @@ mm_3gpp_parse_cind_test_response (const gchar *reply,
 
             g_free (desc);
 
-            g_match_info_next (match_info, NULL);
+            mm_match_info_next (match_info, NULL);
         }
     }
     g_match_info_free (match_info);
@@ -3602,10 +3603,10 @@ mm_3gpp_parse_cind_read_response (const gchar *reply,
 
     reply = mm_strip_tag (reply, CIND_TAG);
 
-    r = g_regex_new ("(\\d+)[^0-9]+", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("(\\d+)[^0-9]+", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match (r, reply, 0, &match_info)) {
+    if (!mm_regex_match (r, reply, 0, &match_info)) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
                      "Could not parse the +CIND response '%s': didn't match",
                      reply);
@@ -3636,7 +3637,7 @@ mm_3gpp_parse_cind_read_response (const gchar *reply,
         }
 
         g_free (str);
-        g_match_info_next (match_info, NULL);
+        mm_match_info_next (match_info, NULL);
     }
 
     if (inner_error) {
@@ -3762,14 +3763,14 @@ mm_3gpp_parse_cgev_indication_pdp (const gchar  *str,
               type == MM_3GPP_CGEV_NW_DEACT_PDP ||
               type == MM_3GPP_CGEV_ME_DEACT_PDP);
 
-    r = g_regex_new ("(?:"
-                     "REJECT|"
-                     "NW REACT|"
-                     "NW DEACT|ME DEACT"
-                     ")\\s*([^,]*),\\s*([^,]*)(?:,\\s*([0-9]+))?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "REJECT|"
+                            "NW REACT|"
+                            "NW DEACT|ME DEACT"
+                            ")\\s*([^,]*),\\s*([^,]*)(?:,\\s*([0-9]+))?", 0, 0, NULL);
 
     str = mm_strip_tag (str, "+CGEV:");
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -3846,13 +3847,13 @@ mm_3gpp_parse_cgev_indication_primary (const gchar  *str,
               (type == MM_3GPP_CGEV_NW_DEACT_PRIMARY) ||
               (type == MM_3GPP_CGEV_ME_DEACT_PRIMARY));
 
-    r = g_regex_new ("(?:"
-                     "NW PDN ACT|ME PDN ACT|"
-                     "NW PDN DEACT|ME PDN DEACT|"
-                     ")\\s*([0-9]+)", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "NW PDN ACT|ME PDN ACT|"
+                            "NW PDN DEACT|ME PDN DEACT|"
+                            ")\\s*([0-9]+)", 0, 0, NULL);
 
     str = mm_strip_tag (str, "+CGEV:");
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -3907,13 +3908,13 @@ mm_3gpp_parse_cgev_indication_secondary (const gchar  *str,
               type == MM_3GPP_CGEV_NW_DEACT_SECONDARY ||
               type == MM_3GPP_CGEV_ME_DEACT_SECONDARY);
 
-    r = g_regex_new ("(?:"
-                     "NW ACT|ME ACT|"
-                     "NW DEACT|ME DEACT"
-                     ")\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "NW ACT|ME ACT|"
+                            "NW DEACT|ME DEACT"
+                            ")\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)", 0, 0, NULL);
 
     str = mm_strip_tag (str, "+CGEV:");
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     if (inner_error)
         goto out;
 
@@ -3987,11 +3988,11 @@ mm_3gpp_parse_pdu_cmgl_response (const gchar *str,
      *
      * We just read <index>, <stat> and the PDU itself.
      */
-    r = g_regex_new ("\\+CMGL:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,(.*)\\r\\n([^\\r\\n]*)(\\r\\n)?",
-                     G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    r = mm_regex_cache_get ("\\+CMGL:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,(.*)\\r\\n([^\\r\\n]*)(\\r\\n)?",
+                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     g_assert (r != NULL);
 
-    g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
+    mm_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
     while (!inner_error && g_match_info_matches (match_info)) {
         MM3gppPduInfo *info;
 
@@ -4001,7 +4002,7 @@ mm_3gpp_parse_pdu_cmgl_response (const gchar *str,
             (info->pdu = mm_get_string_unquoted_from_match_info (match_info, 4)) != NULL) {
             /* Append to our list of results and keep on */
             list = g_list_append (list, info);
-            g_match_info_next (match_info, &inner_error);
+            mm_match_info_next (match_info, &inner_error);
         } else {
             mm_3gpp_pdu_info_free (info);
             inner_error = g_error_new (MM_CORE_ERROR,
@@ -4759,12 +4760,12 @@ mm_cdma_parse_crm_test_response (const gchar *reply,
      *   <--- +CRM: (0-2)
      */
 
-    r = g_regex_new ("\\+CRM:\\s*\\((\\d+)-(\\d+)\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, error);
+    r = mm_regex_cache_get ("\\+CRM:\\s*\\((\\d+)-(\\d+)\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, error);
     g_assert (r != NULL);
 
-    if (g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &match_error)) {
+    if (mm_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &match_error)) {
         gchar *aux;
         guint min_val = 0;
         guint max_val = 0;
@@ -5047,10 +5048,10 @@ mm_parse_cclk_response (const char *response,
      *  +CCLK: "15/03/05,14:14:26-32"
      *  +CCLK: 17/07/26,11:42:15+01
      */
-    r = g_regex_new ("\\+CCLK:\\s*\"?(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d+)([-+]\\d+)?\"?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CCLK:\\s*\"?(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d+)([-+]\\d+)?\"?", 0, 0, NULL);
     g_assert (r != NULL);
 
-    if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
+    if (!mm_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
         if (match_error) {
             g_propagate_error (error, match_error);
             g_prefix_error (error, "Could not parse +CCLK results: ");
@@ -5139,8 +5140,8 @@ mm_parse_csim_response (const gchar *response,
     guint hex_code;
     GError *inner_error = NULL;
 
-    r = g_regex_new ("\\+CSIM:\\s*[0-9]+,\\s*\".*([0-9a-fA-F]{4})\"", G_REGEX_RAW, 0, NULL);
-    g_regex_match (r, response, 0, &match_info);
+    r = mm_regex_cache_get ("\\+CSIM:\\s*[0-9]+,\\s*\".*([0-9a-fA-F]{4})\"", G_REGEX_RAW, 0, NULL);
+    mm_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
         inner_error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
@@ -5287,14 +5288,14 @@ mm_sim_parse_cpol_query_response (const gchar  *response,
     guint                  act = 0;
     guint                  match_count;
 
-    r = g_regex_new ("\\+CPOL:\\s*(\\d+),\\s*(\\d+),\\s*\"?(\\d+)\"?"
-                     "(?:,\\s*(\\d+))?"     /* GSM_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* GSM_Compact_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* UTRAN_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* E-UTRAN_AcTn */
-                     "(?:,\\s*(\\d+))?",    /* NG-RAN_AcTn */
-                     G_REGEX_RAW, 0, NULL);
-    g_regex_match (r, response, 0, &match_info);
+    r = mm_regex_cache_get ("\\+CPOL:\\s*(\\d+),\\s*(\\d+),\\s*\"?(\\d+)\"?"
+                            "(?:,\\s*(\\d+))?"     /* GSM_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* GSM_Compact_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* UTRAN_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* E-UTRAN_AcTn */
+                            "(?:,\\s*(\\d+))?",    /* NG-RAN_AcTn */
+                            G_REGEX_RAW, 0, NULL);
+    mm_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
         g_set_error (error,
@@ -5374,9 +5375,9 @@ mm_sim_parse_cpol_test_response (const gchar  *response,
     guint                  min_index;
     guint                  max_index;
 
-    r = g_regex_new ("\\+CPOL:\\s*\\((\\d+)\\s*-\\s*(\\d+)\\)",
-                     G_REGEX_RAW, 0, NULL);
-    g_regex_match (r, response, 0, &match_info);
+    r = mm_regex_cache_get ("\\+CPOL:\\s*\\((\\d+)\\s*-\\s*(\\d+)\\)",
+                            G_REGEX_RAW, 0, NULL);
+    mm_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
         g_set_error (error,
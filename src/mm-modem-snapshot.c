@@ -0,0 +1,561 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "mm-utils.h"
+#include "mm-log-object.h"
+#include "mm-modem-snapshot.h"
+
+/*
+ * The snapshot is a key file with a header group:
+ *
+ *   [snapshot]
+ *   version=<format version>
+ *   daemon-version=<version of the daemon that wrote it>
+ *
+ * and one group per modem, named after the plugin managing it and its
+ * physical device, e.g. [generic//sys/devices/pci0000:00/0000:00:14.0/usb2/2-3].
+ * Each modem group has:
+ *
+ *   revision=<firmware revision>
+ *   equipment-identifier=<equipment identifier>
+ *   last-seen=<seconds since the epoch>
+ *   <property>=<value>
+ *
+ * where the properties are the ones of the Modem interface that don't
+ * change for a given firmware and that aren't used by plugins to setup their
+ * own private state. The group is looked up before anything is loaded from
+ * the modem, and the revision and equipment identifier loaded afterwards
+ * must match the stored ones; otherwise the whole group is discarded.
+ *
+ * Groups of modems not seen in MAX_AGE_SEC are discarded when loading, and
+ * only the MM_MODEM_SNAPSHOT_MAX_MODEMS seen most recently are kept.
+ *
+ * If the format version doesn't match the one supported, or the file was
+ * written by a different daemon version (which may load or compute the
+ * properties differently), the whole file is discarded.
+ */
+
+#define SNAPSHOT_VERSION 2
+
+#define GROUP_SNAPSHOT       "snapshot"
+#define KEY_VERSION          "version"
+#define KEY_DAEMON_VERSION   "daemon-version"
+#define KEY_REVISION         "revision"
+#define KEY_EQUIPMENT_ID     "equipment-identifier"
+#define KEY_LAST_SEEN        "last-seen"
+
+/* 90 days */
+#define MAX_AGE_SEC          (90 * 24 * 60 * 60)
+/* The last seen time is only refreshed once a day, so that the snapshot isn't
+ * written on every initialization */
+#define LAST_SEEN_UPDATE_SEC (24 * 60 * 60)
+
+#define GROUP_VALID_CHARS G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "-_.:/"
+
+/* String properties of the skeleton, also used as keys */
+static const gchar *string_properties[] = {
+    "manufacturer",
+    "model",
+    "hardware-revision",
+    "device-identifier",
+};
+
+#define PROPERTY_SUPPORTED_IP_FAMILIES "supported-ip-families"
+
+struct _MMModemSnapshot {
+    GObject   parent;
+    /* NULL if the snapshot is disabled */
+    gchar    *path;
+    GKeyFile *key_file;
+};
+
+struct _MMModemSnapshotClass {
+    GObjectClass parent;
+};
+
+enum {
+    PROP_0,
+    PROP_PATH,
+    PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
+/* Path of the snapshot used by the daemon, none until set up */
+static gchar *default_path;
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMModemSnapshot, mm_modem_snapshot, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("modem-snapshot");
+}
+
+/*****************************************************************************/
+
+static void
+snapshot_save (MMModemSnapshot *self)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *dirname = NULL;
+
+    dirname = g_path_get_dirname (self->path);
+    if (g_mkdir_with_parents (dirname, 0755) < 0) {
+        mm_obj_warn (self, "couldn't create directory '%s': %s", dirname, g_strerror (errno));
+        return;
+    }
+
+    /* Written to a temporary file and renamed, so a crash while saving never
+     * leaves a half-written snapshot behind */
+    g_key_file_set_integer (self->key_file, GROUP_SNAPSHOT, KEY_VERSION, SNAPSHOT_VERSION);
+    g_key_file_set_string (self->key_file, GROUP_SNAPSHOT, KEY_DAEMON_VERSION, MM_DIST_VERSION);
+    if (!g_key_file_save_to_file (self->key_file, self->path, &error))
+        mm_obj_warn (self, "couldn't save snapshot: %s", error->message);
+}
+
+/* Returns the group of the modem exposed in the skeleton, if it can be
+ * looked up */
+static gchar *
+snapshot_build_group (MmGdbusModem *skeleton)
+{
+    const gchar *plugin;
+    const gchar *device;
+
+    plugin = mm_gdbus_modem_get_plugin (skeleton);
+    device = mm_gdbus_modem_get_device (skeleton);
+    if (!plugin || !device || !device[0])
+        return NULL;
+
+    return g_strcanon (g_strdup_printf ("%s/%s", plugin, device), GROUP_VALID_CHARS, '_');
+}
+
+static gint64
+get_now (void)
+{
+    return g_get_real_time () / G_USEC_PER_SEC;
+}
+
+/* Removes the groups of modems not seen in MAX_AGE_SEC, and then the ones
+ * seen least recently until at most max_modems are left. Returns TRUE if any
+ * was removed. */
+static gboolean
+snapshot_evict (MMModemSnapshot *self,
+                guint            max_modems)
+{
+    g_auto(GStrv)  groups = NULL;
+    gsize          n_groups = 0;
+    guint          n_modems = 0;
+    gboolean       evicted = FALSE;
+    gint64         now;
+    gsize          i;
+
+    now = get_now ();
+    groups = g_key_file_get_groups (self->key_file, &n_groups);
+    for (i = 0; i < n_groups; i++) {
+        gint64 last_seen;
+
+        if (g_str_equal (groups[i], GROUP_SNAPSHOT))
+            continue;
+
+        last_seen = g_key_file_get_int64 (self->key_file, groups[i], KEY_LAST_SEEN, NULL);
+        if (now - last_seen > MAX_AGE_SEC) {
+            mm_obj_dbg (self, "modem %s not seen in a long time: discarding stored info", groups[i]);
+            g_key_file_remove_group (self->key_file, groups[i], NULL);
+            evicted = TRUE;
+            continue;
+        }
+        n_modems++;
+    }
+
+    while (n_modems > max_modems) {
+        g_auto(GStrv)  remaining = NULL;
+        const gchar   *oldest = NULL;
+        gint64         oldest_last_seen = G_MAXINT64;
+
+        /* On ties, the group stored first is the one removed */
+        remaining = g_key_file_get_groups (self->key_file, &n_groups);
+        for (i = 0; i < n_groups; i++) {
+            gint64 last_seen;
+
+            if (g_str_equal (remaining[i], GROUP_SNAPSHOT))
+                continue;
+
+            last_seen = g_key_file_get_int64 (self->key_file, remaining[i], KEY_LAST_SEEN, NULL);
+            if (last_seen < oldest_last_seen) {
+                oldest = remaining[i];
+                oldest_last_seen = last_seen;
+            }
+        }
+
+        g_assert (oldest);
+        mm_obj_dbg (self, "too many modems stored: discarding info of %s", oldest);
+        g_key_file_remove_group (self->key_file, oldest, NULL);
+        evicted = TRUE;
+        n_modems--;
+    }
+
+    return evicted;
+}
+
+/*****************************************************************************/
+
+GStrv
+mm_modem_snapshot_lookup (MMModemSnapshot *self,
+                          MmGdbusModem    *skeleton)
+{
+    g_autofree gchar *group = NULL;
+    GPtrArray        *loaded;
+    guint             i;
+
+    if (!self->path)
+        return NULL;
+
+    group = snapshot_build_group (skeleton);
+    if (!group || !g_key_file_has_group (self->key_file, group))
+        return NULL;
+
+    loaded = g_ptr_array_new ();
+    for (i = 0; i < G_N_ELEMENTS (string_properties); i++) {
+        g_autofree gchar *current = NULL;
+        g_autofree gchar *value = NULL;
+
+        g_object_get (skeleton, string_properties[i], &current, NULL);
+        if (current)
+            continue;
+
+        value = g_key_file_get_string (self->key_file, group, string_properties[i], NULL);
+        if (!value)
+            continue;
+
+        g_object_set (skeleton, string_properties[i], value, NULL);
+        g_ptr_array_add (loaded, g_strdup (string_properties[i]));
+    }
+
+    if (mm_gdbus_modem_get_supported_ip_families (skeleton) == MM_BEARER_IP_FAMILY_NONE &&
+        g_key_file_has_key (self->key_file, group, PROPERTY_SUPPORTED_IP_FAMILIES, NULL)) {
+        guint ip_families;
+
+        ip_families = (guint) g_key_file_get_integer (self->key_file, group, PROPERTY_SUPPORTED_IP_FAMILIES, NULL);
+        if (ip_families != MM_BEARER_IP_FAMILY_NONE) {
+            mm_gdbus_modem_set_supported_ip_families (skeleton, ip_families);
+            g_ptr_array_add (loaded, g_strdup (PROPERTY_SUPPORTED_IP_FAMILIES));
+        }
+    }
+
+    if (!loaded->len) {
+        g_ptr_array_unref (loaded);
+        return NULL;
+    }
+
+    mm_obj_dbg (self, "loaded static info of modem %s", group);
+    g_ptr_array_add (loaded, NULL);
+    return (GStrv) g_ptr_array_free (loaded, FALSE);
+}
+
+gboolean
+mm_modem_snapshot_confirm (MMModemSnapshot *self,
+                           MmGdbusModem    *skeleton)
+{
+    g_autofree gchar *group = NULL;
+    g_autofree gchar *revision = NULL;
+    g_autofree gchar *equipment_id = NULL;
+
+    if (!self->path)
+        return FALSE;
+
+    group = snapshot_build_group (skeleton);
+    if (!group)
+        return FALSE;
+
+    revision = g_key_file_get_string (self->key_file, group, KEY_REVISION, NULL);
+    equipment_id = g_key_file_get_string (self->key_file, group, KEY_EQUIPMENT_ID, NULL);
+    if (!revision ||
+        !equipment_id ||
+        g_strcmp0 (revision, mm_gdbus_modem_get_revision (skeleton)) != 0 ||
+        g_strcmp0 (equipment_id, mm_gdbus_modem_get_equipment_identifier (skeleton)) != 0) {
+        mm_obj_dbg (self, "modem %s revision or equipment identifier changed: stored info not valid", group);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+mm_modem_snapshot_clear_loaded (MmGdbusModem       *skeleton,
+                                const gchar *const *loaded)
+{
+    guint i;
+
+    for (i = 0; loaded && loaded[i]; i++) {
+        if (g_str_equal (loaded[i], PROPERTY_SUPPORTED_IP_FAMILIES))
+            mm_gdbus_modem_set_supported_ip_families (skeleton, MM_BEARER_IP_FAMILY_NONE);
+        else
+            g_object_set (skeleton, loaded[i], NULL, NULL);
+    }
+}
+
+void
+mm_modem_snapshot_store (MMModemSnapshot *self,
+                         MmGdbusModem    *skeleton)
+{
+    g_autofree gchar *group = NULL;
+    g_autofree gchar *stored_revision = NULL;
+    g_autofree gchar *stored_equipment_id = NULL;
+    const gchar      *revision;
+    const gchar      *equipment_id;
+    gboolean          changed = FALSE;
+    guint             ip_families;
+    gint64            now;
+    guint             i;
+
+    if (!self->path)
+        return;
+
+    group = snapshot_build_group (skeleton);
+    revision = mm_gdbus_modem_get_revision (skeleton);
+    equipment_id = mm_gdbus_modem_get_equipment_identifier (skeleton);
+    if (!group || !revision || !revision[0] || !equipment_id || !equipment_id[0])
+        return;
+
+    stored_revision = g_key_file_get_string (self->key_file, group, KEY_REVISION, NULL);
+    stored_equipment_id = g_key_file_get_string (self->key_file, group, KEY_EQUIPMENT_ID, NULL);
+    if (g_strcmp0 (stored_revision, revision) != 0 || g_strcmp0 (stored_equipment_id, equipment_id) != 0) {
+        if (g_key_file_has_group (self->key_file, group)) {
+            mm_obj_dbg (self, "modem %s changed (revision %s, equipment identifier %s): discarding stored info",
+                        group, revision, equipment_id);
+            g_key_file_remove_group (self->key_file, group, NULL);
+        }
+        g_key_file_set_string (self->key_file, group, KEY_REVISION, revision);
+        g_key_file_set_string (self->key_file, group, KEY_EQUIPMENT_ID, equipment_id);
+        changed = TRUE;
+    }
+
+    now = get_now ();
+    if (changed || now - g_key_file_get_int64 (self->key_file, group, KEY_LAST_SEEN, NULL) > LAST_SEEN_UPDATE_SEC) {
+        g_key_file_set_int64 (self->key_file, group, KEY_LAST_SEEN, now);
+        changed = TRUE;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (string_properties); i++) {
+        g_autofree gchar *current = NULL;
+        g_autofree gchar *value = NULL;
+
+        g_object_get (skeleton, string_properties[i], &current, NULL);
+        if (!current)
+            continue;
+
+        value = g_key_file_get_string (self->key_file, group, string_properties[i], NULL);
+        if (g_strcmp0 (value, current) == 0)
+            continue;
+
+        g_key_file_set_string (self->key_file, group, string_properties[i], current);
+        changed = TRUE;
+    }
+
+    ip_families = mm_gdbus_modem_get_supported_ip_families (skeleton);
+    if (ip_families != MM_BEARER_IP_FAMILY_NONE &&
+        (guint) g_key_file_get_integer (self->key_file, group, PROPERTY_SUPPORTED_IP_FAMILIES, NULL) != ip_families) {
+        g_key_file_set_integer (self->key_file, group, PROPERTY_SUPPORTED_IP_FAMILIES, (gint) ip_families);
+        changed = TRUE;
+    }
+
+    if (!changed)
+        return;
+
+    snapshot_evict (self, MM_MODEM_SNAPSHOT_MAX_MODEMS);
+    mm_obj_dbg (self, "storing static info of modem %s (revision %s)", group, revision);
+    snapshot_save (self);
+}
+
+void
+mm_modem_snapshot_flush (MMModemSnapshot *self)
+{
+    if (!self->path)
+        return;
+
+    mm_obj_dbg (self, "flushing snapshot");
+    g_key_file_unref (self->key_file);
+    self->key_file = g_key_file_new ();
+    if (g_unlink (self->path) < 0 && errno != ENOENT)
+        mm_obj_warn (self, "couldn't remove '%s': %s", self->path, g_strerror (errno));
+}
+
+/*****************************************************************************/
+
+MMModemSnapshot *
+mm_modem_snapshot_new (const gchar *path)
+{
+    return MM_MODEM_SNAPSHOT (g_object_new (MM_TYPE_MODEM_SNAPSHOT,
+                                            MM_MODEM_SNAPSHOT_PATH, path,
+                                            NULL));
+}
+
+MM_DEFINE_SINGLETON_GETTER (MMModemSnapshot, mm_modem_snapshot_get, MM_TYPE_MODEM_SNAPSHOT,
+                            MM_MODEM_SNAPSHOT_PATH, default_path)
+
+void
+mm_modem_snapshot_setup (const gchar *path,
+                         gboolean     flush)
+{
+    g_assert (!singleton_instance);
+
+    g_free (default_path);
+    default_path = g_strdup (path);
+    if (flush)
+        mm_modem_snapshot_flush (mm_modem_snapshot_get ());
+}
+
+/*****************************************************************************/
+
+static void
+snapshot_load (MMModemSnapshot *self)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *daemon_version = NULL;
+    gint               version;
+
+    if (!g_key_file_load_from_file (self->key_file, self->path, G_KEY_FILE_NONE, &error)) {
+        if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            mm_obj_warn (self, "couldn't load snapshot: %s", error->message);
+        return;
+    }
+
+    version = g_key_file_get_integer (self->key_file, GROUP_SNAPSHOT, KEY_VERSION, NULL);
+    if (version != SNAPSHOT_VERSION) {
+        mm_obj_dbg (self, "unsupported snapshot version %d: discarding it", version);
+        g_key_file_unref (self->key_file);
+        self->key_file = g_key_file_new ();
+        return;
+    }
+
+    daemon_version = g_key_file_get_string (self->key_file, GROUP_SNAPSHOT, KEY_DAEMON_VERSION, NULL);
+    if (g_strcmp0 (daemon_version, MM_DIST_VERSION) != 0) {
+        mm_obj_dbg (self, "snapshot written by daemon version %s: discarding it",
+                    daemon_version ? daemon_version : "unknown");
+        g_key_file_unref (self->key_file);
+        self->key_file = g_key_file_new ();
+        return;
+    }
+
+    if (snapshot_evict (self, MM_MODEM_SNAPSHOT_MAX_MODEMS))
+        snapshot_save (self);
+
+    mm_obj_dbg (self, "loaded snapshot from '%s'", self->path);
+}
+
+static void
+mm_modem_snapshot_init (MMModemSnapshot *self)
+{
+    self->key_file = g_key_file_new ();
+}
+
+static void
+constructed (GObject *object)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    G_OBJECT_CLASS (mm_modem_snapshot_parent_class)->constructed (object);
+
+    if (!self->path) {
+        mm_obj_dbg (self, "disabled");
+        return;
+    }
+
+    snapshot_load (self);
+}
+
+static void
+set_property (GObject      *object,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    switch (prop_id) {
+    case PROP_PATH:
+        g_free (self->path);
+        self->path = g_value_dup_string (value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+get_property (GObject    *object,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    switch (prop_id) {
+    case PROP_PATH:
+        g_value_set_string (value, self->path);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+finalize (GObject *object)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    g_key_file_unref (self->key_file);
+    g_free (self->path);
+
+    G_OBJECT_CLASS (mm_modem_snapshot_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_modem_snapshot_class_init (MMModemSnapshotClass *class)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+    object_class->constructed  = constructed;
+    object_class->set_property = set_property;
+    object_class->get_property = get_property;
+    object_class->finalize     = finalize;
+
+    properties[PROP_PATH] =
+        g_param_spec_string (MM_MODEM_SNAPSHOT_PATH,
+                             "Path",
+                             "Path of the snapshot file, none to disable it",
+                             NULL,
+                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    g_object_class_install_property (object_class, PROP_PATH, properties[PROP_PATH]);
+}
@@ -0,0 +1,70 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_MODEM_SNAPSHOT_H
+#define MM_MODEM_SNAPSHOT_H
+
+#include <config.h>
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+#define MM_TYPE_MODEM_SNAPSHOT            (mm_modem_snapshot_get_type ())
+#define MM_MODEM_SNAPSHOT(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshot))
+#define MM_MODEM_SNAPSHOT_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+#define MM_IS_MODEM_SNAPSHOT(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_MODEM_SNAPSHOT))
+#define MM_IS_MODEM_SNAPSHOT_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_MODEM_SNAPSHOT))
+#define MM_MODEM_SNAPSHOT_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+
+typedef struct _MMModemSnapshot      MMModemSnapshot;
+typedef struct _MMModemSnapshotClass MMModemSnapshotClass;
+
+#define MM_MODEM_SNAPSHOT_PATH "path"
+
+/* Modems stored at most, the ones seen least recently are discarded first */
+#define MM_MODEM_SNAPSHOT_MAX_MODEMS 16
+
+GType            mm_modem_snapshot_get_type (void);
+/* Snapshot stored in the given path; nothing is stored nor looked up if no
+ * path given */
+MMModemSnapshot *mm_modem_snapshot_new      (const gchar *path);
+
+/* The snapshot used by the daemon, disabled unless set up before the first
+ * time it's requested. Optionally flushes the stored info. */
+void             mm_modem_snapshot_setup    (const gchar *path,
+                                             gboolean     flush);
+MMModemSnapshot *mm_modem_snapshot_get      (void);
+
+/* Static info of the modem exposed in the given skeleton, keyed by its plugin
+ * and device, which must already be set. Lookup only sets the properties not
+ * loaded yet, and returns the names of the ones set, or NULL if none. */
+GStrv    mm_modem_snapshot_lookup       (MMModemSnapshot    *self,
+                                         MmGdbusModem       *skeleton);
+/* Whether the revision and equipment identifier loaded from the modem are the
+ * ones stored along with the info set by the lookup */
+gboolean mm_modem_snapshot_confirm      (MMModemSnapshot    *self,
+                                         MmGdbusModem       *skeleton);
+/* Clears the properties set by a lookup that couldn't be confirmed */
+void     mm_modem_snapshot_clear_loaded (MmGdbusModem       *skeleton,
+                                         const gchar *const *loaded);
+/* Also requires the revision and equipment identifier */
+void     mm_modem_snapshot_store        (MMModemSnapshot    *self,
+                                         MmGdbusModem       *skeleton);
+
+void     mm_modem_snapshot_flush        (MMModemSnapshot    *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemSnapshot, g_object_unref)
+
+#endif /* MM_MODEM_SNAPSHOT_H */
@@ -28,6 +28,7 @@
 #include <mm-errors-types.h>
 
 #include "mm-plugin-manager.h"
+#include "mm-port-probe-cache.h"
 #include "mm-plugin.h"
 #include "mm-shared.h"
 #include "mm-utils.h"
@@ -727,6 +728,14 @@ port_context_new (MMPluginManager *self,
 /* The wait time we define must always be less than the probing time */
 G_STATIC_ASSERT (MIN_WAIT_TIME_MSECS < MIN_PROBING_TIME_MSECS);
 
+/* All the timeouts above are only needed while we don't know how many ports
+ * the device exposes. Once a device with the same profile (vid, pid and
+ * number of USB interfaces) has gone through a full support check, the
+ * number of ports found is remembered, also across restarts in the port
+ * probe cache; next time, probing starts as soon as that many ports are
+ * available, and the device support check finishes as soon as all of them
+ * are probed. */
+
 /*
  * Device context
  *
@@ -783,6 +792,18 @@ struct _DeviceContext {
 
     /* Port support check contexts being run */
     GList *port_contexts;
+
+    /* Device profile, and number of ports expected in the device according
+     * to it (0 if unknown). Loaded when the first port is grabbed. */
+    gchar    *profile_key;
+    guint     expected_ports;
+    gboolean  expected_ports_ready;
+    /* Number of ports currently grabbed in the device */
+    guint     n_ports;
+
+    /* Probing timeline, in milliseconds since the context was created */
+    guint     probing_start_ms;
+    guint     last_port_ms;
 };
 
 static void
@@ -802,6 +823,7 @@ device_context_unref (DeviceContext *device_context)
         g_assert (!device_context->task);
 
         g_free (device_context->name);
+        g_free (device_context->profile_key);
         g_timer_destroy (device_context->timer);
         if (device_context->cancellable)
             g_object_unref (device_context->cancellable);
@@ -854,6 +876,136 @@ device_context_peek_waiting_port_context (DeviceContext  *device_context,
     return NULL;
 }
 
+static guint
+device_context_elapsed_ms (DeviceContext *device_context)
+{
+    return (guint) (g_timer_elapsed (device_context->timer, NULL) * 1000);
+}
+
+static gchar *
+device_context_build_profile_key (DeviceContext  *device_context,
+                                  MMKernelDevice *port)
+{
+    const gchar      *physdev_sysfs_path;
+    g_autofree gchar *interfaces_path = NULL;
+    g_autofree gchar *interfaces = NULL;
+    guint16           vid;
+    guint16           pid;
+
+    /* Only for devices that can be told apart by vid:pid */
+    vid = mm_device_get_vendor (device_context->device);
+    pid = mm_device_get_product (device_context->device);
+    if (!vid && !pid)
+        return NULL;
+
+    /* The same vid:pid may expose a different set of ports depending on the
+     * USB composition in use, so also use the number of interfaces, which is
+     * available in sysfs as soon as the device is enumerated */
+    physdev_sysfs_path = mm_kernel_device_get_physdev_sysfs_path (port);
+    if (physdev_sysfs_path) {
+        interfaces_path = g_build_filename (physdev_sysfs_path, "bNumInterfaces", NULL);
+        if (g_file_get_contents (interfaces_path, &interfaces, NULL, NULL))
+            g_strstrip (interfaces);
+    }
+
+    return g_strdup_printf ("%04x:%04x:%s", vid, pid, interfaces ? interfaces : "");
+}
+
+static void
+device_context_load_profile (DeviceContext  *device_context,
+                             MMKernelDevice *port)
+{
+    MMPluginManager *self;
+
+    self = device_context->self;
+
+    device_context->profile_key = device_context_build_profile_key (device_context, port);
+    if (!device_context->profile_key)
+        return;
+
+    device_context->expected_ports = mm_port_probe_cache_lookup_profile (mm_port_probe_cache_get (),
+                                                                         device_context->profile_key);
+    if (device_context->expected_ports) {
+        mm_obj_dbg (self, "task %s: expecting %u ports in device with profile %s",
+                    device_context->name, device_context->expected_ports, device_context->profile_key);
+    }
+}
+
+static void
+device_context_store_profile (DeviceContext *device_context)
+{
+    MMPluginManager *self;
+
+    self = device_context->self;
+
+    if (!device_context->profile_key || !device_context->n_ports)
+        return;
+
+    /* If we finished early because the expected ports were available, we
+     * didn't give more ports the chance to appear, so only learn if more
+     * ports than expected were found */
+    if (device_context->expected_ports_ready && device_context->n_ports <= device_context->expected_ports)
+        return;
+
+    mm_obj_dbg (self, "task %s: learned %u ports in device with profile %s",
+                device_context->name, device_context->n_ports, device_context->profile_key);
+    mm_port_probe_cache_store_profile (mm_port_probe_cache_get (),
+                                       device_context->profile_key,
+                                       device_context->n_ports);
+}
+
+static void
+device_context_store_timings (DeviceContext *device_context)
+{
+    GVariantBuilder builder;
+    guint           total_ms;
+
+    total_ms = device_context_elapsed_ms (device_context);
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{su}"));
+    g_variant_builder_add (&builder, "{su}", "wait-time",      device_context->probing_start_ms);
+    g_variant_builder_add (&builder, "{su}", "last-port-time", device_context->last_port_ms);
+    g_variant_builder_add (&builder, "{su}", "probing-time",   total_ms - MIN (total_ms, device_context->probing_start_ms));
+    g_variant_builder_add (&builder, "{su}", "total-time",     total_ms);
+    mm_device_set_probing_timings (device_context->device, g_variant_builder_end (&builder));
+}
+
+static void
+device_context_store_cached_plugin (DeviceContext *device_context)
+{
+    GList *probes;
+
+    probes = mm_device_peek_port_probe_list (device_context->device);
+    if (!probes)
+        return;
+
+    mm_port_probe_cache_store_plugin (mm_port_probe_cache_get (),
+                                      mm_port_probe_peek_port (MM_PORT_PROBE (probes->data)),
+                                      mm_plugin_get_name (device_context->best_plugin));
+}
+
+static MMPlugin *
+device_context_lookup_cached_plugin (DeviceContext  *device_context,
+                                     MMKernelDevice *port,
+                                     GList          *plugins)
+{
+    g_autofree gchar *plugin_name = NULL;
+    GList            *l;
+
+    plugin_name = mm_port_probe_cache_lookup_plugin (mm_port_probe_cache_get (), port);
+    if (!plugin_name)
+        return NULL;
+
+    for (l = plugins; l; l = g_list_next (l)) {
+        MMPlugin *plugin = MM_PLUGIN (l->data);
+
+        /* The GENERIC plugin is NEVER suggested */
+        if (g_str_equal (mm_plugin_get_name (plugin), plugin_name))
+            return (mm_plugin_is_generic (plugin) ? NULL : plugin);
+    }
+    return NULL;
+}
+
 static MMPlugin *
 device_context_run_finish (MMPluginManager  *self,
                            GAsyncResult     *res,
@@ -896,6 +1048,17 @@ device_context_complete (DeviceContext *device_context)
     mm_obj_dbg (self, "task %s: finished in '%lf' seconds",
                 device_context->name, g_timer_elapsed (device_context->timer, NULL));
 
+    /* Keep track of how long each phase took, and of how many ports the
+     * device has, unless the check was aborted */
+    if (device_context->best_plugin && !g_cancellable_is_cancelled (device_context->cancellable)) {
+        device_context_store_timings (device_context);
+        device_context_store_profile (device_context);
+        device_context_store_cached_plugin (device_context);
+    }
+
+    /* Write all the probing results of the device at once */
+    mm_port_probe_cache_sync (mm_port_probe_cache_get ());
+
     /* Remove signal handlers */
     if (device_context->grabbed_id) {
         g_signal_handler_disconnect (device_context->device, device_context->grabbed_id);
@@ -1184,6 +1347,13 @@ device_context_run_port_context (DeviceContext *device_context,
      * unless it is the generic plugin */
     if (device_context->best_plugin && !mm_plugin_is_generic (device_context->best_plugin))
         suggested = device_context->best_plugin;
+    /* Otherwise, try first with the plugin that managed the device last time */
+    else if (!device_context->best_plugin) {
+        suggested = device_context_lookup_cached_plugin (device_context, port_context->port, plugins);
+        if (suggested)
+            mm_obj_dbg (self, "task %s: plugin '%s' managed the device before",
+                        port_context->name, mm_plugin_get_name (suggested));
+    }
 
     port_context_run (self,
                       port_context,
@@ -1207,6 +1377,7 @@ device_context_min_wait_time_elapsed (DeviceContext *device_context)
     self = device_context->self;
 
     device_context->min_wait_time_id = 0;
+    device_context->probing_start_ms = device_context_elapsed_ms (device_context);
     mm_obj_dbg (self, "task %s: min wait time elapsed", device_context->name);
 
     /* Move list of port contexts out of the wait list */
@@ -1232,6 +1403,40 @@ device_context_min_wait_time_elapsed (DeviceContext *device_context)
     return G_SOURCE_REMOVE;
 }
 
+static void
+device_context_expected_ports_ready (DeviceContext *device_context)
+{
+    MMPluginManager *self;
+
+    if (device_context->expected_ports_ready)
+        return;
+    device_context->expected_ports_ready = TRUE;
+
+    self = device_context->self;
+    mm_obj_dbg (self, "task %s: all %u expected ports available",
+                device_context->name, device_context->expected_ports);
+
+    /* No need to wait for more ports to appear */
+    if (device_context->min_probing_time_id) {
+        g_source_remove (device_context->min_probing_time_id);
+        device_context->min_probing_time_id = 0;
+    }
+    if (device_context->extra_probing_time_id) {
+        g_source_remove (device_context->extra_probing_time_id);
+        device_context->extra_probing_time_id = 0;
+    }
+
+    /* Start probing right away; the port contexts are already in the
+     * running list after this */
+    if (device_context->min_wait_time_id) {
+        g_source_remove (device_context->min_wait_time_id);
+        device_context_min_wait_time_elapsed (device_context);
+    }
+
+    /* Wakeup the device context logic */
+    device_context_continue (device_context);
+}
+
 static void
 device_context_port_released (DeviceContext  *device_context,
                               MMKernelDevice *port)
@@ -1243,6 +1448,9 @@ device_context_port_released (DeviceContext  *device_context,
     mm_obj_dbg (self, "task %s: port released: %s",
                 device_context->name, mm_kernel_device_get_name (port));
 
+    if (device_context->n_ports > 0)
+        device_context->n_ports--;
+
     /* Check if there's a waiting port context */
     port_context = device_context_peek_waiting_port_context (device_context, port);
     if (port_context) {
@@ -1302,6 +1510,12 @@ device_context_port_grabbed (DeviceContext  *device_context,
                                                            (GSourceFunc) device_context_extra_probing_time_elapsed,
                                                            device_context);
 
+    /* Once the first port is known, we can tell how many to expect */
+    if (!device_context->profile_key)
+        device_context_load_profile (device_context, port);
+    device_context->n_ports++;
+    device_context->last_port_ms = device_context_elapsed_ms (device_context);
+
     /* Setup a new port context for the newly grabbed port */
     port_context = port_context_new (self,
                                      device_context->name,
@@ -1317,15 +1531,17 @@ device_context_port_grabbed (DeviceContext  *device_context,
                     port_context->name);
         /* Store the port reference in the list within the device */
         device_context->wait_port_contexts = g_list_prepend (device_context->wait_port_contexts, port_context);
-        return;
-    }
+    } else {
+        /* Store the port reference in the list within the device */
+        device_context->port_contexts = g_list_prepend (device_context->port_contexts, port_context) ;
 
-    /* Store the port reference in the list within the device */
-    device_context->port_contexts = g_list_prepend (device_context->port_contexts, port_context) ;
+        /* If the port has been grabbed after the min wait timeout expired, launch
+         * probing directly */
+        device_context_run_port_context (device_context, port_context);
+    }
 
-    /* If the port has been grabbed after the min wait timeout expired, launch
-     * probing directly */
-    device_context_run_port_context (device_context, port_context);
+    if (device_context->expected_ports && device_context->n_ports >= device_context->expected_ports)
+        device_context_expected_ports_ready (device_context);
 }
 
 static gboolean
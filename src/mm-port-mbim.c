@@ -34,6 +34,7 @@ G_DEFINE_TYPE (MMPortMbim, mm_port_mbim, MM_TYPE_PORT)
 struct _MMPortMbimPrivate {
     gboolean    in_progress;
     MbimDevice *mbim_device;
+    gulong      indication_trace_id;
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
     gboolean    qmi_supported;
     QmiDevice  *qmi_device;
@@ -542,6 +543,18 @@ mbim_query_device_services (GTask *task)
 
 #endif
 
+static void
+mbim_device_indication_trace (MMPortMbim  *self,
+                              MbimMessage *message)
+{
+    const guint8 *raw;
+    guint32       raw_len;
+
+    raw = mbim_message_get_raw (message, &raw_len, NULL);
+    if (raw)
+        mm_port_record_traffic (MM_PORT (self), MM_PORT_TRACE_DIRECTION_IN, raw, raw_len);
+}
+
 static void
 mbim_device_open_ready (MbimDevice   *mbim_device,
                         GAsyncResult *res,
@@ -562,6 +575,14 @@ mbim_device_open_ready (MbimDevice   *mbim_device,
 
     mm_obj_dbg (self, "MBIM device is now open");
 
+    /* Requests and responses are built and parsed within libmbim, only
+     * the indications are exposed raw */
+    if (mm_port_trace_is_enabled ())
+        self->priv->indication_trace_id = g_signal_connect_swapped (self->priv->mbim_device,
+                                                                    MBIM_DEVICE_SIGNAL_INDICATE_STATUS,
+                                                                    G_CALLBACK (mbim_device_indication_trace),
+                                                                    self);
+
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
     if (self->priv->qmi_supported) {
         mbim_query_device_services (task);
@@ -774,6 +795,8 @@ mm_port_mbim_close (MMPortMbim          *self,
 
     /* Store device(s) to close in the context */
     ctx = g_slice_new0 (PortMbimCloseContext);
+    if (self->priv->indication_trace_id)
+        g_clear_signal_handler (&self->priv->indication_trace_id, self->priv->mbim_device);
     ctx->mbim_device = g_steal_pointer (&self->priv->mbim_device);
     g_task_set_task_data (task, ctx, (GDestroyNotify)port_mbim_close_context_free);
 
@@ -855,6 +878,8 @@ dispose (GObject *object)
 #endif
 
     /* Clear device object */
+    if (self->priv->indication_trace_id)
+        g_clear_signal_handler (&self->priv->indication_trace_id, self->priv->mbim_device);
     g_clear_object (&self->priv->mbim_device);
 
     G_OBJECT_CLASS (mm_port_mbim_parent_class)->dispose (object);
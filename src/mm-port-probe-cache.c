@@ -0,0 +1,437 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "mm-context.h"
+#include "mm-utils.h"
+#include "mm-log-object.h"
+#include "mm-port-probe-cache.h"
+
+#if !defined PKGSTATEDIR
+# error PKGSTATEDIR must be defined at build time
+#endif
+
+#define PORT_PROBE_CACHE_FILE PKGSTATEDIR "/port-probe-cache"
+
+/*
+ * The cache is a key file with one group per physical device, named after
+ * the device uid. Each group has:
+ *
+ *   device=<vid>:<pid>:<revision>
+ *   plugin=<name of the plugin managing the device>
+ *   port.<subsystem>.<interface number>=<probing results, as a{sv} text>
+ *   port.<subsystem>.<interface number>.runs=<consecutive runs with them>
+ *   port.<subsystem>.<interface number>.updated=<time of the last run>
+ *
+ * The USB device release number (bcdDevice) changes with firmware upgrades
+ * in most modules, so if the device line doesn't match the one of the
+ * device being probed, the whole group is discarded.
+ *
+ * An additional group keeps the number of ports found in devices of each
+ * profile (see the plugin manager), so that device probing may finish early
+ * also in the first probing after a restart:
+ *
+ *   [port-profiles]
+ *   <vid>:<pid>:<number of USB interfaces>=<number of ports>
+ *
+ * A port not replying during one single run (e.g. because the modem was
+ * still booting, or because another process was using it) must not be
+ * skipped forever, so probing results are only reused once they have been
+ * the same in several consecutive runs, and only for a limited time after
+ * the last run confirming them.
+ */
+
+#define GROUP_PROFILES     "port-profiles"
+
+#define KEY_DEVICE         "device"
+#define KEY_PLUGIN         "plugin"
+#define KEY_PORT_PREFIX    "port."
+#define KEY_RUNS_SUFFIX    ".runs"
+#define KEY_UPDATED_SUFFIX ".updated"
+
+#define RESULTS_MIN_RUNS    2
+#define RESULTS_MAX_AGE_SEC (7 * 24 * 60 * 60)
+
+struct _MMPortProbeCache {
+    GObject   parent;
+    /* NULL if the cache is disabled */
+    gchar    *path;
+    GKeyFile *key_file;
+    /* Contents not saved yet */
+    gboolean  dirty;
+    guint     save_id;
+};
+
+struct _MMPortProbeCacheClass {
+    GObjectClass parent;
+};
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMPortProbeCache, mm_port_probe_cache, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("port-probe-cache");
+}
+
+/*****************************************************************************/
+
+static void
+cache_save (MMPortProbeCache *self)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *dirname = NULL;
+
+    self->dirty = FALSE;
+
+    dirname = g_path_get_dirname (self->path);
+    if (g_mkdir_with_parents (dirname, 0755) < 0) {
+        mm_obj_warn (self, "couldn't create directory '%s': %s", dirname, g_strerror (errno));
+        return;
+    }
+
+    if (!g_key_file_save_to_file (self->key_file, self->path, &error))
+        mm_obj_warn (self, "couldn't save cache: %s", error->message);
+}
+
+static gboolean
+cache_save_idle (MMPortProbeCache *self)
+{
+    self->save_id = 0;
+    if (self->dirty)
+        cache_save (self);
+    return G_SOURCE_REMOVE;
+}
+
+/* Returns the group of the device owning the port, if it can be cached */
+static gboolean
+cache_build_device_info (MMKernelDevice  *port,
+                         const gchar    **out_group,
+                         gchar          **out_device)
+{
+    const gchar *uid;
+    guint16      vid;
+    guint16      pid;
+
+    /* Only USB devices, which have a stable interface layout */
+    uid = mm_kernel_device_get_physdev_uid (port);
+    vid = mm_kernel_device_get_physdev_vid (port);
+    pid = mm_kernel_device_get_physdev_pid (port);
+    if (!uid || (!vid && !pid) || mm_kernel_device_get_interface_number (port) < 0)
+        return FALSE;
+
+    *out_group = uid;
+    if (out_device)
+        *out_device = g_strdup_printf ("%04x:%04x:%04x", vid, pid, mm_kernel_device_get_physdev_revision (port));
+    return TRUE;
+}
+
+static gchar *
+cache_build_port_key (MMKernelDevice *port)
+{
+    return g_strdup_printf (KEY_PORT_PREFIX "%s.%d",
+                            mm_kernel_device_get_subsystem (port),
+                            mm_kernel_device_get_interface_number (port));
+}
+
+/* Returns the group if the device info stored matches the one of the port */
+static const gchar *
+cache_lookup_device (MMPortProbeCache *self,
+                     MMKernelDevice   *port)
+{
+    const gchar      *group;
+    g_autofree gchar *device = NULL;
+    g_autofree gchar *stored = NULL;
+
+    if (!self->path)
+        return NULL;
+
+    if (!cache_build_device_info (port, &group, &device))
+        return NULL;
+
+    stored = g_key_file_get_string (self->key_file, group, KEY_DEVICE, NULL);
+    if (g_strcmp0 (stored, device) != 0)
+        return NULL;
+
+    return group;
+}
+
+/* Returns the group where to store info about the port, resetting it if
+ * the device info stored is outdated */
+static const gchar *
+cache_prepare_device (MMPortProbeCache *self,
+                      MMKernelDevice   *port)
+{
+    const gchar      *group;
+    g_autofree gchar *device = NULL;
+    g_autofree gchar *stored = NULL;
+
+    if (!self->path)
+        return NULL;
+
+    if (!cache_build_device_info (port, &group, &device))
+        return NULL;
+
+    stored = g_key_file_get_string (self->key_file, group, KEY_DEVICE, NULL);
+    if (g_strcmp0 (stored, device) != 0) {
+        if (stored) {
+            mm_obj_dbg (self, "device %s changed (%s -> %s): discarding cached info", group, stored, device);
+            g_key_file_remove_group (self->key_file, group, NULL);
+        }
+        g_key_file_set_string (self->key_file, group, KEY_DEVICE, device);
+    }
+
+    return group;
+}
+
+/*****************************************************************************/
+
+GVariant *
+mm_port_probe_cache_lookup_results (MMPortProbeCache *self,
+                                    MMKernelDevice   *port)
+{
+    const gchar       *group;
+    g_autofree gchar  *key = NULL;
+    g_autofree gchar  *runs_key = NULL;
+    g_autofree gchar  *updated_key = NULL;
+    g_autofree gchar  *str = NULL;
+    g_autoptr(GError)  error = NULL;
+    GVariant          *results;
+    gint               runs;
+    gint64             age;
+
+    group = cache_lookup_device (self, port);
+    if (!group)
+        return NULL;
+
+    key = cache_build_port_key (port);
+    str = g_key_file_get_string (self->key_file, group, key, NULL);
+    if (!str)
+        return NULL;
+
+    /* Not confirmed yet, or not confirmed in a long time */
+    runs_key = g_strconcat (key, KEY_RUNS_SUFFIX, NULL);
+    runs = g_key_file_get_integer (self->key_file, group, runs_key, NULL);
+    if (runs < RESULTS_MIN_RUNS) {
+        mm_obj_dbg (self, "cached results for %s in device %s seen in %d runs only: ignoring", key, group, runs);
+        return NULL;
+    }
+
+    updated_key = g_strconcat (key, KEY_UPDATED_SUFFIX, NULL);
+    age = (g_get_real_time () / G_USEC_PER_SEC) - g_key_file_get_int64 (self->key_file, group, updated_key, NULL);
+    if (age < 0 || age > RESULTS_MAX_AGE_SEC) {
+        mm_obj_dbg (self, "cached results for %s in device %s expired: ignoring", key, group);
+        return NULL;
+    }
+
+    results = g_variant_parse (G_VARIANT_TYPE_VARDICT, str, NULL, NULL, &error);
+    if (!results) {
+        mm_obj_warn (self, "invalid cached results for %s in device %s: %s", key, group, error->message);
+        return NULL;
+    }
+
+    return g_variant_ref_sink (results);
+}
+
+void
+mm_port_probe_cache_store_results (MMPortProbeCache *self,
+                                   MMKernelDevice   *port,
+                                   GVariant         *results)
+{
+    const gchar         *group;
+    g_autofree gchar    *key = NULL;
+    g_autofree gchar    *runs_key = NULL;
+    g_autofree gchar    *updated_key = NULL;
+    g_autofree gchar    *str = NULL;
+    g_autofree gchar    *stored = NULL;
+    g_autoptr(GVariant)  owned = NULL;
+    gint                 runs = 1;
+
+    owned = g_variant_ref_sink (results);
+    g_return_if_fail (g_variant_is_of_type (results, G_VARIANT_TYPE_VARDICT));
+
+    group = cache_prepare_device (self, port);
+    if (!group)
+        return;
+
+    key = cache_build_port_key (port);
+    runs_key = g_strconcat (key, KEY_RUNS_SUFFIX, NULL);
+    updated_key = g_strconcat (key, KEY_UPDATED_SUFFIX, NULL);
+    str = g_variant_print (results, TRUE);
+    stored = g_key_file_get_string (self->key_file, group, key, NULL);
+    if (g_strcmp0 (stored, str) == 0)
+        runs = MIN (g_key_file_get_integer (self->key_file, group, runs_key, NULL), RESULTS_MIN_RUNS - 1) + 1;
+
+    mm_obj_dbg (self, "storing results for %s in device %s (run %d): %s", key, group, runs, str);
+    g_key_file_set_string (self->key_file, group, key, str);
+    g_key_file_set_integer (self->key_file, group, runs_key, runs);
+    g_key_file_set_int64 (self->key_file, group, updated_key, g_get_real_time () / G_USEC_PER_SEC);
+    self->dirty = TRUE;
+}
+
+gchar *
+mm_port_probe_cache_lookup_plugin (MMPortProbeCache *self,
+                                   MMKernelDevice   *port)
+{
+    const gchar *group;
+
+    group = cache_lookup_device (self, port);
+    if (!group)
+        return NULL;
+
+    return g_key_file_get_string (self->key_file, group, KEY_PLUGIN, NULL);
+}
+
+void
+mm_port_probe_cache_store_plugin (MMPortProbeCache *self,
+                                  MMKernelDevice   *port,
+                                  const gchar      *plugin_name)
+{
+    const gchar      *group;
+    g_autofree gchar *stored = NULL;
+
+    group = cache_prepare_device (self, port);
+    if (!group)
+        return;
+
+    stored = g_key_file_get_string (self->key_file, group, KEY_PLUGIN, NULL);
+    if (g_strcmp0 (stored, plugin_name) == 0)
+        return;
+
+    mm_obj_dbg (self, "storing plugin for device %s: %s", group, plugin_name);
+    g_key_file_set_string (self->key_file, group, KEY_PLUGIN, plugin_name);
+    self->dirty = TRUE;
+}
+
+guint
+mm_port_probe_cache_lookup_profile (MMPortProbeCache *self,
+                                    const gchar      *profile)
+{
+    gint n_ports;
+
+    n_ports = g_key_file_get_integer (self->key_file, GROUP_PROFILES, profile, NULL);
+    return (guint) MAX (n_ports, 0);
+}
+
+void
+mm_port_probe_cache_store_profile (MMPortProbeCache *self,
+                                   const gchar      *profile,
+                                   guint             n_ports)
+{
+    /* Kept in memory even if the cache is disabled, so that it is still used
+     * during the current run */
+    if (mm_port_probe_cache_lookup_profile (self, profile) == n_ports)
+        return;
+
+    mm_obj_dbg (self, "storing %u ports for profile %s", n_ports, profile);
+    g_key_file_set_integer (self->key_file, GROUP_PROFILES, profile, (gint) n_ports);
+    if (self->path)
+        self->dirty = TRUE;
+}
+
+void
+mm_port_probe_cache_sync (MMPortProbeCache *self)
+{
+    if (!self->dirty || self->save_id)
+        return;
+
+    self->save_id = g_idle_add ((GSourceFunc) cache_save_idle, self);
+}
+
+void
+mm_port_probe_cache_flush (MMPortProbeCache *self)
+{
+    if (!self->path)
+        return;
+
+    mm_obj_dbg (self, "flushing cache");
+    g_key_file_unref (self->key_file);
+    self->key_file = g_key_file_new ();
+    self->dirty = FALSE;
+    if (g_unlink (self->path) < 0 && errno != ENOENT)
+        mm_obj_warn (self, "couldn't remove '%s': %s", self->path, g_strerror (errno));
+}
+
+/*****************************************************************************/
+
+static void
+mm_port_probe_cache_init (MMPortProbeCache *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    self->key_file = g_key_file_new ();
+
+    /* Never reuse results across test runs */
+    if (mm_context_get_no_probe_cache () || mm_context_get_test_session ()) {
+        mm_obj_dbg (self, "disabled");
+        return;
+    }
+
+    self->path = g_strdup (PORT_PROBE_CACHE_FILE);
+
+    if (mm_context_get_flush_probe_cache ()) {
+        mm_port_probe_cache_flush (self);
+        return;
+    }
+
+    if (!g_key_file_load_from_file (self->key_file, self->path, G_KEY_FILE_NONE, &error)) {
+        if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            mm_obj_warn (self, "couldn't load cache: %s", error->message);
+        return;
+    }
+
+    mm_obj_dbg (self, "loaded cache from '%s'", self->path);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMPortProbeCache *self = MM_PORT_PROBE_CACHE (object);
+
+    if (self->save_id)
+        g_source_remove (self->save_id);
+    if (self->dirty)
+        cache_save (self);
+
+    g_key_file_unref (self->key_file);
+    g_free (self->path);
+
+    G_OBJECT_CLASS (mm_port_probe_cache_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_port_probe_cache_class_init (MMPortProbeCacheClass *class)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+    object_class->finalize = finalize;
+}
+
+MM_DEFINE_SINGLETON_GETTER (MMPortProbeCache, mm_port_probe_cache_get, MM_TYPE_PORT_PROBE_CACHE)
@@ -0,0 +1,65 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_PORT_PROBE_CACHE_H
+#define MM_PORT_PROBE_CACHE_H
+
+#include <config.h>
+#include <glib-object.h>
+
+#include "mm-kernel-device.h"
+
+#define MM_TYPE_PORT_PROBE_CACHE            (mm_port_probe_cache_get_type ())
+#define MM_PORT_PROBE_CACHE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PORT_PROBE_CACHE, MMPortProbeCache))
+#define MM_PORT_PROBE_CACHE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_PORT_PROBE_CACHE, MMPortProbeCacheClass))
+#define MM_IS_PORT_PROBE_CACHE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_PORT_PROBE_CACHE))
+#define MM_IS_PORT_PROBE_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_PORT_PROBE_CACHE))
+#define MM_PORT_PROBE_CACHE_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_PORT_PROBE_CACHE, MMPortProbeCacheClass))
+
+typedef struct _MMPortProbeCache      MMPortProbeCache;
+typedef struct _MMPortProbeCacheClass MMPortProbeCacheClass;
+
+GType             mm_port_probe_cache_get_type (void);
+MMPortProbeCache *mm_port_probe_cache_get      (void);
+
+/* Probing results of a given port, as a{sv}; only given once confirmed by
+ * several consecutive runs, and not for too long after the last one */
+GVariant *mm_port_probe_cache_lookup_results (MMPortProbeCache *self,
+                                              MMKernelDevice   *port);
+void      mm_port_probe_cache_store_results  (MMPortProbeCache *self,
+                                              MMKernelDevice   *port,
+                                              GVariant         *results);
+
+/* Plugin that ended up managing the device the given port belongs to */
+gchar    *mm_port_probe_cache_lookup_plugin  (MMPortProbeCache *self,
+                                              MMKernelDevice   *port);
+void      mm_port_probe_cache_store_plugin   (MMPortProbeCache *self,
+                                              MMKernelDevice   *port,
+                                              const gchar      *plugin_name);
+
+/* Number of ports found in devices with the given profile, 0 if unknown */
+guint     mm_port_probe_cache_lookup_profile (MMPortProbeCache *self,
+                                              const gchar      *profile);
+void      mm_port_probe_cache_store_profile  (MMPortProbeCache *self,
+                                              const gchar      *profile,
+                                              guint             n_ports);
+
+/* Stores are kept in memory until synced; the cache file is then written
+ * once, in idle */
+void      mm_port_probe_cache_sync           (MMPortProbeCache *self);
+
+void      mm_port_probe_cache_flush          (MMPortProbeCache *self);
+
+#endif /* MM_PORT_PROBE_CACHE_H */
@@ -27,6 +27,7 @@
 #include <mm-errors-types.h>
 
 #include "mm-port-probe.h"
+#include "mm-port-probe-cache.h"
 #include "mm-log-object.h"
 #include "mm-port-serial-at.h"
 #include "mm-port-serial.h"
@@ -339,6 +340,8 @@ typedef struct {
     guint32 flags;
     guint source_id;
     GCancellable *cancellable;
+    /* Some results were reused from the cache instead of probed */
+    gboolean cached_results;
 
     /* ---- Serial probing specific context ---- */
 
@@ -386,6 +389,90 @@ static gboolean serial_probe_at       (MMPortProbe *self);
 static gboolean serial_probe_qcdm     (MMPortProbe *self);
 static void     serial_probe_schedule (MMPortProbe *self);
 
+/*****************************************************************************/
+/* Probing results cache */
+
+#define CACHED_FLAGS (MM_PORT_PROBE_AT | MM_PORT_PROBE_QCDM | MM_PORT_PROBE_QMI | MM_PORT_PROBE_MBIM)
+
+static void
+port_probe_load_cached_results (MMPortProbe     *self,
+                                MMPortProbeFlag  flags)
+{
+    PortProbeRunContext *ctx;
+    g_autoptr(GVariant)  results = NULL;
+    guint32              cached_flags = 0;
+    gboolean             is_at = FALSE;
+    gboolean             is_qcdm = FALSE;
+    gboolean             is_qmi = FALSE;
+    gboolean             is_mbim = FALSE;
+
+    results = mm_port_probe_cache_lookup_results (mm_port_probe_cache_get (), self->priv->port);
+    if (!results)
+        return;
+
+    g_variant_lookup (results, "flags", "u", &cached_flags);
+    g_variant_lookup (results, "at",    "b", &is_at);
+    g_variant_lookup (results, "qcdm",  "b", &is_qcdm);
+    g_variant_lookup (results, "qmi",   "b", &is_qmi);
+    g_variant_lookup (results, "mbim",  "b", &is_mbim);
+
+    /* AT ports are always probed again: the probing is quick when the port
+     * replies, and plugins may need to run their custom init on it. The ports
+     * worth skipping are the ones not replying to AT commands, where probing
+     * only finishes after several timeouts. */
+    if ((cached_flags & MM_PORT_PROBE_AT) && is_at) {
+        mm_obj_dbg (self, "cached results found but port is AT: probing anyway");
+        return;
+    }
+
+    /* Only reuse the results requested in this run */
+    cached_flags &= (flags & CACHED_FLAGS);
+    if (!cached_flags)
+        return;
+
+    mm_obj_dbg (self, "reusing cached probing results");
+    ctx = g_task_get_task_data (self->priv->task);
+    ctx->cached_results = TRUE;
+    if ((cached_flags & MM_PORT_PROBE_AT) && !(self->priv->flags & MM_PORT_PROBE_AT))
+        mm_port_probe_set_result_at (self, FALSE);
+    if ((cached_flags & MM_PORT_PROBE_QCDM) && !(self->priv->flags & MM_PORT_PROBE_QCDM))
+        mm_port_probe_set_result_qcdm (self, is_qcdm);
+    if ((cached_flags & MM_PORT_PROBE_QMI) && !(self->priv->flags & MM_PORT_PROBE_QMI))
+        mm_port_probe_set_result_qmi (self, is_qmi);
+    if ((cached_flags & MM_PORT_PROBE_MBIM) && !(self->priv->flags & MM_PORT_PROBE_MBIM))
+        mm_port_probe_set_result_mbim (self, is_mbim);
+}
+
+static void
+port_probe_store_cached_results (MMPortProbe *self)
+{
+    PortProbeRunContext *ctx;
+    GVariantBuilder      builder;
+
+    ctx = g_task_get_task_data (self->priv->task);
+
+    /* Results reused from the cache don't confirm themselves, let them
+     * expire so that they get probed again */
+    if (ctx->cached_results)
+        return;
+
+    /* If AT probing was aborted, the results are not reliable */
+    if (ctx->at_probing_cancellable && g_cancellable_is_cancelled (ctx->at_probing_cancellable))
+        return;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add (&builder, "{sv}", "flags", g_variant_new_uint32 (self->priv->flags & CACHED_FLAGS));
+    g_variant_builder_add (&builder, "{sv}", "at",    g_variant_new_boolean (self->priv->is_at));
+    g_variant_builder_add (&builder, "{sv}", "qcdm",  g_variant_new_boolean (self->priv->is_qcdm));
+    g_variant_builder_add (&builder, "{sv}", "qmi",   g_variant_new_boolean (self->priv->is_qmi));
+    g_variant_builder_add (&builder, "{sv}", "mbim",  g_variant_new_boolean (self->priv->is_mbim));
+    mm_port_probe_cache_store_results (mm_port_probe_cache_get (),
+                                       self->priv->port,
+                                       g_variant_builder_end (&builder));
+}
+
+/*****************************************************************************/
+
 static void
 port_probe_run_context_free (PortProbeRunContext *ctx)
 {
@@ -632,6 +719,7 @@ wdm_probe (MMPortProbe *self)
     }
 
     /* All done now */
+    port_probe_store_cached_results (self);
     port_probe_task_return_boolean (self, TRUE);
     return G_SOURCE_REMOVE;
 }
@@ -1230,6 +1318,7 @@ serial_probe_schedule (MMPortProbe *self)
     }
 
     /* All done! */
+    port_probe_store_cached_results (self);
     port_probe_task_return_boolean (self, TRUE);
 }
 
@@ -1245,13 +1334,13 @@ serial_flash_ready (MMPortSerial *port,
 }
 
 static void
-serial_buffer_full (MMPortSerial *serial,
-                    GByteArray   *buffer,
-                    MMPortProbe  *self)
+serial_buffer_full (MMPortSerial   *serial,
+                    MMSerialBuffer *buffer,
+                    MMPortProbe    *self)
 {
     PortProbeRunContext *ctx;
 
-    if (!is_non_at_response (buffer->data, buffer->len))
+    if (!is_non_at_response (mm_serial_buffer_get_data (buffer), mm_serial_buffer_get_len (buffer)))
         return;
 
     g_assert (self->priv->task);
@@ -1515,6 +1604,9 @@ mm_port_probe_run (MMPortProbe                *self,
         mm_port_probe_set_result_qmi  (self, FALSE);
     }
 
+    /* Reuse the results of a previous run in this same port, if any */
+    port_probe_load_cached_results (self, flags);
+
     /* Check if we already have the requested probing results.
      * We will fix here the 'ctx->flags' so that we only request probing
      * for the missing things. */
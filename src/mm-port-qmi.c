@@ -28,6 +28,7 @@
 #include "mm-port-enums-types.h"
 #include "mm-modem-helpers-qmi.h"
 #include "mm-log-object.h"
+#include "mm-main-loop-monitor.h"
 
 #define DEFAULT_LINK_PREALLOCATED_AMOUNT 4
 
@@ -48,21 +49,16 @@ static GParamSpec *properties[PROP_LAST];
 
 #endif
 
-typedef struct {
-    QmiService  service;
-    QmiClient  *client;
-    guint       flag;
-} ServiceInfo;
-
 struct _MMPortQmiPrivate {
     gboolean   in_progress;
     QmiDevice *qmi_device;
-    GList     *services;
+    MMQmiClientIndex *clients;
     gchar     *net_driver;
     gchar     *net_sysfs_path;
 #if defined WITH_QRTR
     QrtrNode  *node;
 #endif
+    gulong     indication_id;
 
     /* endpoint info */
     gulong              endpoint_info_signal_id;
@@ -83,38 +79,12 @@ struct _MMPortQmiPrivate {
 
 /*****************************************************************************/
 
-static QmiClient *
-lookup_client (MMPortQmi  *self,
-               QmiService  service,
-               guint       flag,
-               gboolean    steal)
-{
-    GList *l;
-
-    for (l = self->priv->services; l; l = g_list_next (l)) {
-        ServiceInfo *info = l->data;
-
-        if (info->service == service && info->flag == flag) {
-            QmiClient *found;
-
-            found = info->client;
-            if (steal) {
-                self->priv->services = g_list_delete_link (self->priv->services, l);
-                g_free (info);
-            }
-            return found;
-        }
-    }
-
-    return NULL;
-}
-
 QmiClient *
 mm_port_qmi_peek_client (MMPortQmi  *self,
                          QmiService  service,
                          guint       flag)
 {
-    return lookup_client (self, service, flag, FALSE);
+    return mm_qmi_client_index_peek (self->priv->clients, service, flag);
 }
 
 QmiClient *
@@ -199,7 +169,7 @@ mm_port_qmi_release_client (MMPortQmi     *self,
     if (!self->priv->qmi_device)
         return;
 
-    client = lookup_client (self, service, flag, TRUE);
+    client = mm_qmi_client_index_steal (self->priv->clients, service, flag);
     if (!client)
         return;
 
@@ -214,16 +184,13 @@ mm_port_qmi_release_client (MMPortQmi     *self,
 /*****************************************************************************/
 
 typedef struct {
-    ServiceInfo *info;
+    QmiService service;
+    guint      flag;
 } AllocateClientContext;
 
 static void
 allocate_client_context_free (AllocateClientContext *ctx)
 {
-    if (ctx->info) {
-        g_assert (ctx->info->client == NULL);
-        g_free (ctx->info);
-    }
     g_free (ctx);
 }
 
@@ -242,20 +209,31 @@ allocate_client_ready (QmiDevice *qmi_device,
 {
     MMPortQmi *self;
     AllocateClientContext *ctx;
+    QmiClient *client;
     GError *error = NULL;
 
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
-    ctx->info->client = qmi_device_allocate_client_finish (qmi_device, res, &error);
-    if (!ctx->info->client) {
+    client = qmi_device_allocate_client_finish (qmi_device, res, &error);
+    if (!client) {
         g_prefix_error (&error,
                         "Couldn't create client for service '%s': ",
-                        qmi_service_get_string (ctx->info->service));
+                        qmi_service_get_string (ctx->service));
         g_task_return_error (task, error);
+    } else if (!mm_qmi_client_index_add (self->priv->clients, ctx->service, ctx->flag, client)) {
+        /* Another allocation for the same service and flag was started before
+         * this one finished, keep the client that was added first */
+        mm_obj_dbg (self, "releasing duplicate client for service '%s'...", qmi_service_get_string (ctx->service));
+        qmi_device_release_client (qmi_device,
+                                   client,
+                                   QMI_DEVICE_RELEASE_CLIENT_FLAGS_RELEASE_CID,
+                                   3, NULL, NULL, NULL);
+        g_object_unref (client);
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_EXISTS,
+                                 "Client for service '%s' already allocated",
+                                 qmi_service_get_string (ctx->service));
     } else {
-        /* Move the service info to our internal list */
-        self->priv->services = g_list_prepend (self->priv->services, ctx->info);
-        ctx->info = NULL;
+        g_object_unref (client);
         g_task_return_boolean (task, TRUE);
     }
 
@@ -291,9 +269,8 @@ mm_port_qmi_allocate_client (MMPortQmi           *self,
     }
 
     ctx = g_new0 (AllocateClientContext, 1);
-    ctx->info = g_new0 (ServiceInfo, 1);
-    ctx->info->service = service;
-    ctx->info->flag = flag;
+    ctx->service = service;
+    ctx->flag = flag;
     g_task_set_task_data (task, ctx, (GDestroyNotify)allocate_client_context_free);
 
     qmi_device_allocate_client (self->priv->qmi_device,
@@ -2105,6 +2082,18 @@ mm_port_qmi_setup_data_format (MMPortQmi                      *self,
 
 /*****************************************************************************/
 
+static void
+qmi_device_indication (MMPortQmi  *self,
+                       GByteArray *raw)
+{
+    mm_port_record_traffic (MM_PORT (self), MM_PORT_TRACE_DIRECTION_IN, raw->data, raw->len);
+    /* The indication is processed by the clients right after, so only the
+     * latency can be recorded */
+    mm_main_loop_monitor_dispatch_record (MM_MAIN_LOOP_HANDLER_QMI_INDICATION, mm_log_object_get_id (MM_LOG_OBJECT (self)), 0);
+}
+
+/*****************************************************************************/
+
 typedef enum {
     PORT_OPEN_STEP_FIRST,
     PORT_OPEN_STEP_CHECK_OPENING,
@@ -2491,6 +2480,14 @@ port_open_step (GTask *task)
         g_assert (ctx->device);
         g_assert (!self->priv->qmi_device);
         self->priv->qmi_device = g_object_ref (ctx->device);
+
+        /* Requests and responses are built and parsed within libqmi, only
+         * the indications are exposed raw */
+        if (mm_port_trace_is_enabled () || mm_main_loop_monitor_handler_stats_enabled ())
+            self->priv->indication_id = g_signal_connect_swapped (self->priv->qmi_device,
+                                                                  QMI_DEVICE_SIGNAL_INDICATION,
+                                                                  G_CALLBACK (qmi_device_indication),
+                                                                  self);
         self->priv->in_progress = FALSE;
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
@@ -2601,6 +2598,7 @@ mm_port_qmi_close (MMPortQmi           *self,
 {
     PortQmiCloseContext *ctx;
     GTask               *task;
+    GList               *clients;
     GList               *l;
 
     g_return_if_fail (MM_IS_PORT_QMI (self));
@@ -2626,22 +2624,24 @@ mm_port_qmi_close (MMPortQmi           *self,
 
     /* Store device to close in the context */
     ctx = g_slice_new0 (PortQmiCloseContext);
+    if (self->priv->indication_id)
+        g_clear_signal_handler (&self->priv->indication_id, self->priv->qmi_device);
     ctx->qmi_device = g_steal_pointer (&self->priv->qmi_device);
     g_task_set_task_data (task, ctx, (GDestroyNotify)port_qmi_close_context_free);
 
     /* Release all allocated clients */
-    for (l = self->priv->services; l; l = g_list_next (l)) {
-        ServiceInfo *info = l->data;
+    clients = mm_qmi_client_index_steal_all (self->priv->clients);
+    for (l = clients; l; l = g_list_next (l)) {
+        QmiClient *client = l->data;
 
-        mm_obj_dbg (self, "Releasing client for service '%s'...", qmi_service_get_string (info->service));
+        mm_obj_dbg (self, "Releasing client for service '%s'...", qmi_service_get_string (qmi_client_get_service (client)));
         qmi_device_release_client (ctx->qmi_device,
-                                   info->client,
+                                   client,
                                    QMI_DEVICE_RELEASE_CLIENT_FLAGS_RELEASE_CID,
                                    3, NULL, NULL, NULL);
-        g_clear_object (&info->client);
     }
-    g_list_free_full (self->priv->services, g_free);
-    self->priv->services = NULL;
+    g_list_free_full (clients, g_object_unref);
+    mm_qmi_client_index_log_stats (self->priv->clients, self);
 
     /* Cleanup preallocated links, if any */
     if (self->priv->preallocated_links) {
@@ -2689,6 +2689,8 @@ mm_port_qmi_init (MMPortQmi *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_QMI, MMPortQmiPrivate);
 
+    self->priv->clients = mm_qmi_client_index_new ();
+
     /* load endpoint info as soon as kernel device is set */
     self->priv->endpoint_info_signal_id = g_signal_connect (self,
                                                             "notify::" MM_PORT_KERNEL_DEVICE,
@@ -2741,7 +2743,7 @@ static void
 dispose (GObject *object)
 {
     MMPortQmi *self = MM_PORT_QMI (object);
-    GList *l;
+    GList *clients;
 
     if (self->priv->endpoint_info_signal_id) {
         g_signal_handler_disconnect (self, self->priv->endpoint_info_signal_id);
@@ -2749,14 +2751,8 @@ dispose (GObject *object)
     }
 
     /* Deallocate all clients */
-    for (l = self->priv->services; l; l = g_list_next (l)) {
-        ServiceInfo *info = l->data;
-
-        if (info->client)
-            g_object_unref (info->client);
-    }
-    g_list_free_full (self->priv->services, g_free);
-    self->priv->services = NULL;
+    clients = mm_qmi_client_index_steal_all (self->priv->clients);
+    g_list_free_full (clients, g_object_unref);
 
     /* Cleanup preallocated links, if any */
     if (self->priv->preallocated_links && self->priv->qmi_device)
@@ -2769,6 +2765,8 @@ dispose (GObject *object)
     g_clear_object (&self->priv->node);
 #endif
     /* Clear device object */
+    if (self->priv->indication_id)
+        g_clear_signal_handler (&self->priv->indication_id, self->priv->qmi_device);
     g_clear_object (&self->priv->qmi_device);
 
     g_clear_pointer (&self->priv->net_driver, g_free);
@@ -2777,6 +2775,16 @@ dispose (GObject *object)
     G_OBJECT_CLASS (mm_port_qmi_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+    MMPortQmi *self = MM_PORT_QMI (object);
+
+    mm_qmi_client_index_free (self->priv->clients);
+
+    G_OBJECT_CLASS (mm_port_qmi_parent_class)->finalize (object);
+}
+
 static void
 mm_port_qmi_class_init (MMPortQmiClass *klass)
 {
@@ -2786,6 +2794,7 @@ mm_port_qmi_class_init (MMPortQmiClass *klass)
 
     /* Virtual methods */
     object_class->dispose = dispose;
+    object_class->finalize = finalize;
 
 #if defined WITH_QRTR
     object_class->get_property = get_property;
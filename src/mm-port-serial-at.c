@@ -42,6 +42,19 @@ struct _MMPortSerialAtPrivate {
     GDestroyNotify response_parser_notify;
 
     GSList *unsolicited_msg_handlers;
+    /* Dispatch index for the handlers above: full URC keys (e.g. "+CREG:")
+     * map to the list of handlers expecting them, while handlers with a
+     * shorter literal prefix (e.g. "RING") are compared one by one. Handlers
+     * without any literal prefix are not indexed and always run. */
+    GHashTable *unsolicited_msg_keyed;
+    GSList *unsolicited_msg_partial;
+
+    /* Copy of the response buffer contents given to the parser, kept while a
+     * response is being received so that only the new chunks are appended to
+     * it, along with the response buffer generation it mirrors */
+    GString *response_string;
+    guint response_string_generation;
+    MMPortSerialAtParseStats parse_stats;
 
     MMPortSerialAtFlag flags;
 
@@ -96,78 +109,155 @@ mm_port_serial_at_set_response_parser (MMPortSerialAt *self,
     self->priv->response_parser_notify = notify;
 }
 
-void
-mm_port_serial_at_remove_echo (GByteArray *response)
+/* Length of the echo or garbage found before the first <CR><LF> */
+static gsize
+echo_len (const guint8 *data,
+          gsize         len)
 {
-    guint i;
+    gsize i;
 
-    if (response->len <= 2)
-        return;
+    if (len <= 2)
+        return 0;
 
-    for (i = 0; i < (response->len - 1); i++) {
+    for (i = 0; i < (len - 1); i++) {
         /* If there is any content before the first
          * <CR><LF>, assume it's echo or garbage, and skip it */
-        if (response->data[i] == '\r' && response->data[i + 1] == '\n') {
-            if (i > 0)
-                g_byte_array_remove_range (response, 0, i);
-            /* else, good, we're already started with <CR><LF> */
-            break;
-        }
+        if (data[i] == '\r' && data[i + 1] == '\n')
+            return i;
     }
+    return 0;
+}
+
+void
+mm_port_serial_at_remove_echo (GByteArray *response)
+{
+    gsize len;
+
+    len = echo_len (response->data, response->len);
+    if (len > 0)
+        g_byte_array_remove_range (response, 0, len);
+}
+
+static void
+remove_echo (MMSerialBuffer *response)
+{
+    /* Just moves the read cursor */
+    mm_serial_buffer_consume (response,
+                              echo_len (mm_serial_buffer_get_data (response),
+                                        mm_serial_buffer_get_len (response)));
+}
+
+/* Brings the parse buffer up to date with the response buffer. While the
+ * response buffer contents are only appended to, only the new data is
+ * copied. */
+static GString *
+update_response_string (MMPortSerialAt *self,
+                        MMSerialBuffer *response)
+{
+    const guint8 *data;
+    gsize len;
+    guint generation;
+    GString *string;
+
+    data = mm_serial_buffer_get_data (response);
+    len = mm_serial_buffer_get_len (response);
+    generation = mm_serial_buffer_get_generation (response);
+
+    string = self->priv->response_string;
+    if (!string) {
+        string = self->priv->response_string = g_string_sized_new (len + 1);
+        self->priv->parse_stats.n_buffers++;
+    } else if (generation != self->priv->response_string_generation || string->len > len)
+        g_string_truncate (string, 0);
+    self->priv->response_string_generation = generation;
+
+    if (len > string->len) {
+        gsize allocated_len;
+
+        allocated_len = string->allocated_len;
+        self->priv->parse_stats.n_copied += len - string->len;
+        g_string_append_len (string, (const gchar *) &data[string->len], len - string->len);
+        if (string->allocated_len != allocated_len)
+            self->priv->parse_stats.n_grows++;
+    }
+    return string;
 }
 
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
     MMPortSerialAt *self = MM_PORT_SERIAL_AT (port);
     GString *string;
     gsize parsed_len;
+    gsize response_len;
     GError *inner_error = NULL;
 
     g_return_val_if_fail (self->priv->response_parser_fn != NULL, FALSE);
 
     /* Remove echo */
     if (self->priv->remove_echo)
-        mm_port_serial_at_remove_echo (response);
+        remove_echo (response);
 
     /* If there's no response to receive, we're done; e.g. if we only got
      * unsolicited messages */
-    if (!response->len)
+    response_len = mm_serial_buffer_get_len (response);
+    if (!response_len)
         return MM_PORT_SERIAL_RESPONSE_NONE;
 
-    /* Construct the string that AT-parsing functions expect */
-    string = g_string_sized_new (response->len + 1);
-    g_string_append_len (string, (const char *) response->data, response->len);
-
-    /* Fully cleanup the response array, we'll consider the contents we got
-     * as the full reply that the command may expect. */
-    g_byte_array_remove_range (response, 0, response->len);
+    /* Get the string that AT-parsing functions expect */
+    string = update_response_string (self, response);
 
     /* Parse it; returns FALSE if there is nothing we can do with this
      * response yet. */
-    if (!self->priv->response_parser_fn (self->priv->response_parser_user_data, string, self, &inner_error)) {
-        /* Copy what we got back in the response buffer. */
-        g_byte_array_append (response, (const guint8 *) string->str, string->len);
-        g_string_free (string, TRUE);
+    if (!self->priv->response_parser_fn (self->priv->response_parser_user_data,
+                                         string,
+                                         mm_serial_buffer_get_generation (response),
+                                         self,
+                                         &inner_error)) {
+        /* Keep the response buffer as is, unless the parser removed some of
+         * the contents we gave it; the parse buffer is then still a copy of
+         * the updated response buffer */
+        if (string->len != response_len) {
+            mm_serial_buffer_clear (response);
+            mm_serial_buffer_append (response, (const guint8 *) string->str, string->len);
+            self->priv->response_string_generation = mm_serial_buffer_get_generation (response);
+        }
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
-    /* If we got an error, propagate it without any further response string */
+    /* Fully cleanup the response buffer, we'll consider the contents we got
+     * as the full reply that the command may expect. */
+    mm_serial_buffer_clear (response);
+
+    /* If we got an error, propagate it without any further response string;
+     * the parse buffer is kept for the next response */
     if (inner_error) {
-        g_string_free (string, TRUE);
+        g_string_truncate (string, 0);
         g_propagate_error (error, inner_error);
         return MM_PORT_SERIAL_RESPONSE_ERROR;
     }
 
-    /* Otherwise, build a new GByteArray considered as parsed response */
+    /* Otherwise, build a new GByteArray considered as parsed response. It
+     * takes the parse buffer contents, so it is NUL-terminated right after
+     * its length, and it is handed as is to the command caller. */
+    self->priv->response_string = NULL;
     parsed_len = string->len;
     *parsed_response = g_byte_array_new_take ((guint8 *) g_string_free (string, FALSE), parsed_len);
     return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
+void
+mm_port_serial_at_get_parse_stats (MMPortSerialAt           *self,
+                                   MMPortSerialAtParseStats *stats)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL_AT (self));
+
+    *stats = self->priv->parse_stats;
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -176,8 +266,128 @@ typedef struct {
     gboolean enable;
     gpointer user_data;
     GDestroyNotify notify;
+    /* Literal that must follow a <CR><LF> for the regex to match, if any */
+    gchar *prefix;
+    gsize prefix_len;
+    gboolean candidate;
 } MMAtUnsolicitedMsgHandler;
 
+/* Longest URC key looked up in the index, e.g. "+CGEREP:" */
+#define UNSOLICITED_MSG_KEY_MAX_LEN 32
+
+gchar *
+mm_port_serial_at_get_unsolicited_msg_prefix (GRegex *regex)
+{
+    const gchar *pattern;
+    const gchar *p;
+    GString     *prefix;
+    gboolean     line_start = FALSE;
+    guint        depth = 0;
+    gboolean     in_class = FALSE;
+
+    /* Literal prefixes can't be used for case-insensitive or extended
+     * (whitespace-ignoring) patterns */
+    if (g_regex_get_compile_flags (regex) & (G_REGEX_CASELESS | G_REGEX_EXTENDED))
+        return NULL;
+
+    pattern = g_regex_get_pattern (regex);
+
+    /* A top-level alternation means no single prefix is required */
+    for (p = pattern; *p; p++) {
+        if (*p == '\\') {
+            if (!*(++p))
+                break;
+        } else if (in_class) {
+            if (*p == ']')
+                in_class = FALSE;
+        } else if (*p == '[')
+            in_class = TRUE;
+        else if (*p == '(')
+            depth++;
+        else if (*p == ')' && depth > 0)
+            depth--;
+        else if (*p == '|' && depth == 0)
+            return NULL;
+    }
+
+    /* The literal must come right after one or more <CR><LF>, given either
+     * escaped or as raw characters in the pattern */
+    p = pattern;
+    while (TRUE) {
+        if (g_str_has_prefix (p, "\\r\\n"))
+            p += 4;
+        else if (g_str_has_prefix (p, "\r\n"))
+            p += 2;
+        else
+            break;
+        line_start = TRUE;
+    }
+    if (!line_start || (*p && strchr ("?*+{", *p)))
+        return NULL;
+
+    prefix = g_string_new (NULL);
+    while (*p) {
+        gchar literal;
+        guint len;
+
+        if (*p == '\\') {
+            /* Escaped alphanumerics are classes or control chars */
+            if (!p[1] || g_ascii_isalnum (p[1]))
+                break;
+            literal = p[1];
+            len = 2;
+        } else if (strchr (".^$|()[]{}*+?", *p))
+            break;
+        else {
+            literal = *p;
+            len = 1;
+        }
+
+        /* Optional characters end the prefix */
+        if (p[len] && strchr ("?*{", p[len]))
+            break;
+
+        g_string_append_c (prefix, literal);
+        p += len;
+
+        /* URC keys end with the colon; also stop if the char may repeat */
+        if (literal == ':' || *p == '+')
+            break;
+    }
+
+    if (!prefix->len) {
+        g_string_free (prefix, TRUE);
+        return NULL;
+    }
+    return g_string_free (prefix, FALSE);
+}
+
+static void
+unsolicited_msg_handler_index (MMPortSerialAt            *self,
+                               MMAtUnsolicitedMsgHandler *handler)
+{
+    GSList *list;
+
+    handler->prefix = mm_port_serial_at_get_unsolicited_msg_prefix (handler->regex);
+    if (!handler->prefix)
+        return;
+
+    handler->prefix_len = strlen (handler->prefix);
+    if (handler->prefix[handler->prefix_len - 1] != ':' ||
+        handler->prefix_len > UNSOLICITED_MSG_KEY_MAX_LEN) {
+        self->priv->unsolicited_msg_partial = g_slist_prepend (self->priv->unsolicited_msg_partial, handler);
+        return;
+    }
+
+    /* Steal the current list so that it isn't freed when replaced */
+    list = g_hash_table_lookup (self->priv->unsolicited_msg_keyed, handler->prefix);
+    if (list)
+        g_hash_table_steal (self->priv->unsolicited_msg_keyed, handler->prefix);
+    g_hash_table_insert (self->priv->unsolicited_msg_keyed,
+                         handler->prefix,
+                         g_slist_prepend (list, handler));
+}
+
 static gint
 unsolicited_msg_handler_cmp (MMAtUnsolicitedMsgHandler *handler,
                              GRegex *regex)
@@ -211,8 +421,9 @@ mm_port_serial_at_add_unsolicited_msg_handler (MMPortSerialAt *self,
         /* The new handler is always PREPENDED, so that e.g. plugins can provide
          * more specific matches for URCs that are also handled by the generic
          * plugin. */
-        handler = g_slice_new (MMAtUnsolicitedMsgHandler);
+        handler = g_slice_new0 (MMAtUnsolicitedMsgHandler);
         handler->regex = g_regex_ref (regex);
+        unsolicited_msg_handler_index (self, handler);
         self->priv->unsolicited_msg_handlers = g_slist_prepend (self->priv->unsolicited_msg_handlers, handler);
     }
 
@@ -242,67 +453,347 @@ mm_port_serial_at_enable_unsolicited_msg_handler (MMPortSerialAt *self,
     }
 }
 
+static void
+mark_unsolicited_msg_candidates (MMPortSerialAt *self,
+                                 const guint8   *data,
+                                 gsize           len)
+{
+    const guint8 *end = data + len;
+    const guint8 *cr;
+
+    /* Walk all line starts once; a line start is whatever follows <CR><LF> */
+    for (cr = memchr (data, '\r', len); cr; cr = memchr (cr + 1, '\r', end - cr - 1)) {
+        const guint8 *line;
+        gsize         available;
+        gsize         i;
+        GSList       *l;
+
+        if (cr + 2 >= end)
+            break;
+        if (cr[1] != '\n')
+            continue;
+
+        line = cr + 2;
+        available = end - line;
+
+        /* Full URC key lookup, up to and including the colon */
+        for (i = 0; i < available && i < UNSOLICITED_MSG_KEY_MAX_LEN; i++) {
+            if (line[i] == ':' || line[i] == '\r' || line[i] == '\n')
+                break;
+        }
+        if (i < available && i < UNSOLICITED_MSG_KEY_MAX_LEN && line[i] == ':') {
+            gchar key[UNSOLICITED_MSG_KEY_MAX_LEN + 1];
+
+            memcpy (key, line, i + 1);
+            key[i + 1] = '\0';
+            for (l = g_hash_table_lookup (self->priv->unsolicited_msg_keyed, key); l; l = g_slist_next (l))
+                ((MMAtUnsolicitedMsgHandler *) l->data)->candidate = TRUE;
+        }
+
+        /* Shorter literal prefixes */
+        for (l = self->priv->unsolicited_msg_partial; l; l = g_slist_next (l)) {
+            MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) l->data;
+
+            if (handler->prefix_len <= available && memcmp (line, handler->prefix, handler->prefix_len) == 0)
+                handler->candidate = TRUE;
+        }
+    }
+}
+
+typedef struct {
+    gint start;
+    gint end;
+} MatchedRange;
+
+static gboolean
+matched_range_overlaps (GArray *ranges,
+                        gint    start,
+                        gint    end)
+{
+    guint i;
+
+    for (i = 0; ranges && i < ranges->len; i++) {
+        MatchedRange *range = &g_array_index (ranges, MatchedRange, i);
+
+        if (start < range->end && range->start < end)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static gint
+matched_range_cmp (const MatchedRange *a,
+                   const MatchedRange *b)
+{
+    return a->start - b->start;
+}
+
+static void
+remove_matched_ranges (MMSerialBuffer *response,
+                       GArray         *ranges)
+{
+    guint8 *data;
+    gsize   len;
+    gsize   head = 0;
+    gsize   read_pos;
+    gsize   write_pos;
+    guint   i = 0;
+
+    g_array_sort (ranges, (GCompareFunc) matched_range_cmp);
+
+    /* Matches at the head are just consumed, without moving any data */
+    while (i < ranges->len && (gsize) g_array_index (ranges, MatchedRange, i).start == head)
+        head = g_array_index (ranges, MatchedRange, i++).end;
+
+    if (i < ranges->len) {
+        data = mm_serial_buffer_get_data (response);
+        len = mm_serial_buffer_get_len (response);
+
+        /* Ranges never overlap, so all kept chunks can be moved in one pass */
+        read_pos = write_pos = g_array_index (ranges, MatchedRange, i).start;
+        for (; i < ranges->len; i++) {
+            MatchedRange *range = &g_array_index (ranges, MatchedRange, i);
+
+            if ((gsize) range->start > read_pos) {
+                memmove (&data[write_pos], &data[read_pos], range->start - read_pos);
+                write_pos += range->start - read_pos;
+            }
+            read_pos = range->end;
+        }
+        if (len > read_pos) {
+            memmove (&data[write_pos], &data[read_pos], len - read_pos);
+            write_pos += len - read_pos;
+        }
+        mm_serial_buffer_truncate (response, write_pos);
+    }
+
+    mm_serial_buffer_consume (response, head);
+}
+
+/*****************************************************************************/
+/* Reply memoization */
+
+/* Several clients (mmcli, NetworkManager...) usually ask for the same state
+ * at once, so replies to these queries are reused for a short time instead
+ * of asking the modem every time. */
+static const struct {
+    const gchar *command;
+    guint        ttl; /* ms */
+} reply_ttls[] = {
+    { "+CSQ",     1000 },
+    { "+CIND?",   1000 },
+    { "+CREG?",   2000 },
+    { "+CGREG?",  2000 },
+    { "+CEREG?",  2000 },
+    { "+C5GREG?", 2000 },
+    { "+COPS?",   2000 },
+    { "+CFUN?",   2000 },
+    { "+CPIN?",   2000 },
+    { "+CIMI",    5000 },
+    { "+CNUM",    5000 },
+};
+
+#define REGISTRATION_QUERIES "+CREG?", "+CGREG?", "+CEREG?", "+C5GREG?", "+COPS?"
+#define SIM_QUERIES          "+CPIN?", "+CIMI", "+CNUM"
+
+/* URCs reporting a state change (e.g. "+CREG: 1"), and commands changing it
+ * (e.g. "+COPS=0"), make the cached replies to the queries of that state
+ * stale */
+static const struct {
+    const gchar *prefix;
+    const gchar *commands[12];
+} reply_invalidations[] = {
+    { "+CREG",   { REGISTRATION_QUERIES, NULL } },
+    { "+CGREG",  { REGISTRATION_QUERIES, NULL } },
+    { "+CEREG",  { REGISTRATION_QUERIES, NULL } },
+    { "+C5GREG", { REGISTRATION_QUERIES, NULL } },
+    { "+COPS",   { REGISTRATION_QUERIES, NULL } },
+    { "+CGATT",  { REGISTRATION_QUERIES, NULL } },
+    { "+CPIN",   { SIM_QUERIES, "+CFUN?", NULL } },
+    { "+CLCK",   { "+CPIN?", NULL } },
+    { "+CFUN",   { "+CFUN?", REGISTRATION_QUERIES, SIM_QUERIES, "+CSQ", "+CIND?", NULL } },
+    { "+CIEV",   { "+CIND?", "+CSQ", NULL } },
+};
+
+/* The command without the AT prefix and the trailing CR/LF */
+static const gchar *
+at_command_get_body (const GByteArray *command,
+                     gsize            *len)
+{
+    const gchar *body = (const gchar *) command->data;
+    gsize        body_len = command->len;
+
+    if (body_len >= 2 && g_ascii_strncasecmp (body, "AT", 2) == 0) {
+        body += 2;
+        body_len -= 2;
+    }
+    while (body_len > 0 && (body[body_len - 1] == '\r' || body[body_len - 1] == '\n'))
+        body_len--;
+
+    *len = body_len;
+    return body;
+}
+
 static gboolean
-remove_eval_cb (const GMatchInfo *match_info,
-                GString *result,
-                gpointer user_data)
+at_command_body_equal (const gchar *body,
+                       gsize        len,
+                       const gchar *command)
 {
-    int *result_len = (int *) user_data;
-    int start;
-    int end;
+    return strlen (command) == len && g_ascii_strncasecmp (body, command, len) == 0;
+}
 
-    if (g_match_info_fetch_pos  (match_info, 0, &start, &end))
-        *result_len -= (end - start);
+static guint
+get_reply_ttl (MMPortSerial     *port,
+               const GByteArray *command)
+{
+    const gchar *body;
+    gsize        len;
+    guint        i;
+
+    body = at_command_get_body (command, &len);
+    for (i = 0; i < G_N_ELEMENTS (reply_ttls); i++) {
+        if (at_command_body_equal (body, len, reply_ttls[i].command))
+            return reply_ttls[i].ttl;
+    }
+    return 0;
+}
 
+static gboolean
+cached_reply_is_stale (const GByteArray *command,
+                       const gchar     **commands)
+{
+    const gchar *body;
+    gsize        len;
+    guint        i;
+
+    body = at_command_get_body (command, &len);
+    for (i = 0; commands[i]; i++) {
+        if (at_command_body_equal (body, len, commands[i]))
+            return TRUE;
+    }
     return FALSE;
 }
 
+/* @line is either an URC or a command, told apart by the character
+ * following the prefix, ':' or '=' respectively. Returns the queries whose
+ * cached replies become stale, or NULL if none. */
+static const gchar * const *
+find_stale_queries (const gchar *line,
+                    gsize        len,
+                    gchar        separator)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (reply_invalidations); i++) {
+        gsize prefix_len;
+
+        prefix_len = strlen (reply_invalidations[i].prefix);
+        if (len > prefix_len &&
+            line[prefix_len] == separator &&
+            g_ascii_strncasecmp (line, reply_invalidations[i].prefix, prefix_len) == 0)
+            return reply_invalidations[i].commands;
+    }
+    return NULL;
+}
+
+static void
+invalidate_cached_replies (MMPortSerialAt      *self,
+                           const gchar * const *stale_queries)
+{
+    if (stale_queries)
+        mm_port_serial_invalidate_cached_replies (MM_PORT_SERIAL (self),
+                                                  (MMPortSerialReplyCacheFilter) cached_reply_is_stale,
+                                                  (gpointer) stale_queries);
+}
+
 static void
-parse_unsolicited (MMPortSerial *port, GByteArray *response)
+urc_invalidate_cached_replies (MMPortSerialAt *self,
+                               const gchar    *urc,
+                               gsize           len)
+{
+    while (len > 0 && (*urc == '\r' || *urc == '\n')) {
+        urc++;
+        len--;
+    }
+    invalidate_cached_replies (self, find_stale_queries (urc, len, ':'));
+}
+
+/*****************************************************************************/
+
+static void
+parse_unsolicited (MMPortSerial *port, MMSerialBuffer *response)
 {
     MMPortSerialAt *self = MM_PORT_SERIAL_AT (port);
     GSList *iter;
+    GArray *matched = NULL;
+    const guint8 *data;
+    gsize len;
 
     /* Remove echo */
     if (self->priv->remove_echo)
-        mm_port_serial_at_remove_echo (response);
+        remove_echo (response);
+
+    data = mm_serial_buffer_get_data (response);
+    len = mm_serial_buffer_get_len (response);
+    if (!len)
+        return;
+
+    /* Flag the indexed handlers that could possibly match */
+    mark_unsolicited_msg_candidates (self, data, len);
 
     for (iter = self->priv->unsolicited_msg_handlers; iter; iter = iter->next) {
         MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) iter->data;
         GMatchInfo *match_info;
-        gboolean matches;
+        gboolean candidate;
+
+        candidate = handler->candidate;
+        handler->candidate = FALSE;
 
         if (!handler->enable)
             continue;
 
-        matches = g_regex_match_full (handler->regex,
-                                      (const char *) response->data,
-                                      response->len,
-                                      0, 0, &match_info, NULL);
-        if (handler->callback) {
-            while (g_match_info_matches (match_info)) {
-                handler->callback (self, match_info, handler->user_data);
-                g_match_info_next (match_info, NULL);
+        /* Indexed handlers whose prefix wasn't found at any line start
+         * can't match */
+        if (handler->prefix && !candidate)
+            continue;
+
+        if (!g_regex_match_full (handler->regex,
+                                 (const char *) data,
+                                 len,
+                                 0, 0, &match_info, NULL)) {
+            g_match_info_free (match_info);
+            continue;
+        }
+
+        while (g_match_info_matches (match_info)) {
+            gint start;
+            gint end;
+
+            /* Contents already matched by a previous handler (which takes
+             * precedence) are considered removed */
+            if (g_match_info_fetch_pos (match_info, 0, &start, &end) &&
+                !matched_range_overlaps (matched, start, end)) {
+                if (end > start) {
+                    MatchedRange range = { start, end };
+
+                    if (!matched)
+                        matched = g_array_new (FALSE, FALSE, sizeof (MatchedRange));
+                    g_array_append_val (matched, range);
+                }
+                urc_invalidate_cached_replies (self, (const gchar *) &data[start], end - start);
+                if (handler->callback)
+                    handler->callback (self, match_info, handler->user_data);
             }
+            g_match_info_next (match_info, NULL);
         }
 
         g_match_info_free (match_info);
+    }
 
-        if (matches) {
-            /* Remove matches */
-            char *str;
-            int result_len = response->len;
-
-            str = g_regex_replace_eval (handler->regex,
-                                        (const char *) response->data,
-                                        response->len,
-                                        0, 0,
-                                        remove_eval_cb, &result_len, NULL);
-
-            g_byte_array_remove_range (response, 0, response->len);
-            g_byte_array_append (response, (const guint8 *) str, result_len);
-            g_free (str);
-        }
+    /* Remove all matches at once */
+    if (matched) {
+        remove_matched_ranges (response, matched);
+        g_array_unref (matched);
     }
 }
 
@@ -348,63 +839,76 @@ mm_port_serial_at_command_finish (MMPortSerialAt *self,
                                   GAsyncResult *res,
                                   GError **error)
 {
-    GString *str;
+    GByteArray *response;
 
     if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (res), error))
         return NULL;
 
-    str = (GString *)g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (res));
-    return str->str;
+    response = (GByteArray *)g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (res));
+    return (const gchar *) response->data;
 }
 
-static void
-string_free (GString *str)
+GBytes *
+mm_port_serial_at_command_take_response (MMPortSerialAt *self,
+                                         GAsyncResult *res,
+                                         GError **error)
 {
-    g_string_free (str, TRUE);
+    GByteArray *response;
+
+    if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (res), error))
+        return NULL;
+
+    /* Zero-copy, the bytes keep a reference to the response buffer */
+    response = (GByteArray *)g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (res));
+    return g_bytes_new_with_free_func (response->data,
+                                       response->len,
+                                       (GDestroyNotify) g_byte_array_unref,
+                                       g_byte_array_ref (response));
 }
 
+typedef struct {
+    GSimpleAsyncResult  *result;
+    const gchar * const *stale_queries;
+} CommandContext;
+
 static void
-serial_command_ready (MMPortSerial *port,
-                      GAsyncResult *res,
-                      GSimpleAsyncResult *simple)
+serial_command_ready (MMPortSerial   *port,
+                      GAsyncResult   *res,
+                      CommandContext *ctx)
 {
-    GByteArray *response_buffer;
+    GByteArray *response;
     GError *error = NULL;
-    GString *response;
-
-    response_buffer = mm_port_serial_command_finish (port, res, &error);
-    if (!response_buffer) {
-        g_simple_async_result_take_error (simple, error);
-        g_simple_async_result_complete (simple);
-        g_object_unref (simple);
-        return;
-    }
 
-    /* Build a GString just with the response we need, and clear the
-     * processed range from the response buffer */
-    response = g_string_new_len ((const gchar *)response_buffer->data, response_buffer->len);
-    if (response_buffer->len > 0)
-        g_byte_array_remove_range (response_buffer, 0, response_buffer->len);
-    g_byte_array_unref (response_buffer);
+    /* Queries cached while the state-changing command was in flight may
+     * already be outdated, so invalidate again once it's done */
+    invalidate_cached_replies (MM_PORT_SERIAL_AT (port), ctx->stale_queries);
 
-    g_simple_async_result_set_op_res_gpointer (simple,
-                                               response,
-                                               (GDestroyNotify)string_free);
-    g_simple_async_result_complete (simple);
-    g_object_unref (simple);
+    response = mm_port_serial_command_finish (port, res, &error);
+    if (!response)
+        g_simple_async_result_take_error (ctx->result, error);
+    else
+        /* The parsed response buffer is given to the caller as is, it's
+         * already NUL-terminated */
+        g_simple_async_result_set_op_res_gpointer (ctx->result,
+                                                   response,
+                                                   (GDestroyNotify)g_byte_array_unref);
+    g_simple_async_result_complete (ctx->result);
+    g_object_unref (ctx->result);
+    g_slice_free (CommandContext, ctx);
 }
 
 void
-mm_port_serial_at_command (MMPortSerialAt *self,
-                           const char *command,
-                           guint32 timeout_seconds,
-                           gboolean is_raw,
-                           gboolean allow_cached,
-                           GCancellable *cancellable,
-                           GAsyncReadyCallback callback,
-                           gpointer user_data)
+mm_port_serial_at_command_full (MMPortSerialAt *self,
+                                const char *command,
+                                guint32 timeout_seconds,
+                                gboolean is_raw,
+                                MMPortSerialCacheMode cache_mode,
+                                MMPortSerialCommandPriority priority,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
 {
-    GSimpleAsyncResult *simple;
+    CommandContext *ctx;
     GByteArray *buf;
 
     g_return_if_fail (self != NULL);
@@ -418,22 +922,54 @@ mm_port_serial_at_command (MMPortSerialAt *self,
                                      TRUE));
     g_return_if_fail (buf != NULL);
 
-    simple = g_simple_async_result_new (G_OBJECT (self),
-                                        callback,
-                                        user_data,
-                                        mm_port_serial_at_command);
-
-    mm_port_serial_command (MM_PORT_SERIAL (self),
-                            buf,
-                            timeout_seconds,
-                            allow_cached,
-                            is_raw, /* raw commands always run next, never queued last */
-                            cancellable,
-                            (GAsyncReadyCallback)serial_command_ready,
-                            simple);
+    ctx = g_slice_new0 (CommandContext);
+    ctx->result = g_simple_async_result_new (G_OBJECT (self),
+                                             callback,
+                                             user_data,
+                                             mm_port_serial_at_command);
+
+    if (!is_raw) {
+        const gchar *body;
+        gsize        len;
+
+        body = at_command_get_body (buf, &len);
+        ctx->stale_queries = find_stale_queries (body, len, '=');
+        invalidate_cached_replies (self, ctx->stale_queries);
+    }
+
+    mm_port_serial_command_full (MM_PORT_SERIAL (self),
+                                 buf,
+                                 timeout_seconds,
+                                 cache_mode,
+                                 is_raw, /* raw commands always run next, never queued last */
+                                 priority,
+                                 cancellable,
+                                 (GAsyncReadyCallback)serial_command_ready,
+                                 ctx);
     g_byte_array_unref (buf);
 }
 
+void
+mm_port_serial_at_command (MMPortSerialAt *self,
+                           const char *command,
+                           guint32 timeout_seconds,
+                           gboolean is_raw,
+                           gboolean allow_cached,
+                           GCancellable *cancellable,
+                           GAsyncReadyCallback callback,
+                           gpointer user_data)
+{
+    mm_port_serial_at_command_full (self,
+                                    command,
+                                    timeout_seconds,
+                                    is_raw,
+                                    allow_cached ? MM_PORT_SERIAL_CACHE_MODE_ANY : MM_PORT_SERIAL_CACHE_MODE_NONE,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                    cancellable,
+                                    callback,
+                                    user_data);
+}
+
 static void
 debug_log (MMPortSerial *self,
            const gchar  *prefix,
@@ -441,7 +977,8 @@ debug_log (MMPortSerial *self,
            gsize         len)
 {
     static GString *debug = NULL;
-    const  char    *s;
+    const gchar    *s;
+    const gchar    *end;
 
     if (!debug)
         debug = g_string_sized_new (256);
@@ -450,16 +987,23 @@ debug_log (MMPortSerial *self,
     g_string_append (debug, " '");
 
     s = buf;
-    while (len--) {
-        if (g_ascii_isprint (*s))
-            g_string_append_c (debug, *s);
-        else if (*s == '\r')
+    end = buf + len;
+    while (s < end) {
+        const gchar *run;
+
+        /* Copy runs of printable chars at once */
+        for (run = s; s < end && g_ascii_isprint (*s); s++);
+        if (s > run)
+            g_string_append_len (debug, run, s - run);
+        if (s == end)
+            break;
+
+        if (*s == '\r')
             g_string_append (debug, "<CR>");
         else if (*s == '\n')
             g_string_append (debug, "<LF>");
         else
             g_string_append_printf (debug, "\\%u", (guint8) (*s & 0xFF));
-
         s++;
     }
 
@@ -544,6 +1088,11 @@ mm_port_serial_at_init (MMPortSerialAt *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_SERIAL_AT, MMPortSerialAtPrivate);
 
+    self->priv->unsolicited_msg_keyed = g_hash_table_new_full (g_str_hash,
+                                                               g_str_equal,
+                                                               NULL,
+                                                               (GDestroyNotify) g_slist_free);
+
     /* By default, remove echo */
     self->priv->remove_echo = TRUE;
     /* By default, run init sequence during first port opening */
@@ -613,6 +1162,10 @@ finalize (GObject *object)
 {
     MMPortSerialAt *self = MM_PORT_SERIAL_AT (object);
 
+    /* Index keys are owned by the handlers, so clear it first */
+    g_hash_table_unref (self->priv->unsolicited_msg_keyed);
+    g_slist_free (self->priv->unsolicited_msg_partial);
+
     while (self->priv->unsolicited_msg_handlers) {
         MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) self->priv->unsolicited_msg_handlers->data;
 
@@ -620,6 +1173,7 @@ finalize (GObject *object)
             handler->notify (handler->user_data);
 
         g_regex_unref (handler->regex);
+        g_free (handler->prefix);
         g_slice_free (MMAtUnsolicitedMsgHandler, handler);
         self->priv->unsolicited_msg_handlers = g_slist_delete_link (self->priv->unsolicited_msg_handlers,
                                                                     self->priv->unsolicited_msg_handlers);
@@ -629,6 +1183,8 @@ finalize (GObject *object)
         self->priv->response_parser_notify (self->priv->response_parser_user_data);
 
     g_strfreev (self->priv->init_sequence);
+    if (self->priv->response_string)
+        g_string_free (self->priv->response_string, TRUE);
 
     G_OBJECT_CLASS (mm_port_serial_at_parent_class)->finalize (object);
 }
@@ -650,6 +1206,7 @@ mm_port_serial_at_class_init (MMPortSerialAtClass *klass)
     serial_class->parse_response = parse_response;
     serial_class->debug_log = debug_log;
     serial_class->config = config;
+    serial_class->get_reply_ttl = get_reply_ttl;
 
     g_object_class_install_property
         (object_class, PROP_REMOVE_ECHO,
@@ -56,8 +56,12 @@ typedef enum { /*< underscore_name=mm_port_serial_at_flag >*/
     MM_PORT_SERIAL_AT_FLAG_NONE_NO_GENERIC = 1 << 4,
 } MMPortSerialAtFlag;
 
+/* @generation changes whenever the response contents given in the previous
+ * call were modified, instead of just appended to. When returning FALSE, the
+ * parser may remove contents from the response, but never replace them. */
 typedef gboolean (*MMPortSerialAtResponseParserFn) (gpointer   user_data,
                                                     GString   *response,
+                                                    guint      generation,
                                                     gpointer   log_object,
                                                     GError   **error);
 
@@ -108,9 +112,34 @@ void         mm_port_serial_at_command        (MMPortSerialAt *self,
                                                GCancellable *cancellable,
                                                GAsyncReadyCallback callback,
                                                gpointer user_data);
+void         mm_port_serial_at_command_full   (MMPortSerialAt *self,
+                                               const char *command,
+                                               guint32 timeout_seconds,
+                                               gboolean is_raw,
+                                               MMPortSerialCacheMode cache_mode,
+                                               MMPortSerialCommandPriority priority,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
+/* The response is borrowed, valid only until the callback returns */
 const gchar *mm_port_serial_at_command_finish (MMPortSerialAt *self,
                                                GAsyncResult *res,
                                                GError **error);
+/* Takes a reference on the response, without copying it */
+GBytes      *mm_port_serial_at_command_take_response (MMPortSerialAt *self,
+                                                      GAsyncResult *res,
+                                                      GError **error);
+
+typedef struct {
+    /* Bytes copied from the response buffer to be given to the parser */
+    guint64 n_copied;
+    /* Parse buffers allocated, one per response, and times they had to grow */
+    guint64 n_buffers;
+    guint64 n_grows;
+} MMPortSerialAtParseStats;
+
+void         mm_port_serial_at_get_parse_stats (MMPortSerialAt           *self,
+                                                MMPortSerialAtParseStats *stats);
 
 /*
  * Convert a string into a quoted and escaped string. Returns a new
@@ -120,6 +149,7 @@ gchar   *mm_port_serial_at_quote_string (const char *string);
 
 /* Just for unit tests */
 void     mm_port_serial_at_remove_echo (GByteArray *response);
+gchar   *mm_port_serial_at_get_unsolicited_msg_prefix (GRegex *regex);
 
 void     mm_port_serial_at_set_flags (MMPortSerialAt *self,
                                       MMPortSerialAtFlag flags);
@@ -18,6 +18,10 @@
 #include <unistd.h>
 #include <string.h>
 
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
 #include "mm-port-serial-gps.h"
 #include "mm-log-object.h"
 
@@ -28,9 +32,6 @@ struct _MMPortSerialGpsPrivate {
     MMPortSerialGpsTraceFn callback;
     gpointer user_data;
     GDestroyNotify notify;
-
-    /* Regex for all known traces */
-    GRegex *known_traces_regex;
 };
 
 /*****************************************************************************/
@@ -53,83 +54,87 @@ mm_port_serial_gps_add_trace_handler (MMPortSerialGps *self,
 
 /*****************************************************************************/
 
-static gboolean
-remove_eval_cb (const GMatchInfo *match_info,
-                GString *result,
-                gpointer user_data)
+static void
+process_trace (MMPortSerialGps *self,
+               const gchar     *trace,
+               gsize            len)
 {
-    int *result_len = (int *) user_data;
-    int start;
-    int end;
+    MMNmeaSentence sentence;
 
-    if (g_match_info_fetch_pos  (match_info, 0, &start, &end))
-        *result_len -= (end - start);
+    if (!self->priv->callback)
+        return;
+
+    /* The sentence is parsed only once here, and given as is to the handler */
+    if (!mm_nmea_sentence_parse (trace, len, &sentence)) {
+        mm_obj_dbg (self, "dropping invalid NMEA trace");
+        return;
+    }
 
-    return FALSE;
+    /* Sentences with a wrong checksum were corrupted in the way, drop them */
+    if (sentence.has_checksum && !sentence.checksum_ok) {
+        mm_obj_dbg (self, "dropping NMEA trace with invalid checksum");
+        return;
+    }
+
+    self->priv->callback (self, &sentence, self->priv->user_data);
 }
 
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
     MMPortSerialGps *self = MM_PORT_SERIAL_GPS (port);
-    gboolean matches;
-    GMatchInfo *match_info;
-    gchar *str;
-    gint result_len;
-    guint i;
-
-    for (i = 0; i < response->len; i++) {
-        /* If there is any content before the first $,
-         * assume it's garbage, and skip it */
-        if (response->data[i] == '$') {
-            if (i > 0)
-                g_byte_array_remove_range (response, 0, i);
-            /* else, good, we're already started with $ */
+    GByteArray *parsed = NULL;
+    const gchar *data;
+    const gchar *line;
+    const gchar *end;
+    const gchar *dollar;
+    gsize len;
+    gsize consumed = 0;
+
+    /* If there is any content before the first $,
+     * assume it's garbage, and skip it */
+    dollar = memchr (mm_serial_buffer_get_data (response), '$', mm_serial_buffer_get_len (response));
+    if (dollar)
+        mm_serial_buffer_consume (response, dollar - (const gchar *) mm_serial_buffer_get_data (response));
+
+    data = (const gchar *) mm_serial_buffer_get_data (response);
+    len = mm_serial_buffer_get_len (response);
+
+    /* All traces start with the dollar sign and end with \r\n; process
+     * complete lines only, so that a trace split across reads is kept in the
+     * buffer until the rest of it arrives */
+    for (line = data; line < data + len; line = end) {
+        const gchar *lf;
+
+        lf = memchr (line, '\n', data + len - line);
+        if (!lf)
             break;
-        }
-    }
-
-    matches = g_regex_match_full (self->priv->known_traces_regex,
-                                  (const gchar *) response->data,
-                                  response->len,
-                                  0, 0, &match_info, NULL);
-
-    if (self->priv->callback) {
-        while (g_match_info_matches (match_info)) {
-            gchar *trace;
-
-            trace = g_match_info_fetch (match_info, 0);
-            if (trace) {
-                self->priv->callback (self, trace, self->priv->user_data);
-                g_free (trace);
-            }
-            g_match_info_next (match_info, NULL);
-        }
-    }
+        end = lf + 1;
 
-    g_match_info_free (match_info);
+        dollar = memchr (line, '$', end - line);
+        if (!dollar || (lf == dollar) || (lf[-1] != '\r'))
+            continue;
 
-    if (!matches)
-        return MM_PORT_SERIAL_RESPONSE_NONE;
+        /* The parsed response is whatever is not a known trace */
+        if (!parsed)
+            parsed = g_byte_array_new ();
+        g_byte_array_append (parsed, (const guint8 *) &data[consumed], dollar - &data[consumed]);
+        consumed = end - data;
 
-    /* Remove matches */
-    result_len = response->len;
-    str = g_regex_replace_eval (self->priv->known_traces_regex,
-                                (const char *) response->data,
-                                response->len,
-                                0, 0,
-                                remove_eval_cb, &result_len, NULL);
+        process_trace (self, dollar, end - dollar);
+    }
 
-    /* Cleanup response buffer */
-    g_byte_array_remove_range (response, 0, response->len);
+    if (!parsed)
+        return MM_PORT_SERIAL_RESPONSE_NONE;
 
-    /* Build parsed response */
-    *parsed_response = g_byte_array_new_take ((guint8 *)str, result_len);
+    /* Everything after the last trace stays in the buffer */
+    mm_serial_buffer_consume (response, consumed);
 
-    return TRUE;
+    *parsed_response = parsed;
+    return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
 /*****************************************************************************/
@@ -142,6 +147,7 @@ debug_log (MMPortSerial *self,
 {
     static GString *debug = NULL;
     const gchar    *s;
+    const gchar    *end;
 
     if (!debug)
         debug = g_string_sized_new (256);
@@ -150,16 +156,23 @@ debug_log (MMPortSerial *self,
     g_string_append (debug, " '");
 
     s = buf;
-    while (len--) {
-        if (g_ascii_isprint (*s))
-            g_string_append_c (debug, *s);
-        else if (*s == '\r')
+    end = buf + len;
+    while (s < end) {
+        const gchar *run;
+
+        /* Copy runs of printable chars at once */
+        for (run = s; s < end && g_ascii_isprint (*s); s++);
+        if (s > run)
+            g_string_append_len (debug, run, s - run);
+        if (s == end)
+            break;
+
+        if (*s == '\r')
             g_string_append (debug, "<CR>");
         else if (*s == '\n')
             g_string_append (debug, "<LF>");
         else
             g_string_append_printf (debug, "\\%u", (guint8) (*s & 0xFF));
-
         s++;
     }
 
@@ -186,13 +199,6 @@ mm_port_serial_gps_init (MMPortSerialGps *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_PORT_SERIAL_GPS,
                                               MMPortSerialGpsPrivate);
-
-    /* We'll assume that all traces start with the dollar sign and end with \r\n */
-    self->priv->known_traces_regex =
-        g_regex_new ("\\$.*\\r\\n",
-                     G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                     0,
-                     NULL);
 }
 
 static void
@@ -203,8 +209,6 @@ finalize (GObject *object)
     if (self->priv->notify)
         self->priv->notify (self->priv->user_data);
 
-    g_regex_unref (self->priv->known_traces_regex);
-
     G_OBJECT_CLASS (mm_port_serial_gps_parent_class)->finalize (object);
 }
 
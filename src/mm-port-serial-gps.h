@@ -19,6 +19,9 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
 #include "mm-port-serial.h"
 
 #define MM_TYPE_PORT_SERIAL_GPS            (mm_port_serial_gps_get_type ())
@@ -32,8 +35,10 @@ typedef struct _MMPortSerialGps MMPortSerialGps;
 typedef struct _MMPortSerialGpsClass MMPortSerialGpsClass;
 typedef struct _MMPortSerialGpsPrivate MMPortSerialGpsPrivate;
 
+/* The sentence is already parsed and its checksum validated; it points to
+ * the port buffer, so it's only valid during the call */
 typedef void (*MMPortSerialGpsTraceFn) (MMPortSerialGps *port,
-                                        const gchar *trace,
+                                        const MMNmeaSentence *sentence,
                                         gpointer user_data);
 
 struct _MMPortSerialGps {
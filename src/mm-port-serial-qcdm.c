@@ -38,10 +38,13 @@ struct _MMPortSerialQcdmPrivate {
 /*****************************************************************************/
 
 static gboolean
-find_qcdm_start (GByteArray *response, gsize *start)
+find_qcdm_start (const guint8 *data,
+                 gsize         len,
+                 gsize        *start)
 {
-    guint i;
-    gint  last = -1;
+    const guint8 *marker;
+    gsize         pos = 0;
+    gssize        last = -1;
 
     /* Look for 3 bytes and a QCDM frame marker, ie enough data for a valid
      * frame.  There will usually be three cases here; (1) a QCDM frame
@@ -49,29 +52,32 @@ find_qcdm_start (GByteArray *response, gsize *start)
      * with 0x7E and ending with 0x7E, and (3) a non-QCDM frame that still
      * uses HDLC framing (like Sierra CnS) that starts and ends with 0x7E.
      */
-    for (i = 0; i < response->len; i++) {
+    while ((marker = memchr (data + pos, 0x7E, len - pos)) != NULL) {
+        gsize i;
+
         /* Marker found */
-        if (response->data[i] == 0x7E) {
-            /* If we didn't get an initial marker, count at least 3 bytes since
-             * origin; if we did get an initial marker, count at least 3 bytes
-             * since the marker.
-             */
-            if (((last == -1) && (i >= 3)) || ((last >= 0) && (i > (guint)(last + 3)))) {
-                /* Got a full QCDM frame; 3 non-0x7E bytes and a terminator */
-                if (start)
-                    *start = last + 1;
-                return TRUE;
-            }
-
-            /* Save position of the last QCDM frame marker */
-            last = i;
+        i = marker - data;
+
+        /* If we didn't get an initial marker, count at least 3 bytes since
+         * origin; if we did get an initial marker, count at least 3 bytes
+         * since the marker.
+         */
+        if (((last == -1) && (i >= 3)) || ((last >= 0) && (i > (gsize)(last + 3)))) {
+            /* Got a full QCDM frame; 3 non-0x7E bytes and a terminator */
+            if (start)
+                *start = last + 1;
+            return TRUE;
         }
+
+        /* Save position of the last QCDM frame marker */
+        last = i;
+        pos = i + 1;
     }
     return FALSE;
 }
 
 static MMPortSerialResponseType
-parse_qcdm (GByteArray *response,
+parse_qcdm (MMSerialBuffer *response,
             gboolean want_log,
             GByteArray **parsed_response,
             GError **error)
@@ -83,7 +89,9 @@ parse_qcdm (GByteArray *response,
     qcdmbool more = FALSE;
 
     /* Get the offset into the buffer of where the QCDM frame starts */
-    if (!find_qcdm_start (response, &start)) {
+    if (!find_qcdm_start (mm_serial_buffer_get_data (response),
+                          mm_serial_buffer_get_len (response),
+                          &start)) {
         /* Discard the unparsable data right away, we do need a QCDM
          * start, and anything that comes before it is unknown data
          * that we'll never use. */
@@ -91,14 +99,14 @@ parse_qcdm (GByteArray *response,
     }
 
     /* If there is anything before the start marker, remove it */
-    g_byte_array_remove_range (response, 0, start);
-    if (response->len == 0)
+    mm_serial_buffer_consume (response, start);
+    if (mm_serial_buffer_get_len (response) == 0)
         return MM_PORT_SERIAL_RESPONSE_NONE;
 
     /* Try to decapsulate the response into a buffer */
     unescaped_buffer = g_malloc (1024);
-    if (!dm_decapsulate_buffer ((const char *)(response->data),
-                                response->len,
+    if (!dm_decapsulate_buffer ((const char *) mm_serial_buffer_get_data (response),
+                                mm_serial_buffer_get_len (response),
                                 (char *)unescaped_buffer,
                                 1024,
                                 &unescaped_len,
@@ -116,7 +124,7 @@ parse_qcdm (GByteArray *response,
     }
 
     if (more) {
-        /* Need more data, we leave the original byte array untouched so that
+        /* Need more data, we leave the original buffer untouched so that
          * we can retry later when more data arrives. */
         g_free (unescaped_buffer);
         return MM_PORT_SERIAL_RESPONSE_NONE;
@@ -139,13 +147,13 @@ parse_qcdm (GByteArray *response,
     /* Remove the data we used from the input buffer, leaving out any
      * additional data that may already been received (e.g. from the following
      * message). */
-    g_byte_array_remove_range (response, 0, used);
+    mm_serial_buffer_consume (response, used);
     return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
@@ -211,16 +219,21 @@ debug_log (MMPortSerial *self,
            const gchar  *buf,
            gsize         len)
 {
-    static GString *debug = NULL;
-    const gchar    *s = buf;
+    static const gchar  hex[] = "0123456789abcdef";
+    static GString     *debug = NULL;
+    const guint8       *s = (const guint8 *) buf;
 
     if (!debug)
         debug = g_string_sized_new (512);
 
     g_string_append (debug, prefix);
 
-    while (len--)
-        g_string_append_printf (debug, " %02x", (guint8) (*s++ & 0xFF));
+    while (len--) {
+        g_string_append_c (debug, ' ');
+        g_string_append_c (debug, hex[*s >> 4]);
+        g_string_append_c (debug, hex[*s & 0x0F]);
+        s++;
+    }
 
     mm_obj_dbg (self, "%s", debug->str);
     g_string_truncate (debug, 0);
@@ -297,7 +310,7 @@ mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *self,
 }
 
 static void
-parse_unsolicited (MMPortSerial *port, GByteArray *response)
+parse_unsolicited (MMPortSerial *port, MMSerialBuffer *response)
 {
     MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
     GByteArray *log_buffer = NULL;
@@ -35,6 +35,7 @@
 
 #include "mm-port-serial.h"
 #include "mm-log-object.h"
+#include "mm-main-loop-monitor.h"
 #include "mm-helper-enums-types.h"
 
 static gboolean port_serial_queue_process          (gpointer data);
@@ -44,7 +45,10 @@ static void     port_serial_close_force            (MMPortSerial *self);
 static void     port_serial_reopen_cancel          (MMPortSerial *self);
 static void     port_serial_set_cached_reply       (MMPortSerial *self,
                                                     const GByteArray *command,
-                                                    const GByteArray *response);
+                                                    const GByteArray *response,
+                                                    guint ttl);
+static const GByteArray *port_serial_get_cached_reply (MMPortSerial *self,
+                                                       GByteArray *command);
 
 G_DEFINE_TYPE (MMPortSerial, mm_port_serial, MM_TYPE_PORT)
 
@@ -81,7 +85,7 @@ struct _MMPortSerialPrivate {
     int fd;
     GHashTable *reply_cache;
     GQueue *queue;
-    GByteArray *response;
+    MMSerialBuffer *response;
 
     /* For real ports, iochannel, and we implement the eagain limit */
     GIOChannel *iochannel;
@@ -111,6 +115,13 @@ struct _MMPortSerialPrivate {
 
     guint connected_id;
 
+    /* Queue statistics */
+    guint64 n_processed;
+    guint64 n_coalesced;
+    guint64 n_cache_hits;
+    gint64 total_wait;
+    gint64 max_wait;
+
     GTask *flash_task;
     GTask *reopen_task;
 };
@@ -125,16 +136,46 @@ typedef struct {
     GByteArray *command;
     guint32 timeout;
     gboolean allow_cached;
+    /* How long the reply may be reused, in ms, if not explicitly allowed */
+    guint reply_ttl;
     guint32 eagain_count;
+    MMPortSerialCommandPriority priority;
+    gint64 queued_time;
+    /* Requests of the same command coalesced into this one */
+    GSList *coalesced;
 
     guint32 idx;
     gboolean started;
     gboolean done;
 } CommandContext;
 
+static void
+command_context_set_result (CommandContext *ctx,
+                            GByteArray     *response,
+                            const GError   *error)
+{
+    GSList *l;
+
+    for (l = ctx->coalesced; l; l = g_slist_next (l))
+        command_context_set_result ((CommandContext *) l->data, response, error);
+
+    if (error)
+        g_simple_async_result_set_from_error (ctx->result, error);
+    else
+        g_simple_async_result_set_op_res_gpointer (ctx->result,
+                                                   g_byte_array_ref (response),
+                                                   (GDestroyNotify) g_byte_array_unref);
+}
+
 static void
 command_context_complete_and_free (CommandContext *ctx, gboolean idle)
 {
+    GSList *l;
+
+    for (l = ctx->coalesced; l; l = g_slist_next (l))
+        command_context_complete_and_free ((CommandContext *) l->data, idle);
+    g_slist_free (ctx->coalesced);
+
     if (idle)
         g_simple_async_result_complete_in_idle (ctx->result);
     else
@@ -158,15 +199,80 @@ mm_port_serial_command_finish (MMPortSerial *self,
     return g_byte_array_ref (g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (res)));
 }
 
+static void
+command_context_enqueue (MMPortSerial   *self,
+                         CommandContext *ctx,
+                         gboolean        run_next)
+{
+    GList *l;
+
+    l = self->priv->queue->head;
+
+    /* Never go before the command currently being sent */
+    if (l && ((CommandContext *) l->data)->started)
+        l = g_list_next (l);
+
+    /* If requested to run next, push right there so that it really is
+     * the next one sent. Otherwise, keep the queue sorted by priority, in
+     * FIFO order within the same priority */
+    if (!run_next) {
+        while (l && ((CommandContext *) l->data)->priority <= ctx->priority)
+            l = g_list_next (l);
+    }
+
+    if (l)
+        g_queue_insert_before (self->priv->queue, l, ctx);
+    else
+        g_queue_push_tail (self->priv->queue, ctx);
+}
+
+static gboolean
+command_context_coalesce (MMPortSerial   *self,
+                          CommandContext *ctx)
+{
+    GList *l;
+
+    /* Only polls are coalesced, other commands may have side effects and
+     * must always be sent */
+    if (ctx->priority == MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT)
+        return FALSE;
+
+    for (l = self->priv->queue->head; l; l = g_list_next (l)) {
+        CommandContext *queued = l->data;
+
+        /* The reply of a command already being sent may have been partially
+         * received, so don't wait for that one */
+        if (queued->started ||
+            queued->cancellable != ctx->cancellable ||
+            queued->command->len != ctx->command->len ||
+            memcmp (queued->command->data, ctx->command->data, ctx->command->len) != 0)
+            continue;
+
+        queued->coalesced = g_slist_append (queued->coalesced, ctx);
+        self->priv->n_coalesced++;
+
+        /* The coalesced command may need to run earlier */
+        if (ctx->priority < queued->priority) {
+            queued->priority = ctx->priority;
+            g_queue_delete_link (self->priv->queue, l);
+            command_context_enqueue (self, queued, FALSE);
+        }
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
 void
-mm_port_serial_command (MMPortSerial *self,
-                        GByteArray *command,
-                        guint32 timeout_seconds,
-                        gboolean allow_cached,
-                        gboolean run_next,
-                        GCancellable *cancellable,
-                        GAsyncReadyCallback callback,
-                        gpointer user_data)
+mm_port_serial_command_full (MMPortSerial *self,
+                             GByteArray *command,
+                             guint32 timeout_seconds,
+                             MMPortSerialCacheMode cache_mode,
+                             gboolean run_next,
+                             MMPortSerialCommandPriority priority,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data)
 {
     CommandContext *ctx;
 
@@ -181,9 +287,11 @@ mm_port_serial_command (MMPortSerial *self,
                                              user_data,
                                              mm_port_serial_command);
     ctx->command = g_byte_array_ref (command);
-    ctx->allow_cached = allow_cached;
+    ctx->allow_cached = (cache_mode == MM_PORT_SERIAL_CACHE_MODE_ANY);
     ctx->timeout = timeout_seconds;
     ctx->cancellable = (cancellable ? g_object_ref (cancellable) : NULL);
+    ctx->priority = priority;
+    ctx->queued_time = g_get_monotonic_time ();
 
     /* Only accept about 3 seconds of EAGAIN for this command */
     if (self->priv->send_delay && mm_port_get_subsys (MM_PORT (self)) == MM_PORT_SUBSYS_TTY)
@@ -200,21 +308,79 @@ mm_port_serial_command (MMPortSerial *self,
         return;
     }
 
-    /* Clear the cached value for this command if not asking for cached value */
-    if (!allow_cached)
-        port_serial_set_cached_reply (self, ctx->command, NULL);
+    if (cache_mode == MM_PORT_SERIAL_CACHE_MODE_RECENT && MM_PORT_SERIAL_GET_CLASS (self)->get_reply_ttl)
+        ctx->reply_ttl = MM_PORT_SERIAL_GET_CLASS (self)->get_reply_ttl (self, ctx->command);
 
-    /* If requested to run next, push to the head of the queue so that it really is
-     * the next one sent */
-    if (run_next)
-        g_queue_push_head (self->priv->queue, ctx);
-    else
-        g_queue_push_tail (self->priv->queue, ctx);
+    if (ctx->allow_cached || ctx->reply_ttl) {
+        const GByteArray *cached;
+
+        /* Reuse the cached reply right away, no need to wait in the queue */
+        cached = port_serial_get_cached_reply (self, ctx->command);
+        if (cached) {
+            self->priv->n_cache_hits++;
+            command_context_set_result (ctx, (GByteArray *) cached, NULL);
+            command_context_complete_and_free (ctx, TRUE);
+            return;
+        }
+    } else {
+        /* Clear the cached value for this command if not asking for cached value */
+        port_serial_set_cached_reply (self, ctx->command, NULL, 0);
+    }
+
+    /* If the same poll is already queued, just wait for its reply */
+    if (!run_next && command_context_coalesce (self, ctx))
+        return;
+
+    command_context_enqueue (self, ctx, run_next);
 
     if (g_queue_get_length (self->priv->queue) == 1)
         port_serial_schedule_queue_process (self, 0);
 }
 
+void
+mm_port_serial_command (MMPortSerial *self,
+                        GByteArray *command,
+                        guint32 timeout_seconds,
+                        gboolean allow_cached,
+                        gboolean run_next,
+                        GCancellable *cancellable,
+                        GAsyncReadyCallback callback,
+                        gpointer user_data)
+{
+    mm_port_serial_command_full (self,
+                                 command,
+                                 timeout_seconds,
+                                 allow_cached ? MM_PORT_SERIAL_CACHE_MODE_ANY : MM_PORT_SERIAL_CACHE_MODE_NONE,
+                                 run_next,
+                                 MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                 cancellable,
+                                 callback,
+                                 user_data);
+}
+
+guint
+mm_port_serial_get_queue_depth (MMPortSerial *self)
+{
+    g_return_val_if_fail (MM_IS_PORT_SERIAL (self), 0);
+
+    return g_queue_get_length (self->priv->queue);
+}
+
+void
+mm_port_serial_get_queue_stats (MMPortSerial           *self,
+                                MMPortSerialQueueStats *stats)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL (self));
+    g_return_if_fail (stats != NULL);
+
+    stats->depth = g_queue_get_length (self->priv->queue);
+    stats->n_processed = self->priv->n_processed;
+    stats->n_coalesced = self->priv->n_coalesced;
+    stats->n_cache_hits = self->priv->n_cache_hits;
+    stats->total_wait = self->priv->total_wait;
+    stats->max_wait = self->priv->max_wait;
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -532,6 +698,10 @@ serial_debug (MMPortSerial *self,
 {
     g_return_if_fail (len > 0);
 
+    /* Dumps are expensive to build, don't do it if they're not logged */
+    if (!mm_obj_dbg_enabled (self))
+        return;
+
     if (MM_PORT_SERIAL_GET_CLASS (self)->debug_log)
         MM_PORT_SERIAL_GET_CLASS (self)->debug_log (self, prefix, buf, len);
 }
@@ -591,6 +761,7 @@ port_serial_process_command (MMPortSerial *self,
 
         case G_IO_STATUS_NORMAL:
             if (written > 0) {
+                mm_port_record_traffic (MM_PORT (self), MM_PORT_TRACE_DIRECTION_OUT, p, written);
                 ctx->idx += written;
                 break;
             }
@@ -648,8 +819,10 @@ port_serial_process_command (MMPortSerial *self,
 
             /* Just keep on, will retry... */
             written = 0;
-        } else
+        } else {
             written = bytes_sent;
+            mm_port_record_traffic (MM_PORT (self), MM_PORT_TRACE_DIRECTION_OUT, p, written);
+        }
 
         ctx->idx += written;
     } else
@@ -661,31 +834,103 @@ port_serial_process_command (MMPortSerial *self,
     return TRUE;
 }
 
+typedef struct {
+    GByteArray *response;
+    /* Monotonic time after which the reply is stale, 0 if never */
+    gint64 expiry;
+} CachedReply;
+
+static void
+cached_reply_free (CachedReply *cached)
+{
+    g_byte_array_unref (cached->response);
+    g_slice_free (CachedReply, cached);
+}
+
 static void
 port_serial_set_cached_reply (MMPortSerial *self,
                               const GByteArray *command,
-                              const GByteArray *response)
+                              const GByteArray *response,
+                              guint ttl)
 {
+    CachedReply *cached;
+
     g_return_if_fail (self != NULL);
     g_return_if_fail (MM_IS_PORT_SERIAL (self));
     g_return_if_fail (command != NULL);
 
-    if (response) {
-        GByteArray *cmd_copy = g_byte_array_sized_new (command->len);
-        GByteArray *rsp_copy = g_byte_array_sized_new (response->len);
-
-        g_byte_array_append (cmd_copy, command->data, command->len);
-        g_byte_array_append (rsp_copy, response->data, response->len);
-        g_hash_table_insert (self->priv->reply_cache, cmd_copy, rsp_copy);
-    } else
+    if (!response) {
         g_hash_table_remove (self->priv->reply_cache, command);
+        return;
+    }
+
+    /* Neither commands nor parsed responses are modified once built, so
+     * the cache just keeps references to them */
+    cached = g_slice_new (CachedReply);
+    cached->response = g_byte_array_ref ((GByteArray *) response);
+    cached->expiry = ttl ? g_get_monotonic_time () + (gint64) ttl * 1000 : 0;
+    g_hash_table_insert (self->priv->reply_cache,
+                         g_byte_array_ref ((GByteArray *) command),
+                         cached);
 }
 
 static const GByteArray *
 port_serial_get_cached_reply (MMPortSerial *self,
                               GByteArray *command)
 {
-    return (const GByteArray *)g_hash_table_lookup (self->priv->reply_cache, command);
+    CachedReply *cached;
+
+    cached = g_hash_table_lookup (self->priv->reply_cache, command);
+    if (!cached)
+        return NULL;
+
+    if (cached->expiry && g_get_monotonic_time () >= cached->expiry) {
+        g_hash_table_remove (self->priv->reply_cache, command);
+        return NULL;
+    }
+
+    return cached->response;
+}
+
+void
+mm_port_serial_share_reply_cache (MMPortSerial *self,
+                                  MMPortSerial *peer)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL (self));
+    g_return_if_fail (MM_IS_PORT_SERIAL (peer));
+
+    if (self->priv->reply_cache == peer->priv->reply_cache)
+        return;
+
+    g_hash_table_unref (peer->priv->reply_cache);
+    peer->priv->reply_cache = g_hash_table_ref (self->priv->reply_cache);
+}
+
+typedef struct {
+    MMPortSerialReplyCacheFilter filter;
+    gpointer user_data;
+} InvalidateContext;
+
+static gboolean
+invalidate_cached_reply (GByteArray        *command,
+                         CachedReply       *cached,
+                         InvalidateContext *ctx)
+{
+    return !ctx->filter || ctx->filter (command, ctx->user_data);
+}
+
+void
+mm_port_serial_invalidate_cached_replies (MMPortSerial                 *self,
+                                          MMPortSerialReplyCacheFilter  filter,
+                                          gpointer                      user_data)
+{
+    InvalidateContext ctx = { filter, user_data };
+
+    g_return_if_fail (MM_IS_PORT_SERIAL (self));
+
+    g_hash_table_foreach_remove (self->priv->reply_cache,
+                                 (GHRFunc) invalidate_cached_reply,
+                                 &ctx);
 }
 
 static void
@@ -739,19 +984,17 @@ port_serial_got_response (MMPortSerial *self,
 
         ctx = (CommandContext *) g_queue_pop_head (self->priv->queue);
         if (ctx) {
-            /* Complete the command context with the appropriate result */
-            if (error)
-                g_simple_async_result_set_from_error (ctx->result, error);
-            else {
-                if (ctx->allow_cached)
-                    port_serial_set_cached_reply (self, ctx->command, parsed_response);
-                g_simple_async_result_set_op_res_gpointer (ctx->result,
-                                                           g_byte_array_ref (parsed_response),
-                                                           (GDestroyNotify) g_byte_array_unref);
-            }
-
-            /* Don't complete in idle. We need the caller remove the response range which
-             * was processed, and that must be done before processing any new queued command */
+            /* Complete the command context (and all the ones coalesced into
+             * it) with the appropriate result */
+            if (!error && (ctx->allow_cached || ctx->reply_ttl))
+                port_serial_set_cached_reply (self,
+                                              ctx->command,
+                                              parsed_response,
+                                              ctx->allow_cached ? 0 : ctx->reply_ttl);
+            command_context_set_result (ctx, parsed_response, error);
+
+            /* Don't complete in idle, the response must be processed before
+             * any new queued command */
             command_context_complete_and_free (ctx, FALSE);
         }
 
@@ -814,6 +1057,22 @@ port_serial_response_wait_cancelled (GCancellable *cancellable,
     g_error_free (error);
 }
 
+static void
+port_serial_update_queue_stats (MMPortSerial   *self,
+                                CommandContext *ctx)
+{
+    gint64 wait;
+
+    wait = g_get_monotonic_time () - ctx->queued_time;
+    self->priv->n_processed++;
+    self->priv->total_wait += wait;
+    if (wait > self->priv->max_wait)
+        self->priv->max_wait = wait;
+
+    if (wait >= G_USEC_PER_SEC)
+        mm_obj_dbg (self, "command waited %.3f seconds in queue", (gdouble) wait / G_USEC_PER_SEC);
+}
+
 static gboolean
 port_serial_queue_process (gpointer data)
 {
@@ -827,15 +1086,25 @@ port_serial_queue_process (gpointer data)
     if (!ctx)
         return G_SOURCE_REMOVE;
 
-    if (ctx->allow_cached) {
+    if (!ctx->started)
+        port_serial_update_queue_stats (self, ctx);
+
+    if (ctx->allow_cached || ctx->reply_ttl) {
         const GByteArray *cached;
 
+        /* The reply may have been cached while this command was queued */
         cached = port_serial_get_cached_reply (self, ctx->command);
         if (cached) {
             GByteArray *parsed_response;
 
-            parsed_response = g_byte_array_sized_new (cached->len);
-            g_byte_array_append (parsed_response, cached->data, cached->len);
+            self->priv->n_cache_hits++;
+
+            /* Don't store the reply again, that would extend its lifetime */
+            ctx->allow_cached = FALSE;
+            ctx->reply_ttl = 0;
+
+            /* Keep our own reference while the command is completed */
+            parsed_response = g_byte_array_ref ((GByteArray *) cached);
             /* Note: may complete last operation and unref the MMPortSerial */
             port_serial_got_response (self, parsed_response, NULL);
             g_byte_array_unref (parsed_response);
@@ -946,7 +1215,7 @@ static gboolean
 common_input_available (MMPortSerial *self,
                         GIOCondition condition)
 {
-    char buf[SERIAL_BUF_SIZE + 1];
+    gchar *buf;
     gsize bytes_read;
     GIOStatus status = G_IO_STATUS_NORMAL;
     CommandContext *ctx;
@@ -956,15 +1225,13 @@ common_input_available (MMPortSerial *self,
 
     if (condition & G_IO_HUP) {
         mm_obj_dbg (self, "unexpected port hangup!");
-        if (self->priv->response->len)
-            g_byte_array_remove_range (self->priv->response, 0, self->priv->response->len);
+        mm_serial_buffer_clear (self->priv->response);
         port_serial_close_force (self);
         return G_SOURCE_REMOVE;
     }
 
     if (condition & G_IO_ERR) {
-        if (self->priv->response->len)
-            g_byte_array_remove_range (self->priv->response, 0, self->priv->response->len);
+        mm_serial_buffer_clear (self->priv->response);
         return G_SOURCE_CONTINUE;
     }
 
@@ -976,6 +1243,9 @@ common_input_available (MMPortSerial *self,
     while (iterate) {
         bytes_read = 0;
 
+        /* Read right into the response buffer */
+        buf = (gchar *) mm_serial_buffer_reserve (self->priv->response, SERIAL_BUF_SIZE);
+
         if (self->priv->iochannel) {
             status = g_io_channel_read_chars (self->priv->iochannel,
                                               buf,
@@ -1014,14 +1284,15 @@ common_input_available (MMPortSerial *self,
             break;
 
         g_assert (bytes_read > 0);
+        mm_port_record_traffic (MM_PORT (self), MM_PORT_TRACE_DIRECTION_IN, buf, bytes_read);
         serial_debug (self, "<--", buf, bytes_read);
-        g_byte_array_append (self->priv->response, (const guint8 *) buf, bytes_read);
+        mm_serial_buffer_commit (self->priv->response, bytes_read);
 
         /* Make sure the response doesn't grow too long */
-        if ((self->priv->response->len > SERIAL_BUF_SIZE) && self->priv->spew_control) {
+        if ((mm_serial_buffer_get_len (self->priv->response) > SERIAL_BUF_SIZE) && self->priv->spew_control) {
             /* Notify listeners and then trim the buffer */
             g_signal_emit (self, signals[BUFFER_FULL], 0, self->priv->response);
-            g_byte_array_remove_range (self->priv->response, 0, (SERIAL_BUF_SIZE / 2));
+            mm_serial_buffer_consume (self->priv->response, (SERIAL_BUF_SIZE / 2));
         }
 
         /* See if we can parse anything. The response parsing may actually
@@ -1050,12 +1321,29 @@ common_input_available (MMPortSerial *self,
     return keep_source;
 }
 
+static gboolean
+monitored_input_available (MMPortSerial *self,
+                           GIOCondition condition)
+{
+    MMMainLoopDispatch dispatch;
+    gboolean           keep_source;
+
+    /* The port may be disposed while parsing, keep it around until the
+     * dispatch is recorded */
+    g_object_ref (self);
+    mm_main_loop_monitor_dispatch_begin (&dispatch, 0);
+    keep_source = common_input_available (self, condition);
+    mm_main_loop_monitor_dispatch_end (&dispatch, MM_MAIN_LOOP_HANDLER_SERIAL_READ, mm_log_object_get_id (MM_LOG_OBJECT (self)));
+    g_object_unref (self);
+    return keep_source;
+}
+
 static gboolean
 iochannel_input_available (GIOChannel *iochannel,
                            GIOCondition condition,
                            gpointer data)
 {
-    return common_input_available (MM_PORT_SERIAL (data), condition);
+    return monitored_input_available (MM_PORT_SERIAL (data), condition);
 }
 
 static gboolean
@@ -1063,7 +1351,7 @@ socket_input_available (GSocket *socket,
                         GIOCondition condition,
                         gpointer data)
 {
-    return common_input_available (MM_PORT_SERIAL (data), condition);
+    return monitored_input_available (MM_PORT_SERIAL (data), condition);
 }
 
 static void
@@ -1349,6 +1637,7 @@ static void
 _close_internal (MMPortSerial *self, gboolean force)
 {
     guint i;
+    GError *closed_error;
 
     g_return_if_fail (MM_IS_PORT_SERIAL (self));
 
@@ -1439,17 +1728,18 @@ _close_internal (MMPortSerial *self, gboolean force)
     }
 
     /* Clear the command queue */
+    closed_error = g_error_new_literal (MM_SERIAL_ERROR,
+                                        MM_SERIAL_ERROR_SEND_FAILED,
+                                        "Serial port is now closed");
     for (i = 0; i < g_queue_get_length (self->priv->queue); i++) {
         CommandContext *ctx;
 
         ctx = g_queue_peek_nth (self->priv->queue, i);
-        g_simple_async_result_set_error (ctx->result,
-                                         MM_SERIAL_ERROR,
-                                         MM_SERIAL_ERROR_SEND_FAILED,
-                                         "Serial port is now closed");
+        command_context_set_result (ctx, NULL, closed_error);
         command_context_complete_and_free (ctx, TRUE);
     }
     g_queue_clear (self->priv->queue);
+    g_error_free (closed_error);
 
     if (self->priv->timeout_id) {
         g_source_remove (self->priv->timeout_id);
@@ -1500,6 +1790,8 @@ port_serial_close_force (MMPortSerial *self)
 
     /* If already closed, done */
     if (self->priv->open_count > 0) {
+        /* Whatever the modem replied before is no longer reliable */
+        mm_port_serial_invalidate_cached_replies (self, NULL, NULL);
         _close_internal (self, TRUE);
 
         /* Notify about the forced close status */
@@ -1628,6 +1920,9 @@ mm_port_serial_reopen (MMPortSerial *self,
 
     mm_obj_dbg (self, "reopening port (%u)", ctx->initial_open_count);
 
+    /* The modem may have been reset meanwhile */
+    mm_port_serial_invalidate_cached_replies (self, NULL, NULL);
+
     for (i = 0; i < ctx->initial_open_count; i++)
         mm_port_serial_close (self);
 
@@ -1912,20 +2207,12 @@ ba_equal (gconstpointer v1, gconstpointer v2)
     const GByteArray *a = v1;
     const GByteArray *b = v2;
 
-    if (!a && b)
-        return -1;
-    else if (a && !b)
-        return 1;
-    else if (!a && !b)
-        return 0;
+    if (!a || !b)
+        return a == b;
 
-    g_assert (a && b);
-    if (a->len < b->len)
-        return -1;
-    else if (a->len > b->len)
-        return 1;
+    if (a->len != b->len)
+        return FALSE;
 
-    g_assert (a->len == b->len);
     return !memcmp (a->data, b->data, a->len);
 }
 
@@ -1953,7 +2240,7 @@ mm_port_serial_init (MMPortSerial *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_SERIAL, MMPortSerialPrivate);
 
-    self->priv->reply_cache = g_hash_table_new_full (ba_hash, ba_equal, ba_free, ba_free);
+    self->priv->reply_cache = g_hash_table_new_full (ba_hash, ba_equal, ba_free, (GDestroyNotify) cached_reply_free);
 
     self->priv->fd = -1;
     self->priv->baud = 57600;
@@ -1964,7 +2251,7 @@ mm_port_serial_init (MMPortSerial *self)
     self->priv->send_delay = 1000;
 
     self->priv->queue = g_queue_new ();
-    self->priv->response = g_byte_array_sized_new (500);
+    self->priv->response = mm_serial_buffer_new (4 * SERIAL_BUF_SIZE);
 }
 
 static void
@@ -2071,8 +2358,9 @@ finalize (GObject *object)
     if (self->priv->queue_id)
         g_source_remove (self->priv->queue_id);
 
-    g_hash_table_destroy (self->priv->reply_cache);
-    g_byte_array_unref (self->priv->response);
+    /* The cache may be shared with other ports */
+    g_hash_table_unref (self->priv->reply_cache);
+    mm_serial_buffer_free (self->priv->response);
     g_queue_free (self->priv->queue);
 
     G_OBJECT_CLASS (mm_port_serial_parent_class)->finalize (object);
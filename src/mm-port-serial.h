@@ -23,6 +23,7 @@
 
 #include "mm-modem-helpers.h"
 #include "mm-port.h"
+#include "mm-serial-buffer.h"
 
 #define MM_TYPE_PORT_SERIAL            (mm_port_serial_get_type ())
 #define MM_PORT_SERIAL(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PORT_SERIAL, MMPortSerial))
@@ -61,9 +62,9 @@ struct _MMPortSerialClass {
 
     /* Called for subclasses to parse unsolicited responses.  If any recognized
      * unsolicited response is found, it should be removed from the 'response'
-     * byte array before returning.
+     * buffer before returning.
      */
-    void     (*parse_unsolicited) (MMPortSerial *self, GByteArray *response);
+    void     (*parse_unsolicited) (MMPortSerial *self, MMSerialBuffer *response);
 
     /*
      * Called to parse the device's response to a command or determine if the
@@ -78,11 +79,11 @@ struct _MMPortSerialClass {
      * If there is no response, @MM_PORT_SERIAL_RESPONSE_NONE will be returned,
      * and neither @error nor @parsed_response will be set.
      *
-     * The implementation is allowed to cleanup the @response byte array, e.g. to
-     * just remove 1 single response if more than one found.
+     * The implementation is allowed to cleanup the @response buffer, e.g. to
+     * just consume 1 single response if more than one found.
      */
     MMPortSerialResponseType (*parse_response) (MMPortSerial *self,
-                                                GByteArray *response,
+                                                MMSerialBuffer *response,
                                                 GByteArray **parsed_response,
                                                 GError **error);
 
@@ -100,8 +101,15 @@ struct _MMPortSerialClass {
                                    const gchar  *buf,
                                    gsize         len);
 
+    /* Called to get for how long (in milliseconds) the reply to a command
+     * may be reused by later requests of the same command made with
+     * MM_PORT_SERIAL_CACHE_MODE_RECENT. Returns 0 if the reply should not be
+     * reused that way. */
+    guint (*get_reply_ttl)        (MMPortSerial     *self,
+                                   const GByteArray *command);
+
     /* Signals */
-    void (*buffer_full)           (MMPortSerial *port, const GByteArray *buffer);
+    void (*buffer_full)           (MMPortSerial *port, MMSerialBuffer *buffer);
     void (*timed_out)             (MMPortSerial *port, guint n_consecutive_replies);
     void (*forced_close)          (MMPortSerial *port);
 };
@@ -153,6 +161,71 @@ GByteArray *mm_port_serial_command_finish (MMPortSerial *self,
                                            GAsyncResult *res,
                                            GError **error);
 
+/* Commands are sent in priority order, and in FIFO order within the same
+ * priority. Identical commands with a priority other than the default one
+ * are coalesced while queued, and all requesters get the same reply. */
+typedef enum {
+    /* Commands requested by the user, or with side effects */
+    MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT    = 0,
+    /* Periodic state polling */
+    MM_PORT_SERIAL_COMMAND_PRIORITY_POLLING    = 1,
+    /* Background housekeeping */
+    MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND = 2,
+} MMPortSerialCommandPriority;
+
+/* Whether a command may be completed with a reply cached earlier. The first
+ * two values match the allow_cached flag of mm_port_serial_command(). */
+typedef enum {
+    /* Always ask the modem, and drop the cached reply, if any */
+    MM_PORT_SERIAL_CACHE_MODE_NONE   = 0,
+    /* Reuse the cached reply, however old it is */
+    MM_PORT_SERIAL_CACHE_MODE_ANY    = 1,
+    /* Reuse the reply if received within the lifetime the port gives to
+     * the command (see get_reply_ttl()); otherwise ask the modem */
+    MM_PORT_SERIAL_CACHE_MODE_RECENT = 2,
+} MMPortSerialCacheMode;
+
+void        mm_port_serial_command_full   (MMPortSerial *self,
+                                           GByteArray *command,
+                                           guint32 timeout_seconds,
+                                           MMPortSerialCacheMode cache_mode,
+                                           gboolean run_next,
+                                           MMPortSerialCommandPriority priority,
+                                           GCancellable *cancellable,
+                                           GAsyncReadyCallback callback,
+                                           gpointer user_data);
+
+typedef struct {
+    /* Commands queued, including the one being sent */
+    guint   depth;
+    /* Commands taken from the queue so far */
+    guint64 n_processed;
+    /* Commands coalesced with an already queued one */
+    guint64 n_coalesced;
+    /* Commands completed with a cached reply */
+    guint64 n_cache_hits;
+    /* Time spent by commands in the queue, in microseconds */
+    gint64  total_wait;
+    gint64  max_wait;
+} MMPortSerialQueueStats;
+
+guint       mm_port_serial_get_queue_depth (MMPortSerial *self);
+void        mm_port_serial_get_queue_stats (MMPortSerial           *self,
+                                            MMPortSerialQueueStats *stats);
+
+/* Replies are cached per port unless shared; e.g. all the AT ports of a
+ * modem should share them, as they talk to the same device. */
+void        mm_port_serial_share_reply_cache (MMPortSerial *self,
+                                              MMPortSerial *peer);
+
+/* Removes the cached replies to the commands for which @filter returns TRUE,
+ * or all of them if no @filter given */
+typedef gboolean (* MMPortSerialReplyCacheFilter) (const GByteArray *command,
+                                                   gpointer          user_data);
+void        mm_port_serial_invalidate_cached_replies (MMPortSerial                 *self,
+                                                      MMPortSerialReplyCacheFilter  filter,
+                                                      gpointer                      user_data);
+
 gboolean mm_port_serial_set_flow_control (MMPortSerial   *self,
                                           MMFlowControl   flow_control,
                                           GError        **error);
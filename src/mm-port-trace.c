@@ -0,0 +1,336 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-log.h"
+#include "mm-port-trace.h"
+
+/*****************************************************************************/
+/* Writer */
+
+/* Records are buffered, and written to disk once the buffer is full or after
+ * some time, so that capturing doesn't cost one write() per port read */
+#define PORT_TRACE_BUFFER_SIZE    (64 * 1024)
+#define PORT_TRACE_FLUSH_TIMEOUT  1
+
+typedef struct {
+    FILE       *file;
+    gchar      *buffer;
+    guint       flush_id;
+    /* port type and name -> channel */
+    GHashTable *channels;
+    guint       last_channel;
+} PortTrace;
+
+static PortTrace *port_trace;
+
+static void
+write_record_header (guint8                *header,
+                     guint64                timestamp,
+                     guint                  channel,
+                     MMPortTraceRecordType  type,
+                     MMPortTraceDirection   direction,
+                     gsize                  len)
+{
+    guint64 timestamp_le;
+    guint16 channel_le;
+    guint32 len_le;
+
+    timestamp_le = GUINT64_TO_LE (timestamp);
+    channel_le = GUINT16_TO_LE ((guint16) channel);
+    len_le = GUINT32_TO_LE ((guint32) len);
+
+    memcpy (&header[0], &timestamp_le, 8);
+    memcpy (&header[8], &channel_le, 2);
+    header[10] = (guint8) type;
+    header[11] = (guint8) direction;
+    memcpy (&header[12], &len_le, 4);
+}
+
+static gboolean
+port_trace_flush_cb (gpointer user_data)
+{
+    port_trace->flush_id = 0;
+    if (fflush (port_trace->file) != 0) {
+        mm_obj_warn (NULL, "couldn't write to capture file, disabling capture: %s", g_strerror (errno));
+        mm_port_trace_close ();
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void
+port_trace_write (guint                  channel,
+                  MMPortTraceRecordType  type,
+                  MMPortTraceDirection   direction,
+                  gconstpointer          data,
+                  gsize                  len)
+{
+    guint8 header[MM_PORT_TRACE_RECORD_SIZE];
+
+    write_record_header (header, (guint64) g_get_real_time (), channel, type, direction, len);
+
+    if (fwrite (header, sizeof (header), 1, port_trace->file) != 1 ||
+        (len > 0 && fwrite (data, len, 1, port_trace->file) != 1)) {
+        mm_obj_warn (NULL, "couldn't write to capture file, disabling capture: %s", g_strerror (errno));
+        mm_port_trace_close ();
+        return;
+    }
+
+    if (!port_trace->flush_id)
+        port_trace->flush_id = g_timeout_add_seconds (PORT_TRACE_FLUSH_TIMEOUT, port_trace_flush_cb, NULL);
+}
+
+gboolean
+mm_port_trace_open (const gchar  *path,
+                    GError      **error)
+{
+    FILE    *file;
+    gchar   *buffer;
+    guint8   header[MM_PORT_TRACE_HEADER_SIZE] = { 0 };
+    guint16  value_le;
+
+    g_assert (!port_trace);
+
+    file = fopen (path, "wb");
+    if (!file) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't open capture file: %s", g_strerror (errno));
+        return FALSE;
+    }
+
+    /* Must be set before any I/O on the stream */
+    buffer = g_malloc (PORT_TRACE_BUFFER_SIZE);
+    setvbuf (file, buffer, _IOFBF, PORT_TRACE_BUFFER_SIZE);
+
+    memcpy (&header[0], MM_PORT_TRACE_MAGIC, strlen (MM_PORT_TRACE_MAGIC));
+    value_le = GUINT16_TO_LE (MM_PORT_TRACE_VERSION);
+    memcpy (&header[8], &value_le, 2);
+    value_le = GUINT16_TO_LE (MM_PORT_TRACE_HEADER_SIZE);
+    memcpy (&header[10], &value_le, 2);
+
+    if (fwrite (header, sizeof (header), 1, file) != 1 || fflush (file) != 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't write capture file header: %s", g_strerror (errno));
+        fclose (file);
+        g_free (buffer);
+        return FALSE;
+    }
+
+    port_trace = g_slice_new0 (PortTrace);
+    port_trace->file = file;
+    port_trace->buffer = buffer;
+    port_trace->channels = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    return TRUE;
+}
+
+void
+mm_port_trace_close (void)
+{
+    if (!port_trace)
+        return;
+
+    if (port_trace->flush_id)
+        g_source_remove (port_trace->flush_id);
+    /* Flushes whatever is still buffered */
+    if (fclose (port_trace->file) != 0)
+        mm_obj_warn (NULL, "couldn't write to capture file: %s", g_strerror (errno));
+    g_free (port_trace->buffer);
+    g_hash_table_unref (port_trace->channels);
+    g_slice_free (PortTrace, port_trace);
+    port_trace = NULL;
+}
+
+gboolean
+mm_port_trace_is_enabled (void)
+{
+    return !!port_trace;
+}
+
+guint
+mm_port_trace_get_channel (const gchar *name,
+                           guint        port_type)
+{
+    g_autoptr(GByteArray)  payload = NULL;
+    gchar                 *key;
+    guint                  channel;
+    guint8                 port_type_byte;
+
+    if (!port_trace)
+        return 0;
+
+    key = g_strdup_printf ("%u:%s", port_type, name);
+    channel = GPOINTER_TO_UINT (g_hash_table_lookup (port_trace->channels, key));
+    if (channel) {
+        g_free (key);
+        return channel;
+    }
+
+    if (port_trace->last_channel == G_MAXUINT16) {
+        mm_obj_warn (NULL, "too many channels in capture file, not capturing port %s", name);
+        g_free (key);
+        return 0;
+    }
+
+    channel = ++port_trace->last_channel;
+    g_hash_table_insert (port_trace->channels, key, GUINT_TO_POINTER (channel));
+
+    port_type_byte = (guint8) port_type;
+    payload = g_byte_array_sized_new (1 + strlen (name));
+    g_byte_array_append (payload, &port_type_byte, 1);
+    g_byte_array_append (payload, (const guint8 *) name, strlen (name));
+    port_trace_write (channel, MM_PORT_TRACE_RECORD_TYPE_CHANNEL, MM_PORT_TRACE_DIRECTION_NONE, payload->data, payload->len);
+
+    /* The write may have failed and disabled capture */
+    return port_trace ? channel : 0;
+}
+
+void
+mm_port_trace_record (guint                 channel,
+                      MMPortTraceDirection  direction,
+                      gconstpointer         data,
+                      gsize                 len)
+{
+    if (!port_trace || !channel || !len)
+        return;
+
+    port_trace_write (channel, MM_PORT_TRACE_RECORD_TYPE_DATA, direction, data, len);
+}
+
+/*****************************************************************************/
+/* Reader */
+
+struct _MMPortTraceReader {
+    GMappedFile  *mapped_file;
+    const guint8 *contents;
+    gsize         len;
+    gsize         offset;
+};
+
+MMPortTraceReader *
+mm_port_trace_reader_new (const gchar  *path,
+                          GError      **error)
+{
+    MMPortTraceReader *self;
+    GMappedFile       *mapped_file;
+    const guint8      *contents;
+    gsize              len;
+    guint16            version;
+    guint16            header_size;
+
+    mapped_file = g_mapped_file_new (path, FALSE, error);
+    if (!mapped_file)
+        return NULL;
+
+    contents = (const guint8 *) g_mapped_file_get_contents (mapped_file);
+    len = g_mapped_file_get_length (mapped_file);
+
+    if (len < MM_PORT_TRACE_HEADER_SIZE || memcmp (contents, MM_PORT_TRACE_MAGIC, strlen (MM_PORT_TRACE_MAGIC) + 1) != 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Not a capture file");
+        g_mapped_file_unref (mapped_file);
+        return NULL;
+    }
+
+    memcpy (&version, &contents[8], 2);
+    memcpy (&header_size, &contents[10], 2);
+    version = GUINT16_FROM_LE (version);
+    header_size = GUINT16_FROM_LE (header_size);
+    if (version != MM_PORT_TRACE_VERSION || header_size < MM_PORT_TRACE_HEADER_SIZE || header_size > len) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
+                     "Unsupported capture file version: %u", version);
+        g_mapped_file_unref (mapped_file);
+        return NULL;
+    }
+
+    self = g_slice_new0 (MMPortTraceReader);
+    self->mapped_file = mapped_file;
+    self->contents = contents;
+    self->len = len;
+    self->offset = header_size;
+    return self;
+}
+
+void
+mm_port_trace_reader_free (MMPortTraceReader *self)
+{
+    g_mapped_file_unref (self->mapped_file);
+    g_slice_free (MMPortTraceReader, self);
+}
+
+gboolean
+mm_port_trace_reader_next (MMPortTraceReader  *self,
+                           MMPortTraceRecord  *record,
+                           GError            **error)
+{
+    const guint8 *header;
+    guint64       timestamp;
+    guint16       channel;
+    guint32       len;
+
+    if (self->offset == self->len)
+        return FALSE;
+
+    /* A capture may be truncated if the daemon was killed while writing */
+    if (self->len - self->offset < MM_PORT_TRACE_RECORD_SIZE) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Truncated record header at offset %" G_GSIZE_FORMAT, self->offset);
+        return FALSE;
+    }
+
+    header = &self->contents[self->offset];
+    memcpy (&timestamp, &header[0], 8);
+    memcpy (&channel, &header[8], 2);
+    memcpy (&len, &header[12], 4);
+    len = GUINT32_FROM_LE (len);
+
+    if (self->len - self->offset - MM_PORT_TRACE_RECORD_SIZE < len) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Truncated record payload at offset %" G_GSIZE_FORMAT, self->offset);
+        return FALSE;
+    }
+
+    record->timestamp = GUINT64_FROM_LE (timestamp);
+    record->channel = GUINT16_FROM_LE (channel);
+    record->type = (MMPortTraceRecordType) header[10];
+    record->direction = (MMPortTraceDirection) header[11];
+    record->data = &header[MM_PORT_TRACE_RECORD_SIZE];
+    record->len = len;
+
+    self->offset += MM_PORT_TRACE_RECORD_SIZE + len;
+    return TRUE;
+}
+
+guint
+mm_port_trace_record_get_port_type (const MMPortTraceRecord *record)
+{
+    g_assert (record->type == MM_PORT_TRACE_RECORD_TYPE_CHANNEL);
+
+    return record->len > 0 ? record->data[0] : 0;
+}
+
+gchar *
+mm_port_trace_record_get_name (const MMPortTraceRecord *record)
+{
+    g_assert (record->type == MM_PORT_TRACE_RECORD_TYPE_CHANNEL);
+
+    return record->len > 1 ? g_strndup ((const gchar *) &record->data[1], record->len - 1) : g_strdup ("");
+}
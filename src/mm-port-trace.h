@@ -0,0 +1,104 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_PORT_TRACE_H
+#define MM_PORT_TRACE_H
+
+#include <glib.h>
+
+/*
+ * Capture of the raw traffic exchanged with the modem control ports.
+ *
+ * The capture file starts with a 16 byte header:
+ *
+ *   magic "MMTRACE\0" (8 bytes), version (guint16), header size (guint16),
+ *   reserved (guint32)
+ *
+ * followed by records, each with a 16 byte header and the payload:
+ *
+ *   timestamp in microseconds since the epoch (guint64), channel (guint16),
+ *   record type (guint8), direction (guint8), payload length (guint32)
+ *
+ * All integers are little endian. Each port gets its own channel, defined
+ * by a CHANNEL record (payload: port type as guint8, then the port name)
+ * before any DATA record (payload: the raw bytes) in that channel.
+ */
+
+#define MM_PORT_TRACE_MAGIC       "MMTRACE"
+#define MM_PORT_TRACE_VERSION     1
+#define MM_PORT_TRACE_HEADER_SIZE 16
+#define MM_PORT_TRACE_RECORD_SIZE 16
+
+typedef enum {
+    MM_PORT_TRACE_RECORD_TYPE_CHANNEL = 0,
+    MM_PORT_TRACE_RECORD_TYPE_DATA    = 1,
+} MMPortTraceRecordType;
+
+typedef enum {
+    MM_PORT_TRACE_DIRECTION_NONE = 0,
+    /* From the host to the modem */
+    MM_PORT_TRACE_DIRECTION_OUT  = 1,
+    /* From the modem to the host */
+    MM_PORT_TRACE_DIRECTION_IN   = 2,
+} MMPortTraceDirection;
+
+/*****************************************************************************/
+/* Writer, process-wide */
+
+gboolean mm_port_trace_open       (const gchar  *path,
+                                   GError      **error);
+void     mm_port_trace_close      (void);
+gboolean mm_port_trace_is_enabled (void);
+
+/* Returns the channel of the port with the given name and type, defining it
+ * in the capture if not done already. Returns 0 if capture is disabled. */
+guint    mm_port_trace_get_channel (const gchar          *name,
+                                    guint                 port_type);
+void     mm_port_trace_record      (guint                 channel,
+                                    MMPortTraceDirection  direction,
+                                    gconstpointer         data,
+                                    gsize                 len);
+
+/*****************************************************************************/
+/* Reader */
+
+typedef struct _MMPortTraceReader MMPortTraceReader;
+
+typedef struct {
+    guint64                timestamp;
+    guint                  channel;
+    MMPortTraceRecordType  type;
+    MMPortTraceDirection   direction;
+    /* Valid as long as the reader */
+    const guint8          *data;
+    gsize                  len;
+} MMPortTraceRecord;
+
+MMPortTraceReader *mm_port_trace_reader_new  (const gchar        *path,
+                                              GError            **error);
+void               mm_port_trace_reader_free (MMPortTraceReader  *self);
+
+/* Returns FALSE with no error set once all records have been read */
+gboolean           mm_port_trace_reader_next (MMPortTraceReader  *self,
+                                              MMPortTraceRecord  *record,
+                                              GError            **error);
+
+/* Helpers to parse the payload of CHANNEL records */
+guint              mm_port_trace_record_get_port_type (const MMPortTraceRecord *record);
+gchar             *mm_port_trace_record_get_name      (const MMPortTraceRecord *record);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMPortTraceReader, mm_port_trace_reader_free)
+
+#endif /* MM_PORT_TRACE_H */
@@ -43,6 +43,8 @@ struct _MMPortPrivate {
     MMPortType ptype;
     gboolean connected;
     MMKernelDevice *kernel_device;
+    guint trace_channel;
+    gboolean trace_failed;
 };
 
 /*****************************************************************************/
@@ -104,6 +106,28 @@ mm_port_peek_kernel_device (MMPort *self)
     return self->priv->kernel_device;
 }
 
+void
+mm_port_record_traffic (MMPort               *self,
+                        MMPortTraceDirection  direction,
+                        gconstpointer         data,
+                        gsize                 len)
+{
+    if (self->priv->trace_failed || !mm_port_trace_is_enabled ())
+        return;
+
+    /* Capture is enabled once for the whole lifetime of the process, so the
+     * channel never changes; and if it couldn't be defined, don't retry on
+     * every read or write */
+    if (!self->priv->trace_channel) {
+        self->priv->trace_channel = mm_port_trace_get_channel (self->priv->device, self->priv->ptype);
+        if (!self->priv->trace_channel) {
+            self->priv->trace_failed = TRUE;
+            return;
+        }
+    }
+    mm_port_trace_record (self->priv->trace_channel, direction, data, len);
+}
+
 /*****************************************************************************/
 
 static gchar *
@@ -21,6 +21,7 @@
 #include <glib-object.h>
 
 #include "mm-kernel-device.h"
+#include "mm-port-trace.h"
 
 typedef enum { /*< underscore_name=mm_port_subsys >*/
     MM_PORT_SUBSYS_UNKNOWN = 0x0,
@@ -83,4 +84,10 @@ gboolean        mm_port_get_connected      (MMPort *self);
 void            mm_port_set_connected      (MMPort *self, gboolean connected);
 MMKernelDevice *mm_port_peek_kernel_device (MMPort *self);
 
+/* Raw traffic capture, if enabled with --capture-file */
+void            mm_port_record_traffic     (MMPort               *self,
+                                            MMPortTraceDirection  direction,
+                                            gconstpointer         data,
+                                            gsize                 len);
+
 #endif /* MM_PORT_H */
@@ -0,0 +1,181 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <string.h>
+
+#include "mm-log.h"
+#include "mm-regex-cache.h"
+
+typedef struct {
+    /* The key, owned by the entry */
+    gchar              *key;
+    GRegex             *regex;
+    MMRegexCacheStats   stats;
+} CacheEntry;
+
+static GMutex      cache_mutex;
+/* key -> CacheEntry */
+static GHashTable *cache_by_key;
+/* GRegex -> CacheEntry */
+static GHashTable *cache_by_regex;
+
+/* The same pattern may be used with different options */
+static gchar *
+build_key (const gchar        *pattern,
+           GRegexCompileFlags  compile_options,
+           GRegexMatchFlags    match_options)
+{
+    return g_strdup_printf ("%x:%x:%s", compile_options, match_options, pattern);
+}
+
+GRegex *
+mm_regex_cache_get (const gchar         *pattern,
+                    GRegexCompileFlags   compile_options,
+                    GRegexMatchFlags     match_options,
+                    GError             **error)
+{
+    g_autofree gchar *key = NULL;
+    CacheEntry       *entry;
+    GRegex           *regex;
+
+    g_return_val_if_fail (pattern != NULL, NULL);
+
+    key = build_key (pattern, compile_options, match_options);
+
+    g_mutex_lock (&cache_mutex);
+
+    if (G_UNLIKELY (!cache_by_key)) {
+        cache_by_key = g_hash_table_new (g_str_hash, g_str_equal);
+        cache_by_regex = g_hash_table_new (g_direct_hash, g_direct_equal);
+    }
+
+    entry = g_hash_table_lookup (cache_by_key, key);
+    if (!entry) {
+        regex = g_regex_new (pattern, compile_options, match_options, error);
+        if (!regex) {
+            g_mutex_unlock (&cache_mutex);
+            return NULL;
+        }
+
+        entry = g_slice_new0 (CacheEntry);
+        entry->key = g_steal_pointer (&key);
+        entry->regex = regex;
+        entry->stats.pattern = g_regex_get_pattern (regex);
+        entry->stats.compile_options = compile_options;
+        entry->stats.n_compiles++;
+        g_hash_table_insert (cache_by_key, entry->key, entry);
+        g_hash_table_insert (cache_by_regex, regex, entry);
+    }
+    entry->stats.n_lookups++;
+    regex = g_regex_ref (entry->regex);
+
+    g_mutex_unlock (&cache_mutex);
+
+    return regex;
+}
+
+/*****************************************************************************/
+
+static void
+account_match (const GRegex *regex,
+               gint64        start_time)
+{
+    gint64      elapsed;
+    CacheEntry *entry;
+
+    elapsed = g_get_monotonic_time () - start_time;
+
+    g_mutex_lock (&cache_mutex);
+    entry = cache_by_regex ? g_hash_table_lookup (cache_by_regex, regex) : NULL;
+    if (entry) {
+        entry->stats.n_matches++;
+        entry->stats.match_time_us += elapsed;
+    }
+    g_mutex_unlock (&cache_mutex);
+}
+
+gboolean
+mm_regex_match (const GRegex      *regex,
+                const gchar       *string,
+                GRegexMatchFlags   match_options,
+                GMatchInfo       **match_info)
+{
+    return mm_regex_match_full (regex, string, -1, 0, match_options, match_info, NULL);
+}
+
+gboolean
+mm_regex_match_full (const GRegex      *regex,
+                     const gchar       *string,
+                     gssize             string_len,
+                     gint               start_position,
+                     GRegexMatchFlags   match_options,
+                     GMatchInfo       **match_info,
+                     GError           **error)
+{
+    gint64   start_time;
+    gboolean matched;
+
+    /* Matching is in the hot path, only account it when debugging */
+    if (!mm_obj_dbg_enabled (NULL))
+        return g_regex_match_full (regex, string, string_len, start_position, match_options, match_info, error);
+
+    start_time = g_get_monotonic_time ();
+    matched = g_regex_match_full (regex, string, string_len, start_position, match_options, match_info, error);
+    account_match (regex, start_time);
+    return matched;
+}
+
+gboolean
+mm_match_info_next (GMatchInfo  *match_info,
+                    GError     **error)
+{
+    gint64   start_time;
+    gboolean matched;
+
+    if (!mm_obj_dbg_enabled (NULL))
+        return g_match_info_next (match_info, error);
+
+    start_time = g_get_monotonic_time ();
+    matched = g_match_info_next (match_info, error);
+    account_match (g_match_info_get_regex (match_info), start_time);
+    return matched;
+}
+
+/*****************************************************************************/
+
+void
+mm_regex_cache_foreach_stats (MMRegexCacheStatsFunc func,
+                              gpointer              user_data)
+{
+    g_autoptr(GArray) stats = NULL;
+    GHashTableIter    iter;
+    CacheEntry       *entry;
+    guint             i;
+
+    stats = g_array_new (FALSE, FALSE, sizeof (MMRegexCacheStats));
+
+    /* Patterns are never released, so they can be used without the lock */
+    g_mutex_lock (&cache_mutex);
+    if (cache_by_key) {
+        g_hash_table_iter_init (&iter, cache_by_key);
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&entry))
+            g_array_append_val (stats, entry->stats);
+    }
+    g_mutex_unlock (&cache_mutex);
+
+    for (i = 0; i < stats->len; i++)
+        func (&g_array_index (stats, MMRegexCacheStats, i), user_data);
+}
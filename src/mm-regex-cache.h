@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_REGEX_CACHE_H
+#define MM_REGEX_CACHE_H
+
+#include <glib.h>
+
+/*
+ * Process-wide cache of compiled regular expressions.
+ *
+ * The patterns used to parse responses and unsolicited messages are fixed,
+ * so instead of compiling them (and running the JIT with G_REGEX_OPTIMIZE)
+ * for every single response, each pattern is compiled once and kept for
+ * the whole lifetime of the process. Only fixed patterns should be given,
+ * as cached entries are never released.
+ *
+ * The returned GRegex is a new reference, so this method is a drop-in
+ * replacement of g_regex_new(). It is safe to use from any thread.
+ */
+GRegex *mm_regex_cache_get (const gchar         *pattern,
+                            GRegexCompileFlags   compile_options,
+                            GRegexMatchFlags     match_options,
+                            GError             **error);
+
+/* Same as the GRegex methods, but also accounting the time spent matching
+ * when the regex comes from the cache and debug logging is enabled */
+gboolean mm_regex_match      (const GRegex      *regex,
+                              const gchar       *string,
+                              GRegexMatchFlags   match_options,
+                              GMatchInfo       **match_info);
+gboolean mm_regex_match_full (const GRegex      *regex,
+                              const gchar       *string,
+                              gssize             string_len,
+                              gint               start_position,
+                              GRegexMatchFlags   match_options,
+                              GMatchInfo       **match_info,
+                              GError           **error);
+gboolean mm_match_info_next  (GMatchInfo        *match_info,
+                              GError           **error);
+
+typedef struct {
+    const gchar        *pattern;
+    GRegexCompileFlags  compile_options;
+    /* Number of times the pattern was compiled and requested */
+    guint               n_compiles;
+    guint               n_lookups;
+    /* Number of match operations and total time spent in them, only
+     * accounted while debug logging is enabled */
+    guint               n_matches;
+    guint64             match_time_us;
+} MMRegexCacheStats;
+
+typedef void (* MMRegexCacheStatsFunc) (const MMRegexCacheStats *stats,
+                                        gpointer                 user_data);
+
+void mm_regex_cache_foreach_stats (MMRegexCacheStatsFunc func,
+                                   gpointer              user_data);
+
+#endif /* MM_REGEX_CACHE_H */
@@ -0,0 +1,170 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <string.h>
+
+#include "mm-serial-buffer.h"
+
+struct _MMSerialBuffer {
+    guint8 *storage;
+    gsize   capacity;
+    /* Read cursor */
+    gsize   start;
+    gsize   len;
+    /* Changed whenever existing contents are modified */
+    guint   generation;
+};
+
+static gsize
+nearest_pow2 (gsize value)
+{
+    gsize pow2 = 1;
+
+    while (pow2 < value)
+        pow2 <<= 1;
+    return pow2;
+}
+
+MMSerialBuffer *
+mm_serial_buffer_new (gsize capacity)
+{
+    MMSerialBuffer *self;
+
+    self = g_slice_new0 (MMSerialBuffer);
+    self->capacity = nearest_pow2 (MAX (capacity, 16));
+    self->storage = g_malloc (self->capacity);
+    self->generation = 1;
+    return self;
+}
+
+void
+mm_serial_buffer_free (MMSerialBuffer *self)
+{
+    g_free (self->storage);
+    g_slice_free (MMSerialBuffer, self);
+}
+
+guint8 *
+mm_serial_buffer_get_data (MMSerialBuffer *self)
+{
+    return &self->storage[self->start];
+}
+
+gsize
+mm_serial_buffer_get_len (MMSerialBuffer *self)
+{
+    return self->len;
+}
+
+guint
+mm_serial_buffer_get_generation (MMSerialBuffer *self)
+{
+    return self->generation;
+}
+
+static void
+bump_generation (MMSerialBuffer *self)
+{
+    /* 0 is never a valid generation */
+    if (!++self->generation)
+        self->generation = 1;
+}
+
+gsize
+mm_serial_buffer_get_capacity (MMSerialBuffer *self)
+{
+    return self->capacity;
+}
+
+guint8 *
+mm_serial_buffer_reserve (MMSerialBuffer *self,
+                          gsize           len)
+{
+    /* Enough room at the tail already? */
+    if (self->start + self->len + len <= self->capacity)
+        return &self->storage[self->start + self->len];
+
+    /* Need to grow the storage? */
+    if (self->len + len > self->capacity) {
+        guint8 *storage;
+
+        self->capacity = nearest_pow2 (self->len + len);
+        storage = g_malloc (self->capacity);
+        if (self->len)
+            memcpy (storage, &self->storage[self->start], self->len);
+        g_free (self->storage);
+        self->storage = storage;
+    } else if (self->len)
+        memmove (self->storage, &self->storage[self->start], self->len);
+
+    self->start = 0;
+    return &self->storage[self->len];
+}
+
+void
+mm_serial_buffer_commit (MMSerialBuffer *self,
+                         gsize           len)
+{
+    g_assert (self->start + self->len + len <= self->capacity);
+    self->len += len;
+}
+
+void
+mm_serial_buffer_append (MMSerialBuffer *self,
+                         const guint8   *data,
+                         gsize           len)
+{
+    if (!len)
+        return;
+    memcpy (mm_serial_buffer_reserve (self, len), data, len);
+    mm_serial_buffer_commit (self, len);
+}
+
+void
+mm_serial_buffer_consume (MMSerialBuffer *self,
+                          gsize           len)
+{
+    g_assert (len <= self->len);
+
+    if (!len)
+        return;
+
+    bump_generation (self);
+    self->len -= len;
+    /* Rewind the cursor for free whenever we get empty */
+    self->start = (self->len ? self->start + len : 0);
+}
+
+void
+mm_serial_buffer_truncate (MMSerialBuffer *self,
+                           gsize           len)
+{
+    if (len >= self->len)
+        return;
+
+    bump_generation (self);
+    self->len = len;
+    if (!self->len)
+        self->start = 0;
+}
+
+void
+mm_serial_buffer_clear (MMSerialBuffer *self)
+{
+    if (self->len)
+        bump_generation (self);
+    self->start = 0;
+    self->len = 0;
+}
@@ -0,0 +1,66 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_SERIAL_BUFFER_H
+#define MM_SERIAL_BUFFER_H
+
+#include <glib.h>
+
+/*
+ * Buffer used to store the data received from a serial port.
+ *
+ * The contents are always available as a single contiguous chunk of memory,
+ * as required by the parsers (regex matching, HDLC decapsulation...). Data is
+ * consumed from the head by advancing a read cursor, without moving the
+ * remaining bytes. The unused space before the read cursor is only reclaimed
+ * (i.e. the contents linearized to the start of the storage) when there is no
+ * more room at the tail for new data. The storage size is always a power of
+ * two, and it is only ever grown, never shrunk.
+ */
+typedef struct _MMSerialBuffer MMSerialBuffer;
+
+MMSerialBuffer *mm_serial_buffer_new            (gsize           capacity);
+void            mm_serial_buffer_free           (MMSerialBuffer *self);
+
+guint8         *mm_serial_buffer_get_data       (MMSerialBuffer *self);
+gsize           mm_serial_buffer_get_len        (MMSerialBuffer *self);
+gsize           mm_serial_buffer_get_capacity   (MMSerialBuffer *self);
+
+/* Changes whenever contents already in the buffer are modified or removed, so
+ * it stays the same as long as new data is only appended. Never 0. */
+guint           mm_serial_buffer_get_generation (MMSerialBuffer *self);
+
+/* Get room for at least @len bytes at the tail, and then commit the amount of
+ * bytes actually written there. */
+guint8         *mm_serial_buffer_reserve        (MMSerialBuffer *self,
+                                                 gsize           len);
+void            mm_serial_buffer_commit         (MMSerialBuffer *self,
+                                                 gsize           len);
+
+void            mm_serial_buffer_append         (MMSerialBuffer *self,
+                                                 const guint8   *data,
+                                                 gsize           len);
+
+/* Remove @len bytes from the head; no data is moved */
+void            mm_serial_buffer_consume        (MMSerialBuffer *self,
+                                                 gsize           len);
+/* Keep just the first @len bytes */
+void            mm_serial_buffer_truncate       (MMSerialBuffer *self,
+                                                 gsize           len);
+void            mm_serial_buffer_clear          (MMSerialBuffer *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSerialBuffer, mm_serial_buffer_free)
+
+#endif /* MM_SERIAL_BUFFER_H */
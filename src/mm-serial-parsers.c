@@ -14,6 +14,8 @@
  * Copyright (C) 2009 Red Hat, Inc.
  */
 
+#define _GNU_SOURCE  /* for memmem() */
+
 #include <string.h>
 #include <stdlib.h>
 
@@ -98,8 +100,138 @@ typedef struct {
     /* User-provided parser filter */
     mm_serial_parser_v1_filter_fn filter_callback;
     gpointer                      filter_user_data;
+    /* Length of the response contents already scanned without finding any
+     * final result code, up to the start of the last unterminated line, and
+     * generation of those contents */
+    gsize scanned_len;
+    guint scanned_generation;
 } MMSerialParserV1;
 
+/*****************************************************************************/
+/* Final result code pre-scan
+ *
+ * Before running any of the built-in regular expressions we look for the
+ * keywords they require, and only in the part of the response not already
+ * scanned in a previous call; so that long replies received in many small
+ * chunks don't get fully re-parsed for every chunk.
+ *
+ * The keywords are a superset of what the built-in regexes may match: some
+ * must be found at the beginning of a line (i.e. after <CR><LF>), while some
+ * others may be found anywhere. */
+
+/* Longest keyword that may be found anywhere, to step back on resume */
+#define FLOATING_KEYWORD_MAX_LEN 21
+
+static const gchar *floating_keywords[] = {
+    "COMMAND NOT SUPPORT\r\n",
+    "BUSY",
+    "NO ANSWER",
+    "NO DIALTONE\r\n",
+};
+
+static inline gboolean
+line_has_keyword (const gchar *line,
+                  gsize        available,
+                  const gchar *keyword,
+                  gsize        keyword_len)
+{
+    return (available >= keyword_len && memcmp (line, keyword, keyword_len) == 0);
+}
+
+#define LINE_HAS_KEYWORD(line, available, keyword) \
+    line_has_keyword (line, available, keyword, sizeof (keyword) - 1)
+
+static gboolean
+line_has_final_result_keyword (const gchar *line,
+                               gsize        available)
+{
+    if (!available)
+        return FALSE;
+
+    switch (line[0]) {
+    case 'O':
+        return LINE_HAS_KEYWORD (line, available, "OK\r\n");
+    case 'C':
+        return LINE_HAS_KEYWORD (line, available, "CONNECT");
+    case '>':
+        return TRUE;
+    case '+':
+        return (LINE_HAS_KEYWORD (line, available, "+CME ERROR:") ||
+                LINE_HAS_KEYWORD (line, available, "+CMS ERROR:"));
+    case 'M':
+        return LINE_HAS_KEYWORD (line, available, "MODEM ERROR:");
+    case 'E':
+        return LINE_HAS_KEYWORD (line, available, "ERROR");
+    case 'N':
+        return (LINE_HAS_KEYWORD (line, available, "NO CARRIER") ||
+                LINE_HAS_KEYWORD (line, available, "NA\r\n"));
+    default:
+        return FALSE;
+    }
+}
+
+static gboolean
+response_has_final_result_keyword (const gchar *str,
+                                   gsize        len,
+                                   gsize        from)
+{
+    const gchar *end = str + len;
+    const gchar *cr;
+    gsize        floating_from;
+    guint        i;
+
+    for (cr = memchr (str + from, '\r', len - from); cr; cr = memchr (cr + 1, '\r', end - cr - 1)) {
+        if (cr + 2 >= end)
+            break;
+        if (cr[1] == '\n' && line_has_final_result_keyword (cr + 2, end - cr - 2))
+            return TRUE;
+    }
+
+    floating_from = (from > FLOATING_KEYWORD_MAX_LEN ? from - FLOATING_KEYWORD_MAX_LEN : 0);
+    for (i = 0; i < G_N_ELEMENTS (floating_keywords); i++) {
+        if (memmem (str + floating_from, len - floating_from,
+                    floating_keywords[i], strlen (floating_keywords[i])))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* Returns the offset from which the given response must be scanned */
+static gsize
+response_scan_start (MMSerialParserV1 *parser,
+                     const GString    *response,
+                     guint             generation)
+{
+    /* If the contents we already went through may have changed (e.g. the
+     * response was processed or unsolicited messages removed), start from
+     * scratch */
+    if (!generation ||
+        generation != parser->scanned_generation ||
+        parser->scanned_len > response->len)
+        parser->scanned_len = 0;
+    parser->scanned_generation = generation;
+
+    return parser->scanned_len;
+}
+
+static void
+response_scan_update (MMSerialParserV1 *parser,
+                      const GString    *response,
+                      gsize             from)
+{
+    gsize i;
+
+    /* Next time, resume at the last <CR><LF>, so that the unterminated
+     * line following it is fully scanned again */
+    for (i = response->len; i > from + 1; i--) {
+        if (response->str[i - 2] == '\r' && response->str[i - 1] == '\n') {
+            parser->scanned_len = i - 2;
+            return;
+        }
+    }
+}
+
 gpointer
 mm_serial_parser_v1_new (void)
 {
@@ -125,6 +257,8 @@ mm_serial_parser_v1_new (void)
     parser->regex_custom_error = NULL;
     parser->filter_callback = NULL;
     parser->filter_user_data = NULL;
+    parser->scanned_len = 0;
+    parser->scanned_generation = 0;
 
     return parser;
 }
@@ -163,21 +297,28 @@ mm_serial_parser_v1_add_filter (gpointer data,
 gboolean
 mm_serial_parser_v1_parse (gpointer   data,
                            GString   *response,
+                           guint      generation,
                            gpointer   log_object,
                            GError   **error)
 {
     MMSerialParserV1 *parser = (MMSerialParserV1 *) data;
-    GMatchInfo *match_info;
+    GMatchInfo *match_info = NULL;
     GError *local_error = NULL;
     gboolean found = FALSE;
+    gboolean keyword = FALSE;
+    gsize scan_start;
     char *str = NULL;
 
     g_return_val_if_fail (parser != NULL, FALSE);
     g_return_val_if_fail (response != NULL, FALSE);
 
-    /* Skip NUL bytes if they are found leading the response */
-    while (response->len > 0 && response->str[0] == '\0')
-        g_string_erase (response, 0, 1);
+    /* Skip NUL bytes if they are found leading the response; the contents
+     * are shifted, so they must be fully scanned again */
+    if (response->len > 0 && response->str[0] == '\0') {
+        while (response->len > 0 && response->str[0] == '\0')
+            g_string_erase (response, 0, 1);
+        generation = 0;
+    }
 
     if (G_UNLIKELY (!response->len))
         return FALSE;
@@ -192,9 +333,15 @@ mm_serial_parser_v1_parse (gpointer   data,
         mm_obj_dbg (log_object, "response filtered in serial port: %s", local_error->message);
         g_propagate_error (error, local_error);
         response_clean (response);
+        parser->scanned_len = 0;
         return TRUE;
     }
 
+    /* Look for the keywords required by the built-in final result codes in
+     * the contents not scanned yet */
+    scan_start = response_scan_start (parser, response, generation);
+    keyword = response_has_final_result_keyword (response->str, response->len, scan_start);
+
     /* Then, check for successful responses */
 
     /* Custom successful replies first, if any */
@@ -204,7 +351,7 @@ mm_serial_parser_v1_parse (gpointer   data,
                                     0, 0, NULL, NULL);
     }
 
-    if (!found) {
+    if (!found && keyword) {
         found = g_regex_match_full (parser->regex_ok,
                                     response->str, response->len,
                                     0, 0, NULL, NULL);
@@ -212,13 +359,13 @@ mm_serial_parser_v1_parse (gpointer   data,
             remove_matches (parser->regex_ok, response);
     }
 
-    if (!found) {
+    if (!found && keyword) {
         found = g_regex_match_full (parser->regex_connect,
                                     response->str, response->len,
                                     0, 0, NULL, NULL);
     }
 
-    if (!found) {
+    if (!found && keyword) {
         found = g_regex_match_full (parser->regex_sms,
                                     response->str, response->len,
                                     0, 0, NULL, NULL);
@@ -226,6 +373,7 @@ mm_serial_parser_v1_parse (gpointer   data,
 
     if (found) {
         response_clean (response);
+        parser->scanned_len = 0;
         return TRUE;
     }
 
@@ -242,9 +390,13 @@ mm_serial_parser_v1_parse (gpointer   data,
             local_error = mm_mobile_equipment_error_for_code (atoi (str), log_object);
             goto done;
         }
-        g_match_info_free (match_info);
+        g_clear_pointer (&match_info, g_match_info_free);
     }
 
+    /* None of the built-in errors may be found without keywords */
+    if (!keyword)
+        goto done;
+
     /* Numeric CME errors */
     found = g_regex_match_full (parser->regex_cme_error,
                                 response->str, response->len,
@@ -357,9 +509,13 @@ mm_serial_parser_v1_parse (gpointer   data,
 
 done:
     g_free (str);
-    g_match_info_free (match_info);
-    if (found)
+    if (match_info)
+        g_match_info_free (match_info);
+    if (found) {
         response_clean (response);
+        parser->scanned_len = 0;
+    } else
+        response_scan_update (parser, response, scan_start);
 
     if (local_error) {
         mm_obj_dbg (log_object, "operation failure: %d (%s)", local_error->code, local_error->message);
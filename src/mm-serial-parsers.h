@@ -22,8 +22,13 @@ gpointer mm_serial_parser_v1_new                  (void);
 void     mm_serial_parser_v1_set_custom_regex     (gpointer data,
                                                    GRegex *successful,
                                                    GRegex *error);
+/* The parser only looks for final result codes in the contents not already
+ * scanned in the previous call with the same @generation, so the caller must
+ * give a new one whenever contents other than the tail are modified; 0 always
+ * forces a full scan. */
 gboolean mm_serial_parser_v1_parse                (gpointer parser,
                                                    GString *response,
+                                                   guint    generation,
                                                    gpointer log_object,
                                                    GError **error);
 void     mm_serial_parser_v1_destroy              (gpointer parser);
@@ -0,0 +1,269 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+
+#include "mm-signal-report.h"
+
+typedef struct {
+    gboolean polling_supported;
+    /* Whether the plugin set up indications for the value */
+    gboolean indications;
+    /* Last value received through indications, 0 if none */
+    gint64   indication_time;
+    /* Whether polled in the current check, and the values polled in this
+     * and in the previous check, to adapt the polling interval */
+    gboolean polled;
+    guint    current;
+    guint    last;
+    gboolean has_last;
+} ValueState;
+
+struct _MMSignalReport {
+    guint      keep_alive_sec;
+    ValueState values[MM_SIGNAL_REPORT_VALUE_LAST];
+    /* End of the initial check, 0 if not done */
+    gint64     initial_check_time;
+    guint      poll_timeout;
+
+    /* Reporting statistics */
+    MMSignalReportMode mode;
+    guint              n_indications;
+    guint              n_polls;
+};
+
+/*****************************************************************************/
+
+static const gchar *mode_str[] = {
+    [MM_SIGNAL_REPORT_MODE_NONE]        = "none",
+    [MM_SIGNAL_REPORT_MODE_POLLING]     = "polling",
+    [MM_SIGNAL_REPORT_MODE_INDICATIONS] = "indications",
+};
+
+const gchar *
+mm_signal_report_mode_get_string (MMSignalReportMode mode)
+{
+    g_return_val_if_fail (mode < G_N_ELEMENTS (mode_str), NULL);
+    return mode_str[mode];
+}
+
+/*****************************************************************************/
+
+void
+mm_signal_report_set_polling_supported (MMSignalReport      *self,
+                                        MMSignalReportValue  value,
+                                        gboolean             supported)
+{
+    self->values[value].polling_supported = supported;
+}
+
+gboolean
+mm_signal_report_get_polling_supported (MMSignalReport      *self,
+                                        MMSignalReportValue  value)
+{
+    return self->values[value].polling_supported;
+}
+
+void
+mm_signal_report_set_indications (MMSignalReport      *self,
+                                  MMSignalReportValue  value,
+                                  gboolean             indications)
+{
+    self->values[value].indications = indications;
+}
+
+void
+mm_signal_report_restart (MMSignalReport *self)
+{
+    self->initial_check_time = 0;
+}
+
+void
+mm_signal_report_initial_check_done (MMSignalReport *self,
+                                     gint64          now)
+{
+    self->initial_check_time = MAX (now, 1);
+    self->poll_timeout = MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC;
+}
+
+void
+mm_signal_report_clear (MMSignalReport *self)
+{
+    guint i;
+
+    mm_signal_report_restart (self);
+    for (i = 0; i < MM_SIGNAL_REPORT_VALUE_LAST; i++)
+        self->values[i].indication_time = 0;
+    self->mode = MM_SIGNAL_REPORT_MODE_NONE;
+}
+
+void
+mm_signal_report_indication (MMSignalReport      *self,
+                             MMSignalReportValue  value,
+                             gint64               now)
+{
+    self->values[value].indication_time = MAX (now, 1);
+    self->n_indications++;
+}
+
+/*****************************************************************************/
+
+/* Returns whether the value is ever polled after the initial check */
+static gboolean
+value_polled_after_initial_check (MMSignalReport *self,
+                                  ValueState     *state)
+{
+    return state->polling_supported && (!state->indications || self->keep_alive_sec);
+}
+
+/* Returns the seconds left until the value reported by indications is
+ * considered stale, 0 if it already is */
+static guint
+value_indication_remaining (MMSignalReport *self,
+                            ValueState     *state,
+                            gint64          now)
+{
+    gint64 reference;
+    guint  window;
+    gint64 elapsed;
+
+    if (state->indications) {
+        /* Trusted since the initial check, even if no indication received */
+        reference = MAX (state->indication_time, self->initial_check_time);
+        window = self->keep_alive_sec;
+    } else {
+        reference = state->indication_time;
+        window = MM_SIGNAL_REPORT_STALE_TIMEOUT_SEC;
+    }
+    if (!reference)
+        return 0;
+
+    elapsed = (now - reference) / G_USEC_PER_SEC;
+    if (elapsed >= window)
+        return 0;
+    return (guint) (window - elapsed);
+}
+
+void
+mm_signal_report_start_check (MMSignalReport *self)
+{
+    guint i;
+
+    for (i = 0; i < MM_SIGNAL_REPORT_VALUE_LAST; i++)
+        self->values[i].polled = FALSE;
+}
+
+gboolean
+mm_signal_report_poll_needed (MMSignalReport      *self,
+                              MMSignalReportValue  value,
+                              gint64               now)
+{
+    ValueState *state = &self->values[value];
+
+    if (!state->polling_supported)
+        return FALSE;
+    if (!self->initial_check_time)
+        return TRUE;
+    if (!value_polled_after_initial_check (self, state))
+        return FALSE;
+    return !value_indication_remaining (self, state, now);
+}
+
+void
+mm_signal_report_polled (MMSignalReport      *self,
+                         MMSignalReportValue  value,
+                         guint                polled)
+{
+    self->values[value].polled = TRUE;
+    self->values[value].current = polled;
+    self->n_polls++;
+}
+
+guint
+mm_signal_report_end_check (MMSignalReport *self,
+                            gint64          now)
+{
+    gboolean polled = FALSE;
+    gboolean changed = FALSE;
+    guint    timeout = 0;
+    guint    i;
+
+    /* While polling, grow the interval as long as the values don't change */
+    for (i = 0; i < MM_SIGNAL_REPORT_VALUE_LAST; i++) {
+        ValueState *state = &self->values[i];
+
+        if (!state->polled)
+            continue;
+        polled = TRUE;
+        if (!state->has_last || state->last != state->current)
+            changed = TRUE;
+        state->last = state->current;
+        state->has_last = TRUE;
+    }
+    if (polled)
+        self->poll_timeout = changed ?
+                             MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC :
+                             MIN (self->poll_timeout * 2, MM_SIGNAL_REPORT_MAX_POLL_TIMEOUT_SEC);
+    self->mode = polled ? MM_SIGNAL_REPORT_MODE_POLLING : MM_SIGNAL_REPORT_MODE_INDICATIONS;
+
+    /* And check again as soon as any value needs polling */
+    for (i = 0; i < MM_SIGNAL_REPORT_VALUE_LAST; i++) {
+        ValueState *state = &self->values[i];
+        guint       value_timeout;
+
+        if (!value_polled_after_initial_check (self, state))
+            continue;
+        value_timeout = value_indication_remaining (self, state, now);
+        if (!value_timeout)
+            value_timeout = self->poll_timeout;
+        timeout = timeout ? MIN (timeout, value_timeout) : value_timeout;
+    }
+    return timeout;
+}
+
+/*****************************************************************************/
+
+void
+mm_signal_report_get_stats (MMSignalReport     *self,
+                            MMSignalReportMode *out_mode,
+                            guint              *out_n_indications,
+                            guint              *out_n_polls)
+{
+    if (out_mode)
+        *out_mode = self->mode;
+    if (out_n_indications)
+        *out_n_indications = self->n_indications;
+    if (out_n_polls)
+        *out_n_polls = self->n_polls;
+}
+
+/*****************************************************************************/
+
+MMSignalReport *
+mm_signal_report_new (guint keep_alive_sec)
+{
+    MMSignalReport *self;
+
+    self = g_slice_new0 (MMSignalReport);
+    self->keep_alive_sec = keep_alive_sec;
+    self->poll_timeout = MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC;
+    return self;
+}
+
+void
+mm_signal_report_free (MMSignalReport *self)
+{
+    g_slice_free (MMSignalReport, self);
+}
@@ -0,0 +1,101 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_SIGNAL_REPORT_H
+#define MM_SIGNAL_REPORT_H
+
+#include <glib.h>
+
+/*
+ * Scheduling of the periodic signal quality and access technology checks.
+ *
+ * All values are polled until the initial check is done. After that, values
+ * reported through indications (or registration updates) are trusted for
+ * MM_SIGNAL_REPORT_STALE_TIMEOUT_SEC, and only the values not reported that
+ * way recently are polled. While polling, the interval grows from
+ * MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC up to MM_SIGNAL_REPORT_MAX_POLL_TIMEOUT_SEC
+ * as long as the polled values don't change.
+ *
+ * If the plugin set up indications for a value, not receiving any just means
+ * that the value didn't cross any threshold, so it's never polled again, or
+ * only once the optional keep-alive timeout passes without indications.
+ *
+ * Times are monotonic, in microseconds.
+ */
+
+#define MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC     30
+#define MM_SIGNAL_REPORT_MAX_POLL_TIMEOUT_SEC 120
+#define MM_SIGNAL_REPORT_STALE_TIMEOUT_SEC    120
+
+typedef enum {
+    MM_SIGNAL_REPORT_MODE_NONE,
+    MM_SIGNAL_REPORT_MODE_POLLING,
+    MM_SIGNAL_REPORT_MODE_INDICATIONS,
+} MMSignalReportMode;
+
+typedef enum {
+    MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY,
+    MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES,
+    MM_SIGNAL_REPORT_VALUE_LAST
+} MMSignalReportValue;
+
+typedef struct _MMSignalReport MMSignalReport;
+
+const gchar    *mm_signal_report_mode_get_string (MMSignalReportMode mode);
+
+/* A keep-alive of 0 never polls values with indications set up */
+MMSignalReport *mm_signal_report_new  (guint           keep_alive_sec);
+void            mm_signal_report_free (MMSignalReport *self);
+
+void     mm_signal_report_set_polling_supported (MMSignalReport      *self,
+                                                 MMSignalReportValue  value,
+                                                 gboolean             supported);
+gboolean mm_signal_report_get_polling_supported (MMSignalReport      *self,
+                                                 MMSignalReportValue  value);
+void     mm_signal_report_set_indications       (MMSignalReport      *self,
+                                                 MMSignalReportValue  value,
+                                                 gboolean             indications);
+
+/* Polls all values again until the initial check is done */
+void     mm_signal_report_restart            (MMSignalReport *self);
+void     mm_signal_report_initial_check_done (MMSignalReport *self,
+                                              gint64          now);
+/* Also forgets the values received through indications */
+void     mm_signal_report_clear              (MMSignalReport *self);
+
+void     mm_signal_report_indication (MMSignalReport      *self,
+                                      MMSignalReportValue  value,
+                                      gint64               now);
+
+/* A check goes through all values, polling the ones needed, and ends
+ * returning the seconds until the next check, or 0 if none is needed */
+void     mm_signal_report_start_check (MMSignalReport      *self);
+gboolean mm_signal_report_poll_needed (MMSignalReport      *self,
+                                       MMSignalReportValue  value,
+                                       gint64               now);
+void     mm_signal_report_polled      (MMSignalReport      *self,
+                                       MMSignalReportValue  value,
+                                       guint                polled);
+guint    mm_signal_report_end_check   (MMSignalReport      *self,
+                                       gint64               now);
+
+void     mm_signal_report_get_stats (MMSignalReport     *self,
+                                     MMSignalReportMode *out_mode,
+                                     guint              *out_n_indications,
+                                     guint              *out_n_polls);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSignalReport, mm_signal_report_free)
+
+#endif /* MM_SIGNAL_REPORT_H */
@@ -53,10 +53,73 @@ struct _MMSmsListPrivate {
     MMBaseModem *modem;
     /* List of sms objects */
     GList *list;
+    guint  count;
+    /* Lookup of sms objects by part storage/index and by multipart
+     * reference */
+    MMSmsPartIndex *index;
 };
 
 /*****************************************************************************/
 
+static void
+sms_index (MMSmsList *self,
+           MMBaseSms *sms)
+{
+    MMSmsStorage  storage;
+    GList        *l;
+
+    mm_sms_part_index_remove_owner (self->priv->index, sms);
+
+    storage = mm_base_sms_get_storage (sms);
+    for (l = mm_base_sms_get_parts (sms); l; l = g_list_next (l))
+        mm_sms_part_index_add_part (self->priv->index,
+                                    storage,
+                                    mm_sms_part_get_index ((MMSmsPart *)l->data),
+                                    sms);
+
+    if (mm_base_sms_is_multipart (sms))
+        mm_sms_part_index_add_multipart (self->priv->index,
+                                         mm_base_sms_get_multipart_reference (sms),
+                                         sms);
+}
+
+static void
+sms_storage_updated (MMBaseSms  *sms,
+                     GParamSpec *pspec,
+                     MMSmsList  *self)
+{
+    /* Parts get their indices once stored */
+    sms_index (self, sms);
+}
+
+static void
+sms_list_track (MMSmsList *self,
+                MMBaseSms *sms)
+{
+    self->priv->list = g_list_prepend (self->priv->list, sms);
+    self->priv->count++;
+    sms_index (self, sms);
+    g_signal_connect (sms,
+                      "notify::storage",
+                      G_CALLBACK (sms_storage_updated),
+                      self);
+}
+
+static void
+sms_list_untrack (MMSmsList *self,
+                  GList     *l)
+{
+    MMBaseSms *sms = MM_BASE_SMS (l->data);
+
+    g_signal_handlers_disconnect_by_func (sms, sms_storage_updated, self);
+    mm_sms_part_index_remove_owner (self->priv->index, sms);
+    self->priv->list = g_list_delete_link (self->priv->list, l);
+    self->priv->count--;
+    g_object_unref (sms);
+}
+
+/*****************************************************************************/
+
 gboolean
 mm_sms_list_has_local_multipart_reference (MMSmsList *self,
                                            const gchar *number,
@@ -67,7 +130,7 @@ mm_sms_list_has_local_multipart_reference (MMSmsList *self,
     /* No one should look for multipart reference 0, which isn't valid */
     g_assert (reference != 0);
 
-    for (l = self->priv->list; l; l = g_list_next (l)) {
+    for (l = mm_sms_part_index_peek_multiparts (self->priv->index, reference); l; l = g_list_next (l)) {
         MMBaseSms *sms = MM_BASE_SMS (l->data);
 
         if (mm_base_sms_is_multipart (sms) &&
@@ -89,7 +152,7 @@ mm_sms_list_has_local_multipart_reference (MMSmsList *self,
 guint
 mm_sms_list_get_count (MMSmsList *self)
 {
-    return g_list_length (self->priv->list);
+    return self->priv->count;
 }
 
 GStrv
@@ -99,8 +162,7 @@ mm_sms_list_get_paths (MMSmsList *self)
     GList *l;
     guint i;
 
-    path_list = g_new0 (gchar *,
-                        1 + g_list_length (self->priv->list));
+    path_list = g_new0 (gchar *, 1 + self->priv->count);
 
     for (i = 0, l = self->priv->list; l; l = g_list_next (l)) {
         const gchar *path;
@@ -154,10 +216,8 @@ delete_ready (MMBaseSms *sms,
     l = g_list_find_custom (self->priv->list,
                             path,
                             (GCompareFunc)cmp_sms_by_path);
-    if (l) {
-        g_object_unref (MM_BASE_SMS (l->data));
-        self->priv->list = g_list_delete_link (self->priv->list, l);
-    }
+    if (l)
+        sms_list_untrack (self, l);
 
     /* We don't need to unref the SMS any more, but we can use the
      * reference we got in the method, which is the one kept alive
@@ -211,7 +271,7 @@ void
 mm_sms_list_add_sms (MMSmsList *self,
                      MMBaseSms *sms)
 {
-    self->priv->list = g_list_prepend (self->priv->list, g_object_ref (sms));
+    sms_list_track (self, g_object_ref (sms));
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    FALSE);
@@ -219,29 +279,6 @@ mm_sms_list_add_sms (MMSmsList *self,
 
 /*****************************************************************************/
 
-static guint
-cmp_sms_by_concat_reference (MMBaseSms *sms,
-                             gpointer user_data)
-{
-    if (!mm_base_sms_is_multipart (sms))
-        return -1;
-
-    return (GPOINTER_TO_UINT (user_data) - mm_base_sms_get_multipart_reference (sms));
-}
-
-typedef struct {
-    guint part_index;
-    MMSmsStorage storage;
-} PartIndexAndStorage;
-
-static guint
-cmp_sms_by_part_index_and_storage (MMBaseSms *sms,
-                                   PartIndexAndStorage *ctx)
-{
-    return !(mm_base_sms_get_storage (sms) == ctx->storage &&
-             mm_base_sms_has_part_index (sms, ctx->part_index));
-}
-
 static gboolean
 take_singlepart (MMSmsList *self,
                  MMSmsPart *part,
@@ -259,7 +296,7 @@ take_singlepart (MMSmsList *self,
     if (!sms)
         return FALSE;
 
-    self->priv->list = g_list_prepend (self->priv->list, sms);
+    sms_list_track (self, sms);
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    state == MM_SMS_STATE_RECEIVED);
@@ -273,18 +310,29 @@ take_multipart (MMSmsList *self,
                 MMSmsStorage storage,
                 GError **error)
 {
+    GList *owners;
     GList *l;
     MMBaseSms *sms;
     guint concat_reference;
+    guint part_index;
 
     concat_reference = mm_sms_part_get_concat_reference (part);
-    l = g_list_find_custom (self->priv->list,
-                            GUINT_TO_POINTER (concat_reference),
-                            (GCompareFunc)cmp_sms_by_concat_reference);
-    if (l) {
+    owners = mm_sms_part_index_peek_multiparts (self->priv->index, concat_reference);
+    if (owners) {
+        /* If several messages share the reference, take the first one
+         * in the list */
+        l = owners;
+        if (owners->next)
+            for (l = self->priv->list; !g_list_find (owners, l->data); l = g_list_next (l));
+        sms = MM_BASE_SMS (l->data);
+
         /* Try to take the part */
         mm_obj_dbg (self, "found existing multipart SMS object with reference '%u': adding new part", concat_reference);
-        return mm_base_sms_multipart_take_part (MM_BASE_SMS (l->data), part, error);
+        part_index = mm_sms_part_get_index (part);
+        if (!mm_base_sms_multipart_take_part (sms, part, error))
+            return FALSE;
+        mm_sms_part_index_add_part (self->priv->index, storage, part_index, sms);
+        return TRUE;
     }
 
     /* Create new Multipart */
@@ -301,7 +349,7 @@ take_multipart (MMSmsList *self,
     mm_obj_dbg (self, "creating new multipart SMS object: need to receive %u parts with reference '%u'",
                 mm_sms_part_get_concat_max (part),
                 concat_reference);
-    self->priv->list = g_list_prepend (self->priv->list, sms);
+    sms_list_track (self, sms);
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    (state == MM_SMS_STATE_RECEIVED ||
@@ -315,18 +363,18 @@ mm_sms_list_has_part (MMSmsList *self,
                       MMSmsStorage storage,
                       guint index)
 {
-    PartIndexAndStorage ctx;
+    MMBaseSms *sms;
 
     if (storage == MM_SMS_STORAGE_UNKNOWN ||
         index == SMS_PART_INVALID_INDEX)
         return FALSE;
 
-    ctx.part_index = index;
-    ctx.storage = storage;
-
-    return !!g_list_find_custom (self->priv->list,
-                                 &ctx,
-                                 (GCompareFunc)cmp_sms_by_part_index_and_storage);
+    /* Parts may have been removed from storage without the SMS object
+     * being removed from the list, so double check */
+    sms = mm_sms_part_index_lookup_part (self->priv->index, storage, index);
+    return (sms &&
+            mm_base_sms_get_storage (sms) == storage &&
+            mm_base_sms_has_part_index (sms, index));
 }
 
 gboolean
@@ -443,6 +491,7 @@ mm_sms_list_init (MMSmsList *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_SMS_LIST,
                                               MMSmsListPrivate);
+    self->priv->index = mm_sms_part_index_new ();
 }
 
 static void
@@ -451,12 +500,22 @@ dispose (GObject *object)
     MMSmsList *self = MM_SMS_LIST (object);
 
     g_clear_object (&self->priv->modem);
-    g_list_free_full (self->priv->list, g_object_unref);
-    self->priv->list = NULL;
+    while (self->priv->list)
+        sms_list_untrack (self, self->priv->list);
 
     G_OBJECT_CLASS (mm_sms_list_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+    MMSmsList *self = MM_SMS_LIST (object);
+
+    mm_sms_part_index_free (self->priv->index);
+
+    G_OBJECT_CLASS (mm_sms_list_parent_class)->finalize (object);
+}
+
 static void
 log_object_iface_init (MMLogObjectInterface *iface)
 {
@@ -474,6 +533,7 @@ mm_sms_list_class_init (MMSmsListClass *klass)
     object_class->get_property = get_property;
     object_class->set_property = set_property;
     object_class->dispose = dispose;
+    object_class->finalize = finalize;
 
     /* Properties */
     properties[PROP_MODEM] =
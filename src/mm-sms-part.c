@@ -191,3 +191,175 @@ mm_sms_part_new (guint index,
 
     return sms_part;
 }
+
+/*****************************************************************************/
+
+struct _MMSmsPartIndex {
+    /* storage/index (gint64) -> owner */
+    GHashTable *parts;
+    /* reference -> GList of owners */
+    GHashTable *multiparts;
+    /* owner -> OwnerKeys */
+    GHashTable *owners;
+};
+
+typedef struct {
+    GArray *parts;
+    GSList *multiparts;
+} OwnerKeys;
+
+static void
+owner_keys_free (OwnerKeys *keys)
+{
+    g_array_unref (keys->parts);
+    g_slist_free (keys->multiparts);
+    g_slice_free (OwnerKeys, keys);
+}
+
+static OwnerKeys *
+index_ensure_owner_keys (MMSmsPartIndex *self,
+                         gpointer        owner)
+{
+    OwnerKeys *keys;
+
+    keys = g_hash_table_lookup (self->owners, owner);
+    if (!keys) {
+        keys = g_slice_new0 (OwnerKeys);
+        keys->parts = g_array_new (FALSE, FALSE, sizeof (gint64));
+        g_hash_table_insert (self->owners, owner, keys);
+    }
+    return keys;
+}
+
+static inline gint64
+build_part_key (MMSmsStorage storage,
+                guint        index)
+{
+    return ((gint64) storage << 32) | index;
+}
+
+void
+mm_sms_part_index_add_part (MMSmsPartIndex *self,
+                            MMSmsStorage    storage,
+                            guint           index,
+                            gpointer        owner)
+{
+    OwnerKeys *keys;
+    gint64     key;
+    gint64    *stored_key;
+
+    if (storage == MM_SMS_STORAGE_UNKNOWN || index == SMS_PART_INVALID_INDEX)
+        return;
+
+    key = build_part_key (storage, index);
+    keys = index_ensure_owner_keys (self, owner);
+    g_array_append_val (keys->parts, key);
+    stored_key = g_new (gint64, 1);
+    *stored_key = key;
+    g_hash_table_insert (self->parts, stored_key, owner);
+}
+
+void
+mm_sms_part_index_add_multipart (MMSmsPartIndex *self,
+                                 guint           reference,
+                                 gpointer        owner)
+{
+    OwnerKeys *keys;
+    gpointer   key;
+    GList     *owners;
+
+    key = GUINT_TO_POINTER (reference);
+    keys = index_ensure_owner_keys (self, owner);
+    if (g_slist_find (keys->multiparts, key))
+        return;
+
+    /* The list head is kept in the table, so steal it before updating it */
+    owners = g_hash_table_lookup (self->multiparts, key);
+    if (owners)
+        g_hash_table_steal (self->multiparts, key);
+    g_hash_table_insert (self->multiparts, key, g_list_prepend (owners, owner));
+    keys->multiparts = g_slist_prepend (keys->multiparts, key);
+}
+
+void
+mm_sms_part_index_remove_owner (MMSmsPartIndex *self,
+                                gpointer        owner)
+{
+    OwnerKeys *keys;
+    GSList    *l;
+    guint      i;
+
+    keys = g_hash_table_lookup (self->owners, owner);
+    if (!keys)
+        return;
+
+    /* A part key may have been taken over by a different owner */
+    for (i = 0; i < keys->parts->len; i++) {
+        gint64 *key = &g_array_index (keys->parts, gint64, i);
+
+        if (g_hash_table_lookup (self->parts, key) == owner)
+            g_hash_table_remove (self->parts, key);
+    }
+
+    for (l = keys->multiparts; l; l = g_slist_next (l)) {
+        GList *owners;
+
+        owners = g_hash_table_lookup (self->multiparts, l->data);
+        if (!owners)
+            continue;
+        g_hash_table_steal (self->multiparts, l->data);
+        owners = g_list_remove (owners, owner);
+        if (owners)
+            g_hash_table_insert (self->multiparts, l->data, owners);
+    }
+
+    g_hash_table_remove (self->owners, owner);
+}
+
+gpointer
+mm_sms_part_index_lookup_part (MMSmsPartIndex *self,
+                               MMSmsStorage    storage,
+                               guint           index)
+{
+    gint64 key;
+
+    if (storage == MM_SMS_STORAGE_UNKNOWN || index == SMS_PART_INVALID_INDEX)
+        return NULL;
+
+    key = build_part_key (storage, index);
+    return g_hash_table_lookup (self->parts, &key);
+}
+
+GList *
+mm_sms_part_index_peek_multiparts (MMSmsPartIndex *self,
+                                   guint           reference)
+{
+    return g_hash_table_lookup (self->multiparts, GUINT_TO_POINTER (reference));
+}
+
+static void
+multipart_owners_free (GList *owners)
+{
+    g_list_free (owners);
+}
+
+MMSmsPartIndex *
+mm_sms_part_index_new (void)
+{
+    MMSmsPartIndex *self;
+
+    self = g_slice_new0 (MMSmsPartIndex);
+    self->parts = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+    self->multiparts = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) multipart_owners_free);
+    self->owners = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) owner_keys_free);
+    return self;
+}
+
+void
+mm_sms_part_index_free (MMSmsPartIndex *self)
+{
+    g_hash_table_unref (self->owners);
+    g_hash_table_unref (self->multiparts);
+    g_hash_table_unref (self->parts);
+    g_slice_free (MMSmsPartIndex, self);
+}
@@ -154,4 +154,29 @@ MMSmsCdmaServiceCategory mm_sms_part_get_cdma_service_category (MMSmsPart *part)
 void                     mm_sms_part_set_cdma_service_category (MMSmsPart *part,
                                                                 MMSmsCdmaServiceCategory cdma_service_category);
 
+/* Index of the SMS objects owning a set of parts, so that lookups by part
+ * storage/index and by multipart reference don't need to walk the
+ * whole list of SMS objects. The owners are not referenced. */
+typedef struct _MMSmsPartIndex MMSmsPartIndex;
+
+MMSmsPartIndex *mm_sms_part_index_new              (void);
+void            mm_sms_part_index_free             (MMSmsPartIndex *self);
+void            mm_sms_part_index_add_part         (MMSmsPartIndex *self,
+                                                    MMSmsStorage    storage,
+                                                    guint           index,
+                                                    gpointer        owner);
+void            mm_sms_part_index_add_multipart    (MMSmsPartIndex *self,
+                                                    guint           reference,
+                                                    gpointer        owner);
+void            mm_sms_part_index_remove_owner     (MMSmsPartIndex *self,
+                                                    gpointer        owner);
+gpointer        mm_sms_part_index_lookup_part      (MMSmsPartIndex *self,
+                                                    MMSmsStorage    storage,
+                                                    guint           index);
+/* Most recently added owner first */
+GList          *mm_sms_part_index_peek_multiparts  (MMSmsPartIndex *self,
+                                                    guint           reference);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSmsPartIndex, mm_sms_part_index_free)
+
 #endif /* MM_SMS_PART_H */
@@ -0,0 +1,270 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+
+#include "mm-timer.h"
+#include "mm-main-loop-monitor.h"
+
+/* Coalescing window of each timer class, in seconds */
+static const guint class_windows[] = {
+    [MM_TIMER_CLASS_DEFAULT] = 1,
+    [MM_TIMER_CLASS_POLLING] = 5,
+    [MM_TIMER_CLASS_STATS]   = 10,
+};
+
+/* Tags of the timer dispatches in the main loop stats */
+static const gchar *class_tags[] = {
+    [MM_TIMER_CLASS_DEFAULT] = "default",
+    [MM_TIMER_CLASS_POLLING] = "polling",
+    [MM_TIMER_CLASS_STATS]   = "stats",
+};
+
+typedef struct {
+    guint           id;
+    MMTimerClass    timer_class;
+    /* Log id of the owner, NULL if none */
+    gchar          *tag;
+    guint           interval;
+    guint           window;
+    gint64          deadline;
+    GSourceFunc     function;
+    gpointer        user_data;
+    GDestroyNotify  notify;
+    /* NULL while the callback runs */
+    GSequenceIter  *iter;
+    gboolean        removed;
+} Timer;
+
+typedef struct {
+    GSource     *source;
+    /* Timers sorted by deadline */
+    GSequence   *queue;
+    /* id -> Timer, owns the timers */
+    GHashTable  *timers;
+    guint        last_id;
+    Timer       *dispatching;
+    guint64      n_wakeups;
+    guint64      n_callbacks;
+} TimerQueue;
+
+static TimerQueue *timer_queue;
+
+/*****************************************************************************/
+
+static void
+timer_free (Timer *timer)
+{
+    if (timer->notify)
+        timer->notify (timer->user_data);
+    g_free (timer->tag);
+    g_slice_free (Timer, timer);
+}
+
+static gint
+timer_cmp (const Timer *a,
+           const Timer *b,
+           gpointer     unused)
+{
+    if (a->deadline != b->deadline)
+        return a->deadline < b->deadline ? -1 : 1;
+    /* Same deadline, keep the order in which they were added */
+    if (a->id != b->id)
+        return a->id < b->id ? -1 : 1;
+    return 0;
+}
+
+static void
+timer_schedule (Timer  *timer,
+                gint64  now)
+{
+    gint64 window;
+    gint64 deadline;
+
+    /* Round up to the window boundary, shared by all timers of the class and
+     * by those of classes with larger windows */
+    window = (gint64) timer->window * G_USEC_PER_SEC;
+    deadline = now + (gint64) timer->interval * G_USEC_PER_SEC;
+    timer->deadline = ((deadline + window - 1) / window) * window;
+    timer->iter = g_sequence_insert_sorted (timer_queue->queue, timer, (GCompareDataFunc) timer_cmp, NULL);
+}
+
+static void
+timer_queue_update_ready_time (void)
+{
+    GSequenceIter *iter;
+
+    /* Updated once the dispatch is over */
+    if (timer_queue->dispatching)
+        return;
+
+    iter = g_sequence_get_begin_iter (timer_queue->queue);
+    g_source_set_ready_time (timer_queue->source,
+                             g_sequence_iter_is_end (iter) ? -1 : ((Timer *) g_sequence_get (iter))->deadline);
+}
+
+static gboolean
+timer_source_dispatch (GSource     *source,
+                       GSourceFunc  callback,
+                       gpointer     user_data)
+{
+    gint64 now;
+
+    now = g_get_monotonic_time ();
+    timer_queue->n_wakeups++;
+
+    /* Run all expired timers in the same wakeup */
+    while (TRUE) {
+        GSequenceIter      *iter;
+        Timer              *timer;
+        gboolean            keep;
+        MMMainLoopDispatch  dispatch;
+
+        iter = g_sequence_get_begin_iter (timer_queue->queue);
+        if (g_sequence_iter_is_end (iter))
+            break;
+        timer = g_sequence_get (iter);
+        if (timer->deadline > now)
+            break;
+
+        g_sequence_remove (iter);
+        timer->iter = NULL;
+
+        timer_queue->dispatching = timer;
+        mm_main_loop_monitor_dispatch_begin (&dispatch, timer->deadline);
+        keep = timer->function (timer->user_data);
+        mm_main_loop_monitor_dispatch_end (&dispatch,
+                                           MM_MAIN_LOOP_HANDLER_TIMER,
+                                           timer->tag ? timer->tag : class_tags[timer->timer_class]);
+        timer_queue->dispatching = NULL;
+        timer_queue->n_callbacks++;
+
+        if (!keep || timer->removed) {
+            g_hash_table_remove (timer_queue->timers, GUINT_TO_POINTER (timer->id));
+            continue;
+        }
+
+        /* The new deadline is always in the future, so the loop ends */
+        timer_schedule (timer, now);
+    }
+
+    timer_queue_update_ready_time ();
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs timer_source_funcs = {
+    .dispatch = timer_source_dispatch,
+};
+
+static void
+timer_queue_init (void)
+{
+    timer_queue = g_slice_new0 (TimerQueue);
+    timer_queue->queue = g_sequence_new (NULL);
+    timer_queue->timers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) timer_free);
+
+    timer_queue->source = g_source_new (&timer_source_funcs, sizeof (GSource));
+    g_source_set_name (timer_queue->source, "[mm] coalesced timers");
+    g_source_attach (timer_queue->source, NULL);
+}
+
+/*****************************************************************************/
+
+guint
+mm_timer_add_seconds_full (MMTimerClass    timer_class,
+                           MMLogObject    *owner,
+                           guint           interval,
+                           GSourceFunc     function,
+                           gpointer        user_data,
+                           GDestroyNotify  notify)
+{
+    Timer *timer;
+
+    g_return_val_if_fail (timer_class < G_N_ELEMENTS (class_windows), 0);
+    g_return_val_if_fail (!owner || MM_IS_LOG_OBJECT (owner), 0);
+    g_return_val_if_fail (interval > 0, 0);
+    g_return_val_if_fail (function != NULL, 0);
+
+    if (!timer_queue)
+        timer_queue_init ();
+
+    timer = g_slice_new0 (Timer);
+    timer->timer_class = timer_class;
+    timer->interval = interval;
+    timer->function = function;
+    timer->user_data = user_data;
+    timer->notify = notify;
+    /* The log id of the owner never changes once built */
+    if (owner)
+        timer->tag = g_strdup (mm_log_object_get_id (owner));
+
+    /* Never delay a timer by more than half its interval */
+    timer->window = class_windows[timer_class];
+    while (timer->window > 1 && 2 * timer->window > interval)
+        timer->window /= 2;
+
+    do {
+        timer->id = ++timer_queue->last_id;
+    } while (!timer->id || g_hash_table_contains (timer_queue->timers, GUINT_TO_POINTER (timer->id)));
+
+    g_hash_table_insert (timer_queue->timers, GUINT_TO_POINTER (timer->id), timer);
+    timer_schedule (timer, g_get_monotonic_time ());
+    timer_queue_update_ready_time ();
+
+    return timer->id;
+}
+
+guint
+mm_timer_add_seconds (MMTimerClass  timer_class,
+                      MMLogObject  *owner,
+                      guint         interval,
+                      GSourceFunc   function,
+                      gpointer      user_data)
+{
+    return mm_timer_add_seconds_full (timer_class, owner, interval, function, user_data, NULL);
+}
+
+void
+mm_timer_remove (guint id)
+{
+    Timer *timer = NULL;
+
+    if (timer_queue)
+        timer = g_hash_table_lookup (timer_queue->timers, GUINT_TO_POINTER (id));
+    g_return_if_fail (timer != NULL);
+
+    /* The timer being dispatched is freed once its callback returns */
+    if (timer == timer_queue->dispatching) {
+        timer->removed = TRUE;
+        return;
+    }
+
+    g_sequence_remove (timer->iter);
+    g_hash_table_remove (timer_queue->timers, GUINT_TO_POINTER (id));
+    timer_queue_update_ready_time ();
+}
+
+void
+mm_timer_get_stats (guint   *out_n_timers,
+                    guint64 *out_n_wakeups,
+                    guint64 *out_n_callbacks)
+{
+    if (out_n_timers)
+        *out_n_timers = timer_queue ? g_hash_table_size (timer_queue->timers) : 0;
+    if (out_n_wakeups)
+        *out_n_wakeups = timer_queue ? timer_queue->n_wakeups : 0;
+    if (out_n_callbacks)
+        *out_n_callbacks = timer_queue ? timer_queue->n_callbacks : 0;
+}
@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#ifndef MM_TIMER_H
+#define MM_TIMER_H
+
+#include <glib.h>
+
+#include "mm-log-object.h"
+
+/*
+ * Coalesced timers for periodic work, e.g. polling the modem state.
+ *
+ * All timers are driven by a single GSource in the default main context,
+ * which only wakes up at the earliest pending deadline. Deadlines are rounded
+ * up to the coalescing window of the timer class, so timers of different
+ * modems and interfaces expire together instead of each one waking up the
+ * main loop on its own. A timer is never delayed by more than half its
+ * interval.
+ *
+ * The semantics are those of g_timeout_add_seconds(): the callback is run
+ * again after the same interval as long as it returns G_SOURCE_CONTINUE.
+ * Timers must only be used from the main thread.
+ *
+ * The dispatches of each timer are tagged in the main loop stats with the log
+ * id of its owner (e.g. the modem or bearer), or with the timer class if the
+ * timer has no owner.
+ */
+
+typedef enum {
+    /* Rounded to the second, like g_timeout_add_seconds() */
+    MM_TIMER_CLASS_DEFAULT = 0,
+    /* Periodic checks of the modem state, coalesced in 5s windows */
+    MM_TIMER_CLASS_POLLING = 1,
+    /* Statistics updates, coalesced in 10s windows */
+    MM_TIMER_CLASS_STATS   = 2,
+} MMTimerClass;
+
+guint mm_timer_add_seconds      (MMTimerClass    timer_class,
+                                 MMLogObject    *owner,
+                                 guint           interval,
+                                 GSourceFunc     function,
+                                 gpointer        user_data);
+guint mm_timer_add_seconds_full (MMTimerClass    timer_class,
+                                 MMLogObject    *owner,
+                                 guint           interval,
+                                 GSourceFunc     function,
+                                 gpointer        user_data,
+                                 GDestroyNotify  notify);
+
+/* May be called from the callback of the timer being removed */
+void  mm_timer_remove           (guint           id);
+
+/* Number of pending timers, number of times the timer source woke up the main
+ * loop and number of callbacks run in those wakeups */
+void  mm_timer_get_stats        (guint          *out_n_timers,
+                                 guint64        *out_n_wakeups,
+                                 guint64        *out_n_callbacks);
+
+#endif /* MM_TIMER_H */
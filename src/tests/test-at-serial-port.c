@@ -15,7 +15,13 @@
 
 #include <config.h>
 #include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
 #include <glib.h>
+#include <glib-unix.h>
 
 #include "mm-port-serial-at.h"
 #include "mm-serial-parsers.h"
@@ -106,6 +112,50 @@ at_serial_echo_removal (void)
     }
 }
 
+typedef struct {
+    const gchar        *pattern;
+    GRegexCompileFlags  flags;
+    const gchar        *prefix;
+} UnsolicitedMsgPrefixTest;
+
+static const UnsolicitedMsgPrefixTest unsolicited_msg_prefix_tests[] = {
+    { "\\r\\n\\+CREG: (.*)\\r\\n",                    G_REGEX_RAW,      "+CREG:" },
+    { "\\r\\n\\+CLIP:\\s*([^,\\s]*)\\r\\n",           G_REGEX_RAW,      "+CLIP:" },
+    { "\\r\\n\\^MODE:(.*)\\r\\n",                     G_REGEX_RAW,      "^MODE:" },
+    { "\r\n\\+CIEV: (.*)\r\n",                        G_REGEX_RAW,      "+CIEV:" },
+    { "\\r\\nRING\\r\\n",                             G_REGEX_RAW,      "RING" },
+    { "\\r\\n\\+ZEND\\r\\n",                          G_REGEX_RAW,      "+ZEND" },
+    { "\\r\\n\\^SYSSTART.*\\r\\n",                    G_REGEX_RAW,      "^SYSSTART" },
+    { "\\r\\n\\+CREG: (.*)\\r\\n",                    G_REGEX_CASELESS, NULL },
+    { "\\+CREG: (.*)\\r\\n",                          G_REGEX_RAW,      NULL },
+    { "\\r?\\n\\+CREG: (.*)\\r\\n",                   G_REGEX_RAW,      NULL },
+    { "\\r\\n(\\+CREG|\\+CGREG): (.*)\\r\\n",         G_REGEX_RAW,      NULL },
+    { "\\r\\n\\+CREG: (.*)\\r\\n|\\r\\n\\+CGREG: .*", G_REGEX_RAW,      NULL },
+    { "\\r\\n(NO CARRIER|BUSY)\\r\\n",                G_REGEX_RAW,      NULL },
+};
+
+static void
+at_serial_unsolicited_msg_prefix (void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (unsolicited_msg_prefix_tests); i++) {
+        GRegex *regex;
+        gchar  *prefix;
+
+        regex = g_regex_new (unsolicited_msg_prefix_tests[i].pattern,
+                             unsolicited_msg_prefix_tests[i].flags,
+                             0, NULL);
+        g_assert (regex);
+
+        prefix = mm_port_serial_at_get_unsolicited_msg_prefix (regex);
+        g_assert_cmpstr (prefix, ==, unsolicited_msg_prefix_tests[i].prefix);
+
+        g_free (prefix);
+        g_regex_unref (regex);
+    }
+}
+
 static void
 _run_parse_test (const ParseResponseTest tests[], guint number_of_tests)
 {
@@ -118,7 +168,7 @@ _run_parse_test (const ParseResponseTest tests[], guint number_of_tests)
     for (i = 0; i < number_of_tests; i++) {
         parser = mm_serial_parser_v1_new ();
         response = g_string_new (tests[i].response);
-        found = mm_serial_parser_v1_parse (parser, response, NULL, &error);
+        found = mm_serial_parser_v1_parse (parser, response, 0, NULL, &error);
 
         /* Verify if we expect a match or not */
         g_assert_cmpint (found, ==, tests[i].found);
@@ -149,13 +199,783 @@ at_serial_parse_error (void)
     _run_parse_test (parse_error_tests, G_N_ELEMENTS(parse_error_tests));
 }
 
+/*****************************************************************************/
+/* Long replies received in chunks */
+
+#define CMGL_PDU "07914306073011F0040B914316709807F40000" \
+                 "022070312100001AD4F29C0E8AC966B49C0DBA97D9E9F2F99C76B3E36EBC0B"
+
+static GString *
+build_cmgl_listing (gsize size)
+{
+    GString *listing;
+    guint    i;
+
+    listing = g_string_sized_new (size + 256);
+    for (i = 0; listing->len < size; i++)
+        g_string_append_printf (listing, "\r\n+CMGL: %u,1,,%u\r\n%s", i, (guint) (strlen (CMGL_PDU) / 2), CMGL_PDU);
+    g_string_append (listing, "\r\n\r\nOK\r\n");
+    return listing;
+}
+
+static gdouble
+feed_cmgl_listing (gsize listing_size,
+                   gsize chunk_size)
+{
+    GString  *listing;
+    GString  *response;
+    gpointer  parser;
+    gsize     offset;
+    gdouble   elapsed;
+    GError   *error = NULL;
+    gboolean  found = FALSE;
+
+    listing = build_cmgl_listing (listing_size);
+    response = g_string_sized_new (listing->len);
+    parser = mm_serial_parser_v1_new ();
+
+    g_test_timer_start ();
+    for (offset = 0; offset < listing->len; offset += chunk_size) {
+        g_string_append_len (response, &listing->str[offset], MIN (chunk_size, listing->len - offset));
+        found = mm_serial_parser_v1_parse (parser, response, 1, NULL, &error);
+        g_assert_no_error (error);
+        if (found)
+            break;
+    }
+    elapsed = g_test_timer_elapsed ();
+
+    /* Only the full listing is a valid response */
+    g_assert (found);
+    g_assert_cmpuint (offset + chunk_size, >=, listing->len);
+    g_assert (g_str_has_prefix (response->str, "+CMGL: 0,1,,"));
+    g_assert (strstr (response->str, "OK") == NULL);
+
+    mm_serial_parser_v1_destroy (parser);
+    g_string_free (response, TRUE);
+    g_string_free (listing, TRUE);
+
+    return elapsed;
+}
+
+static void
+at_serial_parse_chunked (void)
+{
+    feed_cmgl_listing (4096, 1);
+    feed_cmgl_listing (4096, 16);
+    feed_cmgl_listing (4096, 512);
+}
+
+static void
+at_serial_parse_generation (void)
+{
+    GString  *response;
+    gpointer  parser;
+    GError   *error = NULL;
+
+    parser = mm_serial_parser_v1_new ();
+    response = g_string_new ("\r\n+CPMS: 3,20\r\n");
+    g_assert (!mm_serial_parser_v1_parse (parser, response, 1, NULL, &error));
+    g_assert_no_error (error);
+
+    /* Contents replaced instead of appended to: a new generation forces the
+     * already scanned part to be looked at again */
+    g_string_assign (response, "\r\nOK\r\n+CMTI: \"SM\",3\r\n");
+    g_assert (mm_serial_parser_v1_parse (parser, response, 2, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_cmpstr (response->str, ==, "+CMTI: \"SM\",3");
+
+    mm_serial_parser_v1_destroy (parser);
+    g_string_free (response, TRUE);
+}
+
+static void
+at_serial_parse_chunked_perf (gconstpointer user_data)
+{
+    gsize   chunk_size = GPOINTER_TO_UINT (user_data);
+    gdouble elapsed;
+
+    elapsed = feed_cmgl_listing (64 * 1024, chunk_size);
+    g_test_minimized_result (elapsed,
+                             "64 KiB +CMGL listing in %" G_GSIZE_FORMAT "-byte chunks parsed in %.6f seconds",
+                             chunk_size, elapsed);
+}
+
+/*****************************************************************************/
+/* Synthetic modem session over a pty */
+
+/* Commands known by the synthetic modem; the first ones are the status
+ * polling commands, run periodically on every modem */
+#define N_POLLING_COMMANDS 4
+static const struct {
+    const gchar *command;
+    const gchar *reply;
+} session_commands[] = {
+    { "+CSQ",   "\r\n+CSQ: 21,99\r\n\r\nOK\r\n" },
+    { "+CREG?", "\r\n+CREG: 0,1\r\n\r\nOK\r\n" },
+    { "+COPS?", "\r\n+COPS: 0,0,\"Operator\",7\r\n\r\nOK\r\n" },
+    { "+CIND?", "\r\n+CIND: 5,3,1,0,0,0,1,0\r\n\r\nOK\r\n" },
+    { "+COPS=?", "\r\n+COPS: (2,\"Operator\",\"Op\",\"21401\",7)\r\n\r\nOK\r\n" },
+    { "+COPS=0", "\r\nOK\r\n" },
+    /* Replied with the session long reply */
+    { "+CMGL=4", NULL },
+};
+
+typedef struct {
+    GMainLoop      *loop;
+    MMPortSerialAt *port;
+    gint            main_fd;
+    guint           watch_id;
+    GString        *request;
+    guint           n_commands;
+    guint           i;
+    GAsyncResult   *last_result;
+    /* The reply to this command is held until explicitly released */
+    const gchar    *hold;
+    const gchar    *held_reply;
+    /* Replies are written at once, or in chunks of this size, one per main
+     * loop iteration, as received from slow devices */
+    const gchar    *long_reply;
+    gsize           chunk_size;
+    const gchar    *chunked_reply;
+    gsize           chunked_len;
+    gsize           chunked_offset;
+    guint           chunk_id;
+} Session;
+
+static gboolean
+session_write_chunk_cb (Session *session)
+{
+    gssize n;
+
+    n = write (session->main_fd,
+               &session->chunked_reply[session->chunked_offset],
+               MIN (session->chunk_size, session->chunked_len - session->chunked_offset));
+    if (n < 0) {
+        /* The port didn't read the previous chunks yet */
+        g_assert_cmpint (errno, ==, EAGAIN);
+        return G_SOURCE_CONTINUE;
+    }
+
+    session->chunked_offset += n;
+    if (session->chunked_offset < session->chunked_len)
+        return G_SOURCE_CONTINUE;
+
+    session->chunk_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void
+session_write_reply (Session     *session,
+                     const gchar *reply)
+{
+    if (!session->chunk_size) {
+        g_assert_cmpint (write (session->main_fd, reply, strlen (reply)), ==, strlen (reply));
+        return;
+    }
+
+    g_assert (!session->chunk_id);
+    session->chunked_reply = reply;
+    session->chunked_len = strlen (reply);
+    session->chunked_offset = 0;
+    session->chunk_id = g_idle_add ((GSourceFunc) session_write_chunk_cb, session);
+}
+
+static gboolean
+session_modem_cb (gint          fd,
+                  GIOCondition  condition,
+                  Session      *session)
+{
+    gchar   buf[64];
+    gssize  n;
+    gchar  *cr;
+
+    n = read (fd, buf, sizeof (buf));
+    if (n > 0)
+        g_string_append_len (session->request, buf, n);
+
+    /* Reply to each complete request */
+    while ((cr = memchr (session->request->str, '\r', session->request->len)) != NULL) {
+        guint i;
+
+        for (i = 0; i < G_N_ELEMENTS (session_commands); i++) {
+            if (strncmp (session->request->str + 2, session_commands[i].command, cr - session->request->str - 2) == 0) {
+                const gchar *reply;
+
+                reply = session_commands[i].reply ? session_commands[i].reply : session->long_reply;
+                g_assert (reply);
+                if (g_strcmp0 (session_commands[i].command, session->hold) == 0) {
+                    session->held_reply = reply;
+                    g_main_loop_quit (session->loop);
+                    break;
+                }
+                session_write_reply (session, reply);
+                break;
+            }
+        }
+        g_assert_cmpuint (i, <, G_N_ELEMENTS (session_commands));
+        g_string_erase (session->request, 0, cr - session->request->str + 1);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void session_run_next (Session *session);
+
+static void
+session_command_ready (MMPortSerialAt *port,
+                       GAsyncResult   *res,
+                       Session        *session)
+{
+    const gchar *response;
+    GError      *error = NULL;
+
+    if (session->i + 1 == session->n_commands)
+        session->last_result = g_object_ref (res);
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    g_assert (g_str_has_prefix (response, "+"));
+
+    /* Measure real round trips, not replies reused from the cache */
+    mm_port_serial_invalidate_cached_replies (MM_PORT_SERIAL (port), NULL, NULL);
+
+    session->i++;
+    session_run_next (session);
+}
+
+static void
+session_run_next (Session *session)
+{
+    if (session->i == session->n_commands) {
+        g_main_loop_quit (session->loop);
+        return;
+    }
+
+    mm_port_serial_at_command (session->port,
+                               session_commands[session->i % N_POLLING_COMMANDS].command,
+                               3,
+                               FALSE,
+                               FALSE,
+                               NULL,
+                               (GAsyncReadyCallback) session_command_ready,
+                               session);
+}
+
+static void
+session_init (Session *session)
+{
+    struct termios  stbuf;
+    gint            secondary_fd;
+    GError         *error = NULL;
+
+    memset (session, 0, sizeof (Session));
+
+    session->main_fd = posix_openpt (O_RDWR | O_NOCTTY);
+    g_assert_cmpint (session->main_fd, >=, 0);
+    g_assert_cmpint (grantpt (session->main_fd), ==, 0);
+    g_assert_cmpint (unlockpt (session->main_fd), ==, 0);
+    secondary_fd = open (ptsname (session->main_fd), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    g_assert_cmpint (secondary_fd, >=, 0);
+
+    memset (&stbuf, 0, sizeof (stbuf));
+    tcgetattr (secondary_fd, &stbuf);
+    cfmakeraw (&stbuf);
+    tcsetattr (secondary_fd, TCSANOW, &stbuf);
+    fcntl (session->main_fd, F_SETFL, O_NONBLOCK);
+
+    session->loop = g_main_loop_new (NULL, FALSE);
+    session->request = g_string_new (NULL);
+    session->watch_id = g_unix_fd_add (session->main_fd, G_IO_IN, (GUnixFDSourceFunc) session_modem_cb, session);
+
+    session->port = MM_PORT_SERIAL_AT (g_object_new (MM_TYPE_PORT_SERIAL_AT,
+                                                     MM_PORT_DEVICE, "pty",
+                                                     MM_PORT_SUBSYS, MM_PORT_SUBSYS_TTY,
+                                                     MM_PORT_TYPE, MM_PORT_TYPE_AT,
+                                                     MM_PORT_SERIAL_FD, secondary_fd,
+                                                     MM_PORT_SERIAL_SEND_DELAY, (guint64) 0,
+                                                     MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE,
+                                                     NULL));
+    mm_port_serial_at_set_response_parser (session->port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (session->port), &error));
+    g_assert_no_error (error);
+}
+
+static void
+session_run (Session *session,
+             guint    n_commands)
+{
+    session->n_commands = n_commands;
+    session->i = 0;
+    g_clear_object (&session->last_result);
+    session_run_next (session);
+    g_main_loop_run (session->loop);
+}
+
+static void
+session_release_held_reply (Session *session)
+{
+    g_assert (session->held_reply);
+    g_assert_cmpint (write (session->main_fd, session->held_reply, strlen (session->held_reply)), ==, strlen (session->held_reply));
+    session->held_reply = NULL;
+    session->hold = NULL;
+}
+
+static void
+session_clear (Session *session)
+{
+    mm_port_serial_close (MM_PORT_SERIAL (session->port));
+    g_object_unref (session->port);
+    g_source_remove (session->watch_id);
+    if (session->chunk_id)
+        g_source_remove (session->chunk_id);
+    g_clear_object (&session->last_result);
+    g_string_free (session->request, TRUE);
+    g_main_loop_unref (session->loop);
+    close (session->main_fd);
+}
+
+static void
+at_serial_command (void)
+{
+    Session                   session;
+    MMPortSerialAtParseStats  stats;
+    const gchar              *response;
+    GBytes                   *taken;
+    GError                   *error = NULL;
+
+    session_init (&session);
+    session_run (&session, 2 * N_POLLING_COMMANDS);
+
+    /* A single parse buffer per response, which is the one handed out */
+    mm_port_serial_at_get_parse_stats (session.port, &stats);
+    g_assert_cmpuint (stats.n_buffers, ==, 2 * N_POLLING_COMMANDS);
+
+    /* The borrowed response lives as long as the result */
+    g_assert (session.last_result);
+    response = mm_port_serial_at_command_finish (session.port, session.last_result, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (response, ==, "+CIND: 5,3,1,0,0,0,1,0");
+
+    /* And the taken one as long as needed, without a copy */
+    taken = mm_port_serial_at_command_take_response (session.port, session.last_result, &error);
+    g_assert_no_error (error);
+    g_assert (g_bytes_get_data (taken, NULL) == (gconstpointer) response);
+    g_clear_object (&session.last_result);
+    g_assert_cmpmem (g_bytes_get_data (taken, NULL), g_bytes_get_size (taken),
+                     "+CIND: 5,3,1,0,0,0,1,0", strlen ("+CIND: 5,3,1,0,0,0,1,0"));
+    g_bytes_unref (taken);
+
+    session_clear (&session);
+}
+
+typedef struct {
+    Session      *session;
+    GAsyncResult *results[2];
+    guint         n_results;
+} ZeroCopyContext;
+
+static void
+zero_copy_command_ready (MMPortSerialAt  *port,
+                         GAsyncResult    *res,
+                         ZeroCopyContext *ctx)
+{
+    /* Keep the results alive, so that a copied response could never be
+     * allocated where a previous one was */
+    ctx->results[ctx->n_results++] = g_object_ref (res);
+    g_main_loop_quit (ctx->session->loop);
+}
+
+static void
+at_serial_command_zero_copy (void)
+{
+    Session          session;
+    ZeroCopyContext  ctx = { 0 };
+    const gchar     *responses[2];
+    GError          *error = NULL;
+    guint            i;
+
+    session_init (&session);
+    ctx.session = &session;
+
+    /* The second query is completed with the cached reply to the first one,
+     * so both responses are the same buffer if neither was copied on the
+     * way to the caller */
+    for (i = 0; i < G_N_ELEMENTS (ctx.results); i++) {
+        mm_port_serial_at_command_full (session.port, "+CSQ", 3, FALSE, MM_PORT_SERIAL_CACHE_MODE_ANY,
+                                        MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                        NULL, (GAsyncReadyCallback) zero_copy_command_ready, &ctx);
+        g_main_loop_run (session.loop);
+    }
+    g_assert_cmpuint (ctx.n_results, ==, 2);
+
+    for (i = 0; i < G_N_ELEMENTS (ctx.results); i++) {
+        responses[i] = mm_port_serial_at_command_finish (session.port, ctx.results[i], &error);
+        g_assert_no_error (error);
+        g_assert_cmpstr (responses[i], ==, "+CSQ: 21,99");
+    }
+    g_assert (responses[0] == responses[1]);
+
+    for (i = 0; i < G_N_ELEMENTS (ctx.results); i++)
+        g_object_unref (ctx.results[i]);
+    session_clear (&session);
+}
+
+typedef struct {
+    Session               *session;
+    GString               *order;
+    guint                  n_pending;
+    MMPortSerialCacheMode  cache_mode;
+} PriorityContext;
+
+static void
+priority_command_ready (MMPortSerialAt  *port,
+                        GAsyncResult    *res,
+                        PriorityContext *ctx)
+{
+    const gchar *response;
+    GError      *error = NULL;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    g_string_append_len (ctx->order, response, strchr (response, ':') - response);
+    g_string_append_c (ctx->order, ' ');
+
+    if (--ctx->n_pending == 0)
+        g_main_loop_quit (ctx->session->loop);
+}
+
+static void
+priority_command (PriorityContext             *ctx,
+                  const gchar                 *command,
+                  MMPortSerialCommandPriority  priority)
+{
+    ctx->n_pending++;
+    mm_port_serial_at_command_full (ctx->session->port,
+                                    command,
+                                    3,
+                                    FALSE,
+                                    ctx->cache_mode,
+                                    priority,
+                                    NULL,
+                                    (GAsyncReadyCallback) priority_command_ready,
+                                    ctx);
+}
+
+static void
+at_serial_command_priority (void)
+{
+    Session                session;
+    PriorityContext        ctx = { 0 };
+    MMPortSerialQueueStats stats;
+
+    session_init (&session);
+    ctx.session = &session;
+    ctx.order = g_string_new (NULL);
+
+    /* Nothing is sent until the main loop runs, so all these get sorted */
+    priority_command (&ctx, "+COPS?", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    priority_command (&ctx, "+CREG?", MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND);
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_POLLING);
+    priority_command (&ctx, "+CIND?", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    /* Same poll as an already queued one, coalesced */
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_POLLING);
+
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.depth, ==, 4);
+    g_assert_cmpuint (stats.n_coalesced, ==, 1);
+
+    g_main_loop_run (session.loop);
+    g_assert_cmpstr (ctx.order->str, ==, "+COPS +CIND +CSQ +CSQ +CREG ");
+
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.depth, ==, 0);
+    g_assert_cmpuint (stats.n_processed, ==, 4);
+    g_assert_cmpint (stats.max_wait, >=, 0);
+    g_assert_cmpint (stats.total_wait, >=, stats.max_wait);
+
+    g_string_free (ctx.order, TRUE);
+    session_clear (&session);
+}
+
+static void
+ciev_received (MMPortSerialAt *port,
+               GMatchInfo     *match_info,
+               Session        *session)
+{
+    g_main_loop_quit (session->loop);
+}
+
+static void
+at_serial_command_cached (void)
+{
+    Session                session;
+    PriorityContext        ctx = { 0 };
+    MMPortSerialQueueStats stats;
+    GRegex                *ciev_regex;
+
+    session_init (&session);
+    ctx.session = &session;
+    ctx.order = g_string_new (NULL);
+    ctx.cache_mode = MM_PORT_SERIAL_CACHE_MODE_RECENT;
+
+    ciev_regex = g_regex_new ("\\r\\n\\+CIEV: (\\d+),(\\d+)\\r\\n", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    mm_port_serial_at_add_unsolicited_msg_handler (session.port,
+                                                   ciev_regex,
+                                                   (MMPortSerialAtUnsolicitedMsgFn) ciev_received,
+                                                   &session,
+                                                   NULL);
+
+    /* The second query reuses the reply to the first one */
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.n_cache_hits, ==, 1);
+    g_assert_cmpuint (stats.n_processed, ==, 1);
+
+    /* Commands without a reply lifetime are never reused */
+    priority_command (&ctx, "+COPS=?", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    priority_command (&ctx, "+COPS=?", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.n_cache_hits, ==, 1);
+    g_assert_cmpuint (stats.n_processed, ==, 3);
+
+    /* An indicator change makes the cached signal quality stale */
+    g_assert_cmpint (write (session.main_fd, "\r\n+CIEV: 2,3\r\n", 14), ==, 14);
+    g_main_loop_run (session.loop);
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.n_cache_hits, ==, 1);
+    g_assert_cmpuint (stats.n_processed, ==, 4);
+
+    /* Recent replies are only reused when asked for */
+    ctx.cache_mode = MM_PORT_SERIAL_CACHE_MODE_NONE;
+    priority_command (&ctx, "+CSQ", MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT);
+    g_main_loop_run (session.loop);
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (session.port), &stats);
+    g_assert_cmpuint (stats.n_cache_hits, ==, 1);
+    g_assert_cmpuint (stats.n_processed, ==, 5);
+
+    g_assert_cmpstr (ctx.order->str, ==, "+CSQ +CSQ +COPS +COPS +CSQ +CSQ ");
+
+    g_regex_unref (ciev_regex);
+    g_string_free (ctx.order, TRUE);
+    session_clear (&session);
+}
+
+static void
+command_ready_quit (MMPortSerialAt *port,
+                    GAsyncResult   *res,
+                    GMainLoop      *loop)
+{
+    GError *error = NULL;
+
+    mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    g_main_loop_quit (loop);
+}
+
+static void
+at_serial_command_cached_invalidation (void)
+{
+    Session                primary;
+    Session                secondary;
+    MMPortSerialQueueStats stats;
+
+    session_init (&primary);
+    session_init (&secondary);
+    mm_port_serial_share_reply_cache (MM_PORT_SERIAL (primary.port), MM_PORT_SERIAL (secondary.port));
+
+    /* Deregistration sent on the primary port, the modem doesn't reply yet */
+    primary.hold = "+COPS=0";
+    mm_port_serial_at_command_full (primary.port, "+COPS=0", 3, FALSE, MM_PORT_SERIAL_CACHE_MODE_NONE,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                    NULL, (GAsyncReadyCallback) command_ready_quit, primary.loop);
+    g_main_loop_run (primary.loop);
+
+    /* The registration queried meanwhile on the secondary port gets cached */
+    mm_port_serial_at_command_full (secondary.port, "+COPS?", 3, FALSE, MM_PORT_SERIAL_CACHE_MODE_RECENT,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                    NULL, (GAsyncReadyCallback) command_ready_quit, primary.loop);
+    g_main_loop_run (primary.loop);
+
+    /* Once the deregistration is done, that reply is stale */
+    session_release_held_reply (&primary);
+    g_main_loop_run (primary.loop);
+
+    mm_port_serial_at_command_full (secondary.port, "+COPS?", 3, FALSE, MM_PORT_SERIAL_CACHE_MODE_RECENT,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_DEFAULT,
+                                    NULL, (GAsyncReadyCallback) command_ready_quit, primary.loop);
+    g_main_loop_run (primary.loop);
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (secondary.port), &stats);
+    g_assert_cmpuint (stats.n_cache_hits, ==, 0);
+    g_assert_cmpuint (stats.n_processed, ==, 2);
+
+    session_clear (&secondary);
+    session_clear (&primary);
+}
+
+static void
+long_reply_ready (MMPortSerialAt *port,
+                  GAsyncResult   *res,
+                  Session        *session)
+{
+    const gchar *response;
+    GError      *error = NULL;
+
+    /* Only the full listing is a valid response */
+    response = mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    g_assert (g_str_has_prefix (response, "+CMGL: 0,1,,"));
+    g_assert (strstr (response, "OK") == NULL);
+    g_main_loop_quit (session->loop);
+}
+
+/* Runs +CMGL=4, replied with the listing in chunks, and gives the parse
+ * stats of the reply */
+static void
+session_run_long_reply (Session                  *session,
+                        const gchar              *listing,
+                        gsize                     chunk_size,
+                        MMPortSerialAtParseStats *stats)
+{
+    MMPortSerialAtParseStats before;
+    MMPortSerialAtParseStats after;
+
+    session->long_reply = listing;
+    session->chunk_size = chunk_size;
+
+    mm_port_serial_at_get_parse_stats (session->port, &before);
+    mm_port_serial_at_command (session->port, "+CMGL=4", 60, FALSE, FALSE, NULL,
+                               (GAsyncReadyCallback) long_reply_ready, session);
+    g_main_loop_run (session->loop);
+    mm_port_serial_at_get_parse_stats (session->port, &after);
+
+    session->long_reply = NULL;
+    session->chunk_size = 0;
+
+    stats->n_copied = after.n_copied - before.n_copied;
+    stats->n_buffers = after.n_buffers - before.n_buffers;
+    stats->n_grows = after.n_grows - before.n_grows;
+}
+
+static void
+at_serial_command_chunked (void)
+{
+    Session                  session;
+    MMPortSerialAtParseStats stats;
+    GString                 *listing;
+    gsize                    chunk_sizes[] = { 16, 512 };
+    guint                    i;
+
+    listing = build_cmgl_listing (4096);
+    session_init (&session);
+
+    /* Each chunk received is copied just once to be parsed, always into the
+     * same buffer */
+    for (i = 0; i < G_N_ELEMENTS (chunk_sizes); i++) {
+        session_run_long_reply (&session, listing->str, chunk_sizes[i], &stats);
+        g_assert_cmpuint (stats.n_copied, ==, listing->len);
+        g_assert_cmpuint (stats.n_buffers, ==, 1);
+    }
+
+    session_clear (&session);
+    g_string_free (listing, TRUE);
+}
+
+static void
+at_serial_command_chunked_perf (gconstpointer user_data)
+{
+    gsize    chunk_size = GPOINTER_TO_UINT (user_data);
+    Session                  session;
+    MMPortSerialAtParseStats stats;
+    GString                 *listing;
+    gdouble                  elapsed;
+
+    listing = build_cmgl_listing (64 * 1024);
+    session_init (&session);
+
+    g_test_timer_start ();
+    session_run_long_reply (&session, listing->str, chunk_size, &stats);
+    elapsed = g_test_timer_elapsed ();
+    g_test_minimized_result (elapsed,
+                             "64 KiB +CMGL reply in %" G_GSIZE_FORMAT "-byte chunks received in %.6f seconds",
+                             chunk_size, elapsed);
+    g_test_message ("%" G_GUINT64_FORMAT " bytes copied to parse a %" G_GSIZE_FORMAT "-byte reply, "
+                    "%" G_GUINT64_FORMAT " parse buffer allocations",
+                    stats.n_copied, listing->len, stats.n_buffers + stats.n_grows);
+
+    session_clear (&session);
+    g_string_free (listing, TRUE);
+}
+
+#define N_SESSION_COMMANDS 4000
+
+static void
+at_serial_command_perf (void)
+{
+    Session                  session;
+    MMPortSerialAtParseStats before;
+    MMPortSerialAtParseStats after;
+    gdouble                  elapsed;
+    gdouble                  n_allocations;
+
+    session_init (&session);
+
+    /* Warm up, so that one-time setup (types, caches...) is left out */
+    session_run (&session, 2 * N_POLLING_COMMANDS);
+
+    mm_port_serial_at_get_parse_stats (session.port, &before);
+    g_test_timer_start ();
+    session_run (&session, N_SESSION_COMMANDS);
+    elapsed = g_test_timer_elapsed ();
+    mm_port_serial_at_get_parse_stats (session.port, &after);
+
+    /* Counted by the port itself instead of interposing the allocator,
+     * which would break ASan and valgrind */
+    n_allocations = (gdouble) ((after.n_buffers - before.n_buffers) + (after.n_grows - before.n_grows)) / N_SESSION_COMMANDS;
+    g_test_minimized_result (n_allocations,
+                             "%.2f parse buffer allocations per AT command",
+                             n_allocations);
+    g_test_minimized_result (elapsed,
+                             "%u AT commands run in %.6f seconds",
+                             N_SESSION_COMMANDS, elapsed);
+
+    session_clear (&session);
+}
+
 int main (int argc, char **argv)
 {
     g_test_init (&argc, &argv, NULL);
 
     g_test_add_func ("/ModemManager/AT-serial/echo-removal", at_serial_echo_removal);
+    g_test_add_func ("/ModemManager/AT-serial/unsolicited-msg-prefix", at_serial_unsolicited_msg_prefix);
     g_test_add_func ("/ModemManager/AT-serial/parse-ok", at_serial_parse_ok);
     g_test_add_func ("/ModemManager/AT-serial/parse-error", at_serial_parse_error);
+    g_test_add_func ("/ModemManager/AT-serial/parse-chunked", at_serial_parse_chunked);
+    g_test_add_func ("/ModemManager/AT-serial/parse-generation", at_serial_parse_generation);
+    g_test_add_func ("/ModemManager/AT-serial/command", at_serial_command);
+    g_test_add_func ("/ModemManager/AT-serial/command-priority", at_serial_command_priority);
+    g_test_add_func ("/ModemManager/AT-serial/command-cached", at_serial_command_cached);
+    g_test_add_func ("/ModemManager/AT-serial/command-cached-invalidation", at_serial_command_cached_invalidation);
+    g_test_add_func ("/ModemManager/AT-serial/command-zero-copy", at_serial_command_zero_copy);
+    g_test_add_func ("/ModemManager/AT-serial/command-chunked", at_serial_command_chunked);
+
+    if (g_test_perf ()) {
+        g_test_add_data_func ("/ModemManager/AT-serial/perf/parse-chunked/1", GUINT_TO_POINTER (1), at_serial_parse_chunked_perf);
+        g_test_add_data_func ("/ModemManager/AT-serial/perf/parse-chunked/16", GUINT_TO_POINTER (16), at_serial_parse_chunked_perf);
+        g_test_add_data_func ("/ModemManager/AT-serial/perf/parse-chunked/512", GUINT_TO_POINTER (512), at_serial_parse_chunked_perf);
+        g_test_add_data_func ("/ModemManager/AT-serial/perf/command-chunked/16", GUINT_TO_POINTER (16), at_serial_command_chunked_perf);
+        g_test_add_data_func ("/ModemManager/AT-serial/perf/command-chunked/512", GUINT_TO_POINTER (512), at_serial_command_chunked_perf);
+        g_test_add_func ("/ModemManager/AT-serial/perf/command", at_serial_command_perf);
+    }
 
     return g_test_run ();
 }
@@ -316,6 +316,199 @@ test_gsm7_pack_7_chars_offset (void)
     g_free (packed);
 }
 
+/* Bit by bit implementations, to validate the block based ones */
+
+static guint8 *
+gsm7_pack_reference (const guint8 *src,
+                     guint32       src_len,
+                     guint8        start_offset,
+                     guint32      *out_packed_len)
+{
+    guint8 *packed;
+    guint32 plen;
+    guint32 i;
+
+    plen = ((src_len * 7) + start_offset + 7) / 8;
+    packed = g_malloc0 (plen);
+    for (i = 0; i < src_len * 7; i++) {
+        guint32 bit = start_offset + i;
+
+        if (src[i / 7] & (1 << (i % 7)))
+            packed[bit / 8] |= 1 << (bit % 8);
+    }
+
+    *out_packed_len = plen;
+    return packed;
+}
+
+static guint8 *
+gsm7_unpack_reference (const guint8 *gsm,
+                       guint32       num_septets,
+                       guint8        start_offset)
+{
+    guint8 *unpacked;
+    guint32 i;
+
+    unpacked = g_malloc0 (num_septets);
+    for (i = 0; i < num_septets * 7; i++) {
+        guint32 bit = start_offset + i;
+
+        if (gsm[bit / 8] & (1 << (bit % 8)))
+            unpacked[i / 7] |= 1 << (i % 7);
+    }
+
+    return unpacked;
+}
+
+static void
+test_gsm7_pack_unpack_random (void)
+{
+    guint8 src[300];
+    guint32 len;
+    guint8 start_offset;
+
+    for (len = 0; len < G_N_ELEMENTS (src); len++) {
+        guint32 i;
+
+        for (i = 0; i < len; i++)
+            src[i] = g_test_rand_int_range (0, 0x80);
+
+        for (start_offset = 0; start_offset < 8; start_offset++) {
+            g_autofree guint8 *packed = NULL;
+            g_autofree guint8 *expected_packed = NULL;
+            g_autofree guint8 *unpacked = NULL;
+            g_autofree guint8 *expected_unpacked = NULL;
+            guint32 packed_len = 0;
+            guint32 expected_packed_len = 0;
+            guint32 unpacked_len = 0;
+
+            packed = mm_charset_gsm_pack (src, len, start_offset, &packed_len);
+            expected_packed = gsm7_pack_reference (src, len, start_offset, &expected_packed_len);
+            g_assert_cmpuint (packed_len, ==, expected_packed_len);
+            g_assert_cmpint (memcmp (packed, expected_packed, packed_len), ==, 0);
+
+            unpacked = mm_charset_gsm_unpack (packed, len, start_offset, &unpacked_len);
+            expected_unpacked = gsm7_unpack_reference (packed, len, start_offset);
+            g_assert_cmpuint (unpacked_len, ==, len);
+            g_assert_cmpint (memcmp (unpacked, expected_unpacked, len), ==, 0);
+            g_assert_cmpint (memcmp (unpacked, src, len), ==, 0);
+        }
+    }
+}
+
+static void
+test_gsm7_all_chars_round_trip (void)
+{
+    g_autoptr(GHashTable) gsm_chars = NULL;
+    guint8                c;
+    gunichar              uc;
+
+    gsm_chars = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* Every char of both alphabets converts to UTF-8 and back; a trailing
+     * char is added so that '@' isn't taken as end of string */
+    for (c = 0; c < 0x80; c++) {
+        const guint8 def[] = { c, 'A' };
+        const guint8 ext[] = { 0x1b, c, 'A' };
+        guint        i;
+
+        for (i = 0; i < 2; i++) {
+            g_autoptr(GByteArray)  gsm = NULL;
+            g_autoptr(GByteArray)  gsm_2 = NULL;
+            g_autoptr(GError)      error = NULL;
+            g_autofree gchar      *utf8 = NULL;
+
+            if (i == 0 && c == 0x1b)
+                continue;
+
+            gsm = i == 0 ? g_byte_array_append (g_byte_array_new (), def, sizeof (def)) :
+                           g_byte_array_append (g_byte_array_new (), ext, sizeof (ext));
+            utf8 = mm_modem_charset_bytearray_to_utf8 (gsm, MM_MODEM_CHARSET_GSM, FALSE, &error);
+
+            /* Not all chars exist in the extended alphabet */
+            if (i == 1 && !utf8) {
+                g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+                continue;
+            }
+            g_assert_no_error (error);
+            g_assert_nonnull (utf8);
+            g_assert_cmpint (g_utf8_strlen (utf8, -1), ==, 2);
+
+            g_hash_table_add (gsm_chars, GUINT_TO_POINTER (g_utf8_get_char (utf8)));
+
+            gsm_2 = mm_modem_charset_bytearray_from_utf8 (utf8, MM_MODEM_CHARSET_GSM, FALSE, &error);
+            g_assert_no_error (error);
+            g_assert_nonnull (gsm_2);
+            g_assert_cmpuint (gsm_2->len, ==, gsm->len);
+            g_assert_cmpint (memcmp (gsm_2->data, gsm->data, gsm->len), ==, 0);
+        }
+    }
+    g_assert_cmpuint (g_hash_table_size (gsm_chars), ==, 127 + 10);
+
+    /* And nothing else in the BMP can be converted */
+    for (uc = 1; uc < 0x10000; uc++) {
+        gchar utf8[7] = { 0 };
+
+        if (uc >= 0xd800 && uc <= 0xdfff)
+            continue;
+        g_unichar_to_utf8 (uc, utf8);
+        g_assert (mm_charset_can_convert_to (utf8, MM_MODEM_CHARSET_GSM) ==
+                  g_hash_table_contains (gsm_chars, GUINT_TO_POINTER (uc)));
+    }
+}
+
+static void
+test_gsm7_pack_unpack_perf (void)
+{
+    g_autofree guint8 *src = NULL;
+    guint32            len = 64 * 1024;
+    guint32            i;
+    guint              n;
+    gdouble            elapsed;
+
+    src = g_malloc (len);
+    for (i = 0; i < len; i++)
+        src[i] = g_test_rand_int_range (0, 0x80);
+
+    g_test_timer_start ();
+    for (n = 0; n < 100; n++) {
+        g_autofree guint8 *packed = NULL;
+        g_autofree guint8 *unpacked = NULL;
+        guint32            packed_len = 0;
+        guint32            unpacked_len = 0;
+
+        packed = mm_charset_gsm_pack (src, len, 0, &packed_len);
+        unpacked = mm_charset_gsm_unpack (packed, len, 0, &unpacked_len);
+        g_assert_cmpuint (unpacked_len, ==, len);
+    }
+    elapsed = g_test_timer_elapsed ();
+    g_test_minimized_result (elapsed, "100 x 64K septets packed and unpacked in %.6f seconds", elapsed);
+}
+
+static void
+test_gsm7_from_utf8_perf (void)
+{
+    g_autoptr(GString) text = NULL;
+    guint              n;
+    gdouble            elapsed;
+
+    text = g_string_new (NULL);
+    while (text->len < 64 * 1024)
+        g_string_append (text, "Some from the GSM7 basic set: a % Ψ Ω ñ ö è æ, and extended: {} [] ~ € | ");
+
+    g_test_timer_start ();
+    for (n = 0; n < 100; n++) {
+        g_autoptr(GByteArray) gsm = NULL;
+        g_autoptr(GError)     error = NULL;
+
+        g_assert (mm_charset_can_convert_to (text->str, MM_MODEM_CHARSET_GSM));
+        gsm = mm_modem_charset_bytearray_from_utf8 (text->str, MM_MODEM_CHARSET_GSM, FALSE, &error);
+        g_assert_no_error (error);
+    }
+    elapsed = g_test_timer_elapsed ();
+    g_test_minimized_result (elapsed, "100 x 64 KiB UTF-8 text checked and converted to GSM in %.6f seconds", elapsed);
+}
+
 static void
 test_str_ucs2_to_from_utf8 (void)
 {
@@ -464,6 +657,8 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/charsets/gsm7/pack/24-chars",          test_gsm7_pack_24_chars);
     g_test_add_func ("/MM/charsets/gsm7/pack/last-septet-alone", test_gsm7_pack_last_septet_alone);
     g_test_add_func ("/MM/charsets/gsm7/pack/7-chars-offset",    test_gsm7_pack_7_chars_offset);
+    g_test_add_func ("/MM/charsets/gsm7/pack-unpack/random",     test_gsm7_pack_unpack_random);
+    g_test_add_func ("/MM/charsets/gsm7/all-chars-round-trip",   test_gsm7_all_chars_round_trip);
 
     g_test_add_func ("/MM/charsets/str-from-to/ucs2",         test_str_ucs2_to_from_utf8);
     g_test_add_func ("/MM/charsets/str-from-to/gsm",          test_str_gsm_to_from_utf8);
@@ -471,5 +666,10 @@ int main (int argc, char **argv)
 
     g_test_add_func ("/MM/charsets/can-convert-to", test_charset_can_covert_to);
 
+    if (g_test_perf ()) {
+        g_test_add_func ("/MM/charsets/perf/gsm7/pack-unpack", test_gsm7_pack_unpack_perf);
+        g_test_add_func ("/MM/charsets/perf/gsm7/from-utf8",   test_gsm7_from_utf8_perf);
+    }
+
     return g_test_run ();
 }
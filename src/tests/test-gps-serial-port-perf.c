@@ -0,0 +1,502 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+/*
+ * Perf-only test comparing the processing of NMEA traces received in a GPS
+ * port, from the serial buffer to the NMEA and RAW location objects, with
+ * the regex based implementation used before the NMEA tokenizer.
+ *
+ * This is a separate binary because allocations are counted by overriding
+ * the malloc() family, which is only done with glibc and without
+ * sanitizers; otherwise only the time is reported.
+ */
+
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-port-serial-gps.h"
+#include "mm-serial-buffer.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+/* Allocation counting */
+
+#if defined (__GLIBC__) && !defined (__SANITIZE_ADDRESS__) && !defined (__SANITIZE_THREAD__)
+# define COUNT_ALLOCATIONS 1
+#endif
+#if defined (COUNT_ALLOCATIONS) && defined (__has_feature)
+# if __has_feature (address_sanitizer) || __has_feature (memory_sanitizer) || __has_feature (thread_sanitizer)
+#  undef COUNT_ALLOCATIONS
+# endif
+#endif
+
+static gboolean counting;
+static guint64  n_allocations;
+
+#if defined (COUNT_ALLOCATIONS)
+
+extern void *__libc_malloc  (size_t size);
+extern void *__libc_calloc  (size_t n, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+    if (counting)
+        n_allocations++;
+    return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n,
+        size_t size)
+{
+    if (counting)
+        n_allocations++;
+    return __libc_calloc (n, size);
+}
+
+void *
+realloc (void   *ptr,
+         size_t  size)
+{
+    if (counting)
+        n_allocations++;
+    return __libc_realloc (ptr, size);
+}
+
+#endif
+
+static void
+counting_start (void)
+{
+    n_allocations = 0;
+    counting = TRUE;
+    g_test_timer_start ();
+}
+
+static gdouble
+counting_stop (void)
+{
+    gdouble elapsed;
+
+    elapsed = g_test_timer_elapsed ();
+    counting = FALSE;
+    return elapsed;
+}
+
+static void
+report (const gchar *path,
+        guint        n_traces,
+        gdouble      elapsed,
+        gboolean     minimized)
+{
+    g_autofree gchar *allocations = NULL;
+
+#if defined (COUNT_ALLOCATIONS)
+    allocations = g_strdup_printf ("%.2f allocations per trace", (gdouble) n_allocations / n_traces);
+#else
+    allocations = g_strdup ("allocations not counted");
+#endif
+
+    if (minimized)
+        g_test_minimized_result (elapsed, "%s: %.0f traces/s, %s", path, n_traces / elapsed, allocations);
+    else
+        g_test_message ("%s: %.0f traces/s, %s", path, n_traces / elapsed, allocations);
+}
+
+/*****************************************************************************/
+/* Input: one hour of output of a receiver reporting once per second, each
+ * report read from the port at once */
+
+#define NMEA_SECONDS 3600
+#define NMEA_TRACES_PER_SECOND 6
+
+static GPtrArray *
+build_nmea_reads (void)
+{
+    GPtrArray *reads;
+    guint      i;
+
+    reads = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; i < NMEA_SECONDS; i++) {
+        g_autofree gchar *utc = NULL;
+        GString          *read;
+        gchar            *sentences[NMEA_TRACES_PER_SECOND];
+        guint             j;
+
+        utc = g_strdup_printf ("%02u%02u%02u.000", 16 + i / 3600, (i / 60) % 60, i % 60);
+        sentences[0] = g_strdup_printf ("GPGGA,%s,3723.%04u,N,12158.3416,W,1,07,1.0,9.0,M,,,,0000", utc, i % 10000);
+        sentences[1] = g_strdup_printf ("GPRMC,%s,A,3723.%04u,N,12158.3416,W,0.13,309.62,120598,,", utc, i % 10000);
+        sentences[2] = g_strdup ("GPGSA,A,3,07,02,26,27,09,04,15,,,,,,1.8,1.0,1.5");
+        sentences[3] = g_strdup ("GPGSV,3,1,11,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42");
+        sentences[4] = g_strdup ("GPGSV,3,2,11,09,23,313,42,04,19,159,41,15,12,041,42,08,09,200,37");
+        sentences[5] = g_strdup ("GPGSV,3,3,11,10,05,100,30,12,03,020,28,13,01,330,25");
+
+        read = g_string_new (NULL);
+        for (j = 0; j < G_N_ELEMENTS (sentences); j++) {
+            const gchar *p;
+            guint8       checksum = 0;
+
+            for (p = sentences[j]; *p; p++)
+                checksum ^= (guint8) *p;
+            g_string_append_printf (read, "$%s*%02X\r\n", sentences[j], checksum);
+            g_free (sentences[j]);
+        }
+        g_ptr_array_add (reads, g_string_free (read, FALSE));
+    }
+    return reads;
+}
+
+/*****************************************************************************/
+/* Previous implementation: known traces regex in the port, which duplicates
+ * each trace for the handler, and regex based location objects */
+
+typedef struct {
+    GRegex     *known_traces_regex;
+    /* NMEA location */
+    GRegex     *sequence_regex;
+    GHashTable *traces;
+    /* RAW location */
+    GRegex     *gga_regex;
+    gboolean    prefer_gngga;
+    gchar      *utc_time;
+    gdouble     latitude;
+    gdouble     longitude;
+    gdouble     altitude;
+    guint       n_traces;
+} Legacy;
+
+static gboolean
+legacy_nmea_append_or_replace (Legacy      *legacy,
+                               const gchar *trace)
+{
+    gboolean    append_or_replace = FALSE;
+    GMatchInfo *match_info = NULL;
+
+    if (g_regex_match (legacy->sequence_regex, trace, 0, &match_info)) {
+        guint index;
+
+        if (mm_get_uint_from_match_info (match_info, 2, &index) && index != 1)
+            append_or_replace = TRUE;
+    }
+    g_match_info_free (match_info);
+
+    return append_or_replace;
+}
+
+static void
+legacy_nmea_add_trace (Legacy      *legacy,
+                       const gchar *trace_str)
+{
+    gchar       *trace;
+    gchar       *i;
+    gchar       *trace_type;
+    const gchar *previous;
+
+    trace = g_strdup (trace_str);
+    i = strchr (trace, ',');
+    if (!i || i == trace) {
+        g_free (trace);
+        return;
+    }
+
+    trace_type = g_malloc (i - trace + 1);
+    memcpy (trace_type, trace, i - trace);
+    trace_type[i - trace] = '\0';
+
+    if (legacy_nmea_append_or_replace (legacy, trace)) {
+        previous = g_hash_table_lookup (legacy->traces, trace_type);
+        if (previous) {
+            gchar *sequence;
+
+            if (strstr (previous, trace)) {
+                g_free (trace_type);
+                g_free (trace);
+                return;
+            }
+
+            sequence = g_strdup_printf ("%s%s%s",
+                                        previous,
+                                        g_str_has_suffix (previous, "\r\n") ? "" : "\r\n",
+                                        trace);
+            g_free (trace);
+            trace = sequence;
+        }
+    }
+
+    g_hash_table_replace (legacy->traces, trace_type, trace);
+}
+
+static gboolean
+legacy_raw_get_degrees (GMatchInfo *match_info,
+                        guint32     match_index,
+                        gdouble    *out)
+{
+    g_autofree gchar *s = NULL;
+    gchar            *aux;
+    gdouble           minutes;
+    gdouble           degrees;
+
+    s = g_match_info_fetch (match_info, match_index);
+    if (!s)
+        return FALSE;
+
+    aux = strchr (s, '.');
+    if (!aux || ((aux - s) < 3))
+        return FALSE;
+
+    aux -= 2;
+    if (!mm_get_double_from_str (aux, &minutes))
+        return FALSE;
+
+    aux[0] = '\0';
+    if (!mm_get_double_from_str (s, &degrees))
+        return FALSE;
+
+    *out = degrees + (minutes / 60.0);
+    return TRUE;
+}
+
+static void
+legacy_raw_add_trace (Legacy      *legacy,
+                      const gchar *trace)
+{
+    GMatchInfo *match_info = NULL;
+
+    if (g_str_has_prefix (trace, "$GPGGA")) {
+        if (legacy->prefer_gngga)
+            return;
+    } else if (g_str_has_prefix (trace, "$GNGGA"))
+        legacy->prefer_gngga = TRUE;
+    else
+        return;
+
+    if (g_regex_match (legacy->gga_regex, trace, 0, &match_info)) {
+        g_free (legacy->utc_time);
+        legacy->utc_time = g_match_info_fetch (match_info, 1);
+
+        legacy->latitude = MM_LOCATION_LATITUDE_UNKNOWN;
+        if (legacy_raw_get_degrees (match_info, 2, &legacy->latitude)) {
+            g_autofree gchar *str = NULL;
+
+            str = g_match_info_fetch (match_info, 3);
+            if (str && str[0] == 'S')
+                legacy->latitude *= -1;
+        }
+
+        legacy->longitude = MM_LOCATION_LONGITUDE_UNKNOWN;
+        if (legacy_raw_get_degrees (match_info, 4, &legacy->longitude)) {
+            g_autofree gchar *str = NULL;
+
+            str = g_match_info_fetch (match_info, 5);
+            if (str && str[0] == 'W')
+                legacy->longitude *= -1;
+        }
+
+        legacy->altitude = MM_LOCATION_ALTITUDE_UNKNOWN;
+        mm_get_double_from_match_info (match_info, 9, &legacy->altitude);
+    }
+    g_match_info_free (match_info);
+}
+
+/* The trace handler, as in the location interface */
+static void
+legacy_trace_received (Legacy      *legacy,
+                       const gchar *trace)
+{
+    legacy->n_traces++;
+    legacy_nmea_add_trace (legacy, trace);
+    legacy_raw_add_trace (legacy, trace);
+}
+
+static GByteArray *
+legacy_parse_response (Legacy         *legacy,
+                       MMSerialBuffer *response)
+{
+    GMatchInfo   *match_info;
+    GByteArray   *parsed;
+    const guint8 *data;
+    const guint8 *dollar;
+    gsize         len;
+    gint          last_end = 0;
+
+    dollar = memchr (mm_serial_buffer_get_data (response), '$', mm_serial_buffer_get_len (response));
+    if (dollar)
+        mm_serial_buffer_consume (response, dollar - mm_serial_buffer_get_data (response));
+
+    data = mm_serial_buffer_get_data (response);
+    len = mm_serial_buffer_get_len (response);
+
+    if (!g_regex_match_full (legacy->known_traces_regex, (const gchar *) data, len, 0, 0, &match_info, NULL)) {
+        g_match_info_free (match_info);
+        return NULL;
+    }
+
+    parsed = g_byte_array_new ();
+    while (g_match_info_matches (match_info)) {
+        gint start;
+        gint end;
+
+        if (g_match_info_fetch_pos (match_info, 0, &start, &end)) {
+            gchar *trace;
+
+            trace = g_strndup ((const gchar *) &data[start], end - start);
+            legacy_trace_received (legacy, trace);
+            g_free (trace);
+            g_byte_array_append (parsed, &data[last_end], start - last_end);
+            last_end = end;
+        }
+        g_match_info_next (match_info, NULL);
+    }
+    g_byte_array_append (parsed, &data[last_end], len - last_end);
+    g_match_info_free (match_info);
+
+    mm_serial_buffer_clear (response);
+    return parsed;
+}
+
+static void
+legacy_init (Legacy *legacy)
+{
+    memset (legacy, 0, sizeof (*legacy));
+    legacy->known_traces_regex = g_regex_new ("\\$.*\\r\\n", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    legacy->sequence_regex = g_regex_new ("\\$..(?:ALM|GSV|RTE|SFI),(\\d),(\\d).*", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    legacy->gga_regex = g_regex_new ("\\$G(?:P|N)GGA,(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*),(.*)\\*(.*).*",
+                                     G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    legacy->traces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+static void
+legacy_clear (Legacy *legacy)
+{
+    g_regex_unref (legacy->known_traces_regex);
+    g_regex_unref (legacy->sequence_regex);
+    g_regex_unref (legacy->gga_regex);
+    g_hash_table_unref (legacy->traces);
+    g_free (legacy->utc_time);
+}
+
+/*****************************************************************************/
+/* Current implementation: the GPS port parser and the location objects fed
+ * with the sentence parsed by the port */
+
+typedef struct {
+    MMLocationGpsNmea *nmea;
+    MMLocationGpsRaw  *raw;
+    guint              n_traces;
+} Current;
+
+/* The trace handler, as in the location interface */
+static void
+current_trace_received (MMPortSerialGps      *port,
+                        const MMNmeaSentence *sentence,
+                        Current              *current)
+{
+    current->n_traces++;
+    mm_location_gps_nmea_add_sentence (current->nmea, sentence);
+    mm_location_gps_raw_add_sentence (current->raw, sentence);
+}
+
+/*****************************************************************************/
+
+static void
+test_nmea_perf (void)
+{
+    g_autoptr(GPtrArray)       reads = NULL;
+    g_autoptr(MMPortSerialGps) port = NULL;
+    g_autoptr(GError)          error = NULL;
+    MMSerialBuffer            *buffer;
+    Legacy                     legacy;
+    Current                    current = { 0 };
+    gdouble                    legacy_elapsed;
+    gdouble                    current_elapsed;
+    guint                      n_traces;
+    guint                      i;
+
+    reads = build_nmea_reads ();
+    n_traces = reads->len * NMEA_TRACES_PER_SECOND;
+
+    /* Previous implementation */
+    legacy_init (&legacy);
+    buffer = mm_serial_buffer_new (4096);
+    counting_start ();
+    for (i = 0; i < reads->len; i++) {
+        const gchar *read = g_ptr_array_index (reads, i);
+        GByteArray  *parsed;
+
+        mm_serial_buffer_append (buffer, (const guint8 *) read, strlen (read));
+        parsed = legacy_parse_response (&legacy, buffer);
+        if (parsed)
+            g_byte_array_unref (parsed);
+    }
+    legacy_elapsed = counting_stop ();
+    mm_serial_buffer_free (buffer);
+    g_assert_cmpuint (legacy.n_traces, ==, n_traces);
+    report ("regex port parser and location objects", n_traces, legacy_elapsed, FALSE);
+
+    /* Current implementation, through the port parser */
+    port = mm_port_serial_gps_new ("ttyGPS");
+    current.nmea = mm_location_gps_nmea_new ();
+    current.raw = mm_location_gps_raw_new ();
+    mm_port_serial_gps_add_trace_handler (port, (MMPortSerialGpsTraceFn) current_trace_received, &current, NULL);
+    buffer = mm_serial_buffer_new (4096);
+    counting_start ();
+    for (i = 0; i < reads->len; i++) {
+        const gchar *read = g_ptr_array_index (reads, i);
+        GByteArray  *parsed = NULL;
+
+        mm_serial_buffer_append (buffer, (const guint8 *) read, strlen (read));
+        g_assert_cmpint (MM_PORT_SERIAL_GET_CLASS (port)->parse_response (MM_PORT_SERIAL (port), buffer, &parsed, &error),
+                         ==, MM_PORT_SERIAL_RESPONSE_BUFFER);
+        g_byte_array_unref (parsed);
+    }
+    current_elapsed = counting_stop ();
+    g_assert_no_error (error);
+    mm_serial_buffer_free (buffer);
+    g_assert_cmpuint (current.n_traces, ==, n_traces);
+    report ("tokenizer port parser and location objects", n_traces, current_elapsed, TRUE);
+
+    /* Both end up with the same location */
+    g_assert_cmpstr (mm_location_gps_raw_get_utc_time (current.raw), ==, legacy.utc_time);
+    g_assert_cmpfloat (mm_location_gps_raw_get_latitude (current.raw), ==, legacy.latitude);
+    g_assert_cmpfloat (mm_location_gps_raw_get_longitude (current.raw), ==, legacy.longitude);
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (current.nmea, "$GPGGA"), ==,
+                     g_hash_table_lookup (legacy.traces, "$GPGGA"));
+    g_assert_cmpstr (mm_location_gps_nmea_get_trace (current.nmea, "$GPGSV"), ==,
+                     g_hash_table_lookup (legacy.traces, "$GPGSV"));
+
+    g_object_unref (current.nmea);
+    g_object_unref (current.raw);
+    legacy_clear (&legacy);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    if (g_test_perf ())
+        g_test_add_func ("/MM/gps-serial-port/perf/nmea", test_nmea_perf);
+
+    return g_test_run ();
+}
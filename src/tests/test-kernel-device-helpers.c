@@ -81,6 +81,29 @@ static const StringMatchTest string_match_tests[] = {
         .str     = "/sys/devices/pci0000:00/0000:00:1ff6/net/eno1",
         .match   = FALSE,
     },
+    /* Both prefix and suffix match */
+    {
+        .pattern = "*wwan*",
+        .str     = "/sys/devices/wwan0/wwan0at0",
+        .match   = TRUE,
+    },
+    {
+        .pattern = "*wwan*",
+        .str     = "/sys/devices/ttyUSB0",
+        .match   = FALSE,
+    },
+    /* Catch-all */
+    {
+        .pattern = "*",
+        .str     = "ttyUSB0",
+        .match   = TRUE,
+    },
+    /* Suffix longer than the string */
+    {
+        .pattern = "*MBIM",
+        .str     = "BIM",
+        .match   = FALSE,
+    },
 };
 
 static void
@@ -106,6 +129,115 @@ test_string_match (void)
 
 /*****************************************************************************/
 
+/* Synthetic kernel events for ports of multiple devices, simulating a hub
+ * reset where ports come and go in random order */
+
+#define PORT_INDEX_N_DEVICES          32
+#define PORT_INDEX_N_PORTS_PER_DEVICE 8
+#define PORT_INDEX_N_EVENTS           20000
+
+typedef struct {
+    gchar    *subsystem;
+    gchar    *name;
+    gchar    *sysfs_path;
+    gpointer  owner;
+} PortIndexSlot;
+
+static void
+port_index_check_slot (MMKernelDevicePortIndex *port_index,
+                       PortIndexSlot           *slot)
+{
+    g_assert (mm_kernel_device_port_index_lookup_name (port_index, slot->subsystem, slot->name) == slot->owner);
+    if (slot->sysfs_path)
+        g_assert (mm_kernel_device_port_index_lookup_sysfs_path (port_index, slot->sysfs_path) == slot->owner);
+}
+
+static void
+test_port_index_stress (void)
+{
+    static const gchar *subsystems[] = { "tty", "net", "usbmisc" };
+    static const gchar *prefixes[]   = { "ttyUSB", "wwan", "cdc-wdm" };
+    g_autoptr(MMKernelDevicePortIndex) port_index = NULL;
+    PortIndexSlot slots[PORT_INDEX_N_DEVICES * PORT_INDEX_N_PORTS_PER_DEVICE];
+    guint         n_owned = 0;
+    guint         i;
+
+    for (i = 0; i < G_N_ELEMENTS (slots); i++) {
+        guint type;
+
+        type = i % G_N_ELEMENTS (subsystems);
+        slots[i].subsystem = g_strdup (subsystems[type]);
+        slots[i].name = g_strdup_printf ("%s%u", prefixes[type], i);
+        /* Not all ports report a sysfs path */
+        slots[i].sysfs_path = ((i % 5) ? g_strdup_printf ("/sys/devices/usb1/1-%u/1-%u:1.%u/%s/%s",
+                                                          i / PORT_INDEX_N_PORTS_PER_DEVICE,
+                                                          i / PORT_INDEX_N_PORTS_PER_DEVICE,
+                                                          i % PORT_INDEX_N_PORTS_PER_DEVICE,
+                                                          subsystems[type],
+                                                          slots[i].name) : NULL);
+        slots[i].owner = NULL;
+    }
+
+    port_index = mm_kernel_device_port_index_new ();
+
+    for (i = 0; i < PORT_INDEX_N_EVENTS; i++) {
+        guint          device;
+        PortIndexSlot *slot;
+
+        device = g_test_rand_int_range (0, PORT_INDEX_N_DEVICES);
+
+        /* Full device removal now and then */
+        if (g_test_rand_int_range (0, 500) == 0) {
+            guint j;
+
+            mm_kernel_device_port_index_remove_owner (port_index, GUINT_TO_POINTER (device + 1));
+            for (j = 0; j < PORT_INDEX_N_PORTS_PER_DEVICE; j++) {
+                slot = &slots[device * PORT_INDEX_N_PORTS_PER_DEVICE + j];
+                if (slot->owner) {
+                    slot->owner = NULL;
+                    n_owned--;
+                }
+                port_index_check_slot (port_index, slot);
+            }
+            continue;
+        }
+
+        slot = &slots[device * PORT_INDEX_N_PORTS_PER_DEVICE + g_test_rand_int_range (0, PORT_INDEX_N_PORTS_PER_DEVICE)];
+        if (!slot->owner) {
+            slot->owner = GUINT_TO_POINTER (device + 1);
+            mm_kernel_device_port_index_add (port_index, slot->subsystem, slot->name, slot->sysfs_path, slot->owner);
+            n_owned++;
+        } else {
+            /* Removals with the wrong owner are ignored */
+            mm_kernel_device_port_index_remove (port_index, slot->subsystem, slot->name, slot->sysfs_path,
+                                                GUINT_TO_POINTER (PORT_INDEX_N_DEVICES + 1));
+            port_index_check_slot (port_index, slot);
+            mm_kernel_device_port_index_remove (port_index, slot->subsystem, slot->name, slot->sysfs_path, slot->owner);
+            slot->owner = NULL;
+            n_owned--;
+        }
+        port_index_check_slot (port_index, slot);
+
+        /* Check some other random port */
+        port_index_check_slot (port_index, &slots[g_test_rand_int_range (0, G_N_ELEMENTS (slots))]);
+        g_assert_cmpuint (mm_kernel_device_port_index_get_size (port_index), ==, n_owned);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (slots); i++) {
+        port_index_check_slot (port_index, &slots[i]);
+        g_free (slots[i].subsystem);
+        g_free (slots[i].name);
+        g_free (slots[i].sysfs_path);
+    }
+
+    /* Unknown ports */
+    g_assert (!mm_kernel_device_port_index_lookup_name (port_index, "tty", "ttyACM0"));
+    g_assert (!mm_kernel_device_port_index_lookup_name (port_index, NULL, NULL));
+    g_assert (!mm_kernel_device_port_index_lookup_sysfs_path (port_index, NULL));
+}
+
+/*****************************************************************************/
+
 int main (int argc, char **argv)
 {
     setlocale (LC_ALL, "");
@@ -113,6 +245,7 @@ int main (int argc, char **argv)
     g_test_init (&argc, &argv, NULL);
 
     g_test_add_func ("/MM/kernel-device-helpers/string-match", test_string_match);
+    g_test_add_func ("/MM/kernel-device-helpers/port-index-stress", test_port_index_stress);
 
     return g_test_run ();
 }
@@ -0,0 +1,253 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include <ModemManager.h>
+
+#include "mm-location-updates.h"
+#include "mm-log-test.h"
+
+#define UPDATE_WINDOW_MS 50
+
+typedef struct {
+    MMLocationUpdates *updates;
+    GMainLoop         *loop;
+    /* Whether the publish callback builds the dictionary, i.e. whether the
+     * location is being signaled */
+    gboolean           signals_location;
+    guint              n_builds[MM_MODEM_LOCATION_SOURCE_CDMA_BS + 1];
+    guint              n_publishes;
+    GVariant          *location;
+} Fixture;
+
+static GVariant *
+build_cb (MMModemLocationSource  source,
+          Fixture               *fixture)
+{
+    g_assert_cmpuint (source, <=, MM_MODEM_LOCATION_SOURCE_CDMA_BS);
+    fixture->n_builds[source]++;
+    return g_variant_new_printf ("%u:%u", source, fixture->n_builds[source]);
+}
+
+static void
+publish_cb (MMLocationUpdates     *updates,
+            MMModemLocationSource  sources,
+            Fixture               *fixture)
+{
+    g_assert (updates == fixture->updates);
+    g_assert_cmpuint (sources, !=, MM_MODEM_LOCATION_SOURCE_NONE);
+
+    fixture->n_publishes++;
+    if (fixture->signals_location) {
+        g_clear_pointer (&fixture->location, g_variant_unref);
+        fixture->location = g_variant_ref_sink (mm_location_updates_build_dictionary (updates, sources));
+    }
+    if (fixture->loop)
+        g_main_loop_quit (fixture->loop);
+}
+
+static void
+fixture_setup (Fixture *fixture,
+               guint    window_ms)
+{
+    memset (fixture, 0, sizeof (*fixture));
+    fixture->signals_location = TRUE;
+    fixture->updates = mm_location_updates_new (window_ms,
+                                                (MMLocationUpdatesBuildFunc) build_cb,
+                                                (MMLocationUpdatesPublishFunc) publish_cb,
+                                                fixture);
+}
+
+static void
+fixture_teardown (Fixture *fixture)
+{
+    mm_location_updates_free (fixture->updates);
+    g_clear_pointer (&fixture->location, g_variant_unref);
+    g_clear_pointer (&fixture->loop, g_main_loop_unref);
+}
+
+static void
+wait_for_publish (Fixture *fixture)
+{
+    if (!fixture->loop)
+        fixture->loop = g_main_loop_new (NULL, FALSE);
+    g_main_loop_run (fixture->loop);
+}
+
+/* Checks the value published for the source, or that none was if expected
+ * is NULL */
+static void
+check_location_value (Fixture               *fixture,
+                      MMModemLocationSource  source,
+                      const gchar           *expected)
+{
+    GVariantIter  iter;
+    guint         key;
+    GVariant     *value;
+    gboolean      found = FALSE;
+
+    g_assert (fixture->location);
+
+    g_variant_iter_init (&iter, fixture->location);
+    while (g_variant_iter_next (&iter, "{uv}", &key, &value)) {
+        if (key == source) {
+            g_assert (expected);
+            g_assert_cmpstr (g_variant_get_string (value, NULL), ==, expected);
+            found = TRUE;
+        }
+        g_variant_unref (value);
+    }
+    g_assert (found == !!expected);
+}
+
+/*****************************************************************************/
+
+static void
+test_coalesce (void)
+{
+    Fixture fixture;
+    guint   i;
+
+    fixture_setup (&fixture, UPDATE_WINDOW_MS);
+
+    /* A burst of NMEA traces within the update window */
+    for (i = 0; i < 10; i++)
+        mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_RAW);
+    g_assert_cmpuint (fixture.n_publishes, ==, 0);
+
+    /* Results in a single property change, building each value once */
+    wait_for_publish (&fixture);
+    g_assert_cmpuint (fixture.n_publishes, ==, 1);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 1);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_RAW], ==, 1);
+    g_assert_cmpuint (g_variant_n_children (fixture.location), ==, 2);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_NMEA, "4:1");
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_RAW, "2:1");
+
+    /* Next window */
+    for (i = 0; i < 10; i++)
+        mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    wait_for_publish (&fixture);
+    g_assert_cmpuint (fixture.n_publishes, ==, 2);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 2);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_NMEA, "4:2");
+
+    fixture_teardown (&fixture);
+}
+
+static void
+test_no_window (void)
+{
+    Fixture fixture;
+
+    fixture_setup (&fixture, 0);
+
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    g_assert_cmpuint (fixture.n_publishes, ==, 1);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    g_assert_cmpuint (fixture.n_publishes, ==, 2);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 2);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_NMEA, "4:2");
+
+    fixture_teardown (&fixture);
+}
+
+static void
+test_cached_values (void)
+{
+    Fixture fixture;
+
+    fixture_setup (&fixture, 0);
+
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_CDMA_BS);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+
+    /* Sources not updated are published with their cached values, not built
+     * again */
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI], ==, 1);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_CDMA_BS], ==, 1);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 2);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_RAW], ==, 0);
+    g_assert_cmpuint (g_variant_n_children (fixture.location), ==, 3);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI, "1:1");
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_CDMA_BS, "8:1");
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_NMEA, "4:2");
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_RAW, NULL);
+
+    /* Nothing is built while the location isn't signaled */
+    fixture.signals_location = FALSE;
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    g_assert_cmpuint (fixture.n_publishes, ==, 5);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 2);
+
+    /* Once cleared, only the sources updated afterwards are published */
+    mm_location_updates_clear (fixture.updates);
+    fixture.signals_location = TRUE;
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_RAW);
+    g_assert_cmpuint (g_variant_n_children (fixture.location), ==, 1);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_GPS_RAW, "2:1");
+
+    fixture_teardown (&fixture);
+}
+
+static void
+test_flush_clear (void)
+{
+    Fixture fixture;
+
+    fixture_setup (&fixture, UPDATE_WINDOW_MS);
+
+    /* Nothing to publish */
+    mm_location_updates_flush (fixture.updates);
+    g_assert_cmpuint (fixture.n_publishes, ==, 0);
+
+    /* Pending updates published right away */
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI);
+    mm_location_updates_flush (fixture.updates);
+    g_assert_cmpuint (fixture.n_publishes, ==, 1);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_3GPP_LAC_CI, "1:1");
+
+    /* Pending updates dropped; the next one is published once its own
+     * window is over */
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_GPS_NMEA);
+    mm_location_updates_clear (fixture.updates);
+    mm_location_updates_schedule (fixture.updates, MM_MODEM_LOCATION_SOURCE_CDMA_BS);
+    wait_for_publish (&fixture);
+    g_assert_cmpuint (fixture.n_publishes, ==, 2);
+    g_assert_cmpuint (fixture.n_builds[MM_MODEM_LOCATION_SOURCE_GPS_NMEA], ==, 0);
+    g_assert_cmpuint (g_variant_n_children (fixture.location), ==, 1);
+    check_location_value (&fixture, MM_MODEM_LOCATION_SOURCE_CDMA_BS, "8:1");
+
+    fixture_teardown (&fixture);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/location-updates/coalesce",      test_coalesce);
+    g_test_add_func ("/MM/location-updates/no-window",     test_no_window);
+    g_test_add_func ("/MM/location-updates/cached-values", test_cached_values);
+    g_test_add_func ("/MM/location-updates/flush-clear",   test_flush_clear);
+
+    return g_test_run ();
+}
@@ -0,0 +1,266 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+/* This test exercises the real logging backends, so mm-log-test.h must
+ * NOT be included here */
+#define MM_LOG_NO_OBJECT
+#include "mm-log.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    gchar *dir;
+    gchar *path;
+    gchar *rotated_path;
+} Fixture;
+
+static void
+fixture_setup (Fixture       *fixture,
+               gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+
+    fixture->dir = g_dir_make_tmp ("test-log-XXXXXX", &error);
+    g_assert_no_error (error);
+    fixture->path = g_build_filename (fixture->dir, "mm.log", NULL);
+    fixture->rotated_path = g_strdup_printf ("%s.1", fixture->path);
+}
+
+static void
+fixture_teardown (Fixture       *fixture,
+                  gconstpointer  user_data)
+{
+    if (g_unlink (fixture->rotated_path) < 0)
+        g_rmdir (fixture->rotated_path);
+    g_unlink (fixture->path);
+    g_rmdir (fixture->dir);
+    g_free (fixture->rotated_path);
+    g_free (fixture->path);
+    g_free (fixture->dir);
+}
+
+static void
+log_setup (Fixture  *fixture,
+           gboolean  buffered,
+           guint64   max_size)
+{
+    g_autoptr(GError) error = NULL;
+
+    g_assert (mm_log_setup ("DEBUG", fixture->path, FALSE, FALSE, FALSE, buffered, max_size, &error));
+    g_assert_no_error (error);
+}
+
+static gchar **
+read_lines (const gchar *path)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *contents = NULL;
+
+    g_file_get_contents (path, &contents, NULL, &error);
+    g_assert_no_error (error);
+    return g_strsplit (contents, "\n", -1);
+}
+
+/*****************************************************************************/
+
+#define N_LINES 20000
+
+static void
+test_buffered_order (Fixture       *fixture,
+                     gconstpointer  user_data)
+{
+    g_auto(GStrv) lines = NULL;
+    guint         i;
+
+    log_setup (fixture, TRUE, 0);
+    for (i = 0; i < N_LINES; i++)
+        mm_dbg ("line %u", i);
+    mm_log_shutdown ();
+
+    /* All lines written, in order, once the log is shut down */
+    lines = read_lines (fixture->path);
+    g_assert_cmpuint (g_strv_length (lines), ==, N_LINES + 1);
+    for (i = 0; i < N_LINES; i++) {
+        g_autofree gchar *expected = NULL;
+
+        expected = g_strdup_printf ("line %u", i);
+        g_assert (g_str_has_suffix (lines[i], expected));
+    }
+    g_assert_cmpstr (lines[N_LINES], ==, "");
+}
+
+static void
+test_buffered_warn_flush (Fixture       *fixture,
+                          gconstpointer  user_data)
+{
+    g_autofree gchar *contents = NULL;
+
+    log_setup (fixture, TRUE, 0);
+    mm_dbg ("pending debug message");
+    mm_warn ("urgent warning");
+
+    /* Warnings flush everything pending right away */
+    g_assert (g_file_get_contents (fixture->path, &contents, NULL, NULL));
+    g_assert (strstr (contents, "pending debug message\n"));
+    g_assert (strstr (contents, "urgent warning\n"));
+    g_assert (strstr (contents, "pending debug message") < strstr (contents, "urgent warning"));
+
+    mm_log_shutdown ();
+}
+
+#define MAX_SIZE 4096
+
+static void
+test_rotation (Fixture       *fixture,
+               gconstpointer  user_data)
+{
+    gboolean         buffered = GPOINTER_TO_UINT (user_data);
+    GStatBuf         st;
+    g_auto(GStrv)    lines = NULL;
+    g_auto(GStrv)    rotated_lines = NULL;
+    guint            n_lines;
+    guint            n_rotated_lines;
+    guint            i;
+    g_autofree gchar *expected = NULL;
+
+    log_setup (fixture, buffered, MAX_SIZE);
+    for (i = 0; i < N_LINES; i++)
+        mm_dbg ("line %u", i);
+    mm_log_shutdown ();
+
+    g_assert_cmpint (g_stat (fixture->path, &st), ==, 0);
+    g_assert_cmpint (st.st_size, <=, MAX_SIZE);
+    g_assert_cmpint (g_stat (fixture->rotated_path, &st), ==, 0);
+    g_assert_cmpint (st.st_size, <=, MAX_SIZE);
+
+    /* The last lines are in the current file, the ones before them in the
+     * rotated file */
+    lines = read_lines (fixture->path);
+    n_lines = g_strv_length (lines) - 1;
+    g_assert_cmpuint (n_lines, >, 0);
+    expected = g_strdup_printf ("line %u", N_LINES - 1);
+    g_assert (g_str_has_suffix (lines[n_lines - 1], expected));
+    g_clear_pointer (&expected, g_free);
+
+    rotated_lines = read_lines (fixture->rotated_path);
+    n_rotated_lines = g_strv_length (rotated_lines) - 1;
+    g_assert_cmpuint (n_rotated_lines, >, 0);
+    expected = g_strdup_printf ("line %u", N_LINES - 1 - n_lines);
+    g_assert (g_str_has_suffix (rotated_lines[n_rotated_lines - 1], expected));
+}
+
+static void
+test_rotation_failed (Fixture       *fixture,
+                      gconstpointer  user_data)
+{
+    g_auto(GStrv)     lines = NULL;
+    g_autofree gchar *expected = NULL;
+    guint             n_notes = 0;
+    guint             i;
+
+    /* The rotated file can't replace a directory */
+    g_assert_cmpint (g_mkdir (fixture->rotated_path, 0700), ==, 0);
+
+    log_setup (fixture, FALSE, MAX_SIZE);
+    for (i = 0; i < N_LINES; i++)
+        mm_dbg ("line %u", i);
+    mm_log_shutdown ();
+
+    /* Logging goes on in the same file, with the failure noted once */
+    lines = read_lines (fixture->path);
+    g_assert_cmpuint (g_strv_length (lines), ==, N_LINES + 2);
+    for (i = 0; lines[i]; i++) {
+        if (strstr (lines[i], "couldn't rotate log file"))
+            n_notes++;
+    }
+    g_assert_cmpuint (n_notes, ==, 1);
+    expected = g_strdup_printf ("line %u", N_LINES - 1);
+    g_assert (g_str_has_suffix (lines[N_LINES], expected));
+}
+
+/*****************************************************************************/
+
+#define N_PERF_LINES 100000
+
+static void
+run_perf (Fixture  *fixture,
+          gboolean  buffered,
+          gdouble  *out_elapsed,
+          gdouble  *out_max_latency)
+{
+    guint  i;
+    gint64 max_latency = 0;
+
+    log_setup (fixture, buffered, 0);
+
+    g_test_timer_start ();
+    for (i = 0; i < N_PERF_LINES; i++) {
+        gint64 start;
+        gint64 latency;
+
+        start = g_get_monotonic_time ();
+        mm_dbg ("some debug message logged while processing modem %u", i);
+        latency = g_get_monotonic_time () - start;
+        if (latency > max_latency)
+            max_latency = latency;
+    }
+    *out_elapsed = g_test_timer_elapsed ();
+    *out_max_latency = (gdouble) max_latency / G_USEC_PER_SEC;
+
+    mm_log_shutdown ();
+    g_unlink (fixture->path);
+}
+
+static void
+test_perf (Fixture       *fixture,
+           gconstpointer  user_data)
+{
+    gdouble sync_elapsed;
+    gdouble sync_max_latency;
+    gdouble buffered_elapsed;
+    gdouble buffered_max_latency;
+
+    run_perf (fixture, FALSE, &sync_elapsed, &sync_max_latency);
+    run_perf (fixture, TRUE, &buffered_elapsed, &buffered_max_latency);
+
+    g_test_message ("synchronous file backend: %.0f lines/s, max latency %.6f seconds",
+                    N_PERF_LINES / sync_elapsed, sync_max_latency);
+    g_test_minimized_result (buffered_max_latency,
+                             "buffered file backend: %.0f lines/s, max latency %.6f seconds",
+                             N_PERF_LINES / buffered_elapsed, buffered_max_latency);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add ("/MM/log/buffered/order", Fixture, NULL, fixture_setup, test_buffered_order, fixture_teardown);
+    g_test_add ("/MM/log/buffered/warn-flush", Fixture, NULL, fixture_setup, test_buffered_warn_flush, fixture_teardown);
+    g_test_add ("/MM/log/rotation/sync", Fixture, GUINT_TO_POINTER (FALSE), fixture_setup, test_rotation, fixture_teardown);
+    g_test_add ("/MM/log/rotation/buffered", Fixture, GUINT_TO_POINTER (TRUE), fixture_setup, test_rotation, fixture_teardown);
+    g_test_add ("/MM/log/rotation/failed", Fixture, NULL, fixture_setup, test_rotation_failed, fixture_teardown);
+
+    if (g_test_perf ())
+        g_test_add ("/MM/log/perf", Fixture, NULL, fixture_setup, test_perf, fixture_teardown);
+
+    return g_test_run ();
+}
@@ -0,0 +1,151 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <glib.h>
+
+#include "mm-main-loop-monitor.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static GVariantDict *
+lookup_handler (GVariantDict *stats,
+                const gchar  *type,
+                const gchar  *tag)
+{
+    g_autoptr(GVariant) handlers = NULL;
+    GVariantIter        iter;
+    GVariant           *handler;
+
+    handlers = g_variant_dict_lookup_value (stats, "handlers", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert (handlers);
+
+    g_variant_iter_init (&iter, handlers);
+    while ((handler = g_variant_iter_next_value (&iter))) {
+        g_autoptr(GVariantDict)  dict = NULL;
+        g_autofree gchar        *handler_type = NULL;
+        g_autofree gchar        *handler_tag = NULL;
+
+        dict = g_variant_dict_new (handler);
+        g_variant_unref (handler);
+        g_assert (g_variant_dict_lookup (dict, "type", "s", &handler_type));
+        g_assert (g_variant_dict_lookup (dict, "tag", "s", &handler_tag));
+        if (g_str_equal (handler_type, type) && g_str_equal (handler_tag, tag))
+            return g_steal_pointer (&dict);
+    }
+    return NULL;
+}
+
+static void
+check_histogram (GVariantDict *dict,
+                 const gchar  *key,
+                 guint         bucket,
+                 guint64       count)
+{
+    g_autoptr(GVariant)  histogram = NULL;
+    const guint64       *buckets;
+    gsize                n_buckets;
+    gsize                i;
+
+    histogram = g_variant_dict_lookup_value (dict, key, G_VARIANT_TYPE ("at"));
+    g_assert (histogram);
+    buckets = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+    g_assert_cmpuint (n_buckets, ==, 6);
+    for (i = 0; i < n_buckets; i++)
+        g_assert_cmpuint (buckets[i], ==, i == bucket ? count : 0);
+}
+
+static void
+test_handler_stats (void)
+{
+    g_autoptr(GVariant)      stats = NULL;
+    g_autoptr(GVariantDict)  dict = NULL;
+    g_autoptr(GVariantDict)  serial = NULL;
+    g_autoptr(GVariantDict)  dbus = NULL;
+    MMMainLoopDispatch       dispatch;
+    guint64                  value = 0;
+    guint                    i;
+
+    mm_main_loop_monitor_setup (TRUE);
+    g_assert (mm_main_loop_monitor_handler_stats_enabled ());
+
+    /* Two reads blocking the main loop for 20ms each, ready 5ms before */
+    for (i = 0; i < 2; i++) {
+        mm_main_loop_monitor_dispatch_begin (&dispatch, g_get_monotonic_time () - 5000);
+        g_usleep (20000);
+        mm_main_loop_monitor_dispatch_end (&dispatch, MM_MAIN_LOOP_HANDLER_SERIAL_READ, "modem0/ttyUSB2");
+    }
+    mm_main_loop_monitor_dispatch_record (MM_MAIN_LOOP_HANDLER_DBUS_METHOD, "Modem/0", g_get_monotonic_time () - 200000);
+
+    stats = g_variant_ref_sink (mm_main_loop_monitor_get_stats ());
+    dict = g_variant_dict_new (stats);
+    g_assert (g_variant_dict_contains (dict, "wakeups"));
+    g_assert (g_variant_dict_contains (dict, "timers"));
+
+    serial = lookup_handler (dict, "serial-read", "modem0/ttyUSB2");
+    g_assert (serial);
+    g_assert (g_variant_dict_lookup (serial, "count", "t", &value));
+    g_assert_cmpuint (value, ==, 2);
+    g_assert (g_variant_dict_lookup (serial, "time-total", "t", &value));
+    g_assert_cmpuint (value, >=, 40000);
+    /* 5ms latency and 20ms run time, in the <10ms and <100ms buckets */
+    check_histogram (serial, "latency-histogram", 2, 2);
+    check_histogram (serial, "time-histogram", 3, 2);
+
+    /* Run time not measured */
+    dbus = lookup_handler (dict, "dbus-method", "Modem/0");
+    g_assert (dbus);
+    check_histogram (dbus, "latency-histogram", 4, 1);
+    g_assert (!g_variant_dict_contains (dbus, "time-total"));
+
+    g_assert (!lookup_handler (dict, "qmi-indication", "modem0/cdc-wdm0"));
+
+    mm_main_loop_monitor_shutdown ();
+    g_assert (!mm_main_loop_monitor_handler_stats_enabled ());
+}
+
+static void
+test_handler_stats_disabled (void)
+{
+    g_autoptr(GVariant)     stats = NULL;
+    g_autoptr(GVariantDict) dict = NULL;
+    MMMainLoopDispatch      dispatch;
+
+    mm_main_loop_monitor_setup (FALSE);
+    g_assert (!mm_main_loop_monitor_handler_stats_enabled ());
+
+    mm_main_loop_monitor_dispatch_begin (&dispatch, 0);
+    mm_main_loop_monitor_dispatch_end (&dispatch, MM_MAIN_LOOP_HANDLER_SERIAL_READ, "modem0/ttyUSB2");
+
+    stats = g_variant_ref_sink (mm_main_loop_monitor_get_stats ());
+    dict = g_variant_dict_new (stats);
+    g_assert (g_variant_dict_contains (dict, "wakeups"));
+    g_assert (!g_variant_dict_contains (dict, "handlers"));
+
+    mm_main_loop_monitor_shutdown ();
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/main-loop-monitor/handler-stats", test_handler_stats);
+    g_test_add_func ("/MM/main-loop-monitor/handler-stats-disabled", test_handler_stats_disabled);
+
+    return g_test_run ();
+}
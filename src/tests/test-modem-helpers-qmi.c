@@ -1333,6 +1333,103 @@ test_supported_modes_generic_nr5g_lte_evdo (void)
 
 /*****************************************************************************/
 
+static void
+check_client_stats (MMQmiClientIndex *index,
+                    QmiService        service,
+                    guint             n_allocated,
+                    guint             n_released,
+                    guint             n_released_on_close)
+{
+    MMQmiClientStats stats;
+
+    mm_qmi_client_index_get_stats (index, service, &stats);
+    g_assert_cmpuint (stats.n_allocated, ==, n_allocated);
+    g_assert_cmpuint (stats.n_released, ==, n_released);
+    g_assert_cmpuint (stats.n_released_on_close, ==, n_released_on_close);
+}
+
+static void
+test_client_index (void)
+{
+    g_autoptr(MMQmiClientIndex)  index = NULL;
+    g_autoptr(QmiClient)         dms = NULL;
+    g_autoptr(QmiClient)         wds = NULL;
+    g_autoptr(QmiClient)         wds_flagged = NULL;
+    g_autoptr(QmiClient)         gms = NULL;
+    g_autoptr(QmiClient)         stolen = NULL;
+    GList                       *list;
+
+    index = mm_qmi_client_index_new ();
+    dms = g_object_new (QMI_TYPE_CLIENT_DMS, NULL);
+    wds = g_object_new (QMI_TYPE_CLIENT_WDS, NULL);
+    wds_flagged = g_object_new (QMI_TYPE_CLIENT_WDS, NULL);
+    /* Not in the array of default clients */
+    gms = g_object_new (QMI_TYPE_CLIENT_GMS, NULL);
+
+    mm_qmi_client_index_add (index, QMI_SERVICE_DMS, 0, dms);
+    mm_qmi_client_index_add (index, QMI_SERVICE_WDS, 0, wds);
+    mm_qmi_client_index_add (index, QMI_SERVICE_WDS, 1, wds_flagged);
+    mm_qmi_client_index_add (index, QMI_SERVICE_GMS, 0, gms);
+
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_DMS, 0) == dms);
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 0) == wds);
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 1) == wds_flagged);
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_GMS, 0) == gms);
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 2));
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_NAS, 0));
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_GMS, 1));
+
+    /* Explicit release of one of the WDS clients */
+    stolen = mm_qmi_client_index_steal (index, QMI_SERVICE_WDS, 0);
+    g_assert (stolen == wds);
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 0));
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 1) == wds_flagged);
+    g_assert (!mm_qmi_client_index_steal (index, QMI_SERVICE_WDS, 0));
+    g_clear_object (&stolen);
+
+    stolen = mm_qmi_client_index_steal (index, QMI_SERVICE_GMS, 0);
+    g_assert (stolen == gms);
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_GMS, 0));
+    g_clear_object (&stolen);
+
+    /* And the same flag may be allocated again */
+    g_assert (mm_qmi_client_index_add (index, QMI_SERVICE_WDS, 0, wds));
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 0) == wds);
+
+    /* But a second client for the same service and flag is not added, as
+     * when two allocations for them run at the same time */
+    g_assert (!mm_qmi_client_index_add (index, QMI_SERVICE_WDS, 0, wds_flagged));
+    g_assert (!mm_qmi_client_index_add (index, QMI_SERVICE_WDS, 1, wds));
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 0) == wds);
+    g_assert (mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 1) == wds_flagged);
+
+    /* The ones left are released when closing */
+    list = mm_qmi_client_index_steal_all (index);
+    g_assert_cmpuint (g_list_length (list), ==, 3);
+    g_assert (g_list_find (list, dms));
+    g_assert (g_list_find (list, wds));
+    g_assert (g_list_find (list, wds_flagged));
+    g_list_free_full (list, g_object_unref);
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_DMS, 0));
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 0));
+    g_assert (!mm_qmi_client_index_peek (index, QMI_SERVICE_WDS, 1));
+
+    check_client_stats (index, QMI_SERVICE_DMS, 1, 0, 1);
+    check_client_stats (index, QMI_SERVICE_WDS, 3, 1, 2);
+    check_client_stats (index, QMI_SERVICE_GMS, 1, 1, 0);
+    check_client_stats (index, QMI_SERVICE_NAS, 0, 0, 0);
+
+    /* Clients are not leaked if still in the index when freeing it */
+    mm_qmi_client_index_add (index, QMI_SERVICE_DMS, 0, dms);
+    g_object_add_weak_pointer (G_OBJECT (dms), (gpointer *)&dms);
+    g_object_unref (dms);
+    g_assert (dms);
+    g_clear_pointer (&index, mm_qmi_client_index_free);
+    g_assert (!dms);
+}
+
+/*****************************************************************************/
+
 int main (int argc, char **argv)
 {
     setlocale (LC_ALL, "");
@@ -1394,5 +1491,7 @@ int main (int argc, char **argv)
     g_test_add_func ("/MM/qmi/supported-capabilities/generic/nr5g-lte-evdo",  test_supported_capabilities_generic_nr5g_lte_evdo);
     g_test_add_func ("/MM/qmi/supported-modes/generic/nr5g-lte-evdo",         test_supported_modes_generic_nr5g_lte_evdo);
 
+    g_test_add_func ("/MM/qmi/client-index",                                  test_client_index);
+
     return g_test_run ();
 }
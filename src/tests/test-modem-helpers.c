@@ -22,6 +22,7 @@
 #define _LIBMM_INSIDE_MM
 #include <libmm-glib.h>
 #include "mm-modem-helpers.h"
+#include "mm-regex-cache.h"
 #include "mm-log-test.h"
 
 #define g_assert_cmpfloat_tolerance(val1, val2, tolerance)  \
@@ -4594,6 +4595,69 @@ test_cpol_response (void)
     }
 }
 
+/*****************************************************************************/
+/* Test the regex cache */
+
+static void
+find_ifc_regex_stats (const MMRegexCacheStats *stats,
+                      MMRegexCacheStats       *out_stats)
+{
+    if (g_str_equal (stats->pattern, "(?:\\+IFC:)?\\s*\\((.*)\\),\\((.*)\\)(?:\\r\\n)?"))
+        *out_stats = *stats;
+}
+
+static void
+test_regex_cache (void)
+{
+    GRegex            *r1;
+    GRegex            *r2;
+    GRegex            *r3;
+    GError            *error = NULL;
+    MMRegexCacheStats  before = { 0 };
+    MMRegexCacheStats  after = { 0 };
+    guint              i;
+
+    /* The same pattern and options give the same regex */
+    r1 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+)", G_REGEX_RAW, 0, &error);
+    g_assert_no_error (error);
+    r2 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+)", G_REGEX_RAW, 0, &error);
+    g_assert_no_error (error);
+    g_assert (r1 == r2);
+
+    /* But not with different options */
+    r3 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+)", 0, 0, &error);
+    g_assert_no_error (error);
+    g_assert (r1 != r3);
+    g_assert_cmpuint (g_regex_get_compile_flags (r3) & G_REGEX_RAW, ==, 0);
+
+    g_regex_unref (r1);
+    g_regex_unref (r2);
+    g_regex_unref (r3);
+
+    /* Invalid patterns are reported, and not cached */
+    for (i = 0; i < 2; i++) {
+        g_assert (mm_regex_cache_get ("(unbalanced", 0, 0, &error) == NULL);
+        g_assert_error (error, G_REGEX_ERROR, G_REGEX_ERROR_UNMATCHED_PARENTHESIS);
+        g_clear_error (&error);
+    }
+
+    /* Parsers compile their patterns once */
+    g_assert_cmpuint (mm_parse_ifc_test_response ("+IFC (0,1,2),(0,1,2)", NULL, &error), !=, MM_FLOW_CONTROL_UNKNOWN);
+    g_assert_no_error (error);
+    mm_regex_cache_foreach_stats ((MMRegexCacheStatsFunc) find_ifc_regex_stats, &before);
+    g_assert_cmpuint (before.n_compiles, ==, 1);
+
+    for (i = 0; i < 10; i++) {
+        g_assert_cmpuint (mm_parse_ifc_test_response ("+IFC (0,1,2),(0,1,2)", NULL, &error), !=, MM_FLOW_CONTROL_UNKNOWN);
+        g_assert_no_error (error);
+    }
+    mm_regex_cache_foreach_stats ((MMRegexCacheStatsFunc) find_ifc_regex_stats, &after);
+    g_assert_cmpuint (after.n_compiles, ==, 1);
+    g_assert_cmpuint (after.n_lookups, ==, before.n_lookups + 10);
+    /* Matches are only accounted when debugging */
+    g_assert_cmpuint (after.n_matches, ==, before.n_matches + (g_test_verbose () ? 10 : 0));
+}
+
 /*****************************************************************************/
 
 #define TESTCASE(t, d) g_test_create_case (#t, 0, d, NULL, (GTestFixtureFunc) t, NULL)
@@ -4830,6 +4894,8 @@ int main (int argc, char **argv)
 
     g_test_suite_add (suite, TESTCASE (test_cpol_response, NULL));
 
+    g_test_suite_add (suite, TESTCASE (test_regex_cache, NULL));
+
     result = g_test_run ();
 
     reg_test_data_free (reg_data);
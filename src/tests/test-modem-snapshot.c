@@ -0,0 +1,438 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libmm-glib.h>
+
+#include "mm-modem-snapshot.h"
+#include "mm-log-test.h"
+
+typedef struct {
+    gchar *dir;
+    gchar *path;
+} Fixture;
+
+static void
+fixture_setup (Fixture *fixture)
+{
+    GError *error = NULL;
+
+    fixture->dir = g_dir_make_tmp ("mm-modem-snapshot-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_assert (fixture->dir);
+    /* In a subdirectory not created yet */
+    fixture->path = g_build_filename (fixture->dir, "state", "modem-snapshot", NULL);
+}
+
+static void
+fixture_teardown (Fixture *fixture)
+{
+    g_autofree gchar *state_dir = NULL;
+
+    state_dir = g_path_get_dirname (fixture->path);
+    g_unlink (fixture->path);
+    g_rmdir (state_dir);
+    g_assert_cmpint (g_rmdir (fixture->dir), ==, 0);
+    g_free (fixture->path);
+    g_free (fixture->dir);
+}
+
+#define DEVICE       "/sys/devices/pci0000:00/0000:00:14.0/usb2/2-3"
+#define EQUIPMENT_ID "356789012345678"
+
+/* Skeleton with the info the snapshot is keyed by, as before anything is
+ * loaded from the modem */
+static MmGdbusModem *
+new_skeleton_for_device (const gchar *device)
+{
+    MmGdbusModem *skeleton;
+
+    skeleton = mm_gdbus_modem_skeleton_new ();
+    mm_gdbus_modem_set_plugin (skeleton, "generic");
+    mm_gdbus_modem_set_device (skeleton, device);
+    return skeleton;
+}
+
+static MmGdbusModem *
+new_skeleton (void)
+{
+    return new_skeleton_for_device (DEVICE);
+}
+
+/* And with the info the snapshot is confirmed with */
+static void
+set_loaded_ids (MmGdbusModem *skeleton,
+                const gchar  *revision)
+{
+    mm_gdbus_modem_set_revision (skeleton, revision);
+    mm_gdbus_modem_set_equipment_identifier (skeleton, EQUIPMENT_ID);
+}
+
+static void
+store_device (MMModemSnapshot *snapshot,
+              const gchar     *device)
+{
+    MmGdbusModem *skeleton;
+
+    skeleton = new_skeleton_for_device (device);
+    set_loaded_ids (skeleton, "FW 1.0");
+    mm_gdbus_modem_set_model (skeleton, "Model");
+    mm_modem_snapshot_store (snapshot, skeleton);
+    g_object_unref (skeleton);
+}
+
+static void
+store_loaded_skeleton (Fixture *fixture)
+{
+    g_autoptr(MMModemSnapshot)  snapshot = NULL;
+    MmGdbusModem               *skeleton;
+
+    snapshot = mm_modem_snapshot_new (fixture->path);
+    skeleton = new_skeleton ();
+    set_loaded_ids (skeleton, "FW 1.0");
+    mm_gdbus_modem_set_manufacturer (skeleton, "Manufacturer");
+    mm_gdbus_modem_set_model (skeleton, "Model");
+    mm_gdbus_modem_set_hardware_revision (skeleton, "HW 2");
+    mm_gdbus_modem_set_device_identifier (skeleton, "0123456789abcdef");
+    mm_gdbus_modem_set_supported_ip_families (skeleton, MM_BEARER_IP_FAMILY_IPV4 | MM_BEARER_IP_FAMILY_IPV6);
+    mm_modem_snapshot_store (snapshot, skeleton);
+    g_object_unref (skeleton);
+
+    g_assert (g_file_test (fixture->path, G_FILE_TEST_IS_REGULAR));
+}
+
+/* Rewrites a key of the stored snapshot */
+static void
+edit_snapshot (Fixture     *fixture,
+               const gchar *group,
+               const gchar *key,
+               const gchar *value)
+{
+    g_autoptr(GKeyFile) key_file = NULL;
+    GError             *error = NULL;
+
+    key_file = g_key_file_new ();
+    g_key_file_load_from_file (key_file, fixture->path, G_KEY_FILE_NONE, &error);
+    g_assert_no_error (error);
+    g_key_file_set_string (key_file, group, key, value);
+    g_key_file_save_to_file (key_file, fixture->path, &error);
+    g_assert_no_error (error);
+}
+
+static gboolean
+lookup (Fixture      *fixture,
+        MmGdbusModem *skeleton)
+{
+    g_autoptr(MMModemSnapshot) snapshot = NULL;
+    g_auto(GStrv)              loaded = NULL;
+
+    snapshot = mm_modem_snapshot_new (fixture->path);
+    loaded = mm_modem_snapshot_lookup (snapshot, skeleton);
+    return !!loaded;
+}
+
+static gboolean
+has_device (MMModemSnapshot *snapshot,
+            const gchar     *device)
+{
+    MmGdbusModem  *skeleton;
+    g_auto(GStrv)  loaded = NULL;
+
+    skeleton = new_skeleton_for_device (device);
+    loaded = mm_modem_snapshot_lookup (snapshot, skeleton);
+    g_object_unref (skeleton);
+    return !!loaded;
+}
+
+/*****************************************************************************/
+
+static void
+test_store_lookup (void)
+{
+    Fixture       fixture;
+    MmGdbusModem *skeleton;
+
+    fixture_setup (&fixture);
+    store_loaded_skeleton (&fixture);
+
+    /* Loaded by a new instance, as in the next daemon run */
+    skeleton = new_skeleton ();
+    g_assert (lookup (&fixture, skeleton));
+    g_assert_cmpstr (mm_gdbus_modem_get_manufacturer (skeleton), ==, "Manufacturer");
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, "Model");
+    g_assert_cmpstr (mm_gdbus_modem_get_hardware_revision (skeleton), ==, "HW 2");
+    g_assert_cmpstr (mm_gdbus_modem_get_device_identifier (skeleton), ==, "0123456789abcdef");
+    g_assert_cmpuint (mm_gdbus_modem_get_supported_ip_families (skeleton), ==, MM_BEARER_IP_FAMILY_IPV4 | MM_BEARER_IP_FAMILY_IPV6);
+
+    g_object_unref (skeleton);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_lookup_loaded (void)
+{
+    Fixture       fixture;
+    MmGdbusModem *skeleton;
+
+    fixture_setup (&fixture);
+    store_loaded_skeleton (&fixture);
+
+    /* Properties already loaded are kept */
+    skeleton = new_skeleton ();
+    mm_gdbus_modem_set_manufacturer (skeleton, "Other");
+    g_assert (lookup (&fixture, skeleton));
+    g_assert_cmpstr (mm_gdbus_modem_get_manufacturer (skeleton), ==, "Other");
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, "Model");
+
+    g_object_unref (skeleton);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_lookup_other_modem (void)
+{
+    Fixture       fixture;
+    MmGdbusModem *skeleton;
+
+    fixture_setup (&fixture);
+    store_loaded_skeleton (&fixture);
+
+    /* Different device */
+    skeleton = new_skeleton_for_device ("/sys/devices/pci0000:00/0000:00:14.0/usb2/2-4");
+    g_assert (!lookup (&fixture, skeleton));
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, NULL);
+    g_clear_object (&skeleton);
+
+    /* Different plugin */
+    skeleton = new_skeleton ();
+    mm_gdbus_modem_set_plugin (skeleton, "other");
+    g_assert (!lookup (&fixture, skeleton));
+    g_clear_object (&skeleton);
+
+    /* No device to key it by */
+    skeleton = new_skeleton_for_device (NULL);
+    g_assert (!lookup (&fixture, skeleton));
+
+    g_object_unref (skeleton);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_confirm (void)
+{
+    Fixture                     fixture;
+    g_autoptr(MMModemSnapshot)  snapshot = NULL;
+    MmGdbusModem               *skeleton;
+    g_auto(GStrv)               loaded = NULL;
+
+    fixture_setup (&fixture);
+    store_loaded_skeleton (&fixture);
+    snapshot = mm_modem_snapshot_new (fixture.path);
+
+    /* Same modem and firmware */
+    skeleton = new_skeleton ();
+    loaded = mm_modem_snapshot_lookup (snapshot, skeleton);
+    g_assert (loaded);
+    set_loaded_ids (skeleton, "FW 1.0");
+    g_assert (mm_modem_snapshot_confirm (snapshot, skeleton));
+    g_clear_pointer (&loaded, g_strfreev);
+    g_clear_object (&skeleton);
+
+    /* Firmware upgraded: the properties set by the lookup are cleared, but
+     * not the ones already loaded before it */
+    skeleton = new_skeleton ();
+    mm_gdbus_modem_set_manufacturer (skeleton, "Other");
+    loaded = mm_modem_snapshot_lookup (snapshot, skeleton);
+    g_assert (loaded);
+    g_assert (!g_strv_contains ((const gchar *const *) loaded, "manufacturer"));
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, "Model");
+    set_loaded_ids (skeleton, "FW 1.1");
+    g_assert (!mm_modem_snapshot_confirm (snapshot, skeleton));
+    mm_modem_snapshot_clear_loaded (skeleton, (const gchar *const *) loaded);
+    g_assert_cmpstr (mm_gdbus_modem_get_manufacturer (skeleton), ==, "Other");
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, NULL);
+    g_assert_cmpstr (mm_gdbus_modem_get_hardware_revision (skeleton), ==, NULL);
+    g_assert_cmpstr (mm_gdbus_modem_get_device_identifier (skeleton), ==, NULL);
+    g_assert_cmpuint (mm_gdbus_modem_get_supported_ip_families (skeleton), ==, MM_BEARER_IP_FAMILY_NONE);
+    g_clear_pointer (&loaded, g_strfreev);
+
+    /* And the info stored for the new firmware replaces the old one */
+    mm_gdbus_modem_set_model (skeleton, "Model 2");
+    mm_modem_snapshot_store (snapshot, skeleton);
+    g_clear_object (&skeleton);
+    skeleton = new_skeleton ();
+    g_assert (lookup (&fixture, skeleton));
+    g_assert_cmpstr (mm_gdbus_modem_get_model (skeleton), ==, "Model 2");
+    g_assert_cmpstr (mm_gdbus_modem_get_hardware_revision (skeleton), ==, NULL);
+    set_loaded_ids (skeleton, "FW 1.1");
+    g_assert (mm_modem_snapshot_confirm (snapshot, skeleton));
+    g_clear_object (&skeleton);
+
+    /* Different modem plugged in the same device */
+    skeleton = new_skeleton ();
+    mm_gdbus_modem_set_revision (skeleton, "FW 1.1");
+    mm_gdbus_modem_set_equipment_identifier (skeleton, "356789012345679");
+    g_assert (!mm_modem_snapshot_confirm (snapshot, skeleton));
+
+    g_object_unref (skeleton);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_max_modems (void)
+{
+    Fixture                     fixture;
+    g_autoptr(MMModemSnapshot)  snapshot = NULL;
+    g_autofree gchar           *last_seen = NULL;
+    guint                       i;
+
+    fixture_setup (&fixture);
+    snapshot = mm_modem_snapshot_new (fixture.path);
+
+    for (i = 0; i < MM_MODEM_SNAPSHOT_MAX_MODEMS; i++) {
+        g_autofree gchar *device = NULL;
+
+        device = g_strdup_printf ("/sys/devices/usb1/1-%u", i);
+        store_device (snapshot, device);
+    }
+    g_clear_object (&snapshot);
+
+    /* The one seen least recently is discarded when storing a new one */
+    last_seen = g_strdup_printf ("%" G_GINT64_FORMAT, g_get_real_time () / G_USEC_PER_SEC - 60);
+    edit_snapshot (&fixture, "generic//sys/devices/usb1/1-5", "last-seen", last_seen);
+    snapshot = mm_modem_snapshot_new (fixture.path);
+    g_assert (has_device (snapshot, "/sys/devices/usb1/1-5"));
+    store_device (snapshot, "/sys/devices/usb1/1-100");
+    g_clear_object (&snapshot);
+
+    snapshot = mm_modem_snapshot_new (fixture.path);
+    g_assert (!has_device (snapshot, "/sys/devices/usb1/1-5"));
+    g_assert (has_device (snapshot, "/sys/devices/usb1/1-100"));
+    for (i = 0; i < MM_MODEM_SNAPSHOT_MAX_MODEMS; i++) {
+        g_autofree gchar *device = NULL;
+
+        if (i == 5)
+            continue;
+        device = g_strdup_printf ("/sys/devices/usb1/1-%u", i);
+        g_assert (has_device (snapshot, device));
+    }
+
+    fixture_teardown (&fixture);
+}
+
+static void
+test_expire (void)
+{
+    Fixture                     fixture;
+    g_autoptr(MMModemSnapshot)  snapshot = NULL;
+    g_autofree gchar           *last_seen = NULL;
+
+    fixture_setup (&fixture);
+    snapshot = mm_modem_snapshot_new (fixture.path);
+    store_device (snapshot, "/sys/devices/usb1/1-1");
+    store_device (snapshot, "/sys/devices/usb1/1-2");
+    g_clear_object (&snapshot);
+
+    /* Seen 91 days ago */
+    last_seen = g_strdup_printf ("%" G_GINT64_FORMAT, g_get_real_time () / G_USEC_PER_SEC - 91 * 24 * 60 * 60);
+    edit_snapshot (&fixture, "generic//sys/devices/usb1/1-1", "last-seen", last_seen);
+
+    snapshot = mm_modem_snapshot_new (fixture.path);
+    g_assert (!has_device (snapshot, "/sys/devices/usb1/1-1"));
+    g_assert (has_device (snapshot, "/sys/devices/usb1/1-2"));
+
+    fixture_teardown (&fixture);
+}
+
+static void
+test_version (void)
+{
+    Fixture       fixture;
+    MmGdbusModem *skeleton;
+
+    fixture_setup (&fixture);
+
+    /* Written by a different daemon version */
+    store_loaded_skeleton (&fixture);
+    edit_snapshot (&fixture, "snapshot", "daemon-version", "0.0.1");
+    skeleton = new_skeleton ();
+    g_assert (!lookup (&fixture, skeleton));
+    g_clear_object (&skeleton);
+
+    /* Unsupported format version */
+    store_loaded_skeleton (&fixture);
+    edit_snapshot (&fixture, "snapshot", "version", "1000");
+    skeleton = new_skeleton ();
+    g_assert (!lookup (&fixture, skeleton));
+    g_clear_object (&skeleton);
+
+    /* Written again by this daemon version */
+    store_loaded_skeleton (&fixture);
+    skeleton = new_skeleton ();
+    g_assert (lookup (&fixture, skeleton));
+
+    g_object_unref (skeleton);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_flush_disabled (void)
+{
+    Fixture                     fixture;
+    g_autoptr(MMModemSnapshot)  snapshot = NULL;
+    MmGdbusModem               *skeleton;
+
+    fixture_setup (&fixture);
+    store_loaded_skeleton (&fixture);
+
+    snapshot = mm_modem_snapshot_new (fixture.path);
+    mm_modem_snapshot_flush (snapshot);
+    g_assert (!g_file_test (fixture.path, G_FILE_TEST_EXISTS));
+    g_assert (!has_device (snapshot, DEVICE));
+    g_clear_object (&snapshot);
+
+    /* Nothing stored nor looked up without a path */
+    snapshot = mm_modem_snapshot_new (NULL);
+    skeleton = new_skeleton ();
+    set_loaded_ids (skeleton, "FW 1.0");
+    mm_gdbus_modem_set_model (skeleton, "Model");
+    mm_modem_snapshot_store (snapshot, skeleton);
+    g_assert (!g_file_test (fixture.path, G_FILE_TEST_EXISTS));
+    g_object_unref (skeleton);
+    g_assert (!has_device (snapshot, DEVICE));
+
+    fixture_teardown (&fixture);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/modem-snapshot/store-lookup",       test_store_lookup);
+    g_test_add_func ("/MM/modem-snapshot/lookup-loaded",      test_lookup_loaded);
+    g_test_add_func ("/MM/modem-snapshot/lookup-other-modem", test_lookup_other_modem);
+    g_test_add_func ("/MM/modem-snapshot/confirm",            test_confirm);
+    g_test_add_func ("/MM/modem-snapshot/max-modems",         test_max_modems);
+    g_test_add_func ("/MM/modem-snapshot/expire",             test_expire);
+    g_test_add_func ("/MM/modem-snapshot/version",            test_version);
+    g_test_add_func ("/MM/modem-snapshot/flush-disabled",     test_flush_disabled);
+
+    return g_test_run ();
+}
@@ -0,0 +1,239 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-port-trace.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static gchar *
+build_capture_path (void)
+{
+    gchar *path = NULL;
+    gint   fd;
+
+    fd = g_file_open_tmp ("test-port-trace-XXXXXX", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    return path;
+}
+
+static void
+check_next_channel (MMPortTraceReader *reader,
+                    guint              channel,
+                    guint              port_type,
+                    const gchar       *name)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *record_name = NULL;
+    MMPortTraceRecord  record;
+
+    g_assert (mm_port_trace_reader_next (reader, &record, &error));
+    g_assert_no_error (error);
+    g_assert_cmpuint (record.type, ==, MM_PORT_TRACE_RECORD_TYPE_CHANNEL);
+    g_assert_cmpuint (record.channel, ==, channel);
+    g_assert_cmpuint (mm_port_trace_record_get_port_type (&record), ==, port_type);
+    record_name = mm_port_trace_record_get_name (&record);
+    g_assert_cmpstr (record_name, ==, name);
+}
+
+static void
+check_next_data (MMPortTraceReader    *reader,
+                 guint                 channel,
+                 MMPortTraceDirection  direction,
+                 gconstpointer         data,
+                 gsize                 len)
+{
+    g_autoptr(GError) error = NULL;
+    MMPortTraceRecord record;
+
+    g_assert (mm_port_trace_reader_next (reader, &record, &error));
+    g_assert_no_error (error);
+    g_assert_cmpuint (record.type, ==, MM_PORT_TRACE_RECORD_TYPE_DATA);
+    g_assert_cmpuint (record.channel, ==, channel);
+    g_assert_cmpuint (record.direction, ==, direction);
+    g_assert_cmpmem (record.data, record.len, data, len);
+    g_assert_cmpuint (record.timestamp, >, 0);
+}
+
+static void
+write_capture (const gchar *path)
+{
+    g_autoptr(GError) error = NULL;
+    static const guint8 qcdm[] = { 0x00, 0x78, 0xf0, 0x7e };
+    guint channel_at;
+    guint channel_qcdm;
+
+    g_assert (!mm_port_trace_is_enabled ());
+    g_assert_cmpuint (mm_port_trace_get_channel ("ttyUSB2", 3), ==, 0);
+
+    g_assert (mm_port_trace_open (path, &error));
+    g_assert_no_error (error);
+    g_assert (mm_port_trace_is_enabled ());
+
+    channel_at = mm_port_trace_get_channel ("ttyUSB2", 3);
+    channel_qcdm = mm_port_trace_get_channel ("ttyUSB0", 4);
+    g_assert_cmpuint (channel_at, >, 0);
+    g_assert_cmpuint (channel_qcdm, >, 0);
+    g_assert_cmpuint (channel_at, !=, channel_qcdm);
+    /* Channels are defined once */
+    g_assert_cmpuint (mm_port_trace_get_channel ("ttyUSB2", 3), ==, channel_at);
+
+    mm_port_trace_record (channel_at, MM_PORT_TRACE_DIRECTION_OUT, "AT\r", 3);
+    mm_port_trace_record (channel_qcdm, MM_PORT_TRACE_DIRECTION_OUT, qcdm, sizeof (qcdm));
+    mm_port_trace_record (channel_at, MM_PORT_TRACE_DIRECTION_IN, "\r\nOK\r\n", 6);
+    /* Empty data is never recorded */
+    mm_port_trace_record (channel_at, MM_PORT_TRACE_DIRECTION_IN, "", 0);
+
+    mm_port_trace_close ();
+    g_assert (!mm_port_trace_is_enabled ());
+}
+
+static void
+test_write_read (void)
+{
+    g_autofree gchar              *path = NULL;
+    g_autoptr(MMPortTraceReader)   reader = NULL;
+    g_autoptr(GError)              error = NULL;
+    MMPortTraceRecord              record;
+    static const guint8            qcdm[] = { 0x00, 0x78, 0xf0, 0x7e };
+
+    path = build_capture_path ();
+    write_capture (path);
+
+    reader = mm_port_trace_reader_new (path, &error);
+    g_assert_no_error (error);
+    g_assert (reader);
+
+    check_next_channel (reader, 1, 3, "ttyUSB2");
+    check_next_channel (reader, 2, 4, "ttyUSB0");
+    check_next_data (reader, 1, MM_PORT_TRACE_DIRECTION_OUT, "AT\r", 3);
+    check_next_data (reader, 2, MM_PORT_TRACE_DIRECTION_OUT, qcdm, sizeof (qcdm));
+    check_next_data (reader, 1, MM_PORT_TRACE_DIRECTION_IN, "\r\nOK\r\n", 6);
+
+    g_assert (!mm_port_trace_reader_next (reader, &record, &error));
+    g_assert_no_error (error);
+
+    g_unlink (path);
+}
+
+static void
+test_truncated (void)
+{
+    g_autofree gchar              *path = NULL;
+    g_autofree gchar              *contents = NULL;
+    g_autoptr(MMPortTraceReader)   reader = NULL;
+    g_autoptr(GError)              error = NULL;
+    MMPortTraceRecord              record;
+    gsize                          len;
+    guint                          n_records = 0;
+
+    path = build_capture_path ();
+    write_capture (path);
+
+    /* Cut the last record in half */
+    g_assert (g_file_get_contents (path, &contents, &len, NULL));
+    g_assert (g_file_set_contents (path, contents, len - 3, NULL));
+
+    reader = mm_port_trace_reader_new (path, &error);
+    g_assert_no_error (error);
+
+    while (mm_port_trace_reader_next (reader, &record, &error))
+        n_records++;
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert_cmpuint (n_records, ==, 4);
+
+    g_unlink (path);
+}
+
+static void
+test_invalid (void)
+{
+    g_autofree gchar              *path = NULL;
+    g_autoptr(MMPortTraceReader)   reader = NULL;
+    g_autoptr(GError)              error = NULL;
+
+    path = build_capture_path ();
+    g_assert (g_file_set_contents (path, "AT\r\r\nOK\r\n and some more text", -1, NULL));
+
+    reader = mm_port_trace_reader_new (path, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert (!reader);
+
+    g_unlink (path);
+}
+
+static gboolean
+quit_cb (GMainLoop *loop)
+{
+    g_main_loop_quit (loop);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+test_flush (void)
+{
+    g_autofree gchar     *path = NULL;
+    g_autoptr(GError)     error = NULL;
+    g_autoptr(GMainLoop)  loop = NULL;
+    GStatBuf              st;
+    guint                 channel;
+
+    path = build_capture_path ();
+    g_assert (mm_port_trace_open (path, &error));
+    g_assert_no_error (error);
+
+    channel = mm_port_trace_get_channel ("ttyUSB2", 3);
+    mm_port_trace_record (channel, MM_PORT_TRACE_DIRECTION_OUT, "AT\r", 3);
+
+    /* Records are buffered, only the file header is on disk */
+    g_assert_cmpint (g_stat (path, &st), ==, 0);
+    g_assert_cmpint (st.st_size, ==, MM_PORT_TRACE_HEADER_SIZE);
+
+    /* And written once the flush timeout fires */
+    loop = g_main_loop_new (NULL, FALSE);
+    g_timeout_add_seconds (2, (GSourceFunc) quit_cb, loop);
+    g_main_loop_run (loop);
+    g_assert_cmpint (g_stat (path, &st), ==, 0);
+    g_assert_cmpint (st.st_size, ==, MM_PORT_TRACE_HEADER_SIZE +
+                                     MM_PORT_TRACE_RECORD_SIZE + 8 +
+                                     MM_PORT_TRACE_RECORD_SIZE + 3);
+
+    mm_port_trace_close ();
+    g_unlink (path);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/port-trace/write-read", test_write_read);
+    g_test_add_func ("/MM/port-trace/truncated", test_truncated);
+    g_test_add_func ("/MM/port-trace/invalid", test_invalid);
+    g_test_add_func ("/MM/port-trace/flush", test_flush);
+
+    return g_test_run ();
+}
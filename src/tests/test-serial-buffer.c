@@ -0,0 +1,149 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+
+#include "mm-serial-buffer.h"
+#include "mm-log-test.h"
+
+static void
+test_append_consume (void)
+{
+    MMSerialBuffer *buffer;
+    guint8         *data;
+
+    buffer = mm_serial_buffer_new (16);
+    g_assert_cmpuint (mm_serial_buffer_get_capacity (buffer), ==, 16);
+
+    mm_serial_buffer_append (buffer, (const guint8 *) "\r\nOK\r\n", 6);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 6);
+
+    /* Consuming from the head doesn't move data */
+    data = mm_serial_buffer_get_data (buffer);
+    mm_serial_buffer_consume (buffer, 2);
+    g_assert (mm_serial_buffer_get_data (buffer) == data + 2);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 4);
+    g_assert (memcmp (mm_serial_buffer_get_data (buffer), "OK\r\n", 4) == 0);
+
+    /* Fully consuming rewinds the read cursor */
+    mm_serial_buffer_consume (buffer, 4);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 0);
+    g_assert (mm_serial_buffer_get_data (buffer) == data);
+
+    mm_serial_buffer_free (buffer);
+}
+
+static void
+test_linearize (void)
+{
+    MMSerialBuffer *buffer;
+    guint8         *data;
+
+    buffer = mm_serial_buffer_new (16);
+    data = mm_serial_buffer_get_data (buffer);
+
+    mm_serial_buffer_append (buffer, (const guint8 *) "0123456789ab", 12);
+    mm_serial_buffer_consume (buffer, 10);
+
+    /* No room at the tail, but enough in total: contents moved to the start
+     * of the storage, without growing it */
+    mm_serial_buffer_append (buffer, (const guint8 *) "cdefghij", 8);
+    g_assert_cmpuint (mm_serial_buffer_get_capacity (buffer), ==, 16);
+    g_assert (mm_serial_buffer_get_data (buffer) == data);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 10);
+    g_assert (memcmp (mm_serial_buffer_get_data (buffer), "abcdefghij", 10) == 0);
+
+    mm_serial_buffer_free (buffer);
+}
+
+static void
+test_grow (void)
+{
+    MMSerialBuffer *buffer;
+    guint8         *tail;
+    guint           i;
+
+    buffer = mm_serial_buffer_new (20);
+    g_assert_cmpuint (mm_serial_buffer_get_capacity (buffer), ==, 32);
+
+    for (i = 0; i < 100; i++)
+        mm_serial_buffer_append (buffer, (const guint8 *) "x", 1);
+    g_assert_cmpuint (mm_serial_buffer_get_capacity (buffer), ==, 128);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 100);
+
+    /* Reserve + commit, as done when reading from the port */
+    tail = mm_serial_buffer_reserve (buffer, 64);
+    memcpy (tail, "yy", 2);
+    mm_serial_buffer_commit (buffer, 2);
+    g_assert_cmpuint (mm_serial_buffer_get_capacity (buffer), ==, 256);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 102);
+    g_assert (memcmp (mm_serial_buffer_get_data (buffer) + 99, "xyy", 3) == 0);
+
+    mm_serial_buffer_truncate (buffer, 50);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 50);
+
+    mm_serial_buffer_clear (buffer);
+    g_assert_cmpuint (mm_serial_buffer_get_len (buffer), ==, 0);
+
+    mm_serial_buffer_free (buffer);
+}
+
+static void
+test_generation (void)
+{
+    MMSerialBuffer *buffer;
+    guint           generation;
+
+    buffer = mm_serial_buffer_new (16);
+    generation = mm_serial_buffer_get_generation (buffer);
+    g_assert_cmpuint (generation, !=, 0);
+
+    /* Appending, even if the storage is linearized or grown, keeps it */
+    mm_serial_buffer_append (buffer, (const guint8 *) "0123456789ab", 12);
+    mm_serial_buffer_append (buffer, (const guint8 *) "cdefghijklmn", 12);
+    g_assert_cmpuint (mm_serial_buffer_get_generation (buffer), ==, generation);
+
+    /* No-op changes keep it too */
+    mm_serial_buffer_consume (buffer, 0);
+    mm_serial_buffer_truncate (buffer, 24);
+    g_assert_cmpuint (mm_serial_buffer_get_generation (buffer), ==, generation);
+
+    mm_serial_buffer_consume (buffer, 2);
+    g_assert_cmpuint (mm_serial_buffer_get_generation (buffer), !=, generation);
+    generation = mm_serial_buffer_get_generation (buffer);
+
+    mm_serial_buffer_truncate (buffer, 10);
+    g_assert_cmpuint (mm_serial_buffer_get_generation (buffer), !=, generation);
+    generation = mm_serial_buffer_get_generation (buffer);
+
+    mm_serial_buffer_clear (buffer);
+    g_assert_cmpuint (mm_serial_buffer_get_generation (buffer), !=, generation);
+
+    mm_serial_buffer_free (buffer);
+}
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/serial-buffer/append-consume", test_append_consume);
+    g_test_add_func ("/MM/serial-buffer/linearize",      test_linearize);
+    g_test_add_func ("/MM/serial-buffer/grow",           test_grow);
+    g_test_add_func ("/MM/serial-buffer/generation",     test_generation);
+
+    return g_test_run ();
+}
@@ -0,0 +1,260 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <glib.h>
+
+#include "mm-signal-report.h"
+#include "mm-log-test.h"
+
+#define SIGNAL_QUALITY      MM_SIGNAL_REPORT_VALUE_SIGNAL_QUALITY
+#define ACCESS_TECHNOLOGIES MM_SIGNAL_REPORT_VALUE_ACCESS_TECHNOLOGIES
+
+/* Monotonic times, in seconds */
+#define SECONDS(s) ((gint64) (s) * G_USEC_PER_SEC)
+
+static MMSignalReport *
+new_report (guint keep_alive_sec)
+{
+    MMSignalReport *report;
+
+    report = mm_signal_report_new (keep_alive_sec);
+    mm_signal_report_set_polling_supported (report, SIGNAL_QUALITY, TRUE);
+    mm_signal_report_set_polling_supported (report, ACCESS_TECHNOLOGIES, TRUE);
+    return report;
+}
+
+/* Runs a whole check at the given time, polling the values needed with the
+ * given results, and returns the timeout to the next one */
+static guint
+run_check (MMSignalReport *report,
+           gint64          now,
+           guint           signal_quality,
+           guint           access_technologies,
+           gboolean       *out_signal_quality_polled,
+           gboolean       *out_access_technologies_polled)
+{
+    gboolean signal_quality_polled;
+    gboolean access_technologies_polled;
+
+    mm_signal_report_start_check (report);
+    signal_quality_polled = mm_signal_report_poll_needed (report, SIGNAL_QUALITY, now);
+    if (signal_quality_polled)
+        mm_signal_report_polled (report, SIGNAL_QUALITY, signal_quality);
+    access_technologies_polled = mm_signal_report_poll_needed (report, ACCESS_TECHNOLOGIES, now);
+    if (access_technologies_polled)
+        mm_signal_report_polled (report, ACCESS_TECHNOLOGIES, access_technologies);
+
+    if (out_signal_quality_polled)
+        *out_signal_quality_polled = signal_quality_polled;
+    if (out_access_technologies_polled)
+        *out_access_technologies_polled = access_technologies_polled;
+    return mm_signal_report_end_check (report, now);
+}
+
+static void
+check_stats (MMSignalReport     *report,
+             MMSignalReportMode  expected_mode,
+             guint               expected_n_indications,
+             guint               expected_n_polls)
+{
+    MMSignalReportMode mode;
+    guint              n_indications;
+    guint              n_polls;
+
+    mm_signal_report_get_stats (report, &mode, &n_indications, &n_polls);
+    g_assert_cmpstr (mm_signal_report_mode_get_string (mode), ==, mm_signal_report_mode_get_string (expected_mode));
+    g_assert_cmpuint (n_indications, ==, expected_n_indications);
+    g_assert_cmpuint (n_polls, ==, expected_n_polls);
+}
+
+/*****************************************************************************/
+
+static void
+test_initial_check (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+    gboolean                  signal_quality_polled;
+    gboolean                  access_technologies_polled;
+
+    report = new_report (0);
+
+    /* Everything polled until the initial check is done, even values
+     * just reported through indications */
+    mm_signal_report_set_indications (report, SIGNAL_QUALITY, TRUE);
+    mm_signal_report_indication (report, ACCESS_TECHNOLOGIES, SECONDS (1));
+    mm_signal_report_start_check (report);
+    g_assert (mm_signal_report_poll_needed (report, SIGNAL_QUALITY, SECONDS (1)));
+    g_assert (mm_signal_report_poll_needed (report, ACCESS_TECHNOLOGIES, SECONDS (1)));
+
+    /* Unless unsupported */
+    mm_signal_report_set_polling_supported (report, ACCESS_TECHNOLOGIES, FALSE);
+    g_assert (!mm_signal_report_poll_needed (report, ACCESS_TECHNOLOGIES, SECONDS (1)));
+    g_assert (!mm_signal_report_get_polling_supported (report, ACCESS_TECHNOLOGIES));
+
+    /* Once done, the value without indications keeps being polled */
+    mm_signal_report_set_polling_supported (report, ACCESS_TECHNOLOGIES, TRUE);
+    mm_signal_report_initial_check_done (report, SECONDS (2));
+    g_assert_cmpuint (run_check (report, SECONDS (200), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+    g_assert (!signal_quality_polled);
+    g_assert (access_technologies_polled);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_POLLING, 1, 1);
+}
+
+static void
+test_indications_fresh (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+    gboolean                  signal_quality_polled;
+    gboolean                  access_technologies_polled;
+
+    report = new_report (0);
+    mm_signal_report_initial_check_done (report, SECONDS (1));
+
+    /* Both values recently reported: nothing polled, and the next check
+     * once the oldest one is stale */
+    mm_signal_report_indication (report, SIGNAL_QUALITY, SECONDS (10));
+    mm_signal_report_indication (report, ACCESS_TECHNOLOGIES, SECONDS (20));
+    g_assert_cmpuint (run_check (report, SECONDS (30), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, MM_SIGNAL_REPORT_STALE_TIMEOUT_SEC - 20);
+    g_assert (!signal_quality_polled);
+    g_assert (!access_technologies_polled);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_INDICATIONS, 2, 0);
+
+    /* Then only the stale one is polled */
+    g_assert_cmpuint (run_check (report, SECONDS (130), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, 10);
+    g_assert (signal_quality_polled);
+    g_assert (!access_technologies_polled);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_POLLING, 2, 1);
+}
+
+static void
+test_indications_setup (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+    gboolean                  signal_quality_polled;
+    gboolean                  access_technologies_polled;
+
+    /* Without keep-alive, values with indications set up are never polled
+     * after the initial check, even if no indication is received */
+    report = new_report (0);
+    mm_signal_report_set_indications (report, SIGNAL_QUALITY, TRUE);
+    mm_signal_report_set_indications (report, ACCESS_TECHNOLOGIES, TRUE);
+    mm_signal_report_initial_check_done (report, SECONDS (1));
+    g_assert_cmpuint (run_check (report, SECONDS (1000), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, 0);
+    g_assert (!signal_quality_polled);
+    g_assert (!access_technologies_polled);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_INDICATIONS, 0, 0);
+
+    /* Unless only one of them has */
+    mm_signal_report_set_indications (report, ACCESS_TECHNOLOGIES, FALSE);
+    g_assert_cmpuint (run_check (report, SECONDS (1000), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+    g_assert (!signal_quality_polled);
+    g_assert (access_technologies_polled);
+}
+
+static void
+test_keep_alive (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+    gboolean                  signal_quality_polled;
+
+    report = new_report (600);
+    mm_signal_report_set_indications (report, SIGNAL_QUALITY, TRUE);
+    mm_signal_report_set_polling_supported (report, ACCESS_TECHNOLOGIES, FALSE);
+    mm_signal_report_initial_check_done (report, SECONDS (100));
+
+    /* Trusted since the initial check, and then since the last indication */
+    g_assert_cmpuint (run_check (report, SECONDS (400), 50, 0, &signal_quality_polled, NULL), ==, 300);
+    g_assert (!signal_quality_polled);
+    mm_signal_report_indication (report, SIGNAL_QUALITY, SECONDS (500));
+    g_assert_cmpuint (run_check (report, SECONDS (700), 50, 0, &signal_quality_polled, NULL), ==, 400);
+    g_assert (!signal_quality_polled);
+
+    /* Polled once no indication is received within the keep-alive */
+    g_assert_cmpuint (run_check (report, SECONDS (1100), 50, 0, &signal_quality_polled, NULL),
+                      ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+    g_assert (signal_quality_polled);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_POLLING, 1, 1);
+}
+
+static void
+test_backoff (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+
+    report = new_report (0);
+    mm_signal_report_initial_check_done (report, SECONDS (1));
+
+    /* The interval grows while the polled values don't change */
+    g_assert_cmpuint (run_check (report, SECONDS (10), 50, 4, NULL, NULL), ==, 30);
+    g_assert_cmpuint (run_check (report, SECONDS (40), 50, 4, NULL, NULL), ==, 60);
+    g_assert_cmpuint (run_check (report, SECONDS (100), 50, 4, NULL, NULL), ==, 120);
+    g_assert_cmpuint (run_check (report, SECONDS (220), 50, 4, NULL, NULL), ==, MM_SIGNAL_REPORT_MAX_POLL_TIMEOUT_SEC);
+
+    /* And is reset as soon as any of them does */
+    g_assert_cmpuint (run_check (report, SECONDS (340), 50, 8, NULL, NULL), ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+    g_assert_cmpuint (run_check (report, SECONDS (370), 50, 8, NULL, NULL), ==, 60);
+    g_assert_cmpuint (run_check (report, SECONDS (430), 45, 8, NULL, NULL), ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+}
+
+static void
+test_clear_restart (void)
+{
+    g_autoptr(MMSignalReport) report = NULL;
+    gboolean                  signal_quality_polled;
+    gboolean                  access_technologies_polled;
+
+    report = new_report (0);
+    mm_signal_report_set_indications (report, SIGNAL_QUALITY, TRUE);
+    mm_signal_report_initial_check_done (report, SECONDS (1));
+    mm_signal_report_indication (report, ACCESS_TECHNOLOGIES, SECONDS (10));
+    g_assert_cmpuint (run_check (report, SECONDS (10), 50, 4, NULL, NULL), ==, MM_SIGNAL_REPORT_STALE_TIMEOUT_SEC);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_INDICATIONS, 1, 0);
+
+    /* Restarting polls everything again */
+    mm_signal_report_restart (report);
+    mm_signal_report_start_check (report);
+    g_assert (mm_signal_report_poll_needed (report, SIGNAL_QUALITY, SECONDS (20)));
+    g_assert (mm_signal_report_poll_needed (report, ACCESS_TECHNOLOGIES, SECONDS (20)));
+
+    /* Indications received before clearing no longer count */
+    mm_signal_report_clear (report);
+    check_stats (report, MM_SIGNAL_REPORT_MODE_NONE, 1, 0);
+    mm_signal_report_initial_check_done (report, SECONDS (30));
+    g_assert_cmpuint (run_check (report, SECONDS (40), 50, 4, &signal_quality_polled, &access_technologies_polled),
+                      ==, MM_SIGNAL_REPORT_POLL_TIMEOUT_SEC);
+    g_assert (!signal_quality_polled);
+    g_assert (access_technologies_polled);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/signal-report/initial-check",     test_initial_check);
+    g_test_add_func ("/MM/signal-report/indications-fresh", test_indications_fresh);
+    g_test_add_func ("/MM/signal-report/indications-setup", test_indications_setup);
+    g_test_add_func ("/MM/signal-report/keep-alive",        test_keep_alive);
+    g_test_add_func ("/MM/signal-report/backoff",           test_backoff);
+    g_test_add_func ("/MM/signal-report/clear-restart",     test_clear_restart);
+
+    return g_test_run ();
+}
@@ -0,0 +1,336 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sms-part.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static void
+test_part_index_basic (void)
+{
+    g_autoptr(MMSmsPartIndex)  part_index = NULL;
+    GList                     *owners;
+    gpointer                   a = GUINT_TO_POINTER (1);
+    gpointer                   b = GUINT_TO_POINTER (2);
+
+    part_index = mm_sms_part_index_new ();
+
+    /* Not stored parts are never indexed */
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_UNKNOWN, 3, a);
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_ME, SMS_PART_INVALID_INDEX, a);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_UNKNOWN, 3) == NULL);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, SMS_PART_INVALID_INDEX) == NULL);
+
+    /* Same index in different storages */
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_ME, 3, a);
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_SM, 3, b);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, 3) == a);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_SM, 3) == b);
+
+    /* Reference 0 is valid in received messages */
+    mm_sms_part_index_add_multipart (part_index, 0, a);
+    owners = mm_sms_part_index_peek_multiparts (part_index, 0);
+    g_assert_cmpuint (g_list_length (owners), ==, 1);
+    g_assert (owners->data == a);
+
+    mm_sms_part_index_add_multipart (part_index, 7, a);
+    owners = mm_sms_part_index_peek_multiparts (part_index, 7);
+    g_assert_cmpuint (g_list_length (owners), ==, 1);
+    g_assert (owners->data == a);
+    g_assert (mm_sms_part_index_peek_multiparts (part_index, 8) == NULL);
+
+    /* Same reference, most recent first; adding twice is a no-op */
+    mm_sms_part_index_add_multipart (part_index, 7, b);
+    mm_sms_part_index_add_multipart (part_index, 7, b);
+    owners = mm_sms_part_index_peek_multiparts (part_index, 7);
+    g_assert_cmpuint (g_list_length (owners), ==, 2);
+    g_assert (owners->data == b);
+
+    /* A part taken over by a different owner isn't removed with the
+     * original one */
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_ME, 3, b);
+    mm_sms_part_index_remove_owner (part_index, a);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, 3) == b);
+    owners = mm_sms_part_index_peek_multiparts (part_index, 7);
+    g_assert_cmpuint (g_list_length (owners), ==, 1);
+    g_assert (owners->data == b);
+    g_assert (mm_sms_part_index_peek_multiparts (part_index, 0) == NULL);
+
+    mm_sms_part_index_remove_owner (part_index, b);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, 3) == NULL);
+    g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_SM, 3) == NULL);
+    g_assert (mm_sms_part_index_peek_multiparts (part_index, 7) == NULL);
+
+    /* Unknown owners are ignored */
+    mm_sms_part_index_remove_owner (part_index, a);
+}
+
+/*****************************************************************************/
+/* Reassembly of a full storage listing, the way MMSmsList does it */
+
+/* Concat references are 8-bit, so keep them unique across messages */
+#define N_MESSAGES          200
+#define N_PARTS_PER_MESSAGE 5
+#define N_NUMBERS           20
+#define N_FRAGMENTS         (N_MESSAGES * N_PARTS_PER_MESSAGE)
+G_STATIC_ASSERT (N_MESSAGES <= 256);
+
+typedef struct {
+    gchar *number;
+    guint  reference;
+    GList *parts;
+} TestSms;
+
+static void
+test_sms_free (TestSms *sms)
+{
+    g_free (sms->number);
+    g_list_free_full (sms->parts, (GDestroyNotify) mm_sms_part_free);
+    g_slice_free (TestSms, sms);
+}
+
+static gboolean
+test_sms_has_part_index (TestSms *sms,
+                         guint    index)
+{
+    GList *l;
+
+    for (l = sms->parts; l; l = g_list_next (l)) {
+        if (mm_sms_part_get_index ((MMSmsPart *)l->data) == index)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static GPtrArray *
+build_fragments (void)
+{
+    GPtrArray *fragments;
+    guint      i;
+
+    /* Parts are owned by the messages once taken */
+    fragments = g_ptr_array_sized_new (N_FRAGMENTS);
+    for (i = 0; i < N_FRAGMENTS; i++) {
+        MMSmsPart        *part;
+        guint             message;
+        g_autofree gchar *number = NULL;
+
+        message = i / N_PARTS_PER_MESSAGE;
+        number = g_strdup_printf ("+346%08u", message % N_NUMBERS);
+
+        part = mm_sms_part_new (i, MM_SMS_PDU_TYPE_DELIVER);
+        mm_sms_part_set_number (part, number);
+        mm_sms_part_set_concat_reference (part, message);
+        mm_sms_part_set_concat_max (part, N_PARTS_PER_MESSAGE);
+        mm_sms_part_set_concat_sequence (part, 1 + i % N_PARTS_PER_MESSAGE);
+        g_ptr_array_add (fragments, part);
+    }
+
+    /* Random listing order */
+    for (i = N_FRAGMENTS - 1; i > 0; i--) {
+        guint    j;
+        gpointer tmp;
+
+        j = g_test_rand_int_range (0, i + 1);
+        tmp = fragments->pdata[i];
+        fragments->pdata[i] = fragments->pdata[j];
+        fragments->pdata[j] = tmp;
+    }
+
+    return fragments;
+}
+
+static TestSms *
+take_part_indexed (MMSmsPartIndex  *part_index,
+                   GList          **list,
+                   MMSmsPart       *part)
+{
+    TestSms *sms;
+    GList   *owners;
+
+    sms = mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, mm_sms_part_get_index (part));
+    if (sms && test_sms_has_part_index (sms, mm_sms_part_get_index (part)))
+        return NULL;
+
+    owners = mm_sms_part_index_peek_multiparts (part_index, mm_sms_part_get_concat_reference (part));
+    if (owners)
+        sms = owners->data;
+    else {
+        sms = g_slice_new0 (TestSms);
+        sms->number = g_strdup (mm_sms_part_get_number (part));
+        sms->reference = mm_sms_part_get_concat_reference (part);
+        *list = g_list_prepend (*list, sms);
+        mm_sms_part_index_add_multipart (part_index, sms->reference, sms);
+    }
+
+    sms->parts = g_list_prepend (sms->parts, part);
+    mm_sms_part_index_add_part (part_index, MM_SMS_STORAGE_ME, mm_sms_part_get_index (part), sms);
+    return sms;
+}
+
+static TestSms *
+take_part_linear (GList     **list,
+                  MMSmsPart  *part)
+{
+    TestSms *sms = NULL;
+    GList   *l;
+
+    for (l = *list; l; l = g_list_next (l)) {
+        if (test_sms_has_part_index ((TestSms *)l->data, mm_sms_part_get_index (part)))
+            return NULL;
+    }
+
+    for (l = *list; l; l = g_list_next (l)) {
+        TestSms *candidate = l->data;
+
+        if (candidate->reference == mm_sms_part_get_concat_reference (part)) {
+            sms = candidate;
+            break;
+        }
+    }
+
+    if (!sms) {
+        sms = g_slice_new0 (TestSms);
+        sms->number = g_strdup (mm_sms_part_get_number (part));
+        sms->reference = mm_sms_part_get_concat_reference (part);
+        *list = g_list_prepend (*list, sms);
+    }
+
+    sms->parts = g_list_prepend (sms->parts, part);
+    return sms;
+}
+
+static void
+check_reassembled (GList *list)
+{
+    GList *l;
+
+    g_assert_cmpuint (g_list_length (list), ==, N_MESSAGES);
+    for (l = list; l; l = g_list_next (l)) {
+        TestSms *sms = l->data;
+        GList   *k;
+
+        g_assert_cmpuint (g_list_length (sms->parts), ==, N_PARTS_PER_MESSAGE);
+        for (k = sms->parts; k; k = g_list_next (k)) {
+            MMSmsPart *part = k->data;
+
+            g_assert_cmpuint (mm_sms_part_get_concat_reference (part), ==, sms->reference);
+            g_assert_cmpstr (mm_sms_part_get_number (part), ==, sms->number);
+        }
+    }
+}
+
+static void
+test_part_index_random_order (void)
+{
+    g_autoptr(MMSmsPartIndex)  part_index = NULL;
+    g_autoptr(GPtrArray)       fragments = NULL;
+    GList                     *list = NULL;
+    GList                     *l;
+    guint                      i;
+
+    part_index = mm_sms_part_index_new ();
+    fragments = build_fragments ();
+
+    for (i = 0; i < fragments->len; i++) {
+        MMSmsPart *part = fragments->pdata[i];
+        TestSms   *sms;
+
+        sms = take_part_indexed (part_index, &list, part);
+        g_assert (sms);
+
+        /* The same part is never taken twice */
+        g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, mm_sms_part_get_index (part)) == sms);
+        g_assert (take_part_indexed (part_index, &list, part) == NULL);
+    }
+    check_reassembled (list);
+
+    /* Removing messages leaves no stale entries behind */
+    for (l = list; l; l = g_list_next (l)) {
+        TestSms *sms = l->data;
+        GList   *k;
+
+        mm_sms_part_index_remove_owner (part_index, sms);
+        g_assert (mm_sms_part_index_peek_multiparts (part_index, sms->reference) == NULL);
+        for (k = sms->parts; k; k = g_list_next (k))
+            g_assert (mm_sms_part_index_lookup_part (part_index, MM_SMS_STORAGE_ME, mm_sms_part_get_index ((MMSmsPart *)k->data)) == NULL);
+    }
+
+    g_list_free_full (list, (GDestroyNotify) test_sms_free);
+}
+
+static void
+test_part_index_random_order_perf (void)
+{
+    g_autoptr(MMSmsPartIndex)  part_index = NULL;
+    g_autoptr(GPtrArray)       fragments_indexed = NULL;
+    g_autoptr(GPtrArray)       fragments_linear = NULL;
+    GList                     *list_indexed = NULL;
+    GList                     *list_linear = NULL;
+    gdouble                    elapsed_indexed;
+    gdouble                    elapsed_linear;
+    guint                      i;
+
+    part_index = mm_sms_part_index_new ();
+    fragments_indexed = build_fragments ();
+    fragments_linear = build_fragments ();
+
+    g_test_timer_start ();
+    for (i = 0; i < fragments_linear->len; i++) {
+        g_assert (take_part_linear (&list_linear, fragments_linear->pdata[i]));
+    }
+    elapsed_linear = g_test_timer_elapsed ();
+
+    g_test_timer_start ();
+    for (i = 0; i < fragments_indexed->len; i++) {
+        g_assert (take_part_indexed (part_index, &list_indexed, fragments_indexed->pdata[i]));
+    }
+    elapsed_indexed = g_test_timer_elapsed ();
+
+    check_reassembled (list_linear);
+    check_reassembled (list_indexed);
+
+    g_test_message ("%u fragments reassembled with a linear scan in %.6f seconds", N_FRAGMENTS, elapsed_linear);
+    g_test_minimized_result (elapsed_indexed,
+                             "%u fragments reassembled with the part index in %.6f seconds",
+                             N_FRAGMENTS, elapsed_indexed);
+
+    g_list_free_full (list_linear, (GDestroyNotify) test_sms_free);
+    g_list_free_full (list_indexed, (GDestroyNotify) test_sms_free);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/sms-part-index/basic", test_part_index_basic);
+    g_test_add_func ("/MM/sms-part-index/random-order", test_part_index_random_order);
+
+    if (g_test_perf ())
+        g_test_add_func ("/MM/sms-part-index/perf/random-order", test_part_index_random_order_perf);
+
+    return g_test_run ();
+}
@@ -0,0 +1,253 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include <config.h>
+#include <glib.h>
+
+#include "mm-timer.h"
+#include "mm-main-loop-monitor.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+/* Log object owning the timers, with a fixed log id */
+
+#define TEST_TYPE_OWNER test_owner_get_type ()
+G_DECLARE_FINAL_TYPE (TestOwner, test_owner, TEST, OWNER, GObject)
+
+struct _TestOwner {
+    GObject parent;
+};
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (TestOwner, test_owner, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+static gchar *
+log_object_build_id (MMLogObject *self)
+{
+    return g_strdup ("owner0");
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+test_owner_init (TestOwner *self)
+{
+}
+
+static void
+test_owner_class_init (TestOwnerClass *klass)
+{
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    GMainLoop *loop;
+    guint      id;
+    guint      other_id;
+    guint      n_runs;
+    guint      max_runs;
+    gboolean   remove_self;
+} TimerContext;
+
+static gboolean
+timer_cb (TimerContext *ctx)
+{
+    ctx->n_runs++;
+
+    if (ctx->other_id) {
+        mm_timer_remove (ctx->other_id);
+        ctx->other_id = 0;
+    }
+
+    if (ctx->remove_self) {
+        mm_timer_remove (ctx->id);
+        g_main_loop_quit (ctx->loop);
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (ctx->n_runs < ctx->max_runs)
+        return G_SOURCE_CONTINUE;
+
+    g_main_loop_quit (ctx->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+unexpected_timer_cb (gpointer unused)
+{
+    g_assert_not_reached ();
+    return G_SOURCE_REMOVE;
+}
+
+/*****************************************************************************/
+
+static void
+test_coalesce (void)
+{
+    g_autoptr(GMainLoop) loop = NULL;
+    TimerContext         first = { 0 };
+    TimerContext         second = { 0 };
+    guint                unexpected_id;
+    guint                n_timers;
+    guint64              n_wakeups_before;
+    guint64              n_callbacks_before;
+    guint64              n_wakeups;
+    guint64              n_callbacks;
+
+    loop = g_main_loop_new (NULL, FALSE);
+    mm_timer_get_stats (NULL, &n_wakeups_before, &n_callbacks_before);
+
+    /* Both timers expire at the same second boundary; the first one removes
+     * a third one with the same deadline before it runs */
+    first.loop = second.loop = loop;
+    first.max_runs = second.max_runs = 1;
+    first.id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, NULL, 1, (GSourceFunc) timer_cb, &first);
+    unexpected_id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, NULL, 1, unexpected_timer_cb, NULL);
+    second.id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, NULL, 1, (GSourceFunc) timer_cb, &second);
+    first.other_id = unexpected_id;
+    g_assert_cmpuint (first.id, !=, second.id);
+
+    mm_timer_get_stats (&n_timers, NULL, NULL);
+    g_assert_cmpuint (n_timers, ==, 3);
+
+    g_main_loop_run (loop);
+
+    g_assert_cmpuint (first.n_runs, ==, 1);
+    g_assert_cmpuint (second.n_runs, ==, 1);
+
+    mm_timer_get_stats (&n_timers, &n_wakeups, &n_callbacks);
+    g_assert_cmpuint (n_timers, ==, 0);
+    g_assert_cmpuint (n_callbacks - n_callbacks_before, ==, 2);
+    g_assert_cmpuint (n_wakeups - n_wakeups_before, ==, 1);
+}
+
+static void
+test_repeat (void)
+{
+    g_autoptr(GMainLoop) loop = NULL;
+    TimerContext         ctx = { 0 };
+    guint                n_timers;
+
+    loop = g_main_loop_new (NULL, FALSE);
+
+    ctx.loop = loop;
+    ctx.max_runs = 2;
+    ctx.id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, NULL, 1, (GSourceFunc) timer_cb, &ctx);
+    g_main_loop_run (loop);
+    g_assert_cmpuint (ctx.n_runs, ==, 2);
+
+    mm_timer_get_stats (&n_timers, NULL, NULL);
+    g_assert_cmpuint (n_timers, ==, 0);
+}
+
+static void
+test_remove_self (void)
+{
+    g_autoptr(GMainLoop) loop = NULL;
+    TimerContext         ctx = { 0 };
+    guint                n_timers;
+
+    loop = g_main_loop_new (NULL, FALSE);
+
+    /* Removed from its own callback, even if asked to run again */
+    ctx.loop = loop;
+    ctx.remove_self = TRUE;
+    ctx.id = mm_timer_add_seconds (MM_TIMER_CLASS_POLLING, NULL, 1, (GSourceFunc) timer_cb, &ctx);
+    g_main_loop_run (loop);
+    g_assert_cmpuint (ctx.n_runs, ==, 1);
+
+    mm_timer_get_stats (&n_timers, NULL, NULL);
+    g_assert_cmpuint (n_timers, ==, 0);
+}
+
+/* Whether any timer dispatch was recorded with the given tag */
+static gboolean
+timer_dispatch_recorded (const gchar *tag)
+{
+    g_autoptr(GVariant)     stats = NULL;
+    g_autoptr(GVariantDict) dict = NULL;
+    g_autoptr(GVariant)     handlers = NULL;
+    GVariantIter            iter;
+    const gchar            *handler_type;
+    const gchar            *handler_tag;
+    GVariant               *handler;
+    gboolean                found = FALSE;
+
+    stats = g_variant_ref_sink (mm_main_loop_monitor_get_stats ());
+    dict = g_variant_dict_new (stats);
+    handlers = g_variant_dict_lookup_value (dict, "handlers", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert (handlers);
+
+    g_variant_iter_init (&iter, handlers);
+    while ((handler = g_variant_iter_next_value (&iter))) {
+        if (g_variant_lookup (handler, "type", "&s", &handler_type) &&
+            g_variant_lookup (handler, "tag", "&s", &handler_tag) &&
+            g_str_equal (handler_type, "timer") &&
+            g_str_equal (handler_tag, tag))
+            found = TRUE;
+        g_variant_unref (handler);
+    }
+    return found;
+}
+
+static void
+test_owner_tag (void)
+{
+    g_autoptr(GMainLoop) loop = NULL;
+    g_autoptr(GObject)   owner = NULL;
+    TimerContext         owned = { 0 };
+    TimerContext         unowned = { 0 };
+
+    mm_main_loop_monitor_setup (TRUE);
+    loop = g_main_loop_new (NULL, FALSE);
+    owner = g_object_new (TEST_TYPE_OWNER, NULL);
+
+    /* Dispatches tagged with the log id of the owner, or the timer class */
+    owned.loop = unowned.loop = loop;
+    owned.max_runs = unowned.max_runs = 1;
+    owned.id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, MM_LOG_OBJECT (owner), 1, (GSourceFunc) timer_cb, &owned);
+    unowned.id = mm_timer_add_seconds (MM_TIMER_CLASS_DEFAULT, NULL, 1, (GSourceFunc) timer_cb, &unowned);
+    g_main_loop_run (loop);
+    g_assert_cmpuint (owned.n_runs, ==, 1);
+    g_assert_cmpuint (unowned.n_runs, ==, 1);
+
+    g_assert (timer_dispatch_recorded ("owner0"));
+    g_assert (timer_dispatch_recorded ("default"));
+    g_assert (!timer_dispatch_recorded ("polling"));
+
+    mm_main_loop_monitor_shutdown ();
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/timer/coalesce", test_coalesce);
+    g_test_add_func ("/MM/timer/repeat", test_repeat);
+    g_test_add_func ("/MM/timer/remove-self", test_remove_self);
+    g_test_add_func ("/MM/timer/owner-tag", test_owner_tag);
+
+    return g_test_run ();
+}
@@ -41,6 +41,65 @@ test_load_cleanup_core (void)
     g_array_unref (rules);
 }
 
+static void
+test_compiled_core (void)
+{
+    GArray *rules;
+    GError *error = NULL;
+    guint   i;
+
+    rules = mm_kernel_device_generic_rules_load (TESTUDEVRULESDIR, &error);
+    g_assert_no_error (error);
+    g_assert (rules);
+
+    for (i = 0; i < rules->len; i++) {
+        MMUdevRule *rule;
+        guint       j;
+
+        rule = &g_array_index (rules, MMUdevRule, i);
+
+        /* GOTOs jump forward to a label */
+        if (rule->result.type == MM_UDEV_RULE_RESULT_TYPE_GOTO_INDEX) {
+            g_assert_cmpuint (rule->result.content.index, >, i);
+            g_assert_cmpuint (rule->result.content.index, <, rules->len);
+            g_assert_cmpuint (g_array_index (rules, MMUdevRule, rule->result.content.index).result.type, ==, MM_UDEV_RULE_RESULT_TYPE_LABEL);
+        }
+
+        if (rule->conditions) {
+            for (j = 0; j < rule->conditions->len; j++)
+                g_assert_cmpuint (g_array_index (rule->conditions, MMUdevRuleMatch, j).parameter_type, !=, MM_UDEV_RULE_MATCH_PARAMETER_UNKNOWN);
+        }
+
+        /* All rules skipped along with a VID/PID/SUBSYSTEM filter have the
+         * same requirement, and the one after them doesn't */
+        g_assert_cmpuint (rule->filter.vid_next, >, i);
+        g_assert_cmpuint (rule->filter.vid_next, <=, rules->len);
+        for (j = i; j < rule->filter.vid_next; j++) {
+            g_assert (g_array_index (rules, MMUdevRule, j).filter.has_vid == rule->filter.has_vid);
+            g_assert_cmpuint (g_array_index (rules, MMUdevRule, j).filter.vid, ==, rule->filter.vid);
+        }
+        if (rule->filter.has_vid && rule->filter.vid_next < rules->len) {
+            MMUdevRuleFilter *next = &g_array_index (rules, MMUdevRule, rule->filter.vid_next).filter;
+
+            g_assert (!next->has_vid || next->vid != rule->filter.vid);
+        }
+
+        g_assert_cmpuint (rule->filter.pid_next, >, i);
+        g_assert_cmpuint (rule->filter.pid_next, <=, rules->len);
+        for (j = i; j < rule->filter.pid_next; j++) {
+            g_assert (g_array_index (rules, MMUdevRule, j).filter.has_pid == rule->filter.has_pid);
+            g_assert_cmpuint (g_array_index (rules, MMUdevRule, j).filter.pid, ==, rule->filter.pid);
+        }
+
+        g_assert_cmpuint (rule->filter.subsystem_next, >, i);
+        g_assert_cmpuint (rule->filter.subsystem_next, <=, rules->len);
+        for (j = i; j < rule->filter.subsystem_next; j++)
+            g_assert (g_array_index (rules, MMUdevRule, j).filter.subsystem == rule->filter.subsystem);
+    }
+
+    g_array_unref (rules);
+}
+
 /************************************************************/
 
 int main (int argc, char **argv)
@@ -50,6 +109,7 @@ int main (int argc, char **argv)
     g_test_init (&argc, &argv, NULL);
 
     g_test_add_func ("/MM/test-udev-rules/load-cleanup-core", test_load_cleanup_core);
+    g_test_add_func ("/MM/test-udev-rules/compiled-core",     test_compiled_core);
 
     return g_test_run ();
 }
@@ -0,0 +1,521 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 The ModemManager authors
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib-unix.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+#include "mm-log-test.h"
+#include "mm-port.h"
+#include "mm-port-enums-types.h"
+#include "mm-port-trace.h"
+
+#define PROGRAM_NAME    "mmtrace"
+#define PROGRAM_VERSION PACKAGE_VERSION
+
+/* Globals */
+static GMainLoop *loop;
+
+/* Context */
+static gchar    *file_str;
+static gboolean  list_flag;
+static gboolean  dump_flag;
+static gchar    *replay_str;
+static gboolean  no_timing_flag;
+static gboolean  verbose_flag;
+static gboolean  version_flag;
+
+static GOptionEntry main_entries[] = {
+    { "file", 'f', 0, G_OPTION_ARG_FILENAME, &file_str,
+      "Capture file, as written by ModemManager --capture-file",
+      "[PATH]"
+    },
+    { "list", 'l', 0, G_OPTION_ARG_NONE, &list_flag,
+      "List the ports in the capture",
+      NULL
+    },
+    { "dump", 'd', 0, G_OPTION_ARG_NONE, &dump_flag,
+      "Print all the captured data",
+      NULL
+    },
+    { "replay", 'r', 0, G_OPTION_ARG_STRING, &replay_str,
+      "Replay the traffic of the given port (e.g. ttyUSB2) in a pseudo-terminal",
+      "[PORT]"
+    },
+    { "no-timing", 0, 0, G_OPTION_ARG_NONE, &no_timing_flag,
+      "When replaying, send responses right away instead of with the captured timing",
+      NULL
+    },
+    { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose_flag,
+      "Run action with verbose logs",
+      NULL
+    },
+    { "version", 'V', 0, G_OPTION_ARG_NONE, &version_flag,
+      "Print version",
+      NULL
+    },
+    { NULL }
+};
+
+static void
+signals_handler (int signum)
+{
+    if (loop && g_main_loop_is_running (loop)) {
+        g_printerr ("%s\n",
+                    "cancelling the main loop...\n");
+        g_main_loop_quit (loop);
+    }
+}
+
+static void
+print_version_and_exit (void)
+{
+    g_print ("\n"
+             PROGRAM_NAME " " PROGRAM_VERSION "\n"
+             "Copyright (2026) The ModemManager authors\n"
+             "License GPLv2+: GNU GPL version 2 or later <http://gnu.org/licenses/gpl-2.0.html>\n"
+             "This is free software: you are free to change and redistribute it.\n"
+             "There is NO WARRANTY, to the extent permitted by law.\n"
+             "\n");
+    exit (EXIT_SUCCESS);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    guint        channel;
+    gchar       *name;
+    MMPortType   port_type;
+    guint        n_records;
+    guint64      n_bytes_in;
+    guint64      n_bytes_out;
+} Channel;
+
+static void
+channel_free (Channel *channel)
+{
+    g_free (channel->name);
+    g_slice_free (Channel, channel);
+}
+
+static const gchar *
+direction_to_string (MMPortTraceDirection direction)
+{
+    switch (direction) {
+    case MM_PORT_TRACE_DIRECTION_OUT:
+        return "-->";
+    case MM_PORT_TRACE_DIRECTION_IN:
+        return "<--";
+    case MM_PORT_TRACE_DIRECTION_NONE:
+    default:
+        return "???";
+    }
+}
+
+/* AT and GPS traffic is printed as escaped text, anything else as hex */
+static gchar *
+record_to_string (MMPortType               port_type,
+                  const MMPortTraceRecord *record)
+{
+    if (port_type == MM_PORT_TYPE_AT || port_type == MM_PORT_TYPE_GPS) {
+        g_autofree gchar *str = NULL;
+
+        str = g_strndup ((const gchar *) record->data, record->len);
+        return g_strescape (str, NULL);
+    }
+
+    return mm_utils_bin2hexstr (record->data, record->len);
+}
+
+/* Loads all records, calling the given method for each of them. The
+ * channels found are returned indexed by channel number. */
+typedef void (* RecordFunc) (const Channel           *channel,
+                             const MMPortTraceRecord *record,
+                             gpointer                 user_data);
+
+static GHashTable *
+load_capture (MMPortTraceReader *reader,
+              RecordFunc         func,
+              gpointer           user_data)
+{
+    GHashTable        *channels;
+    MMPortTraceRecord  record;
+    GError            *error = NULL;
+
+    channels = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) channel_free);
+
+    while (mm_port_trace_reader_next (reader, &record, &error)) {
+        Channel *channel;
+
+        if (record.type == MM_PORT_TRACE_RECORD_TYPE_CHANNEL) {
+            channel = g_slice_new0 (Channel);
+            channel->channel = record.channel;
+            channel->name = mm_port_trace_record_get_name (&record);
+            channel->port_type = (MMPortType) mm_port_trace_record_get_port_type (&record);
+            g_hash_table_replace (channels, GUINT_TO_POINTER (record.channel), channel);
+            continue;
+        }
+
+        channel = g_hash_table_lookup (channels, GUINT_TO_POINTER (record.channel));
+        if (!channel) {
+            g_printerr ("warning: data record in undefined channel %u\n", record.channel);
+            continue;
+        }
+
+        channel->n_records++;
+        if (record.direction == MM_PORT_TRACE_DIRECTION_IN)
+            channel->n_bytes_in += record.len;
+        else
+            channel->n_bytes_out += record.len;
+
+        if (func)
+            func (channel, &record, user_data);
+    }
+
+    /* Keep whatever was read from truncated captures */
+    if (error) {
+        g_printerr ("warning: %s\n", error->message);
+        g_error_free (error);
+    }
+
+    return channels;
+}
+
+/*****************************************************************************/
+
+static void
+list_capture (MMPortTraceReader *reader)
+{
+    g_autoptr(GHashTable)  channels = NULL;
+    GHashTableIter         iter;
+    Channel               *channel;
+
+    channels = load_capture (reader, NULL, NULL);
+
+    g_hash_table_iter_init (&iter, channels);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &channel))
+        g_print ("[%u] %s (%s): %u records, %" G_GUINT64_FORMAT " bytes written, %" G_GUINT64_FORMAT " bytes read\n",
+                 channel->channel,
+                 channel->name,
+                 mm_port_type_get_string (channel->port_type),
+                 channel->n_records,
+                 channel->n_bytes_out,
+                 channel->n_bytes_in);
+}
+
+/*****************************************************************************/
+
+static void
+dump_record (const Channel           *channel,
+             const MMPortTraceRecord *record,
+             guint64                 *start)
+{
+    g_autofree gchar *str = NULL;
+
+    if (!*start)
+        *start = record->timestamp;
+
+    str = record_to_string (channel->port_type, record);
+    g_print ("[%06" G_GUINT64_FORMAT ".%06" G_GUINT64_FORMAT "] [%s] %s '%s'\n",
+             (record->timestamp - *start) / G_USEC_PER_SEC,
+             (record->timestamp - *start) % G_USEC_PER_SEC,
+             channel->name,
+             direction_to_string (record->direction),
+             str);
+}
+
+static void
+dump_capture (MMPortTraceReader *reader)
+{
+    g_autoptr(GHashTable) channels = NULL;
+    guint64               start = 0;
+
+    channels = load_capture (reader, (RecordFunc) dump_record, &start);
+}
+
+/*****************************************************************************/
+/* Replay: the pseudo-terminal acts as the modem, waiting for the data the
+ * host wrote in the capture, and sending back the data the modem replied. */
+
+typedef struct {
+    gint         master;
+    MMPortType   port_type;
+    GArray      *records;
+    guint        current;
+    /* Data received from the host, not yet matched */
+    GByteArray  *received;
+    guint        n_mismatches;
+    guint        timeout_id;
+    guint        fd_id;
+    gint64       start;
+} Replay;
+
+static void replay_step (Replay *replay);
+
+static gboolean
+replay_send_cb (Replay *replay)
+{
+    const MMPortTraceRecord *record;
+    gsize                    written = 0;
+
+    replay->timeout_id = 0;
+
+    record = &g_array_index (replay->records, MMPortTraceRecord, replay->current);
+    while (written < record->len) {
+        gssize n;
+
+        n = write (replay->master, record->data + written, record->len - written);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            g_printerr ("error: couldn't write to pseudo-terminal: %s\n", g_strerror (errno));
+            g_main_loop_quit (loop);
+            return G_SOURCE_REMOVE;
+        }
+        written += n;
+    }
+
+    if (verbose_flag) {
+        g_autofree gchar *str = NULL;
+
+        str = record_to_string (replay->port_type, record);
+        g_print ("<-- '%s'\n", str);
+    }
+
+    replay->current++;
+    replay_step (replay);
+    return G_SOURCE_REMOVE;
+}
+
+/* Matches the data received so far with the captured host writes */
+static void
+replay_match_received (Replay *replay)
+{
+    while (replay->current < replay->records->len) {
+        const MMPortTraceRecord *record;
+
+        record = &g_array_index (replay->records, MMPortTraceRecord, replay->current);
+        if (record->direction != MM_PORT_TRACE_DIRECTION_OUT || replay->received->len < record->len)
+            return;
+
+        if (memcmp (replay->received->data, record->data, record->len) != 0) {
+            g_autofree gchar *expected = NULL;
+            g_autofree gchar *received = NULL;
+            MMPortTraceRecord received_record = {
+                .data = replay->received->data,
+                .len  = record->len,
+            };
+
+            expected = record_to_string (replay->port_type, record);
+            received = record_to_string (replay->port_type, &received_record);
+            g_printerr ("warning: received '%s', expected '%s'\n", received, expected);
+            replay->n_mismatches++;
+        } else if (verbose_flag) {
+            g_autofree gchar *str = NULL;
+
+            str = record_to_string (replay->port_type, record);
+            g_print ("--> '%s'\n", str);
+        }
+
+        g_byte_array_remove_range (replay->received, 0, record->len);
+        replay->current++;
+    }
+}
+
+static void
+replay_step (Replay *replay)
+{
+    const MMPortTraceRecord *record;
+    const MMPortTraceRecord *previous;
+    guint                    delay_ms = 0;
+
+    replay_match_received (replay);
+
+    if (replay->current == replay->records->len) {
+        g_print ("replay finished in %.3f seconds, %u mismatches\n",
+                 (gdouble) (g_get_monotonic_time () - replay->start) / G_USEC_PER_SEC,
+                 replay->n_mismatches);
+        g_main_loop_quit (loop);
+        return;
+    }
+
+    /* Wait for the host to write */
+    record = &g_array_index (replay->records, MMPortTraceRecord, replay->current);
+    if (record->direction == MM_PORT_TRACE_DIRECTION_OUT || replay->timeout_id)
+        return;
+
+    /* Send modem data, with the same delay as in the capture */
+    if (!no_timing_flag && replay->current > 0) {
+        previous = &g_array_index (replay->records, MMPortTraceRecord, replay->current - 1);
+        if (record->timestamp > previous->timestamp)
+            delay_ms = (record->timestamp - previous->timestamp) / 1000;
+    }
+    replay->timeout_id = g_timeout_add (delay_ms, (GSourceFunc) replay_send_cb, replay);
+}
+
+static gboolean
+replay_input_cb (gint          fd,
+                 GIOCondition  condition,
+                 Replay       *replay)
+{
+    guint8 buf[1024];
+    gssize n;
+
+    n = read (fd, buf, sizeof (buf));
+    if (n < 0) {
+        /* EIO just means there's no one with the slave open */
+        if (errno != EAGAIN && errno != EINTR && errno != EIO) {
+            g_printerr ("error: couldn't read from pseudo-terminal: %s\n", g_strerror (errno));
+            g_main_loop_quit (loop);
+            return G_SOURCE_REMOVE;
+        }
+        return G_SOURCE_CONTINUE;
+    }
+
+    g_byte_array_append (replay->received, buf, n);
+    replay_step (replay);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+replay_record (const Channel           *channel,
+               const MMPortTraceRecord *record,
+               Replay                  *replay)
+{
+    if (g_strcmp0 (channel->name, replay_str) != 0)
+        return;
+
+    replay->port_type = channel->port_type;
+    g_array_append_val (replay->records, *record);
+}
+
+static void
+replay_capture (MMPortTraceReader *reader)
+{
+    g_autoptr(GHashTable) channels = NULL;
+    struct termios        tio;
+    Replay                replay = { 0 };
+
+    replay.records = g_array_new (FALSE, FALSE, sizeof (MMPortTraceRecord));
+    channels = load_capture (reader, (RecordFunc) replay_record, &replay);
+    if (!replay.records->len) {
+        g_printerr ("error: no data captured for port '%s'\n", replay_str);
+        exit (EXIT_FAILURE);
+    }
+
+    replay.master = posix_openpt (O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (replay.master < 0 || grantpt (replay.master) < 0 || unlockpt (replay.master) < 0) {
+        g_printerr ("error: couldn't create pseudo-terminal: %s\n", g_strerror (errno));
+        exit (EXIT_FAILURE);
+    }
+
+    /* Pass data through unmodified, as the modem would */
+    if (tcgetattr (replay.master, &tio) == 0) {
+        cfmakeraw (&tio);
+        tcsetattr (replay.master, TCSANOW, &tio);
+    }
+
+    g_print ("replaying %u records of port '%s' (%s) in %s\n",
+             replay.records->len, replay_str,
+             mm_port_type_get_string (replay.port_type),
+             ptsname (replay.master));
+
+    replay.received = g_byte_array_new ();
+    replay.start = g_get_monotonic_time ();
+    replay.fd_id = g_unix_fd_add (replay.master, G_IO_IN, (GUnixFDSourceFunc) replay_input_cb, &replay);
+
+    replay_step (&replay);
+    if (replay.current < replay.records->len)
+        g_main_loop_run (loop);
+
+    if (replay.timeout_id)
+        g_source_remove (replay.timeout_id);
+    g_source_remove (replay.fd_id);
+    close (replay.master);
+    g_byte_array_unref (replay.received);
+    g_array_unref (replay.records);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    GOptionContext    *context;
+    GError            *error = NULL;
+    MMPortTraceReader *reader;
+
+    setlocale (LC_ALL, "");
+
+    /* Setup option context, process it and destroy it */
+    context = g_option_context_new ("- ModemManager traffic capture tool");
+    g_option_context_add_main_entries (context, main_entries, NULL);
+    g_option_context_parse (context, &argc, &argv, NULL);
+    g_option_context_free (context);
+
+    if (version_flag)
+        print_version_and_exit ();
+
+    /* No capture file given? */
+    if (!file_str) {
+        g_printerr ("error: no capture file specified\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if ((!!list_flag + !!dump_flag + !!replay_str) != 1) {
+        g_printerr ("error: exactly one of --list, --dump or --replay must be given\n");
+        exit (EXIT_FAILURE);
+    }
+
+    reader = mm_port_trace_reader_new (file_str, &error);
+    if (!reader) {
+        g_printerr ("error: couldn't open capture file: %s\n", error->message);
+        exit (EXIT_FAILURE);
+    }
+
+    if (list_flag)
+        list_capture (reader);
+    else if (dump_flag)
+        dump_capture (reader);
+    else {
+        /* Setup signals */
+        signal (SIGINT, signals_handler);
+        signal (SIGHUP, signals_handler);
+        signal (SIGTERM, signals_handler);
+
+        loop = g_main_loop_new (NULL, FALSE);
+        replay_capture (reader);
+        g_main_loop_unref (loop);
+    }
+
+    mm_port_trace_reader_free (reader);
+    g_free (file_str);
+    g_free (replay_str);
+
+    return EXIT_SUCCESS;
+}
@@ -303,6 +303,14 @@ _mm_log (gpointer     obj,
     g_print ("[%s] %s\n", level_str ? level_str : "unknown", msg);
 }
 
+gboolean
+_mm_log_is_enabled (gpointer     obj,
+                    const gchar *module,
+                    MMLogLevel   level)
+{
+    return verbose_flag;
+}
+
 int main (int argc, char **argv)
 {
     GOptionContext *context;